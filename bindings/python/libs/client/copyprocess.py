@@ -120,6 +120,35 @@ class CopyProcess(object):
                            dynamicsource, chunksize, parallelchunks, inittimeout,
                            tpctimeout)
 
+  def configure(self,
+                parallel        = 1,
+                inflightbudget  = 0,
+                sourcehostlimit = 0,
+                targethostlimit = 0,
+                smallfilesfirst = False):
+    """Configure how the copy jobs are run.
+
+    :param        parallel: number of copy jobs to be run simultaneously
+    :type         parallel: integer
+    :param  inflightbudget: maximum number of bytes the running jobs may have
+                            in flight, 0 for no limit; a job accounts for its
+                            chunk pipeline or its file size if smaller
+    :type   inflightbudget: integer
+    :param sourcehostlimit: maximum number of jobs reading from the same host
+                            at a time, 0 for no limit
+    :type  sourcehostlimit: integer
+    :param targethostlimit: maximum number of jobs writing to the same host
+                            at a time, 0 for no limit
+    :type  targethostlimit: integer
+    :param smallfilesfirst: start the jobs copying the smallest local files
+                            first
+    :type  smallfilesfirst: boolean
+    """
+    status = self.__process.configure(parallel, inflightbudget,
+                                      sourcehostlimit, targethostlimit,
+                                      smallfilesfirst)
+    return XRootDStatus(status)
+
   def prepare(self):
     """Prepare the copy jobs. **Must be called before** ``run()``."""
     status = self.__process.prepare()
@@ -113,6 +113,38 @@ namespace PyXRootD
     return ConvertType( &status );
   }
 
+  //----------------------------------------------------------------------------
+  // Configure the copy process as a whole
+  //----------------------------------------------------------------------------
+  PyObject* CopyProcess::Configure( CopyProcess *self, PyObject *args, PyObject *kwds )
+  {
+    static const char *kwlist[]
+      = { "parallel", "inflightbudget", "sourcehostlimit", "targethostlimit",
+          "smallfilesfirst", NULL };
+
+    uint16_t           parallel        = 1;
+    unsigned long long inFlightBudget  = 0;
+    uint16_t           sourceHostLimit = 0;
+    uint16_t           targetHostLimit = 0;
+    bool               smallFilesFirst = false;
+
+    if ( !PyArg_ParseTupleAndKeywords( args, kwds, "|HKHHb:configure",
+         (char**) kwlist, &parallel, &inFlightBudget, &sourceHostLimit,
+         &targetHostLimit, &smallFilesFirst ) )
+      return NULL;
+
+    XrdCl::PropertyList properties;
+    properties.Set( "jobType",         "configuration"            );
+    properties.Set( "parallel",        parallel                   );
+    properties.Set( "inFlightBudget",  (uint64_t)inFlightBudget   );
+    properties.Set( "sourceHostLimit", sourceHostLimit            );
+    properties.Set( "targetHostLimit", targetHostLimit            );
+    properties.Set( "smallFilesFirst", smallFilesFirst            );
+
+    XrdCl::XRootDStatus status = self->process->AddJob( properties, 0 );
+    return ConvertType( &status );
+  }
+
   //----------------------------------------------------------------------------
   // Prepare the copy jobs
   //----------------------------------------------------------------------------
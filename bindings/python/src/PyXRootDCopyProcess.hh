@@ -40,6 +40,7 @@ namespace PyXRootD
   {
     public:
       static PyObject* AddJob(CopyProcess *self, PyObject *args, PyObject *kwds);
+      static PyObject* Configure(CopyProcess *self, PyObject *args, PyObject *kwds);
       static PyObject* Prepare(CopyProcess *self, PyObject *args, PyObject *kwds);
       static PyObject* Run(CopyProcess *self, PyObject *args, PyObject *kwds);
     public:
@@ -77,6 +78,8 @@ namespace PyXRootD
   {
     { "add_job",
        (PyCFunction) PyXRootD::CopyProcess::AddJob,  METH_VARARGS | METH_KEYWORDS, NULL },
+    { "configure",
+       (PyCFunction) PyXRootD::CopyProcess::Configure, METH_VARARGS | METH_KEYWORDS, NULL },
     { "prepare",
        (PyCFunction) PyXRootD::CopyProcess::Prepare, METH_VARARGS | METH_KEYWORDS, NULL },
     { "run",
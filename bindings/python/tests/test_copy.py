@@ -46,6 +46,19 @@ def test_copy_bigfile():
   assert size1 == size2
   f.close()
 
+def test_copy_parallel():
+  c = client.CopyProcess()
+  c.add_job( source=bigfile, target=bigcopy, force=True )
+  c.add_job( source=smallfile, target=smallcopy, force=True )
+  s = c.configure( parallel=2, inflightbudget=64*1024*1024,
+                   sourcehostlimit=1, smallfilesfirst=True )
+  assert s.ok
+  s = c.prepare()
+  assert s.ok
+  s, results = c.run()
+  assert s.ok
+  assert len(results) == 2
+
 def test_copy_nojobs():
   c = client.CopyProcess()
   s = c.prepare()
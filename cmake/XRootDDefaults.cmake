@@ -20,3 +20,4 @@ define_default( ENABLE_HTTP     TRUE )
 define_default( ENABLE_CEPH     TRUE )
 define_default( ENABLE_PYTHON   TRUE )
 define_default( XRD_PYTHON_REQ_VERSION 2.4 )
+define_default( XRDCMS_STMAX    64 )
@@ -88,6 +88,8 @@ enum CmsReqCode            // Request Codes
      kYR_update  = 25,
      kYR_usage   = 26,
      kYR_xauth   = 27,
+     kYR_summary = 28,
+     kYR_notify  = 29,
      kYR_MaxReq            // Count of request numbers (highest + 1)
 };
 
@@ -193,6 +195,9 @@ struct CmsDiscRequest
 struct CmsGoneRequest
 {      CmsRRHdr      Hdr;
 //     kXR_string    Path;
+
+enum  {kYR_miss    = 0x01     // Modifier: reply to a kYR_misresp state request
+      };
 };
 
 /******************************************************************************/
@@ -272,6 +277,9 @@ struct CmsLoginData
                   kYR_suspend =   0x00000100,   // Suspended login
                   kYR_nostage =   0x00000200,   // Staging unavailable
                   kYR_trying  =   0x00000400,   // Extensive login retries
+                  kYR_rdrcache=   0x00000800,   // Director caches redirects
+                  kYR_batch   =   0x00001000,   // Manager accepts notify
+                  kYR_namesum =   0x00002000,   // Manager accepts summary
                   kYR_debug   =   0x80000000,
                   kYR_share   =   0x7f000000,   // Mask to isolate share
                   kYR_shift   =   24,           // Share shift position
@@ -347,6 +355,34 @@ struct CmsMvRequest {
 //     kXR_string    New_Path;
 };
 
+/******************************************************************************/
+/*                        n o t i f y   R e q u e s t                         */
+/******************************************************************************/
+  
+// Request: notify <entries>
+// Respond: n/a
+//
+// A batch of have and gone requests, each encoded as a CmsNotifyEntry followed
+// by Slen bytes of path. Paths are front coded: the first Keep bytes of a path
+// are those of the previous path in the batch. Keep and Slen are in network
+// byte order. The request is always sent with the kYR_raw modifier and only to
+// managers that logged us in with kYR_batch.
+//
+struct CmsNotifyRequest
+{      CmsRRHdr      Hdr;
+//     kXR_char      Entries[Hdr.datalen];
+
+enum  {MaxData = 8192
+      };
+};
+
+struct CmsNotifyEntry
+{      kXR_char      rrCode;   // kYR_have or kYR_gone
+       kXR_char      Mod;      // Modifier of the equivalent request
+       kXR_unt16     Keep;     // Bytes kept from the previous path
+       kXR_unt16     Slen;     // Bytes of path that follow
+};
+
 /******************************************************************************/
 /*                          p i n g   R e q u e s t                           */
 /******************************************************************************/
@@ -520,6 +556,7 @@ struct CmsStateRequest
 
 enum  {kYR_refresh = 0x01,   // Modifier
        kYR_noresp  = 0x02,
+       kYR_misresp = 0x04,   // Respond with gone if the file is not here
        kYR_metaman = 0x08
       };
 };
@@ -568,6 +605,36 @@ enum  {kYR_Stage  = 0x01, kYR_noStage = 0x02,  // Modifier
       };
 };
 
+/******************************************************************************/
+/*                       s u m m a r y   R e q u e s t                        */
+/******************************************************************************/
+  
+// Request: summary <gen> <offset> <lgbits> <hashes> <flags> <data>
+// Respond: n/a
+//
+// A piece of the server's namespace summary (a Bloom filter). The summary is
+// sent in order in pieces of at most MaxData bytes; the last piece completes
+// it. The request is always sent with the kYR_raw modifier. With kYR_resolve
+// the server vouches that files only appear through xrootd so that a lookup
+// its summary rules out may be answered without asking it. Summaries are only
+// sent to managers that set kYR_namesum in their login reply.
+//
+struct CmsSummaryRequest
+{      CmsRRHdr      Hdr;
+       kXR_unt32     Gen;      // Generation of the summary
+       kXR_unt32     Offset;   // Offset of the data in the summary
+       kXR_char      lgBits;   // log2 of the number of bits in the summary
+       kXR_char      Hashes;   // Number of hash functions
+       kXR_char      Flags;
+       kXR_char      Rsvd;
+//     kXR_char      Data[Hdr.datalen-12];
+
+enum  {MaxData = 8192
+      };
+enum  {kYR_resolve = 0x01     // Flags: summary may resolve lookups
+      };
+};
+
 /******************************************************************************/
 /*                         t r u n c   R e q u e s t                          */
 /******************************************************************************/
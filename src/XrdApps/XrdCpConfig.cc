@@ -109,6 +109,9 @@ struct option XrdCpConfig::opVec[] =         // For getopt_long()
       {OPT_TYPE "xrate",       1, 0, XrdCpConfig::OpXrate},
       {OPT_TYPE "parallel",    1, 0, XrdCpConfig::OpParallel},
       {OPT_TYPE "zip",         1, 0, XrdCpConfig::OpZip},
+      {OPT_TYPE "max-inflight",1, 0, XrdCpConfig::OpInFlight},
+      {OPT_TYPE "host-limit",  1, 0, XrdCpConfig::OpHostLim},
+      {OPT_TYPE "small-first", 0, 0, XrdCpConfig::OpSmallFst},
       {0,                      0, 0, 0}
      };
 
@@ -131,6 +134,8 @@ XrdCpConfig::XrdCpConfig(const char *pgm)
    pPort    = 0;
    xRate    = 0;
    Parallel = 1;
+   InFlight = 0;
+   HostLimit= 0;
    OpSpec   = 0;
    Dlvl     = 0;
    nSrcs    = 1;
@@ -281,7 +286,15 @@ do{while(optind < Argc && Legacy(optind)) {}
                            if (!a2z(optarg, &xRate, 10*1024LL, -1)) Usage(22);
                            break;
           case OpParallel: OpSpec |= DoParallel;
-                           if (!a2i(optarg, &Parallel, 1, 4)) Usage(22);
+                           if (!a2i(optarg, &Parallel, 1, 128)) Usage(22);
+                           break;
+          case OpInFlight: OpSpec |= DoInFlight;
+                           if (!a2z(optarg, &InFlight, 1024*1024LL, -1)) Usage(22);
+                           break;
+          case OpHostLim:  OpSpec |= DoHostLim;
+                           if (!a2i(optarg, &HostLimit, 1, 128)) Usage(22);
+                           break;
+          case OpSmallFst: OpSpec |= DoSmallFst;
                            break;
           case ':':        UMSG("'" <<OpName() <<"' argument missing.");
                            break;
@@ -867,7 +880,8 @@ void XrdCpConfig::Usage(int rc)
    "         [--path] [--posc] [--proxy <host>:<port>] [--recursive]\n"
    "         [--retry <n>] [--server] [--silent] [--sources <n>] [--streams <n>]\n"
    "         [--tpc {first|only}] [--verbose] [--version] [--xrate <rate>]\n"
-   "         [--parallel <n>] [--zip <file>]";
+   "         [--parallel <n>] [--max-inflight <size>] [--host-limit <n>]\n"
+   "         [--small-first] [--zip <file>]";
 
    static const char *Syntax2= "\n"
    "<src>:   [[x]root://<host>[:<port>]/]<path> | -";
@@ -911,7 +925,13 @@ void XrdCpConfig::Usage(int rc)
    "-V | --version      prints the version number\n"
    "-X | --xrate <rate> limits the transfer to the specified rate. You can\n"
    "                    suffix the value with 'k', 'm', or 'g'\n"
-   "     --parallel <n> number of copy jobs to be run simultaneously\n\n"
+   "     --parallel <n> number of copy jobs to be run simultaneously\n"
+   "     --max-inflight <size> limits the bytes the parallel copy jobs may\n"
+   "                    have in flight. You can suffix the value with 'k',\n"
+   "                    'm', or 'g'\n"
+   "     --host-limit <n> number of copy jobs to be run simultaneously\n"
+   "                    against the same source or destination host\n"
+   "     --small-first  starts copying the smallest local files first\n\n"
    "-z | --zip <file>   treat the source as a ZIP archive containing given file\n"
    "Legacy options:     [-adler] [-DI<var> <val>] [-DS<var> <val>] [-np]\n"
    "                    [-md5] [-OD<cgi>] [-OS<cgi>] [-version] [-x]";
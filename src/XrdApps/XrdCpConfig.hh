@@ -62,7 +62,9 @@ struct defVar
        const char  *srcOpq;        // -> -OS setting (src  opaque)
        const char  *Pgm;           // -> Program name
         long long   xRate;         // -xrate value in bytes/sec   (0 if not set)
-             int    Parallel;      // Number of simultaneous copy ops (1 to 4)
+             int    Parallel;      // Number of simultaneous copy ops (1 to 128)
+        long long   InFlight;      // Copy bytes in flight budget (0 if not set)
+             int    HostLimit;     // Max copy ops per host       (0 if not set)
              char  *pHost;         // -> SOCKS4 proxy hname       (0 if none)
              int    pPort;         //    SOCKS4 proxy port
              int    OpSpec;        // Bit mask of set options     (see Doxxxx)
@@ -162,6 +164,15 @@ static const int    DoDynaSrc  =  0x00400000; //      --dynamic-src
 static const int    OpZip      =  'z';
 static const int    DoZip      =  0x01000000;//       --zip
 
+static const int    OpInFlight =  0x05;
+static const int    DoInFlight =  0x02000000; //      --max-inflight
+
+static const int    OpHostLim  =  0x06;
+static const int    DoHostLim  =  0x04000000; //      --host-limit
+
+static const int    OpSmallFst =  0x07;
+static const int    DoSmallFst =  0x08000000; //      --small-first
+
 // Call Config with the parameters passed to main() to fill out this object. If
 // the method returns then no errors have been found. Otherwise, it exits.
 // The following options may be passed (largely to support legacy stuff):
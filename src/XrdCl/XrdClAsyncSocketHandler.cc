@@ -25,6 +25,22 @@
 #include "XrdCl/XrdClXRootDMsgHandler.hh"
 #include "XrdCl/XrdClOptimizers.hh"
 #include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <climits>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // The most buffers we pass to a single writev
+  //----------------------------------------------------------------------------
+#ifdef IOV_MAX
+  const int MaxIovCnt = IOV_MAX;
+#else
+  const int MaxIovCnt = 1024;
+#endif
+}
 
 namespace XrdCl
 {
@@ -54,14 +70,34 @@ namespace XrdCl
     pOutMsgDone( false ),
     pOutHandler( 0 ),
     pIncMsgSize( 0 ),
-    pOutMsgSize( 0 )
+    pOutMsgSize( 0 ),
+    pRecvBuffer( 0 ),
+    pRecvBufferSize( 0 ),
+    pRecvOffset( 0 ),
+    pRecvSize( 0 )
   {
+    pPipe[0] = pPipe[1] = -1;
+
     Env *env = DefaultEnv::GetEnv();
 
     int timeoutResolution = DefaultTimeoutResolution;
     env->GetInt( "TimeoutResolution", timeoutResolution );
     pTimeoutResolution = timeoutResolution;
 
+    //--------------------------------------------------------------------------
+    // Responses are read in as large chunks as available and parsed from
+    // the receive buffer, 0 means reading every header and body separately,
+    // as is always done for transports that cannot parse buffered data
+    //--------------------------------------------------------------------------
+    int recvBufferSize = DefaultRecvBufferSize;
+    env->GetInt( "RecvBufferSize", recvBufferSize );
+    pBufTransport = dynamic_cast<BufferedTransportHandler*>( pTransport );
+    if( recvBufferSize > 0 && pBufTransport )
+    {
+      pRecvBufferSize = recvBufferSize;
+      pRecvBuffer     = new char[pRecvBufferSize];
+    }
+
     pSocket = new Socket();
     pSocket->SetChannelID( pChannelData );
     pIncHandler = std::make_pair( (IncomingMsgHandler*)0, false );
@@ -76,6 +112,8 @@ namespace XrdCl
     Close();
     delete pSocket;
     delete pSignature;
+    delete [] pRecvBuffer;
+    ClosePipe();
   }
 
   //----------------------------------------------------------------------------
@@ -200,7 +238,8 @@ namespace XrdCl
     if( !pIncHandler.second )
       delete pIncoming;
 
-    pIncoming = 0;
+    pIncoming   = 0;
+    pRecvOffset = pRecvSize = 0;
     return Status();
   }
 
@@ -505,31 +544,30 @@ namespace XrdCl
 
     Log *log = DefaultEnv::GetLog();
 
-    const size_t iovcnt = 1 + ( sign ? 1 : 0 ) + ( chunks ? chunks->size() : 0 );
-    iovec iov[iovcnt];
-    uint32_t leftToBeWritten = 0;
-    size_t i = 0;
+    //--------------------------------------------------------------------------
+    // The raw data go straight from the user buffers, possibly more of them
+    // than a single writev accepts, so we send whatever is left in windows
+    // of at most MaxIovCnt buffers
+    //--------------------------------------------------------------------------
+    iovec    iov[MaxIovCnt];
+    uint32_t rawSize = 0;
 
-    if( sign )
+    while( true )
     {
-      ToIov( *sign, iov[i] );
-      leftToBeWritten += iov[i].iov_len;
-      ++i;
-    }
+      int iovcnt = 0;
 
-    ToIov( *toWrite, iov[i] );
-    leftToBeWritten += iov[i].iov_len;
-    ++i;
+      if( sign && sign->GetCursor() < sign->GetSize() )
+        ToIov( *sign, iov[iovcnt++] );
 
-    uint32_t rawSize = 0;
-    if( chunks )
-    {
-      rawSize = ToIov( chunks, asyncOffset, iov + i );
-      leftToBeWritten += rawSize;
-    }
+      if( toWrite->GetCursor() < toWrite->GetSize() )
+        ToIov( *toWrite, iov[iovcnt++] );
+
+      if( chunks && asyncOffset )
+        ToIov( chunks, asyncOffset, iov, iovcnt );
+
+      if( !iovcnt )
+        break;
 
-    while( leftToBeWritten )
-    {
       int bytesWritten = pSocket->WriteV( iov, iovcnt );
       if( bytesWritten <= 0 )
       {
@@ -548,15 +586,16 @@ namespace XrdCl
         return Status( stError, errSocketError, errno );
       }
 
-      leftToBeWritten -= bytesWritten;
       if( sign )
-        UpdateAfterWrite( *sign, iov[0], bytesWritten );
+        UpdateAfterWrite( *sign, bytesWritten );
 
-      i = sign ? 1 : 0;
-      UpdateAfterWrite( *toWrite, iov[i], bytesWritten );
+      UpdateAfterWrite( *toWrite, bytesWritten );
 
       if( chunks && asyncOffset )
-        UpdateAfterWrite( chunks, asyncOffset, iov + i + 1, bytesWritten );
+      {
+        *asyncOffset += bytesWritten;
+        rawSize      += bytesWritten;
+      }
     }
 
     //--------------------------------------------------------------------------
@@ -661,6 +700,23 @@ namespace XrdCl
   // Got a read readiness event
   //----------------------------------------------------------------------------
   void AsyncSocketHandler::OnRead()
+  {
+    //--------------------------------------------------------------------------
+    // Process all the complete messages the receive buffer holds, partial
+    // message stays in pIncoming until more data arrives
+    //--------------------------------------------------------------------------
+    do
+    {
+      if( !ReadIncoming() )
+        return;
+    }
+    while( pRecvSize && pSocket->GetStatus() == Socket::Connected );
+  }
+
+  //----------------------------------------------------------------------------
+  // Read the incoming message
+  //----------------------------------------------------------------------------
+  bool AsyncSocketHandler::ReadIncoming()
   {
     //--------------------------------------------------------------------------
     // There is no incoming message currently being processed so we create
@@ -682,15 +738,18 @@ namespace XrdCl
     //--------------------------------------------------------------------------
     if( !pHeaderDone )
     {
-      st = pTransport->GetHeader( pIncoming, pSocket->GetFD() );
+      if( pRecvBuffer )
+        st = ReadHeaderBuffered( pIncoming );
+      else
+        st = pTransport->GetHeader( pIncoming, pSocket->GetFD() );
       if( !st.IsOK() )
       {
         OnFault( st );
-        return;
+        return false;
       }
 
       if( st.code == suRetry )
-        return;
+        return false;
 
       log->Dump( AsyncSockMsg, "[%s] Received message header for 0x%x size: %d",
                 pStreamName.c_str(), pIncoming, pIncoming->GetCursor() );
@@ -707,37 +766,59 @@ namespace XrdCl
     }
 
     //--------------------------------------------------------------------------
-    // We need to call a raw message handler to get the data from the socket
+    // We need to call a raw message handler to get the data from the socket,
+    // it takes whatever has been buffered together with the header and
+    // reads the rest directly into the user buffers
     //--------------------------------------------------------------------------
     if( pIncHandler.first )
     {
       uint32_t bytesRead = 0;
-      st = pIncHandler.first->ReadMessageBody( pIncoming, pSocket->GetFD(),
-                                               bytesRead );
+      if( pRecvSize )
+      {
+        BufferedIncomingMsgHandler *handler =
+          dynamic_cast<BufferedIncomingMsgHandler*>( pIncHandler.first );
+        if( handler )
+        {
+          const char *buffer = pRecvBuffer + pRecvOffset;
+          uint32_t    size   = pRecvSize;
+          st = handler->ReadMessageBody( pIncoming, pSocket->GetFD(),
+                                         buffer, size, bytesRead );
+          pRecvOffset += pRecvSize - size;
+          pRecvSize    = size;
+        }
+        else
+          st = ReadRawThroughPipe( bytesRead );
+      }
+      else
+        st = pIncHandler.first->ReadMessageBody( pIncoming, pSocket->GetFD(),
+                                                 bytesRead );
       if( !st.IsOK() )
       {
         OnFault( st );
-        return;
+        return false;
       }
       pIncMsgSize += bytesRead;
 
       if( st.code == suRetry )
-        return;
+        return false;
     }
     //--------------------------------------------------------------------------
     // No raw handler, so we read the message to the buffer
     //--------------------------------------------------------------------------
     else
     {
-      st = pTransport->GetBody( pIncoming, pSocket->GetFD() );
+      if( pRecvBuffer )
+        st = ReadBodyBuffered( pIncoming );
+      else
+        st = pTransport->GetBody( pIncoming, pSocket->GetFD() );
       if( !st.IsOK() )
       {
         OnFault( st );
-        return;
+        return false;
       }
 
       if( st.code == suRetry )
-        return;
+        return false;
 
       pIncMsgSize = pIncoming->GetSize();
     }
@@ -750,6 +831,165 @@ namespace XrdCl
 
     pStream->OnIncoming( pSubStreamNum, pIncoming, pIncMsgSize );
     pIncoming = 0;
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Read whatever is available from the socket into the receive buffer
+  //----------------------------------------------------------------------------
+  Status AsyncSocketHandler::FillRecvBuffer()
+  {
+    if( pRecvSize && pRecvOffset )
+      memmove( pRecvBuffer, pRecvBuffer + pRecvOffset, pRecvSize );
+    pRecvOffset = 0;
+
+    int status = ::read( pSocket->GetFD(), pRecvBuffer + pRecvSize,
+                         pRecvBufferSize - pRecvSize );
+    if( status < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) )
+      return Status( stOK, suRetry );
+
+    if( status <= 0 )
+      return Status( stError, errSocketError, errno );
+
+    pRecvSize += status;
+    return Status();
+  }
+
+  //----------------------------------------------------------------------------
+  // Read the header of the incoming message using the receive buffer
+  //----------------------------------------------------------------------------
+  Status AsyncSocketHandler::ReadHeaderBuffered( Message *msg )
+  {
+    while( true )
+    {
+      if( pRecvSize )
+      {
+        const char *buffer = pRecvBuffer + pRecvOffset;
+        uint32_t    size   = pRecvSize;
+        Status st = pBufTransport->GetHeader( msg, buffer, size );
+        pRecvOffset += pRecvSize - size;
+        pRecvSize    = size;
+        if( !st.IsOK() || st.code == suDone )
+          return st;
+      }
+
+      Status st = FillRecvBuffer();
+      if( !st.IsOK() || st.code == suRetry )
+        return st;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Pass the buffered data to a raw handler that can only read from a socket
+  //----------------------------------------------------------------------------
+  Status AsyncSocketHandler::ReadRawThroughPipe( uint32_t &bytesRead )
+  {
+    //--------------------------------------------------------------------------
+    // The pipe is created on first use and kept empty between the calls
+    //--------------------------------------------------------------------------
+    if( pPipe[0] < 0 )
+    {
+      if( pipe( pPipe ) < 0 )
+        return Status( stError, errSocketError, errno );
+      fcntl( pPipe[0], F_SETFL, O_NONBLOCK );
+      fcntl( pPipe[1], F_SETFL, O_NONBLOCK );
+    }
+    int *fds = pPipe;
+
+    //--------------------------------------------------------------------------
+    // The handler reads no more than the body it expects, so what it leaves
+    // in the pipe is the beginning of the next message. The write end stays
+    // open so that an empty pipe looks like a socket without data. Handlers
+    // may stop at internal boundaries, so they are called for as long as
+    // they make progress.
+    //--------------------------------------------------------------------------
+    Status   st;
+    uint32_t inPipe = 0;
+    while( true )
+    {
+      if( inPipe < pRecvSize )
+      {
+        int queued = ::write( fds[1], pRecvBuffer + pRecvOffset + inPipe,
+                              pRecvSize - inPipe );
+        if( queued < 0 && errno != EAGAIN )
+        {
+          st = Status( stError, errSocketError, errno );
+          break;
+        }
+        if( queued > 0 )
+          inPipe += queued;
+      }
+
+      uint32_t read = 0;
+      st = pIncHandler.first->ReadMessageBody( pIncoming, fds[0], read );
+      bytesRead += read;
+
+      int left = 0;
+      if( ioctl( fds[0], FIONREAD, &left ) < 0 )
+      {
+        st = Status( stError, errSocketError, errno );
+        break;
+      }
+      uint32_t consumed = inPipe - left;
+      pRecvOffset += consumed;
+      pRecvSize   -= consumed;
+      inPipe       = left;
+
+      if( !st.IsOK() || st.code != suRetry || !pRecvSize || !consumed )
+        break;
+    }
+
+    //--------------------------------------------------------------------------
+    // What is left in the pipe is still in the receive buffer, drop it, if
+    // that fails the pipe is recreated next time
+    //--------------------------------------------------------------------------
+    char drain[1024];
+    while( inPipe )
+    {
+      int n = ::read( fds[0], drain, std::min<uint32_t>( inPipe, sizeof( drain ) ) );
+      if( n <= 0 )
+      {
+        ClosePipe();
+        break;
+      }
+      inPipe -= n;
+    }
+    return st;
+  }
+
+  //----------------------------------------------------------------------------
+  // Close the pipe used by ReadRawThroughPipe
+  //----------------------------------------------------------------------------
+  void AsyncSocketHandler::ClosePipe()
+  {
+    if( pPipe[0] < 0 )
+      return;
+    close( pPipe[0] );
+    close( pPipe[1] );
+    pPipe[0] = pPipe[1] = -1;
+  }
+
+  //----------------------------------------------------------------------------
+  // Read the body of the incoming message using the receive buffer
+  //----------------------------------------------------------------------------
+  Status AsyncSocketHandler::ReadBodyBuffered( Message *msg )
+  {
+    if( pRecvSize )
+    {
+      const char *buffer = pRecvBuffer + pRecvOffset;
+      uint32_t    size   = pRecvSize;
+      Status st = pBufTransport->GetBody( msg, buffer, size );
+      pRecvOffset += pRecvSize - size;
+      pRecvSize    = size;
+      if( !st.IsOK() || st.code == suDone )
+        return st;
+    }
+
+    //--------------------------------------------------------------------------
+    // The buffer has been drained, the rest of the body goes straight
+    // into the message, so large responses are not copied twice
+    //--------------------------------------------------------------------------
+    return pTransport->GetBody( msg, pSocket->GetFD() );
   }
 
   //----------------------------------------------------------------------------
@@ -875,6 +1115,7 @@ namespace XrdCl
     pIncoming   = 0;
     pOutgoing   = 0;
     pOutHandler = 0;
+    pRecvOffset = pRecvSize = 0;
 
     pStream->OnError( pSubStreamNum, st );
   }
@@ -956,65 +1197,47 @@ namespace XrdCl
   }
 
   //------------------------------------------------------------------------
-  // Update iovec after write
+  // Advance the message cursor after write
   //------------------------------------------------------------------------
   void AsyncSocketHandler::UpdateAfterWrite( Message  &msg,
-                                             iovec    &iov,
                                              int      &bytesWritten )
   {
-    size_t advance = ( bytesWritten < (int)iov.iov_len ) ? bytesWritten : iov.iov_len;
+    uint32_t left    = msg.GetSize() - msg.GetCursor();
+    uint32_t advance = ( (uint32_t)bytesWritten < left ) ? bytesWritten : left;
     bytesWritten -= advance;
     msg.AdvanceCursor( advance );
-    ToIov( msg, iov );
   }
 
   //------------------------------------------------------------------------
-  // Add chunks to the given iovec
+  // Add the chunks that still need to be written to the given iovec
   //------------------------------------------------------------------------
   uint32_t AsyncSocketHandler::ToIov( ChunkList       *chunks,
                                       const uint32_t  *offset,
-                                      iovec           *iov )
+                                      iovec           *iov,
+                                      int             &iovcnt )
   {
     if( !chunks || !offset ) return 0;
 
     uint32_t off  = *offset;
     uint32_t size = 0;
 
-    for( auto itr = chunks->begin(); itr != chunks->end(); ++itr )
+    for( auto itr = chunks->begin();
+         itr != chunks->end() && iovcnt < MaxIovCnt; ++itr )
     {
       auto &chunk = *itr;
-      if( off > chunk.length )
+      if( off >= chunk.length )
       {
-        iov->iov_len = 0;
-        iov->iov_base = 0;
         off -= chunk.length;
+        continue;
       }
-      else if( off > 0 )
-      {
-        iov->iov_len  = chunk.length - off;
-        iov->iov_base = reinterpret_cast<char*>( chunk.buffer ) + off;
-        size += iov->iov_len;
-        off = 0;
-      }
-      else
-      {
-        iov->iov_len  = chunk.length;
-        iov->iov_base = chunk.buffer;
-        size += iov->iov_len;
-      }
-      ++iov;
+
+      iov[iovcnt].iov_base = reinterpret_cast<char*>( chunk.buffer ) + off;
+      iov[iovcnt].iov_len  = chunk.length - off;
+      size += iov[iovcnt].iov_len;
+      off   = 0;
+      ++iovcnt;
     }
 
     return size;
   }
-
-  void AsyncSocketHandler::UpdateAfterWrite( ChunkList  *chunks,
-                                             uint32_t   *offset,
-                                             iovec      *iov,
-                                             int        &bytesWritten )
-  {
-    *offset += bytesWritten;
-    bytesWritten = 0;
-    ToIov( chunks, offset, iov );
-  }
 }
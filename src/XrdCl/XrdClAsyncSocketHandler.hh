@@ -24,6 +24,7 @@
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdCl/XrdClPoller.hh"
 #include "XrdCl/XrdClPostMasterInterfaces.hh"
+#include "XrdCl/XrdClBufferedRead.hh"
 
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -164,11 +165,44 @@ namespace XrdCl
       //------------------------------------------------------------------------
       void OnRead();
 
+      //------------------------------------------------------------------------
+      // Read the incoming message, true if a complete message has been
+      // received
+      //------------------------------------------------------------------------
+      bool ReadIncoming();
+
       //------------------------------------------------------------------------
       // Got a read readiness event while handshaking
       //------------------------------------------------------------------------
       void OnReadWhileHandshaking();
 
+      //------------------------------------------------------------------------
+      // Read whatever is available from the socket into the receive buffer
+      //------------------------------------------------------------------------
+      Status FillRecvBuffer();
+
+      //------------------------------------------------------------------------
+      // Read the header of the incoming message using the receive buffer
+      //------------------------------------------------------------------------
+      Status ReadHeaderBuffered( Message *msg );
+
+      //------------------------------------------------------------------------
+      // Pass the buffered data to a raw handler that can only read from
+      // a socket
+      //------------------------------------------------------------------------
+      Status ReadRawThroughPipe( uint32_t &bytesRead );
+
+      //------------------------------------------------------------------------
+      // Close the pipe used by ReadRawThroughPipe
+      //------------------------------------------------------------------------
+      void ClosePipe();
+
+      //------------------------------------------------------------------------
+      // Read the body of the incoming message, the buffered data is consumed
+      // first and the rest is read directly into the message
+      //------------------------------------------------------------------------
+      Status ReadBodyBuffered( Message *msg );
+
       //------------------------------------------------------------------------
       // Read a message
       //------------------------------------------------------------------------
@@ -210,30 +244,27 @@ namespace XrdCl
       inline void ToIov( Message &msg, iovec &iov );
 
       //------------------------------------------------------------------------
-      // Update iovec after write
+      // Advance the message cursor after write, consumes the bytes written
+      // to the message
       //------------------------------------------------------------------------
-      inline void UpdateAfterWrite( Message &msg, iovec &iov, int &bytesRead );
+      inline void UpdateAfterWrite( Message &msg, int &bytesWritten );
 
       //------------------------------------------------------------------------
-      // Add chunks to the given iovec
+      // Add the chunks that still need to be written (past offset) to
+      // the given iovec, starting at iovcnt and never exceeding MaxIovCnt
+      // entries
       //------------------------------------------------------------------------
       inline uint32_t ToIov( ChunkList       *chunks,
                              const uint32_t  *offset,
-                             iovec           *iov );
-
-      //------------------------------------------------------------------------
-      // Update raw data after write
-      //------------------------------------------------------------------------
-      inline void UpdateAfterWrite( ChunkList  *chunks,
-                                    uint32_t   *offset,
-                                    iovec      *iov,
-                                    int        &bytesWritten );
+                             iovec           *iov,
+                             int             &iovcnt );
 
       //------------------------------------------------------------------------
       // Data members
       //------------------------------------------------------------------------
       Poller                        *pPoller;
       TransportHandler              *pTransport;
+      BufferedTransportHandler      *pBufTransport;
       AnyObject                     *pChannelData;
       uint16_t                       pSubStreamNum;
       Stream                        *pStream;
@@ -257,6 +288,11 @@ namespace XrdCl
       uint32_t                       pIncMsgSize;
       uint32_t                       pOutMsgSize;
       time_t                         pLastActivity;
+      char                          *pRecvBuffer;
+      uint32_t                       pRecvBufferSize;
+      uint32_t                       pRecvOffset;
+      uint32_t                       pRecvSize;
+      int                            pPipe[2];
   };
 }
 
@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_BUFFERED_READ_HH__
+#define __XRD_CL_BUFFERED_READ_HH__
+
+#include "XrdCl/XrdClPostMasterInterfaces.hh"
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Incoming message handler able to take the part of a raw body that has
+  //! been read from the socket together with the header. The socket handler
+  //! looks for it with dynamic_cast, other handlers get the buffered data
+  //! through a pipe.
+  //----------------------------------------------------------------------------
+  class BufferedIncomingMsgHandler: public IncomingMsgHandler
+  {
+    public:
+      virtual ~BufferedIncomingMsgHandler() {}
+
+      //------------------------------------------------------------------------
+      //! Read message body - called instead of the socket variant if a part
+      //! of the body has already been read from the socket together with
+      //! the header, the buffered data has to be consumed before reading
+      //! from the socket
+      //!
+      //! @param msg       the corresponding message header
+      //! @param socket    the socket to read from
+      //! @param buffer    the data already read, advanced past the bytes
+      //!                  consumed by the method
+      //! @param size      size of the data, decreased by the consumed bytes
+      //! @param bytesRead number of bytes read by the method, including the
+      //!                  consumed buffered data
+      //! @return          stOK & suDone if the whole body has been processed
+      //!                  stOK & suRetry if more data is needed
+      //!                  stError on failure
+      //------------------------------------------------------------------------
+      virtual Status ReadMessageBody( Message     *msg,
+                                      int          socket,
+                                      const char *&buffer,
+                                      uint32_t    &size,
+                                      uint32_t    &bytesRead ) = 0;
+
+      using IncomingMsgHandler::ReadMessageBody;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Transport able to parse messages from data already read from the
+  //! socket. Incoming data is read in large chunks only for transports
+  //! implementing it.
+  //----------------------------------------------------------------------------
+  class BufferedTransportHandler: public TransportHandler
+  {
+    public:
+      virtual ~BufferedTransportHandler() {}
+
+      //------------------------------------------------------------------------
+      //! Get the message header from data already read from the socket,
+      //! may be called multiple times - see GetHeader for details
+      //!
+      //! @param message the message buffer
+      //! @param buffer  the data, advanced past the consumed bytes
+      //! @param size    size of the data, decreased by the consumed bytes
+      //! @return        stOK & suDone if the whole header has been processed
+      //!                stOK & suRetry if more data is needed
+      //!                stError on failure
+      //------------------------------------------------------------------------
+      virtual Status GetHeader( Message     *message,
+                                const char *&buffer,
+                                uint32_t    &size ) = 0;
+
+      //------------------------------------------------------------------------
+      //! Get the message body from data already read from the socket,
+      //! may be called multiple times - see GetHeader for details
+      //!
+      //! @param message the message buffer containing the header
+      //! @param buffer  the data, advanced past the consumed bytes
+      //! @param size    size of the data, decreased by the consumed bytes
+      //! @return        stOK & suDone if the whole body has been processed
+      //!                stOK & suRetry if more data is needed
+      //!                stError on failure
+      //------------------------------------------------------------------------
+      virtual Status GetBody( Message     *message,
+                              const char *&buffer,
+                              uint32_t    &size ) = 0;
+
+      using TransportHandler::GetHeader;
+      using TransportHandler::GetBody;
+  };
+}
+
+#endif // __XRD_CL_BUFFERED_READ_HH__
@@ -949,7 +949,8 @@ namespace
       //! Constructor
       //------------------------------------------------------------------------
       XRootDSourceXCp( const XrdCl::URL* url, uint32_t chunkSize, uint16_t parallelChunks, int32_t nbSrc, uint64_t blockSize ):
-        pXCpCtx( 0 ), pUrl( url ), pChunkSize( chunkSize ), pParallelChunks( parallelChunks ), pNbSrc( nbSrc ), pBlockSize( blockSize )
+        pXCpCtx( 0 ), pUrl( url ), pChunkSize( chunkSize ), pParallelChunks( parallelChunks ), pNbSrc( nbSrc ), pBlockSize( blockSize ),
+        pLastReport( 0 )
       {
       }
 
@@ -1060,6 +1061,24 @@ namespace
         return XrdCl::XRootDStatus( XrdCl::stError, XrdCl::errNoMoreReplicas );
       }
 
+      //------------------------------------------------------------------------
+      //! Report the progress of the sources, at most once a second
+      //------------------------------------------------------------------------
+      void ReportSources( XrdCl::CopyProgressHandler *progress, uint16_t jobNum )
+      {
+        XrdCl::SourceProgressHandler *handler =
+            dynamic_cast<XrdCl::SourceProgressHandler*>( progress );
+        time_t now = time( 0 );
+        if( !handler || !pXCpCtx || now == pLastReport ) return;
+        pLastReport = now;
+
+        std::vector<XrdCl::XCpCtx::SourceStats> stats;
+        pXCpCtx->GetSourceStats( stats );
+        std::vector<XrdCl::XCpCtx::SourceStats>::iterator itr;
+        for( itr = stats.begin() ; itr != stats.end() ; ++itr )
+          handler->SourceProgress( jobNum, itr->url, itr->bytes, itr->transferRate );
+      }
+
     private:
 
 
@@ -1070,6 +1089,7 @@ namespace
       uint16_t                  pParallelChunks;
       int32_t                   pNbSrc;
       uint64_t                  pBlockSize;
+      time_t                    pLastReport;
   };
 
   //----------------------------------------------------------------------------
@@ -1436,8 +1456,9 @@ namespace XrdCl
     // Initialize the source and the destination
     //--------------------------------------------------------------------------
     XRDCL_SMART_PTR_T<Source> src;
+    XRootDSourceXCp *xcpSrc = 0;
     if( xcp )
-      src.reset( new XRootDSourceXCp( &GetSource(), chunkSize, parallelChunks, nbXcpSources, blockSize ) );
+      src.reset( xcpSrc = new XRootDSourceXCp( &GetSource(), chunkSize, parallelChunks, nbXcpSources, blockSize ) );
     else if( zip ) // TODO make zip work for xcp
       src.reset( new XRootDSourceZip( zipSource, &GetSource(), chunkSize, parallelChunks ) );
     else if( GetSource().GetProtocol() == "stdio" )
@@ -1502,7 +1523,11 @@ namespace XrdCl
         return st;
 
       processed += chunkInfo.length;
-      if( progress ) progress->JobProgress( pJobId, processed, size );
+      if( progress )
+      {
+        progress->JobProgress( pJobId, processed, size );
+        if( xcpSrc ) xcpSrc->ReportSources( progress, pJobId );
+      }
     }
 
     st = dest->Flush();
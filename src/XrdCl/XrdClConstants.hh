@@ -70,6 +70,19 @@ namespace XrdCl
   const int DefaultNoDelay              = 1;
   const int DefaultAioSignal            = 1;
   const int DefaultPreferIPv4           = 0;
+  const int DefaultRecvBufferSize       = 65536;
+  const int DefaultMemoryPool           = 0;
+  const int DefaultMaxSubStreamsPerChannel = 1;
+  const int DefaultSubStreamThreshold   = 8388608;
+  const int DefaultSubStreamIdleTime    = 60;
+  const int DefaultReadCacheBlockSize   = 1048576;
+  const int DefaultReadAheadBlocks      = 8;
+  const int DefaultReadBatchSize        = 0;
+  const int DefaultMetadataCacheStatTTL     = 0;
+  const int DefaultMetadataCacheLocateTTL   = 0;
+  const int DefaultMetadataCacheDirListTTL  = 0;
+  const int DefaultMetadataCacheNegativeTTL = 0;
+  const int DefaultMetadataCacheSize        = 65536;
 
   const char * const DefaultPollerPreference   = "built-in";
   const char * const DefaultNetworkStack       = "IPAuto";
@@ -79,6 +92,8 @@ namespace XrdCl
   const char * const DefaultPlugIn             = "";
   const char * const DefaultReadRecovery       = "true";
   const char * const DefaultWriteRecovery      = "true";
+  const char * const DefaultMetadataCacheShm   = "";
+  const char * const DefaultReadCacheSize      = "0";
   const char * const DefaultGlfnRedirector     = "";
 }
 
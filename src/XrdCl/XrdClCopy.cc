@@ -849,6 +849,15 @@ int main( int argc, char **argv )
   PropertyList processConfig;
   processConfig.Set( "jobType", "configuration" );
   processConfig.Set( "parallel", config.Parallel );
+  if( config.Want( XrdCpConfig::DoInFlight ) )
+    processConfig.Set( "inFlightBudget", config.InFlight );
+  if( config.Want( XrdCpConfig::DoHostLim ) )
+  {
+    processConfig.Set( "sourceHostLimit", config.HostLimit );
+    processConfig.Set( "targetHostLimit", config.HostLimit );
+  }
+  if( config.Want( XrdCpConfig::DoSmallFst ) )
+    processConfig.Set( "smallFilesFirst", true );
   process.AddJob( processConfig, 0 );
 
   //----------------------------------------------------------------------------
@@ -36,11 +36,227 @@
 #include "XrdCl/XrdClUglyHacks.hh"
 
 #include <sys/time.h>
+#include <sys/stat.h>
 
 #include <iostream>
+#include <algorithm>
+#include <deque>
+#include <map>
 
 namespace
 {
+  //----------------------------------------------------------------------------
+  // Decides which copy job goes next, so that the jobs in flight stay
+  // within the byte budget and the per host limits
+  //----------------------------------------------------------------------------
+  class CopyScheduler
+  {
+    public:
+      //------------------------------------------------------------------------
+      // Scheduling parameters of a job
+      //------------------------------------------------------------------------
+      typedef std::pair<uint64_t, uint64_t> Priority;
+
+      struct JobInfo
+      {
+        uint64_t    cost;       // bytes the job keeps in flight
+        Priority    priority;   // lower goes first
+        std::string source;     // source host, empty if not limited
+        std::string target;     // target host, empty if not limited
+      };
+
+      //------------------------------------------------------------------------
+      // Constructor
+      //------------------------------------------------------------------------
+      CopyScheduler( const std::vector<JobInfo> &jobs,
+                     uint16_t                    parallel,
+                     uint64_t                    budget,
+                     uint16_t                    sourceLimit,
+                     uint16_t                    targetLimit ):
+        pJobs( jobs ), pParallel( parallel ), pBudget( budget ),
+        pSourceLimit( sourceLimit ), pTargetLimit( targetLimit ),
+        pInFlight( 0 ), pRunning( 0 ), pPending( jobs.size() ), pCond( 0 )
+      {
+        for( size_t i = 0; i < jobs.size(); ++i )
+          pQueues[HostPair( jobs[i].source, jobs[i].target )].push_back( i );
+
+        QueueMap::iterator it;
+        for( it = pQueues.begin(); it != pQueues.end(); ++it )
+          std::stable_sort( it->second.begin(), it->second.end(),
+                            PriorityCmp( jobs ) );
+      }
+
+      //------------------------------------------------------------------------
+      // Get the next job to be run, wait until one fits, -1 if there are
+      // no more jobs
+      //------------------------------------------------------------------------
+      int Next()
+      {
+        XrdSysCondVarHelper scopedLock( pCond );
+        while( pPending )
+        {
+          if( pRunning < pParallel )
+          {
+            int job = Select();
+            if( job >= 0 )
+            {
+              const JobInfo &j = pJobs[job];
+              pInFlight += j.cost;
+              ++pRunning;
+              --pPending;
+              if( !j.source.empty() ) ++pSources[j.source];
+              if( !j.target.empty() ) ++pTargets[j.target];
+              return job;
+            }
+          }
+          pCond.Wait();
+        }
+        return -1;
+      }
+
+      //------------------------------------------------------------------------
+      // The job is done, release what it held
+      //------------------------------------------------------------------------
+      void Done( int job )
+      {
+        XrdSysCondVarHelper scopedLock( pCond );
+        const JobInfo &j = pJobs[job];
+        pInFlight -= j.cost;
+        --pRunning;
+        if( !j.source.empty() ) --pSources[j.source];
+        if( !j.target.empty() ) --pTargets[j.target];
+        pCond.Broadcast();
+      }
+
+      //------------------------------------------------------------------------
+      // Wait for the running jobs to finish
+      //------------------------------------------------------------------------
+      void WaitAll()
+      {
+        XrdSysCondVarHelper scopedLock( pCond );
+        while( pRunning )
+          pCond.Wait();
+      }
+
+    private:
+      typedef std::pair<std::string, std::string>     HostPair;
+      typedef std::map<HostPair, std::deque<size_t> > QueueMap;
+
+      //------------------------------------------------------------------------
+      // Order the jobs of a queue by priority
+      //------------------------------------------------------------------------
+      struct PriorityCmp
+      {
+        PriorityCmp( const std::vector<JobInfo> &jobs ): jobs( jobs ) {}
+        bool operator()( size_t a, size_t b ) const
+        {
+          return jobs[a].priority < jobs[b].priority;
+        }
+        const std::vector<JobInfo> &jobs;
+      };
+
+      //------------------------------------------------------------------------
+      // Pick the job with the highest priority among the heads of the
+      // host pair queues that may be started now
+      //------------------------------------------------------------------------
+      int Select()
+      {
+        QueueMap::iterator selected = pQueues.end();
+        QueueMap::iterator it;
+        for( it = pQueues.begin(); it != pQueues.end(); ++it )
+        {
+          if( it->second.empty() )
+            continue;
+          const JobInfo &j = pJobs[it->second.front()];
+
+          if( pSourceLimit && !j.source.empty() &&
+              pSources[j.source] >= pSourceLimit )
+            continue;
+          if( pTargetLimit && !j.target.empty() &&
+              pTargets[j.target] >= pTargetLimit )
+            continue;
+
+          //--------------------------------------------------------------------
+          // A job larger than the budget still runs when nothing else does
+          //--------------------------------------------------------------------
+          if( pBudget && pRunning && pInFlight + j.cost > pBudget )
+            continue;
+
+          if( selected == pQueues.end() ||
+              j.priority < pJobs[selected->second.front()].priority )
+            selected = it;
+        }
+
+        if( selected == pQueues.end() )
+          return -1;
+        int job = selected->second.front();
+        selected->second.pop_front();
+        return job;
+      }
+
+      const std::vector<JobInfo>      &pJobs;
+      uint16_t                         pParallel;
+      uint64_t                         pBudget;
+      uint16_t                         pSourceLimit;
+      uint16_t                         pTargetLimit;
+      uint64_t                         pInFlight;
+      uint16_t                         pRunning;
+      size_t                           pPending;
+      QueueMap                         pQueues;
+      std::map<std::string, uint16_t>  pSources;
+      std::map<std::string, uint16_t>  pTargets;
+      XrdSysCondVar                    pCond;
+  };
+
+  //----------------------------------------------------------------------------
+  // Get the scheduling parameters of a copy job
+  //----------------------------------------------------------------------------
+  CopyScheduler::JobInfo GetJobInfo( XrdCl::CopyJob *job, uint64_t index,
+                                     bool smallFilesFirst )
+  {
+    XrdCl::PropertyList   *props = job->GetProperties();
+    CopyScheduler::JobInfo info;
+
+    //--------------------------------------------------------------------------
+    // A job holds at most its chunk pipeline in flight, less if the file is
+    // smaller, and nothing at all if the data goes from server to server
+    //--------------------------------------------------------------------------
+    uint64_t chunkSize      = props->Get<uint32_t>( "chunkSize" );
+    uint64_t parallelChunks = props->Get<int>( "parallelChunks" );
+    info.cost = chunkSize * parallelChunks;
+
+    uint64_t size = (uint64_t)-1;
+    if( props->HasProperty( "sourceSize" ) )
+      props->Get( "sourceSize", size );
+    else if( job->GetSource().IsLocalFile() )
+    {
+      struct stat st;
+      if( stat( job->GetSource().GetPath().c_str(), &st ) == 0 &&
+          S_ISREG( st.st_mode ) )
+        size = st.st_size;
+    }
+
+    if( size < info.cost )
+      info.cost = size;
+    if( props->Get<std::string>( "thirdParty" ) == "only" )
+      info.cost = 0;
+
+    //--------------------------------------------------------------------------
+    // The jobs keep their order unless the small files go first, those
+    // of unknown size go last then, the jobs of the same size keep their
+    // order as well
+    //--------------------------------------------------------------------------
+    info.priority = CopyScheduler::Priority( smallFilesFirst ? size : 0, index );
+
+    const XrdCl::URL &source = job->GetSource();
+    const XrdCl::URL &target = job->GetTarget();
+    if( !source.IsLocalFile() && source.GetProtocol() != "stdio" )
+      info.source = source.GetHostId();
+    if( !target.IsLocalFile() && target.GetProtocol() != "stdio" )
+      info.target = target.GetHostId();
+    return info;
+  }
+
   class QueuedCopyJob: public XrdCl::Job
   {
     public:
@@ -48,9 +264,10 @@ namespace
                      XrdCl::CopyProgressHandler *progress,
                      uint16_t                    currentJob,
                      uint16_t                    totalJobs,
-                     XrdCl::Semaphore           *sem = 0 ):
+                     CopyScheduler              *scheduler = 0,
+                     int                         index     = 0 ):
         pJob(job), pProgress(progress), pCurrentJob(currentJob),
-        pTotalJobs(totalJobs), pSem(sem) {}
+        pTotalJobs(totalJobs), pScheduler(scheduler), pIndex(index) {}
 
       //------------------------------------------------------------------------
       //! Run the job
@@ -104,8 +321,8 @@ namespace
         if( pProgress )
           pProgress->EndJob( pCurrentJob, pJob->GetResults() );
 
-        if( pSem )
-          pSem->Post();
+        if( pScheduler )
+          pScheduler->Done( pIndex );
       }
 
     private:
@@ -113,7 +330,8 @@ namespace
       XrdCl::CopyProgressHandler *pProgress;
       uint16_t                    pCurrentJob;
       uint16_t                    pTotalJobs;
-      XrdCl::Semaphore           *pSem;
+      CopyScheduler              *pScheduler;
+      int                         pIndex;
   };
 };
 
@@ -331,79 +549,101 @@ namespace XrdCl
     //--------------------------------------------------------------------------
     // Get the configuration
     //--------------------------------------------------------------------------
-    uint8_t parallelThreads = 1;
+    uint16_t parallelThreads = 1;
+    uint64_t inFlightBudget  = 0;
+    uint16_t sourceLimit     = 0;
+    uint16_t targetLimit     = 0;
+    bool     smallFilesFirst = false;
     if( pJobProperties.size() > 0 &&
         pJobProperties.rbegin()->HasProperty( "jobType" ) &&
         pJobProperties.rbegin()->Get<std::string>( "jobType" ) == "configuration" )
     {
       PropertyList &config = *pJobProperties.rbegin();
       if( config.HasProperty( "parallel" ) )
-        parallelThreads = (uint8_t)config.Get<int>( "parallel" );
+        parallelThreads = (uint16_t)config.Get<int>( "parallel" );
+      config.Get( "inFlightBudget",  inFlightBudget  );
+      config.Get( "sourceHostLimit", sourceLimit     );
+      config.Get( "targetHostLimit", targetLimit     );
+      config.Get( "smallFilesFirst", smallFilesFirst );
     }
+    if( parallelThreads < 1 )
+      parallelThreads = 1;
+
+    //--------------------------------------------------------------------------
+    // Set up the scheduler
+    //--------------------------------------------------------------------------
+    std::vector<CopyScheduler::JobInfo> info;
+    for( size_t i = 0; i < pJobs.size(); ++i )
+      info.push_back( GetJobInfo( pJobs[i], i, smallFilesFirst ) );
+
+    uint16_t workers = std::min( (size_t)parallelThreads, pJobs.size() );
+    CopyScheduler scheduler( info, workers, inFlightBudget, sourceLimit,
+                             targetLimit );
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( UtilityMsg, "CopyProcess: running %d jobs, parallel: %d, "
+                "in-flight budget: %llu, source host limit: %d, target host "
+                "limit: %d, small files first: %d", pJobs.size(), workers,
+                (unsigned long long)inFlightBudget, sourceLimit, targetLimit,
+                smallFilesFirst );
 
     //--------------------------------------------------------------------------
     // Run the show
     //--------------------------------------------------------------------------
     std::vector<CopyJob *>::iterator it;
-    uint16_t currentJob = 1;
-    uint16_t totalJobs  = pJobs.size();
+    uint16_t totalJobs = pJobs.size();
+    int      job;
 
     //--------------------------------------------------------------------------
     // Single thread
     //--------------------------------------------------------------------------
-    if( parallelThreads == 1 )
+    if( workers <= 1 )
     {
       XRootDStatus err;
 
-      for( it = pJobs.begin(); it != pJobs.end(); ++it )
+      while( (job = scheduler.Next()) >= 0 )
       {
-        QueuedCopyJob j( *it, progress, currentJob, totalJobs );
+        QueuedCopyJob j( pJobs[job], progress, job+1, totalJobs, &scheduler,
+                         job );
         j.Run(0);
 
-        XRootDStatus st = (*it)->GetResults()->Get<XRootDStatus>( "status" );
+        XRootDStatus st = pJobs[job]->GetResults()->Get<XRootDStatus>( "status" );
         if( err.IsOK() && !st.IsOK() )
         {
           err = st;
         }
-        ++currentJob;
       }
 
       if( !err.IsOK() ) return err;
     }
     //--------------------------------------------------------------------------
-    // Multiple threads
+    // Multiple threads, the scheduler hands out the jobs that fit and
+    // the workers run them
     //--------------------------------------------------------------------------
     else
     {
-      uint16_t workers = std::min( (uint16_t)parallelThreads,
-                                   (uint16_t)pJobs.size() );
       JobManager jm( workers );
       jm.Initialize();
       if( !jm.Start() )
         return XRootDStatus( stError, errOSError, 0,
                              "Unable to start job manager" );
 
-      Semaphore *sem = new Semaphore(0);
       std::vector<QueuedCopyJob*> queued;
-      for( it = pJobs.begin(); it != pJobs.end(); ++it )
+      while( (job = scheduler.Next()) >= 0 )
       {
-        QueuedCopyJob *j = new QueuedCopyJob( *it, progress, currentJob,
-                                              totalJobs, sem );
+        QueuedCopyJob *j = new QueuedCopyJob( pJobs[job], progress, job+1,
+                                              totalJobs, &scheduler, job );
 
         queued.push_back( j );
         jm.QueueJob(j, 0);
-        ++currentJob;
       }
-
-      std::vector<QueuedCopyJob*>::iterator itQ;
-      for( itQ = queued.begin(); itQ != queued.end(); ++itQ )
-        sem->Wait();
-      delete sem;
+      scheduler.WaitAll();
 
       if( !jm.Stop() )
         return XRootDStatus( stError, errOSError, 0,
                              "Unable to stop job manager" );
       jm.Finalize();
+      std::vector<QueuedCopyJob*>::iterator itQ;
       for( itQ = queued.begin(); itQ != queued.end(); ++itQ )
         delete *itQ;
 
@@ -96,6 +96,30 @@ namespace XrdCl
       }
   };
 
+  //----------------------------------------------------------------------------
+  //! Progress handler that also wants to know about the individual sources
+  //! of extreme copy jobs, the copy process checks for it with dynamic_cast
+  //----------------------------------------------------------------------------
+  class SourceProgressHandler: public CopyProgressHandler
+  {
+    public:
+      virtual ~SourceProgressHandler() {}
+
+      //------------------------------------------------------------------------
+      //! Notify about the progress of one of the sources of an extreme copy
+      //! job, called about once a second for every active source
+      //!
+      //! @param jobNum         job number
+      //! @param source         the replica the source reads from
+      //! @param bytesProcessed bytes received from the source so far
+      //! @param transferRate   current transfer rate of the source [B/s]
+      //------------------------------------------------------------------------
+      virtual void SourceProgress( uint16_t           jobNum,
+                                   const std::string &source,
+                                   uint64_t           bytesProcessed,
+                                   uint64_t           transferRate ) = 0;
+  };
+
   //----------------------------------------------------------------------------
   //! Copy the data from one point to another
   //----------------------------------------------------------------------------
@@ -144,12 +168,27 @@ namespace XrdCl
       //! tpcTimeout     [uint16_t] - time limit for the actual copy to finish
       //! dynamicSource  [bool]     - support for the case where the size source
       //!                             file may change during reading process
+      //! sourceSize     [uint64_t] - size of the source if known, used for
+      //!                             scheduling only
       //!
       //! Configuration job - this is a job that that is supposed to configure
       //! the copy process as a whole instead of adding a copy job:
       //!
-      //! jobType        [string]   - "configuration" - for configuraion
-      //! parallel       [uint8_t]  - nomber of copy jobs to be run in parallel
+      //! jobType         [string]   - "configuration" - for configuraion
+      //! parallel        [uint16_t] - nomber of copy jobs to be run in
+      //!                              parallel
+      //! inFlightBudget  [uint64_t] - maximum number of bytes the running
+      //!                              jobs may have in flight, a job counts
+      //!                              with chunkSize * parallelChunks or
+      //!                              the file size if smaller; 0 - no limit
+      //! sourceHostLimit [uint16_t] - maximum number of jobs reading from
+      //!                              the same host at a time; 0 - no limit
+      //! targetHostLimit [uint16_t] - maximum number of jobs writing to
+      //!                              the same host at a time; 0 - no limit
+      //! smallFilesFirst [bool]     - start the jobs with the smallest source
+      //!                              files first, the size is known for
+      //!                              local files and the jobs that set the
+      //!                              sourceSize property
       //!
       //! Results:
       //! sourceCheckSum [string]   - checksum at source, if requested
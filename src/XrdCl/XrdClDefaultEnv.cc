@@ -21,6 +21,9 @@
 #include "XrdCl/XrdClPostMaster.hh"
 #include "XrdCl/XrdClLog.hh"
 #include "XrdCl/XrdClForkHandler.hh"
+#include "XrdCl/XrdClMemoryPool.hh"
+#include "XrdCl/XrdClReadCache.hh"
+#include "XrdCl/XrdClMetadataCache.hh"
 #include "XrdCl/XrdClFileTimer.hh"
 #include "XrdCl/XrdClUtils.hh"
 #include "XrdCl/XrdClMonitor.hh"
@@ -36,6 +39,7 @@
 
 #include <libgen.h>
 #include <cstring>
+#include <cstdlib>
 #include <map>
 #include <vector>
 #include <algorithm>
@@ -73,6 +77,7 @@ extern "C"
     if( runForkHandler )
       forkHandler->Prepare();
     env->WriteLock();
+    MemoryPool::Lock();
   }
 
   //----------------------------------------------------------------------------
@@ -84,6 +89,7 @@ extern "C"
     Log         *log         = DefaultEnv::GetLog();
     Env         *env         = DefaultEnv::GetEnv();
     ForkHandler *forkHandler = DefaultEnv::GetForkHandler();
+    MemoryPool::UnLock();
     env->UnLock();
 
     pid_t pid = getpid();
@@ -111,6 +117,7 @@ extern "C"
     Log         *log         = DefaultEnv::GetLog();
     Env         *env         = DefaultEnv::GetEnv();
     ForkHandler *forkHandler = DefaultEnv::GetForkHandler();
+    MemoryPool::UnLock();
     env->ReInitializeLock();
 
     pid_t pid = getpid();
@@ -249,6 +256,9 @@ namespace XrdCl
   CheckSumManager   *DefaultEnv::sCheckSumManager    = 0;
   TransportManager  *DefaultEnv::sTransportManager   = 0;
   PlugInManager     *DefaultEnv::sPlugInManager      = 0;
+  ReadCache         *DefaultEnv::sReadCache          = 0;
+  MetadataCache     *DefaultEnv::sMetadataCache      = 0;
+  bool               DefaultEnv::sMetadataCacheInitialized = false;
 
   //----------------------------------------------------------------------------
   // Constructor
@@ -290,6 +300,19 @@ namespace XrdCl
     REGISTER_VAR_INT( varsInt, "NoDelay",              DefaultNoDelay              );
     REGISTER_VAR_INT( varsInt, "AioSignal",            DefaultAioSignal            );
     REGISTER_VAR_INT( varsInt, "PreferIPv4",           DefaultPreferIPv4           );
+    REGISTER_VAR_INT( varsInt, "RecvBufferSize",       DefaultRecvBufferSize       );
+    REGISTER_VAR_INT( varsInt, "MemoryPool",           DefaultMemoryPool           );
+    REGISTER_VAR_INT( varsInt, "MaxSubStreamsPerChannel", DefaultMaxSubStreamsPerChannel );
+    REGISTER_VAR_INT( varsInt, "SubStreamThreshold",   DefaultSubStreamThreshold   );
+    REGISTER_VAR_INT( varsInt, "SubStreamIdleTime",    DefaultSubStreamIdleTime    );
+    REGISTER_VAR_INT( varsInt, "ReadCacheBlockSize",   DefaultReadCacheBlockSize   );
+    REGISTER_VAR_INT( varsInt, "ReadAheadBlocks",      DefaultReadAheadBlocks      );
+    REGISTER_VAR_INT( varsInt, "ReadBatchSize",        DefaultReadBatchSize        );
+    REGISTER_VAR_INT( varsInt, "MetadataCacheStatTTL", DefaultMetadataCacheStatTTL );
+    REGISTER_VAR_INT( varsInt, "MetadataCacheLocateTTL", DefaultMetadataCacheLocateTTL );
+    REGISTER_VAR_INT( varsInt, "MetadataCacheDirListTTL", DefaultMetadataCacheDirListTTL );
+    REGISTER_VAR_INT( varsInt, "MetadataCacheNegativeTTL", DefaultMetadataCacheNegativeTTL );
+    REGISTER_VAR_INT( varsInt, "MetadataCacheSize",    DefaultMetadataCacheSize    );
 
     REGISTER_VAR_STR( varsStr, "PollerPreference",     DefaultPollerPreference     );
     REGISTER_VAR_STR( varsStr, "ClientMonitor",        DefaultClientMonitor        );
@@ -300,6 +323,8 @@ namespace XrdCl
     REGISTER_VAR_STR( varsStr, "ReadRecovery",         DefaultReadRecovery         );
     REGISTER_VAR_STR( varsStr, "WriteRecovery",        DefaultWriteRecovery        );
     REGISTER_VAR_STR( varsStr, "GlfnRedirector",       DefaultGlfnRedirector       );
+    REGISTER_VAR_STR( varsStr, "MetadataCacheShm",     DefaultMetadataCacheShm     );
+    REGISTER_VAR_STR( varsStr, "ReadCacheSize",        DefaultReadCacheSize        );
 
     //--------------------------------------------------------------------------
     // Process the configuration files
@@ -635,6 +660,86 @@ namespace XrdCl
     return sPlugInManager;
   }
 
+  //----------------------------------------------------------------------------
+  // Get the read cache
+  //----------------------------------------------------------------------------
+  ReadCache *DefaultEnv::GetReadCache()
+  {
+    //--------------------------------------------------------------------------
+    // The size is a string, so that caches larger than 2GB can be set up
+    //--------------------------------------------------------------------------
+    std::string sizeStr = DefaultReadCacheSize;
+    GetEnv()->GetString( "ReadCacheSize", sizeStr );
+    char     *end  = 0;
+    uint64_t  size = strtoull( sizeStr.c_str(), &end, 10 );
+    if( !size || *end || sizeStr[0] == '-' )
+      return 0;
+
+    if( unlikely( !sReadCache ) )
+    {
+      XrdSysMutexHelper scopedLock( sInitMutex );
+      if( !sReadCache )
+      {
+        int blockSize = DefaultReadCacheBlockSize;
+        int readAhead = DefaultReadAheadBlocks;
+        sEnv->GetInt( "ReadCacheBlockSize", blockSize );
+        sEnv->GetInt( "ReadAheadBlocks",    readAhead );
+        if( blockSize < 0 ) blockSize = 0;
+        if( readAhead < 0 ) readAhead = 0;
+        sReadCache = new ReadCache( size, blockSize, readAhead );
+        sLog->Debug( UtilityMsg, "Read cache enabled: %llu bytes in blocks of "
+                     "%u bytes, up to %d blocks read ahead",
+                     (unsigned long long)size,
+                     sReadCache->GetBlockSize(), readAhead );
+      }
+    }
+    return sReadCache;
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the metadata cache
+  //----------------------------------------------------------------------------
+  MetadataCache *DefaultEnv::GetMetadataCache()
+  {
+    if( unlikely( !sMetadataCacheInitialized ) )
+    {
+      XrdSysMutexHelper scopedLock( sInitMutex );
+      if( !sMetadataCacheInitialized )
+      {
+        int statTTL     = DefaultMetadataCacheStatTTL;
+        int locateTTL   = DefaultMetadataCacheLocateTTL;
+        int dirListTTL  = DefaultMetadataCacheDirListTTL;
+        int negativeTTL = DefaultMetadataCacheNegativeTTL;
+        int size        = DefaultMetadataCacheSize;
+        std::string shm = DefaultMetadataCacheShm;
+        sEnv->GetInt( "MetadataCacheStatTTL",     statTTL );
+        sEnv->GetInt( "MetadataCacheLocateTTL",   locateTTL );
+        sEnv->GetInt( "MetadataCacheDirListTTL",  dirListTTL );
+        sEnv->GetInt( "MetadataCacheNegativeTTL", negativeTTL );
+        sEnv->GetInt( "MetadataCacheSize",        size );
+        sEnv->GetString( "MetadataCacheShm",      shm );
+        if( statTTL     < 0 ) statTTL     = 0;
+        if( locateTTL   < 0 ) locateTTL   = 0;
+        if( dirListTTL  < 0 ) dirListTTL  = 0;
+        if( negativeTTL < 0 ) negativeTTL = 0;
+        if( size        < 0 ) size        = 0;
+
+        if( statTTL || locateTTL || dirListTTL )
+        {
+          sMetadataCache = new MetadataCache( statTTL, locateTTL, dirListTTL,
+                                              negativeTTL, size, shm );
+          sLog->Debug( UtilityMsg, "Metadata cache enabled: stat %ds, locate "
+                       "%ds, dirlist %ds, not found %ds, up to %d entries%s%s",
+                       statTTL, locateTTL, dirListTTL, negativeTTL, size,
+                       shm.empty() ? "" : ", stat shared through ",
+                       shm.c_str() );
+        }
+        sMetadataCacheInitialized = true;
+      }
+    }
+    return sMetadataCache;
+  }
+
   //----------------------------------------------------------------------------
   // Retrieve the plug-in factory for the given URL
   //----------------------------------------------------------------------------
@@ -659,6 +764,10 @@ namespace XrdCl
     sPlugInManager->ProcessEnvironmentSettings();
     sForkHandler->RegisterFileTimer( sFileTimer );
 
+    int memoryPool = DefaultMemoryPool;
+    sEnv->GetInt( "MemoryPool", memoryPool );
+    MemoryPool::SetEnabled( memoryPool );
+
     //--------------------------------------------------------------------------
     // MacOSX library loading is completely moronic. We cannot dlopen a library
     // from a thread other than a main thread, so we-pre dlopen all the
@@ -703,6 +812,58 @@ namespace XrdCl
       sPostMaster = 0;
     }
 
+    if( MemoryPool::IsEnabled() )
+    {
+      MemoryPool::Stats stats;
+      MemoryPool::GetStats( stats );
+      sLog->Debug( UtilityMsg, "Memory pool: %llu allocations, %llu thread "
+                   "cache hits, %llu depot hits, %llu system allocations",
+                   (unsigned long long)stats.allocations,
+                   (unsigned long long)stats.threadHits,
+                   (unsigned long long)stats.depotHits,
+                   (unsigned long long)stats.sysAllocs );
+    }
+
+    //--------------------------------------------------------------------------
+    // The read cache is not deleted, files destroyed after this point still
+    // detach from it
+    //--------------------------------------------------------------------------
+    if( sReadCache )
+    {
+      ReadCache::Stats stats;
+      sReadCache->GetStats( stats );
+      sLog->Debug( UtilityMsg, "Read cache: %llu block hits, %llu misses, "
+                   "%llu read ahead (%llu used), %llu evictions, %llu "
+                   "requests bypassed, %llu bytes read, %llu bytes fetched",
+                   (unsigned long long)stats.hits,
+                   (unsigned long long)stats.misses,
+                   (unsigned long long)stats.readAheads,
+                   (unsigned long long)stats.readAheadHits,
+                   (unsigned long long)stats.evictions,
+                   (unsigned long long)stats.bypassed,
+                   (unsigned long long)stats.bytesRead,
+                   (unsigned long long)stats.bytesFetched );
+    }
+
+    //--------------------------------------------------------------------------
+    // Neither is the metadata cache
+    //--------------------------------------------------------------------------
+    if( sMetadataCache )
+    {
+      MetadataCache::Stats stats;
+      sMetadataCache->GetStats( stats );
+      sLog->Debug( UtilityMsg, "Metadata cache: %llu hits (%llu not found, "
+                   "%llu shared), %llu misses, %llu inserts, %llu evictions, "
+                   "%llu invalidations",
+                   (unsigned long long)stats.hits,
+                   (unsigned long long)stats.negativeHits,
+                   (unsigned long long)stats.sharedHits,
+                   (unsigned long long)stats.misses,
+                   (unsigned long long)stats.inserts,
+                   (unsigned long long)stats.evictions,
+                   (unsigned long long)stats.invalidations );
+    }
+
     delete sTransportManager;
     sTransportManager = 0;
 
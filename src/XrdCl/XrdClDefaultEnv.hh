@@ -35,6 +35,8 @@ namespace XrdCl
   class FileTimer;
   class PlugInManager;
   class PlugInFactory;
+  class ReadCache;
+  class MetadataCache;
 
   //----------------------------------------------------------------------------
   //! Default environment for the client. Responsible for setting/importing
@@ -133,6 +135,22 @@ namespace XrdCl
       //------------------------------------------------------------------------
       static PlugInManager *GetPlugInManager();
 
+      //------------------------------------------------------------------------
+      //! Get the read cache
+      //!
+      //! @return the cache or 0 if XRD_READCACHESIZE is not set, you do not
+      //!         own the returned memory
+      //------------------------------------------------------------------------
+      static ReadCache *GetReadCache();
+
+      //------------------------------------------------------------------------
+      //! Get the metadata cache
+      //!
+      //! @return the cache or 0 if none of the XRD_METADATACACHE*TTL
+      //!         variables is set, you do not own the returned memory
+      //------------------------------------------------------------------------
+      static MetadataCache *GetMetadataCache();
+
       //------------------------------------------------------------------------
       //! Retrieve the plug-in factory for the given URL
       //!
@@ -170,6 +188,9 @@ namespace XrdCl
       static CheckSumManager   *sCheckSumManager;
       static TransportManager  *sTransportManager;
       static PlugInManager     *sPlugInManager;
+      static ReadCache         *sReadCache;
+      static MetadataCache     *sMetadataCache;
+      static bool               sMetadataCacheInitialized;
   };
 }
 
@@ -27,6 +27,7 @@
 #include "XrdCl/XrdClConstants.hh"
 #include "XrdCl/XrdClFile.hh"
 #include "XrdCl/XrdClFileStateHandler.hh"
+#include "XrdCl/XrdClReadCache.hh"
 #include "XrdCl/XrdClMessageUtils.hh"
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdCl/XrdClPlugInInterface.hh"
@@ -191,6 +192,10 @@ namespace XrdCl
     if( pPlugIn )
       return pPlugIn->Read( offset, size, buffer, handler, timeout );
 
+    FileReadCache *cache = pStateHandler->GetReadCache();
+    if( cache )
+      return cache->Read( offset, size, buffer, handler, timeout );
+
     return pStateHandler->Read( offset, size, buffer, handler, timeout );
   }
 
@@ -315,6 +320,10 @@ namespace XrdCl
     if( pPlugIn )
       return pPlugIn->VectorRead( chunks, buffer, handler, timeout );
 
+    FileReadCache *cache = pStateHandler->GetReadCache();
+    if( cache )
+      return cache->VectorRead( chunks, buffer, handler, timeout );
+
     return pStateHandler->VectorRead( chunks, buffer, handler, timeout );
   }
 
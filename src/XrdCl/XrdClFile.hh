@@ -330,6 +330,9 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Write scattered data chunks in one operation - async
       //!
+      //! As with WriteV, the chunk buffers are not copied and need to stay
+      //! valid until the handler is called.
+      //!
       //! @param chunks    list of the chunks to be written.
       //! @param handler   handler to be notified when the response arrives
       //! @param timeout   timeout value, if 0 then the environment default
@@ -356,6 +359,11 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Write scattered buffers in one operation - async
       //!
+      //! The buffers are sent straight from the caller's memory, they are
+      //! not copied, so they (but not the iovec array itself) need to stay
+      //! valid and unchanged until the handler is called. The total size
+      //! must fit in a single write request (2GB).
+      //!
       //! @param offset    offset from the beginning of the file
       //! @param iov       list of the buffers to be written
       //! @param iovcnt    number of buffers
@@ -37,14 +37,25 @@
 #include "XrdCl/XrdClResponseJob.hh"
 #include "XrdCl/XrdClJobManager.hh"
 #include "XrdCl/XrdClUglyHacks.hh"
+#include "XrdCl/XrdClMemoryPool.hh"
+#include "XrdCl/XrdClReadCache.hh"
 #include "XrdClRedirectorRegistry.hh"
 
 #include <sstream>
 #include <memory>
+#include <limits>
 #include <sys/time.h>
 
 namespace
 {
+  //----------------------------------------------------------------------------
+  // Limits of the vector reads the batched reads are sent in: the maximum
+  // number of segments a server accepts and the size of a segment that
+  // fits the default maximum transfer size together with its header
+  //----------------------------------------------------------------------------
+  const uint32_t MaxBatchSegments   = 1024;
+  const uint32_t MaxBatchedReadSize = 2097152 - 16;
+
   //----------------------------------------------------------------------------
   // Object that does things to the FileStateHandler when kXR_open returns
   // and then calls the user handler
@@ -180,6 +191,19 @@ namespace
         delete pSendParams.chunkList;
       }
 
+      //------------------------------------------------------------------------
+      // Handlers come from the memory pool
+      //------------------------------------------------------------------------
+      static void *operator new( size_t size )
+      {
+        return XrdCl::MemoryPool::AllocateObject( size );
+      }
+
+      static void operator delete( void *ptr, size_t size )
+      {
+        XrdCl::MemoryPool::FreeObject( ptr, size );
+      }
+
       //------------------------------------------------------------------------
       // Handle the response
       //------------------------------------------------------------------------
@@ -223,6 +247,37 @@ namespace
       XrdCl::Message           *pMessage;
       XrdCl::MessageSendParams  pSendParams;
   };
+
+  //----------------------------------------------------------------------------
+  // Gets the response to a batch of reads back to the FileStateHandler
+  //----------------------------------------------------------------------------
+  class ReadBatchHandler: public XrdCl::ResponseHandler
+  {
+    public:
+      //------------------------------------------------------------------------
+      // Constructor
+      //------------------------------------------------------------------------
+      ReadBatchHandler( XrdCl::FileStateHandler                  *stateHandler,
+                        const XrdCl::FileStateHandler::ReadBatch &batch ):
+        pStateHandler( stateHandler ),
+        pBatch( batch )
+      {
+      }
+
+      //------------------------------------------------------------------------
+      // Handle the response
+      //------------------------------------------------------------------------
+      virtual void HandleResponse( XrdCl::XRootDStatus *status,
+                                   XrdCl::AnyObject    *response )
+      {
+        pStateHandler->OnReadBatch( pBatch, status, response );
+        delete this;
+      }
+
+    private:
+      XrdCl::FileStateHandler            *pStateHandler;
+      XrdCl::FileStateHandler::ReadBatch  pBatch;
+  };
 }
 
 namespace XrdCl
@@ -341,10 +396,14 @@ namespace XrdCl
     pDoRecoverWrite( true ),
     pFollowRedirects( true ),
     pUseVirtRedirector( true ),
-    pReOpenHandler( 0 )
+    pReOpenHandler( 0 ),
+    pReadCache( 0 ),
+    pReadBatchSize( 0 ),
+    pReadBatchesInFlight( 0 )
   {
     pFileHandle = new uint8_t[4];
     ResetMonitoringVars();
+    SetUpReadBatching();
     DefaultEnv::GetForkHandler()->RegisterFileObject( this );
     DefaultEnv::GetFileTimer()->RegisterFileObject( this );
     pLFileHandler = new LocalFileHandler();
@@ -371,10 +430,14 @@ namespace XrdCl
     pDoRecoverWrite( true ),
     pFollowRedirects( true ),
     pUseVirtRedirector( useVirtRedirector ),
-    pReOpenHandler( 0 )
+    pReOpenHandler( 0 ),
+    pReadCache( 0 ),
+    pReadBatchSize( 0 ),
+    pReadBatchesInFlight( 0 )
   {
     pFileHandle = new uint8_t[4];
     ResetMonitoringVars();
+    SetUpReadBatching();
     DefaultEnv::GetForkHandler()->RegisterFileObject( this );
     DefaultEnv::GetFileTimer()->RegisterFileObject( this );
     pLFileHandler = new LocalFileHandler();
@@ -415,6 +478,7 @@ namespace XrdCl
     delete pLoadBalancer;
     delete [] pFileHandle;
     delete pLFileHandler;
+    delete pReadCache;
   }
 
   //----------------------------------------------------------------------------
@@ -574,10 +638,49 @@ namespace XrdCl
       return XRootDStatus( stError, errInProgress );
 
     if( pFileState == OpenInProgress || pFileState == Closed ||
-        pFileState == Recovering || !pInTheFly.empty() )
+        pFileState == Recovering )
+      return XRootDStatus( stError, errInvalidOp );
+
+    //--------------------------------------------------------------------------
+    // The read cache goes away with the open file, if it is fetching blocks
+    // the close request is sent when they have arrived
+    //--------------------------------------------------------------------------
+    if( pReadCache && pReadCache->CloseWhenDrained( handler, timeout ) )
+    {
+      pReadCache = 0;
+      pFileState = CloseInProgress;
+      return XRootDStatus();
+    }
+
+    if( !pInTheFly.empty() )
       return XRootDStatus( stError, errInvalidOp );
 
     pFileState = CloseInProgress;
+    FileReadCache *cache = pReadCache;
+    pReadCache = 0;
+    scopedLock.UnLock();
+
+    delete cache;
+    return SendClose( handler, timeout );
+  }
+
+  //----------------------------------------------------------------------------
+  // Send the close request
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::SendClose( ResponseHandler *handler,
+                                            uint16_t         timeout )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+
+    //--------------------------------------------------------------------------
+    // Requests of the user may still be in flight when the read cache is
+    // done, the file stays open then
+    //--------------------------------------------------------------------------
+    if( !pInTheFly.empty() )
+    {
+      pFileState = Opened;
+      return XRootDStatus( stError, errInvalidOp );
+    }
 
     Log *log = DefaultEnv::GetLog();
     log->Debug( FileMsg, "[0x%x@%s] Sending a close command for handle 0x%x to "
@@ -700,6 +803,105 @@ namespace XrdCl
     if( pFileState != Opened && pFileState != Recovering )
       return XRootDStatus( stError, errInvalidOp );
 
+    //--------------------------------------------------------------------------
+    // Reads issued while others are in flight wait to be sent together in
+    // a single vector read
+    //--------------------------------------------------------------------------
+    if( pReadBatchSize && size && size <= MaxBatchedReadSize && pStatInfo &&
+        offset + size <= pStatInfo->GetSize() && IsReadOnly() &&
+        !pDataServer->IsLocalFile() )
+    {
+      BatchedRead read = { offset, size, buffer, handler, timeout };
+      pReadBatch.push_back( read );
+      if( !pReadBatchesInFlight || pReadBatch.size() >= pReadBatchSize )
+        SendReadBatch();
+      return XRootDStatus();
+    }
+
+    return SendRead( offset, size, buffer, handler, timeout );
+  }
+
+  //----------------------------------------------------------------------------
+  // Called when a batch of reads has been served
+  //----------------------------------------------------------------------------
+  void FileStateHandler::OnReadBatch( ReadBatch    &batch,
+                                      XRootDStatus *status,
+                                      AnyObject    *response )
+  {
+    JobManager *jobMgr = DefaultEnv::GetPostMaster()->GetJobManager();
+    XrdSysMutexHelper scopedLock( pMutex );
+    --pReadBatchesInFlight;
+
+    //--------------------------------------------------------------------------
+    // A single read has been sent as is
+    //--------------------------------------------------------------------------
+    if( batch.size() == 1 )
+    {
+      jobMgr->QueueJob( new ResponseJob( batch[0].handler, status, response,
+                                         0 ) );
+      status   = 0;
+      response = 0;
+    }
+    //--------------------------------------------------------------------------
+    // Hand the chunks of the vector read over to the reads
+    //--------------------------------------------------------------------------
+    else if( status->IsOK() )
+    {
+      VectorReadInfo *info = 0;
+      if( response )
+        response->Get( info );
+
+      for( size_t i = 0; i < batch.size(); ++i )
+      {
+        uint32_t length = 0;
+        if( info && i < info->GetChunks().size() )
+          length = info->GetChunks()[i].length;
+
+        AnyObject *obj = new AnyObject();
+        obj->Set( new ChunkInfo( batch[i].offset, length, batch[i].buffer ) );
+        jobMgr->QueueJob( new ResponseJob( batch[i].handler,
+                                           new XRootDStatus(), obj, 0 ) );
+      }
+    }
+    //--------------------------------------------------------------------------
+    // One bad read fails the whole vector read, send the reads one by one
+    // so that each gets its own status
+    //--------------------------------------------------------------------------
+    else
+    {
+      Log *log = DefaultEnv::GetLog();
+      log->Debug( FileMsg, "[0x%x@%s] Batch of %d reads failed: %s, sending "
+                  "them separately", this, pFileUrl->GetURL().c_str(),
+                  batch.size(), status->ToStr().c_str() );
+
+      for( size_t i = 0; i < batch.size(); ++i )
+      {
+        XRootDStatus st( stError, errInvalidOp );
+        if( pFileState == Opened || pFileState == Recovering )
+          st = SendRead( batch[i].offset, batch[i].size, batch[i].buffer,
+                         batch[i].handler, batch[i].timeout );
+        if( !st.IsOK() )
+          jobMgr->QueueJob( new ResponseJob( batch[i].handler,
+                                             new XRootDStatus( st ), 0, 0 ) );
+      }
+    }
+
+    delete status;
+    delete response;
+
+    if( !pReadBatch.empty() )
+      SendReadBatch();
+  }
+
+  //----------------------------------------------------------------------------
+  // Send a read request, the lock needs to be held
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::SendRead( uint64_t         offset,
+                                           uint32_t         size,
+                                           void            *buffer,
+                                           ResponseHandler *handler,
+                                           uint16_t         timeout )
+  {
     Log *log = DefaultEnv::GetLog();
     log->Debug( FileMsg, "[0x%x@%s] Sending a read command for handle 0x%x to "
                 "%s", this, pFileUrl->GetURL().c_str(),
@@ -736,6 +938,45 @@ namespace XrdCl
     return SendOrQueue( *pDataServer, msg, stHandler, params );
   }
 
+  //----------------------------------------------------------------------------
+  // Send the queued reads, as a vector read if there is more than one, the
+  // lock needs to be held
+  //----------------------------------------------------------------------------
+  void FileStateHandler::SendReadBatch()
+  {
+    ReadBatch batch;
+    batch.swap( pReadBatch );
+
+    ReadBatchHandler *handler = new ReadBatchHandler( this, batch );
+    XRootDStatus      st( stError, errInvalidOp );
+    if( pFileState == Opened || pFileState == Recovering )
+    {
+      if( batch.size() == 1 )
+        st = SendRead( batch[0].offset, batch[0].size, batch[0].buffer,
+                       handler, batch[0].timeout );
+      else
+      {
+        ChunkList chunks;
+        for( size_t i = 0; i < batch.size(); ++i )
+          chunks.push_back( ChunkInfo( batch[i].offset, batch[i].size,
+                                       batch[i].buffer ) );
+        st = SendVectorRead( chunks, 0, handler, batch[0].timeout );
+      }
+    }
+
+    if( st.IsOK() )
+    {
+      ++pReadBatchesInFlight;
+      return;
+    }
+
+    delete handler;
+    JobManager *jobMgr = DefaultEnv::GetPostMaster()->GetJobManager();
+    for( size_t i = 0; i < batch.size(); ++i )
+      jobMgr->QueueJob( new ResponseJob( batch[i].handler,
+                                         new XRootDStatus( st ), 0, 0 ) );
+  }
+
   //----------------------------------------------------------------------------
   // Write a data chunk at a given offset - async
   //----------------------------------------------------------------------------
@@ -887,6 +1128,17 @@ namespace XrdCl
     if( pFileState != Opened && pFileState != Recovering )
       return XRootDStatus( stError, errInvalidOp );
 
+    return SendVectorRead( chunks, buffer, handler, timeout );
+  }
+
+  //----------------------------------------------------------------------------
+  // Send a vector read request, the lock needs to be held
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::SendVectorRead( const ChunkList &chunks,
+                                                 void            *buffer,
+                                                 ResponseHandler *handler,
+                                                 uint16_t         timeout )
+  {
     Log *log = DefaultEnv::GetLog();
     log->Debug( FileMsg, "[0x%x@%s] Sending a vector read command for handle "
                 "0x%x to %s", this, pFileUrl->GetURL().c_str(),
@@ -1050,19 +1302,29 @@ namespace XrdCl
                 "%s", this, pFileUrl->GetURL().c_str(),
                 *((uint32_t*)pFileHandle), pDataServer->GetHostId().c_str() );
 
+    //--------------------------------------------------------------------------
+    // The buffers are sent as they are, we only need to make sure they fit
+    // in one request
+    //--------------------------------------------------------------------------
+    if( iovcnt < 0 )
+      return XRootDStatus( stError, errInvalidArgs );
+
+    uint64_t size = 0;
+    for( int i = 0; i < iovcnt; ++i )
+      size += iov[i].iov_len;
+
+    if( size > (uint64_t)std::numeric_limits<kXR_int32>::max() )
+      return XRootDStatus( stError, errInvalidArgs );
+
     Message            *msg;
     ClientWriteRequest *req;
     MessageUtils::CreateRequest( msg, req );
 
     ChunkList *list   = new ChunkList();
-
-    uint32_t size = 0;
+    list->reserve( iovcnt );
     for( int i = 0; i < iovcnt; ++i )
-    {
-      size += iov[i].iov_len;
       list->push_back( ChunkInfo( 0, iov[i].iov_len,
                        (char*)iov[i].iov_base ) );
-    }
 
     req->requestid  = kXR_write;
     req->offset     = offset;
@@ -1358,6 +1620,21 @@ namespace XrdCl
         mon->Event( Monitor::EvOpen, &i );
       }
 
+      //------------------------------------------------------------------------
+      // Read through the cache if enabled, a file that is re-opened during
+      // recovery keeps its cache, every other open gets a new one
+      //------------------------------------------------------------------------
+      ReadCache *cache = DefaultEnv::GetReadCache();
+      if( cache && !pReadCache && pStatInfo && IsReadOnly() &&
+          !pFileUrl->IsLocalFile() )
+      {
+        std::ostringstream key;
+        key << pFileUrl->GetLocation() << "@" << pStatInfo->GetSize() << ":";
+        key << pStatInfo->GetModTime();
+        pReadCache = new FileReadCache( cache, this, key.str(),
+                                        pStatInfo->GetSize() );
+      }
+
       //------------------------------------------------------------------------
       // Resend the queued messages if any
       //------------------------------------------------------------------------
@@ -1723,6 +2000,20 @@ namespace XrdCl
     return false;
   }
 
+  //----------------------------------------------------------------------------
+  // Read the batching settings
+  //----------------------------------------------------------------------------
+  void FileStateHandler::SetUpReadBatching()
+  {
+    int readBatchSize = DefaultReadBatchSize;
+    DefaultEnv::GetEnv()->GetInt( "ReadBatchSize", readBatchSize );
+    if( readBatchSize < 0 )
+      readBatchSize = 0;
+    if( readBatchSize > (int)MaxBatchSegments )
+      readBatchSize = MaxBatchSegments;
+    pReadBatchSize = readBatchSize;
+  }
+
   //----------------------------------------------------------------------------
   // Recover a message
   //----------------------------------------------------------------------------
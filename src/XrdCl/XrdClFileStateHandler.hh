@@ -33,6 +33,7 @@
 #include "XrdCl/XrdClLocalFileHandler.hh"
 #include <list>
 #include <set>
+#include <vector>
 
 #include <sys/uio.h>
 
@@ -40,6 +41,7 @@ namespace XrdCl
 {
   class ResponseHandlerHolder;
   class Message;
+  class FileReadCache;
 
   //----------------------------------------------------------------------------
   //! Handle the stateful operations
@@ -272,6 +274,12 @@ namespace XrdCl
       //------------------------------------------------------------------------
       void OnClose( const XRootDStatus *status );
 
+      //------------------------------------------------------------------------
+      //! Send the close request, called by Close or, once the blocks it was
+      //! fetching have arrived, by the read cache the file had
+      //------------------------------------------------------------------------
+      XRootDStatus SendClose( ResponseHandler *handler, uint16_t timeout );
+
       //------------------------------------------------------------------------
       //! Handle an error while sending a stateful message
       //------------------------------------------------------------------------
@@ -288,6 +296,27 @@ namespace XrdCl
                                ResponseHandler   *userHandler,
                                MessageSendParams &sendParams );
 
+      //------------------------------------------------------------------------
+      //! A read waiting to be sent together with others
+      //------------------------------------------------------------------------
+      struct BatchedRead
+      {
+        uint64_t         offset;
+        uint32_t         size;
+        void            *buffer;
+        ResponseHandler *handler;
+        uint16_t         timeout;
+      };
+      typedef std::vector<BatchedRead> ReadBatch;
+
+      //------------------------------------------------------------------------
+      //! Called when a batch of reads has been served, hands the data over
+      //! to the reads and sends the ones queued in the meantime
+      //------------------------------------------------------------------------
+      void OnReadBatch( ReadBatch    &batch,
+                        XRootDStatus *status,
+                        AnyObject    *response );
+
       //------------------------------------------------------------------------
       //! Handle stateful response
       //------------------------------------------------------------------------
@@ -315,6 +344,17 @@ namespace XrdCl
       //------------------------------------------------------------------------
       bool GetProperty( const std::string &name, std::string &value ) const;
 
+      //------------------------------------------------------------------------
+      //! Get the read cache of the file
+      //!
+      //! @return the cache or 0 if the file is not read through the cache
+      //------------------------------------------------------------------------
+      FileReadCache *GetReadCache() const
+      {
+        XrdSysMutexHelper scopedLock( pMutex );
+        return pReadCache;
+      }
+
       //------------------------------------------------------------------------
       //! Lock the internal lock
       //------------------------------------------------------------------------
@@ -399,6 +439,33 @@ namespace XrdCl
       //------------------------------------------------------------------------
       bool IsReadOnly() const;
 
+      //------------------------------------------------------------------------
+      //! Send a read request, the lock needs to be held
+      //------------------------------------------------------------------------
+      XRootDStatus SendRead( uint64_t         offset,
+                             uint32_t         size,
+                             void            *buffer,
+                             ResponseHandler *handler,
+                             uint16_t         timeout );
+
+      //------------------------------------------------------------------------
+      //! Send a vector read request, the lock needs to be held
+      //------------------------------------------------------------------------
+      XRootDStatus SendVectorRead( const ChunkList &chunks,
+                                   void            *buffer,
+                                   ResponseHandler *handler,
+                                   uint16_t         timeout );
+
+      //------------------------------------------------------------------------
+      //! Send the queued reads in a single request, the lock needs to be held
+      //------------------------------------------------------------------------
+      void SendReadBatch();
+
+      //------------------------------------------------------------------------
+      //! Read the batching settings
+      //------------------------------------------------------------------------
+      void SetUpReadBatching();
+
       //------------------------------------------------------------------------
       //! Re-open the current file at a given server
       //------------------------------------------------------------------------
@@ -495,6 +562,19 @@ namespace XrdCl
       // Responsible for file:// operations on the local filesystem
       //------------------------------------------------------------------------
       LocalFileHandler      *pLFileHandler;
+
+      //------------------------------------------------------------------------
+      // Serves the reads from the read cache, if enabled
+      //------------------------------------------------------------------------
+      FileReadCache         *pReadCache;
+
+      //------------------------------------------------------------------------
+      // Reads issued while a batch is in flight are queued and sent together
+      // when it returns or when pReadBatchSize of them are waiting
+      //------------------------------------------------------------------------
+      ReadBatch              pReadBatch;
+      uint32_t               pReadBatchSize;
+      uint32_t               pReadBatchesInFlight;
   };
 }
 
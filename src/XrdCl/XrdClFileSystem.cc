@@ -34,6 +34,10 @@
 #include "XrdCl/XrdClForkHandler.hh"
 #include "XrdCl/XrdClPlugInInterface.hh"
 #include "XrdCl/XrdClPlugInManager.hh"
+#include "XrdCl/XrdClPostMaster.hh"
+#include "XrdCl/XrdClJobManager.hh"
+#include "XrdCl/XrdClResponseJob.hh"
+#include "XrdCl/XrdClMetadataCache.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
 #include <memory>
@@ -131,6 +135,80 @@ namespace
       ResponseHandler   *pUserHandler;
   };
 
+  //----------------------------------------------------------------------------
+  //! Store the response in the metadata cache and pass it on
+  //----------------------------------------------------------------------------
+  class MetadataCacheHandler: public XrdCl::ResponseHandler
+  {
+    public:
+      //------------------------------------------------------------------------
+      // Constructor
+      //------------------------------------------------------------------------
+      MetadataCacheHandler( XrdCl::MetadataCache *cache,
+                            const std::string    &key,
+                            uint64_t              epoch,
+                            ResponseHandler      *userHandler ):
+        pCache( cache ), pKey( key ), pEpoch( epoch ),
+        pUserHandler( userHandler ) {}
+
+      //------------------------------------------------------------------------
+      // Handle the response
+      //------------------------------------------------------------------------
+      virtual void HandleResponseWithHosts( XrdCl::XRootDStatus *status,
+                                            XrdCl::AnyObject    *response,
+                                            XrdCl::HostList     *hostList )
+      {
+        pCache->Insert( pKey, pEpoch, status, response, hostList );
+        pUserHandler->HandleResponseWithHosts( status, response, hostList );
+        delete this;
+      }
+
+    private:
+      XrdCl::MetadataCache *pCache;
+      std::string           pKey;
+      uint64_t              pEpoch;
+      ResponseHandler      *pUserHandler;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Drop the cached metadata of the changed paths and pass the response on
+  //----------------------------------------------------------------------------
+  class InvalidateCacheHandler: public XrdCl::ResponseHandler
+  {
+    public:
+      //------------------------------------------------------------------------
+      // Constructor
+      //------------------------------------------------------------------------
+      InvalidateCacheHandler( XrdCl::MetadataCache *cache,
+                              const std::string    &path1,
+                              const std::string    &path2,
+                              bool                  tree,
+                              ResponseHandler      *userHandler ):
+        pCache( cache ), pPath1( path1 ), pPath2( path2 ), pTree( tree ),
+        pUserHandler( userHandler ) {}
+
+      //------------------------------------------------------------------------
+      // Handle the response
+      //------------------------------------------------------------------------
+      virtual void HandleResponseWithHosts( XrdCl::XRootDStatus *status,
+                                            XrdCl::AnyObject    *response,
+                                            XrdCl::HostList     *hostList )
+      {
+        pCache->Invalidate( pPath1, pTree );
+        if( !pPath2.empty() )
+          pCache->Invalidate( pPath2, pTree );
+        pUserHandler->HandleResponseWithHosts( status, response, hostList );
+        delete this;
+      }
+
+    private:
+      XrdCl::MetadataCache *pCache;
+      std::string           pPath1;
+      std::string           pPath2;
+      bool                  pTree;
+      ResponseHandler      *pUserHandler;
+  };
+
   //----------------------------------------------------------------------------
   // Deep locate handler
   //----------------------------------------------------------------------------
@@ -768,6 +846,8 @@ namespace XrdCl
       return pPlugIn->Locate( path, flags, handler, timeout );
 
     std::string fPath = FilterXrdClCgi( path );
+    if( FromCache( kXR_locate, fPath, flags, handler ) )
+      return XRootDStatus();
 
     Message             *msg;
     ClientLocateRequest *req;
@@ -844,6 +924,7 @@ namespace XrdCl
 
     std::string fSource = FilterXrdClCgi( source );
     std::string fDest   = FilterXrdClCgi( dest );
+    handler = InvalidateCache( fSource, fDest, true, handler );
 
     Message         *msg;
     ClientMvRequest *req;
@@ -932,6 +1013,7 @@ namespace XrdCl
       return pPlugIn->Truncate( path, size, handler, timeout );
 
     std::string fPath = FilterXrdClCgi( path );
+    handler = InvalidateCache( fPath, std::string(), false, handler );
 
     Message               *msg;
     ClientTruncateRequest *req;
@@ -974,6 +1056,7 @@ namespace XrdCl
       return pPlugIn->Rm( path, handler, timeout );
 
     std::string fPath = FilterXrdClCgi( path );
+    handler = InvalidateCache( fPath, std::string(), false, handler );
 
     Message         *msg;
     ClientRmRequest *req;
@@ -1016,6 +1099,7 @@ namespace XrdCl
       return pPlugIn->MkDir( path, flags, mode, handler, timeout );
 
     std::string fPath = FilterXrdClCgi( path );
+    handler = InvalidateCache( fPath, std::string(), false, handler );
 
     Message            *msg;
     ClientMkdirRequest *req;
@@ -1060,6 +1144,7 @@ namespace XrdCl
       return pPlugIn->RmDir( path, handler, timeout );
 
     std::string fPath = FilterXrdClCgi( path );
+    handler = InvalidateCache( fPath, std::string(), true, handler );
 
     Message            *msg;
     ClientRmdirRequest *req;
@@ -1101,6 +1186,7 @@ namespace XrdCl
       return pPlugIn->ChMod( path, mode, handler, timeout );
 
     std::string fPath = FilterXrdClCgi( path );
+    handler = InvalidateCache( fPath, std::string(), false, handler );
 
     Message            *msg;
     ClientChmodRequest *req;
@@ -1177,6 +1263,8 @@ namespace XrdCl
       return pPlugIn->Stat( path, handler, timeout );
 
     std::string fPath = FilterXrdClCgi( path );
+    if( FromCache( kXR_stat, fPath, 0, handler ) )
+      return XRootDStatus();
 
     Message           *msg;
     ClientStatRequest *req;
@@ -1299,6 +1387,17 @@ namespace XrdCl
 
     URL url = URL( path );
     std::string fPath = FilterXrdClCgi( path );
+    bool dstat = ( flags & DirListFlags::Stat ) ||
+                 ( flags & DirListFlags::Recursive );
+
+    if( flags & DirListFlags::Recursive )
+      handler = new RecursiveDirListHandler( *pUrl, url.GetPath(), flags, handler, timeout );
+
+    if( flags & DirListFlags::Merge )
+      handler = new MergeDirListHandler( handler );
+
+    if( FromCache( kXR_dirlist, fPath, dstat, handler ) )
+      return XRootDStatus();
 
     Message           *msg;
     ClientDirlistRequest *req;
@@ -1307,15 +1406,9 @@ namespace XrdCl
     req->requestid  = kXR_dirlist;
     req->dlen       = fPath.length();
 
-    if( ( flags & DirListFlags::Stat ) || ( flags & DirListFlags::Recursive ) )
+    if( dstat )
       req->options[0] = kXR_dstat;
 
-    if( flags & DirListFlags::Recursive )
-      handler = new RecursiveDirListHandler( *pUrl, url.GetPath(), flags, handler, timeout );
-
-    if( flags & DirListFlags::Merge )
-      handler = new MergeDirListHandler( handler );
-
     msg->Append( fPath.c_str(), fPath.length(), 24 );
     MessageSendParams params; params.timeout = timeout;
     MessageUtils::ProcessSendParams( params );
@@ -1605,6 +1698,65 @@ namespace XrdCl
     pLoadBalancerLookupDone = true;
   }
 
+  //----------------------------------------------------------------------------
+  // Serve a request from the metadata cache or make the handler store
+  // the response in it
+  //----------------------------------------------------------------------------
+  bool FileSystem::FromCache( uint16_t           requestId,
+                              const std::string &path,
+                              uint32_t           options,
+                              ResponseHandler  *&handler )
+  {
+    MetadataCache *cache = DefaultEnv::GetMetadataCache();
+    if( !cache || !cache->IsCached( requestId ) )
+      return false;
+
+    std::string hostId;
+    {
+      XrdSysMutexHelper scopedLock( pMutex );
+      hostId = pUrl->GetHostId();
+    }
+
+    std::string   key = MetadataCache::MakeKey( requestId, hostId, path,
+                                                options );
+    XRootDStatus *status   = 0;
+    AnyObject    *response = 0;
+    HostList     *hostList = 0;
+    uint64_t      epoch    = 0;
+
+    if( !cache->Lookup( key, status, response, hostList, epoch ) )
+    {
+      handler = new MetadataCacheHandler( cache, key, epoch, handler );
+      return false;
+    }
+
+    Log *log = DefaultEnv::GetLog();
+    log->Dump( FileSystemMsg, "[0x%x@%s] Serving the response for %s from "
+               "the metadata cache", this, hostId.c_str(), path.c_str() );
+
+    JobManager *jobMgr = DefaultEnv::GetPostMaster()->GetJobManager();
+    jobMgr->QueueJob( new ResponseJob( handler, status, response, hostList ) );
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Drop the cached metadata of the paths
+  //----------------------------------------------------------------------------
+  ResponseHandler *FileSystem::InvalidateCache( const std::string &path1,
+                                                const std::string &path2,
+                                                bool               tree,
+                                                ResponseHandler   *handler )
+  {
+    MetadataCache *cache = DefaultEnv::GetMetadataCache();
+    if( !cache )
+      return handler;
+
+    cache->Invalidate( path1, tree );
+    if( !path2.empty() )
+      cache->Invalidate( path2, tree );
+    return new InvalidateCacheHandler( cache, path1, path2, tree, handler );
+  }
+
   //----------------------------------------------------------------------------
   // Send a message in a locked environment
   //----------------------------------------------------------------------------
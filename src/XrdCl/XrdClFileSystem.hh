@@ -725,6 +725,25 @@ namespace XrdCl
       //------------------------------------------------------------------------
       void AssignLoadBalancer( const URL &url );
 
+      //------------------------------------------------------------------------
+      // Serve a stat, locate or dirlist request from the metadata cache or
+      // make the handler store the response in it
+      //------------------------------------------------------------------------
+      bool FromCache( uint16_t           requestId,
+                      const std::string &path,
+                      uint32_t           options,
+                      ResponseHandler  *&handler );
+
+      //------------------------------------------------------------------------
+      // Drop the cached metadata of the paths now and once the response
+      // to the request changing them arrives, tree if they may be
+      // directories that get moved or removed
+      //------------------------------------------------------------------------
+      ResponseHandler *InvalidateCache( const std::string &path1,
+                                        const std::string &path2,
+                                        bool               tree,
+                                        ResponseHandler   *handler );
+
       //------------------------------------------------------------------------
       // Lock the internal lock
       //------------------------------------------------------------------------
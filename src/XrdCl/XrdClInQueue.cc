@@ -22,9 +22,73 @@
 #include "XrdCl/XrdClMessage.hh"
 
 #include <arpa/inet.h>              // for network unmarshalling stuff
+#include <cstring>
 
 namespace XrdCl
 {
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  InQueue::InQueue()
+  {
+    memset( pPages,        0, sizeof( pPages ) );
+    memset( pPageHandlers, 0, sizeof( pPageHandlers ) );
+    memset( pPageMessages, 0, sizeof( pPageMessages ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  InQueue::~InQueue()
+  {
+    for( uint32_t i = 0; i < NumPages; ++i )
+      delete [] pPages[i];
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the slot of the SID
+  //----------------------------------------------------------------------------
+  InQueue::Slot *InQueue::GetSlot( uint16_t sid, bool create )
+  {
+    Slot *&page = pPages[sid / PageSize];
+    if( !page )
+    {
+      if( !create )
+        return 0;
+      page = new Slot[PageSize];
+      memset( page, 0, PageSize * sizeof( Slot ) );
+    }
+    return &page[sid % PageSize];
+  }
+
+  //----------------------------------------------------------------------------
+  // Set or clear the handler of a slot
+  //----------------------------------------------------------------------------
+  void InQueue::SetHandler( uint16_t            sid,
+                            Slot               *slot,
+                            IncomingMsgHandler *handler,
+                            time_t              expires )
+  {
+    if( slot->handler && !handler )
+      --pPageHandlers[sid / PageSize];
+    else if( !slot->handler && handler )
+      ++pPageHandlers[sid / PageSize];
+    slot->handler = handler;
+    slot->expires = expires;
+  }
+
+  //----------------------------------------------------------------------------
+  // Set or clear the cached message of a slot
+  //----------------------------------------------------------------------------
+  void InQueue::SetMessage( uint16_t sid, Slot *slot, Message *msg )
+  {
+    if( slot->message && !msg )
+      --pPageMessages[sid / PageSize];
+    else if( !slot->message && msg )
+      ++pPageMessages[sid / PageSize];
+    slot->message = msg;
+  }
+
   //----------------------------------------------------------------------------
   // Filter messages
   //----------------------------------------------------------------------------
@@ -73,21 +137,21 @@ namespace XrdCl
       return true;
     }
 
-    // Lookup the sid in the map of handlers
+    // Lookup the sid in the table of handlers
     pMutex.Lock();
-    HandlerMap::iterator it = pHandlers.find(msgSid);
+    Slot *slot = GetSlot( msgSid, true );
 
-    if (it != pHandlers.end())
+    if( slot->handler )
     {
-      handler = it->second.first;
+      handler = slot->handler;
       action  = handler->Examine( msg );
 
       if( action & IncomingMsgHandler::RemoveHandler )
-	pHandlers.erase( it );
+	SetHandler( msgSid, slot, 0, 0 );
     }
 
     if( !(action & IncomingMsgHandler::Take) )
-      pMessages[msgSid] = msg;
+      SetMessage( msgSid, slot, msg );
 
     pMutex.UnLock();
 
@@ -105,23 +169,23 @@ namespace XrdCl
     uint16_t action = 0;
     uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    MessageMap::iterator it = pMessages.find(handlerSid);
+    Slot *slot = GetSlot( handlerSid, true );
 
-    if (it != pMessages.end())
+    if( slot->message )
     {
-      action = handler->Examine( it->second );
+      action = handler->Examine( slot->message );
 
       if( action & IncomingMsgHandler::Take )
       {
 	if( !(action & IncomingMsgHandler::NoProcess ) )
-	  handler->Process( it->second );
+	  handler->Process( slot->message );
 
-	pMessages.erase( it );
+	SetMessage( handlerSid, slot, 0 );
       }
     }
 
     if( !(action & IncomingMsgHandler::RemoveHandler) )
-      pHandlers[handlerSid] = HandlerAndExpire( handler, expires );
+      SetHandler( handlerSid, slot, handler, expires );
   }
 
   //----------------------------------------------------------------------------
@@ -143,16 +207,16 @@ namespace XrdCl
     }
 
     XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.find(msgSid);
+    Slot *slot = GetSlot( msgSid, false );
 
-    if (it != pHandlers.end())
+    if( slot && slot->handler )
     {
-      handler = it->second.first;
+      handler = slot->handler;
       act     = handler->Examine( msg );
-      exp     = it->second.second;
+      exp     = slot->expires;
 
       if( act & IncomingMsgHandler::Take )
-	pHandlers.erase( it );
+	SetHandler( msgSid, slot, 0, 0 );
     }
 
     if( handler )
@@ -172,7 +236,7 @@ namespace XrdCl
   {
     uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    pHandlers[handlerSid] = HandlerAndExpire( handler, expires );
+    SetHandler( handlerSid, GetSlot( handlerSid, true ), handler, expires );
   }
 
   //----------------------------------------------------------------------------
@@ -182,7 +246,9 @@ namespace XrdCl
   {
     uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    pHandlers.erase(handlerSid);
+    Slot *slot = GetSlot( handlerSid, false );
+    if( slot )
+      SetHandler( handlerSid, slot, 0, 0 );
   }
 
   //----------------------------------------------------------------------------
@@ -194,14 +260,19 @@ namespace XrdCl
   {
     uint8_t action = 0;
     XrdSysMutexHelper scopedLock( pMutex );
-    for( HandlerMap::iterator it = pHandlers.begin(); it != pHandlers.end(); )
+    for( uint32_t p = 0; p < NumPages; ++p )
     {
-      action = it->second.first->OnStreamEvent( event, streamNum, status );
+      for( uint32_t i = 0; pPageHandlers[p] && i < PageSize; ++i )
+      {
+	Slot *slot = &pPages[p][i];
+	if( !slot->handler )
+	  continue;
 
-      if( action & IncomingMsgHandler::RemoveHandler )
-	pHandlers.erase( it++ );
-      else
-	++it;
+	action = slot->handler->OnStreamEvent( event, streamNum, status );
+
+	if( action & IncomingMsgHandler::RemoveHandler )
+	  SetHandler( p * PageSize + i, slot, 0, 0 );
+      }
     }
   }
 
@@ -214,17 +285,27 @@ namespace XrdCl
       now = ::time(0);
 
     XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.begin();
-    while( it != pHandlers.end() )
+    for( uint32_t p = 0; p < NumPages; ++p )
     {
-      if( it->second.second <= now )
+      for( uint32_t i = 0; pPageHandlers[p] && i < PageSize; ++i )
+      {
+	Slot *slot = &pPages[p][i];
+	if( !slot->handler || slot->expires > now )
+	  continue;
+
+	slot->handler->OnStreamEvent( IncomingMsgHandler::Timeout, 0,
+				      Status( stError, errOperationExpired ) );
+	SetHandler( p * PageSize + i, slot, 0, 0 );
+      }
+
+      //------------------------------------------------------------------------
+      // The SIDs move on, release the pages that are no longer used
+      //------------------------------------------------------------------------
+      if( pPages[p] && !pPageHandlers[p] && !pPageMessages[p] )
       {
-	it->second.first->OnStreamEvent( IncomingMsgHandler::Timeout, 0,
-				  Status( stError, errOperationExpired ) );
-	pHandlers.erase( it++ );
+	delete [] pPages[p];
+	pPages[p] = 0;
       }
-      else
-	++it;
     }
   }
 }
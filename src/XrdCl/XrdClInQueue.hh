@@ -20,8 +20,7 @@
 #define __XRD_CL_IN_QUEUE_HH__
 
 #include <XrdSys/XrdSysPthread.hh>
-#include <map>
-#include <utility>
+#include <ctime>
 #include "XrdCl/XrdClStatus.hh"
 #include "XrdCl/XrdClPostMasterInterfaces.hh"
 
@@ -31,10 +30,25 @@ namespace XrdCl
 
   //----------------------------------------------------------------------------
   //! A synchronize queue for incoming data
+  //!
+  //! Handlers and cached messages are indexed directly by the SID in a
+  //! two-level table whose 256-entry pages are allocated when first used
+  //! and released by the timeout scan once they are empty, so that
+  //! a channel with a few requests in flight stays small.
   //----------------------------------------------------------------------------
   class InQueue
   {
     public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      InQueue();
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~InQueue();
+
       //------------------------------------------------------------------------
       //! Add a fully reconstructed message to the queue
       //------------------------------------------------------------------------
@@ -98,12 +112,40 @@ namespace XrdCl
       //------------------------------------------------------------------------
       bool DiscardMessage(Message* msg, uint16_t& sid) const;
 
-      typedef std::pair<IncomingMsgHandler *, time_t> HandlerAndExpire;
-      typedef std::map<uint16_t, HandlerAndExpire> HandlerMap;
-      typedef std::map<uint16_t, Message*> MessageMap;
-      MessageMap pMessages;
-      HandlerMap pHandlers;
-      XrdSysRecMutex pMutex;
+      //------------------------------------------------------------------------
+      //! Handler and cached message of a SID
+      //------------------------------------------------------------------------
+      struct Slot
+      {
+        IncomingMsgHandler *handler;
+        time_t              expires;
+        Message            *message;
+      };
+
+      static const uint32_t PageSize = 256;
+      static const uint32_t NumPages = 65536 / PageSize;
+
+      //------------------------------------------------------------------------
+      //! Get the slot of the SID, allocate the page if requested
+      //------------------------------------------------------------------------
+      Slot *GetSlot( uint16_t sid, bool create );
+
+      //------------------------------------------------------------------------
+      //! Set or clear the handler of a slot keeping the page count right
+      //------------------------------------------------------------------------
+      void SetHandler( uint16_t sid, Slot *slot, IncomingMsgHandler *handler,
+                       time_t expires );
+
+      //------------------------------------------------------------------------
+      //! Set or clear the cached message of a slot keeping the page count
+      //! right
+      //------------------------------------------------------------------------
+      void SetMessage( uint16_t sid, Slot *slot, Message *msg );
+
+      Slot           *pPages[NumPages];
+      uint16_t        pPageHandlers[NumPages];  // handlers in each page
+      uint16_t        pPageMessages[NumPages];  // cached messages in each page
+      XrdSysRecMutex  pMutex;
   };
 }
 
@@ -36,9 +36,18 @@
 #include <sys/stat.h>
 #include <arpa/inet.h>
 #include <aio.h>
+#include <climits>
 
 namespace
 {
+  //----------------------------------------------------------------------------
+  // The most buffers we pass to a single pwritev
+  //----------------------------------------------------------------------------
+#ifdef IOV_MAX
+  const int MaxIovCnt = IOV_MAX;
+#else
+  const int MaxIovCnt = 1024;
+#endif
 
   class AioCtx
   {
@@ -489,12 +498,13 @@ namespace XrdCl
     ssize_t bytesWritten = 0;
     while( bytesWritten < size )
     {
+      int cnt = iovcnt < MaxIovCnt ? iovcnt : MaxIovCnt;
 #ifdef __APPLE__
-      ssize_t ret = lseek( fd, offset, SEEK_SET );
+      ssize_t ret = lseek( fd, offset + bytesWritten, SEEK_SET );
       if( ret >= 0 )
-        ret = writev( fd, iovptr, iovcnt );
+        ret = writev( fd, iovptr, cnt );
 #else
-      ssize_t ret = pwritev( fd, iovptr, iovcnt, offset );
+      ssize_t ret = pwritev( fd, iovptr, cnt, offset + bytesWritten );
 #endif
       if( ret < 0 )
       {
@@ -0,0 +1,351 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClMemoryPool.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include "XrdSys/XrdSysAtomics.hh"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <pthread.h>
+
+namespace
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Counters of a thread, only the owner updates them but GetStats may read
+  // them at any time
+  //----------------------------------------------------------------------------
+  typedef CPP_ATOMIC_TYPE(uint64_t) Counter;
+
+  struct Counters
+  {
+    Counter allocations;
+    Counter threadHits;
+    Counter depotHits;
+    Counter sysAllocs;
+    Counter frees;
+    Counter threadRecycled;
+    Counter depotRecycled;
+    Counter sysFrees;
+  };
+
+  //----------------------------------------------------------------------------
+  // Bump a counter of the calling thread, there is a single writer so no
+  // read-modify-write instruction is needed
+  //----------------------------------------------------------------------------
+  inline void Count( Counter &counter, uint64_t n = 1 )
+  {
+    CPP_ATOMIC_STORE( counter, CPP_ATOMIC_LOAD( counter,
+                      std::memory_order_relaxed ) + n,
+                      std::memory_order_relaxed );
+  }
+
+  inline uint64_t Get( const Counter &counter )
+  {
+    return CPP_ATOMIC_LOAD( counter, std::memory_order_relaxed );
+  }
+
+  //----------------------------------------------------------------------------
+  // Free blocks and counters of a thread
+  //----------------------------------------------------------------------------
+  struct ThreadCache
+  {
+    void              *blocks[MemoryPool::NumClasses][MemoryPool::ThreadCacheSize];
+    uint32_t           count[MemoryPool::NumClasses];
+    Counters           stats;
+    ThreadCache       *prev;
+    ThreadCache       *next;
+  };
+
+  //----------------------------------------------------------------------------
+  // Blocks shared by all the threads, never destroyed so that the buffers
+  // released during the static destruction still have a place to go
+  //----------------------------------------------------------------------------
+  struct Depot
+  {
+    XrdSysMutex        mutex;
+    void              *blocks[MemoryPool::NumClasses][MemoryPool::DepotSize];
+    uint32_t           count[MemoryPool::NumClasses];
+    ThreadCache       *caches;    // caches of the running threads
+    MemoryPool::Stats  retired;   // counters of the threads that are gone
+  };
+
+  Depot          *sDepot   = 0;
+  pthread_key_t   sKey;
+  pthread_once_t  sOnce    = PTHREAD_ONCE_INIT;
+  volatile bool   sEnabled = false;
+
+  //----------------------------------------------------------------------------
+  // Sum the counters
+  //----------------------------------------------------------------------------
+  void AddStats( MemoryPool::Stats &to, const Counters &from )
+  {
+    to.allocations    += Get( from.allocations );
+    to.threadHits     += Get( from.threadHits );
+    to.depotHits      += Get( from.depotHits );
+    to.sysAllocs      += Get( from.sysAllocs );
+    to.frees          += Get( from.frees );
+    to.threadRecycled += Get( from.threadRecycled );
+    to.depotRecycled  += Get( from.depotRecycled );
+    to.sysFrees       += Get( from.sysFrees );
+  }
+
+  //----------------------------------------------------------------------------
+  // Hand the blocks of an exiting thread over to the depot
+  //----------------------------------------------------------------------------
+  extern "C" void ReleaseThreadCache( void *arg )
+  {
+    ThreadCache *cache = (ThreadCache*)arg;
+    XrdSysMutexHelper scopedLock( sDepot->mutex );
+
+    for( uint32_t cls = 0; cls < MemoryPool::NumClasses; ++cls )
+    {
+      for( uint32_t i = 0; i < cache->count[cls]; ++i )
+      {
+        if( sDepot->count[cls] < MemoryPool::DepotSize )
+          sDepot->blocks[cls][sDepot->count[cls]++] = cache->blocks[cls][i];
+        else
+          free( cache->blocks[cls][i] );
+      }
+    }
+
+    AddStats( sDepot->retired, cache->stats );
+    if( cache->prev ) cache->prev->next = cache->next;
+    else sDepot->caches = cache->next;
+    if( cache->next ) cache->next->prev = cache->prev;
+    free( cache );
+  }
+
+  //----------------------------------------------------------------------------
+  // Set up the depot
+  //----------------------------------------------------------------------------
+  extern "C" void InitializeDepot()
+  {
+    sDepot = new Depot();
+    memset( sDepot->count, 0, sizeof( sDepot->count ) );
+    sDepot->caches = 0;
+    pthread_key_create( &sKey, ReleaseThreadCache );
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the cache of the calling thread
+  //----------------------------------------------------------------------------
+  ThreadCache *GetThreadCache()
+  {
+    pthread_once( &sOnce, InitializeDepot );
+    ThreadCache *cache = (ThreadCache*)pthread_getspecific( sKey );
+    if( cache )
+      return cache;
+
+    cache = (ThreadCache*)calloc( 1, sizeof( ThreadCache ) );
+    if( !cache )
+      return 0;
+    new( &cache->stats ) Counters();
+    pthread_setspecific( sKey, cache );
+
+    XrdSysMutexHelper scopedLock( sDepot->mutex );
+    cache->next = sDepot->caches;
+    if( sDepot->caches ) sDepot->caches->prev = cache;
+    sDepot->caches = cache;
+    return cache;
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the size class for the given size, -1 if too large
+  //----------------------------------------------------------------------------
+  inline int GetClass( size_t size )
+  {
+    if( size > MemoryPool::MaxBlockSize )
+      return -1;
+    int    cls       = 0;
+    size_t blockSize = MemoryPool::MinBlockSize;
+    while( blockSize < size )
+    {
+      blockSize <<= 1;
+      ++cls;
+    }
+    return cls;
+  }
+
+  //----------------------------------------------------------------------------
+  // Get a block of the given class
+  //----------------------------------------------------------------------------
+  void *AllocateBlock( int cls )
+  {
+    uint32_t     blockSize = MemoryPool::MinBlockSize << cls;
+    ThreadCache *cache     = sEnabled ? GetThreadCache() : 0;
+    if( !cache )
+      return malloc( blockSize );
+
+    Count( cache->stats.allocations );
+    if( cache->count[cls] )
+    {
+      Count( cache->stats.threadHits );
+      return cache->blocks[cls][--cache->count[cls]];
+    }
+
+    //--------------------------------------------------------------------------
+    // Refill half of the thread cache from the depot
+    //--------------------------------------------------------------------------
+    {
+      XrdSysMutexHelper scopedLock( sDepot->mutex );
+      uint32_t &depotCount = sDepot->count[cls];
+      while( depotCount && cache->count[cls] < MemoryPool::ThreadCacheSize/2 )
+        cache->blocks[cls][cache->count[cls]++] =
+          sDepot->blocks[cls][--depotCount];
+    }
+
+    if( cache->count[cls] )
+    {
+      Count( cache->stats.depotHits );
+      return cache->blocks[cls][--cache->count[cls]];
+    }
+
+    Count( cache->stats.sysAllocs );
+    return malloc( blockSize );
+  }
+
+  //----------------------------------------------------------------------------
+  // Give back a block of the given class
+  //----------------------------------------------------------------------------
+  void FreeBlock( void *block, int cls )
+  {
+    ThreadCache *cache = sEnabled ? GetThreadCache() : 0;
+    if( !cache )
+    {
+      free( block );
+      return;
+    }
+
+    Count( cache->stats.frees );
+    if( cache->count[cls] < MemoryPool::ThreadCacheSize )
+    {
+      Count( cache->stats.threadRecycled );
+      cache->blocks[cls][cache->count[cls]++] = block;
+      return;
+    }
+
+    //--------------------------------------------------------------------------
+    // The thread cache is full, move half of it to the depot, this happens
+    // to the threads that release more than they allocate, ie. the ones
+    // running the response handlers
+    //--------------------------------------------------------------------------
+    uint32_t toFree = 0;
+    void    *freeList[MemoryPool::ThreadCacheSize/2];
+    {
+      XrdSysMutexHelper scopedLock( sDepot->mutex );
+      uint32_t &depotCount = sDepot->count[cls];
+      while( cache->count[cls] > MemoryPool::ThreadCacheSize/2 )
+      {
+        void *b = cache->blocks[cls][--cache->count[cls]];
+        if( depotCount < MemoryPool::DepotSize )
+        {
+          sDepot->blocks[cls][depotCount++] = b;
+          Count( cache->stats.depotRecycled );
+        }
+        else
+          freeList[toFree++] = b;
+      }
+    }
+
+    for( uint32_t i = 0; i < toFree; ++i )
+      free( freeList[i] );
+    Count( cache->stats.sysFrees, toFree );
+
+    Count( cache->stats.threadRecycled );
+    cache->blocks[cls][cache->count[cls]++] = block;
+  }
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Get a block for an object
+  //----------------------------------------------------------------------------
+  void *MemoryPool::AllocateObject( size_t size )
+  {
+    int   cls   = GetClass( size );
+    void *block = cls < 0 ? malloc( size ) : AllocateBlock( cls );
+    if( !block )
+      throw std::bad_alloc();
+    return block;
+  }
+
+  //----------------------------------------------------------------------------
+  // Release an object
+  //----------------------------------------------------------------------------
+  void MemoryPool::FreeObject( void *block, size_t size )
+  {
+    if( !block )
+      return;
+
+    int cls = GetClass( size );
+    if( cls < 0 )
+      free( block );
+    else
+      FreeBlock( block, cls );
+  }
+
+  //----------------------------------------------------------------------------
+  // Enable or disable pooling
+  //----------------------------------------------------------------------------
+  void MemoryPool::SetEnabled( bool enabled )
+  {
+    sEnabled = enabled;
+  }
+
+  //----------------------------------------------------------------------------
+  // Check if pooling is enabled
+  //----------------------------------------------------------------------------
+  bool MemoryPool::IsEnabled()
+  {
+    return sEnabled;
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the counters
+  //----------------------------------------------------------------------------
+  void MemoryPool::GetStats( Stats &stats )
+  {
+    pthread_once( &sOnce, InitializeDepot );
+    XrdSysMutexHelper scopedLock( sDepot->mutex );
+    stats = sDepot->retired;
+    for( ThreadCache *cache = sDepot->caches; cache; cache = cache->next )
+      AddStats( stats, cache->stats );
+  }
+
+  //----------------------------------------------------------------------------
+  // Lock the depot
+  //----------------------------------------------------------------------------
+  void MemoryPool::Lock()
+  {
+    pthread_once( &sOnce, InitializeDepot );
+    sDepot->mutex.Lock();
+  }
+
+  //----------------------------------------------------------------------------
+  // Unlock the depot
+  //----------------------------------------------------------------------------
+  void MemoryPool::UnLock()
+  {
+    sDepot->mutex.UnLock();
+  }
+}
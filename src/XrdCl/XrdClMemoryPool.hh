@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_MEMORY_POOL_HH__
+#define __XRD_CL_MEMORY_POOL_HH__
+
+#include <stdint.h>
+#include <cstddef>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Size-classed pool of memory blocks backing the per-request handlers.
+  //! It is internal to XrdCl: objects that may be created or destroyed by
+  //! user code or plug-ins, such as Message and Buffer, never use it.
+  //!
+  //! Blocks are rounded up to a power of two between MinBlockSize and
+  //! MaxBlockSize and are obtained with malloc. Every thread keeps a small
+  //! cache of free blocks per size class, blocks freed in excess go to a
+  //! shared depot, which is only then returned to the system when it is
+  //! full as well. Pooling is enabled with XRD_MEMORYPOOL (off by default).
+  //----------------------------------------------------------------------------
+  class MemoryPool
+  {
+    public:
+      static const uint32_t MinBlockSize    = 64;
+      static const uint32_t MaxBlockSize    = 65536;
+      static const uint32_t NumClasses      = 11;
+      static const uint32_t ThreadCacheSize = 32;
+      static const uint32_t DepotSize       = 1024;
+
+      //------------------------------------------------------------------------
+      //! Pool counters
+      //------------------------------------------------------------------------
+      struct Stats
+      {
+        Stats(): allocations(0), threadHits(0), depotHits(0), sysAllocs(0),
+                 frees(0), threadRecycled(0), depotRecycled(0), sysFrees(0) {}
+        uint64_t allocations;     //!< blocks requested from the pool
+        uint64_t threadHits;      //!< served from the thread cache
+        uint64_t depotHits;       //!< served from the shared depot
+        uint64_t sysAllocs;       //!< obtained from the system
+        uint64_t frees;           //!< blocks given back to the pool
+        uint64_t threadRecycled;  //!< kept in the thread cache
+        uint64_t depotRecycled;   //!< kept in the shared depot
+        uint64_t sysFrees;        //!< returned to the system
+      };
+
+      //------------------------------------------------------------------------
+      //! Get a block for an object of the given size, the block is taken
+      //! from a size class if it fits, so that the object can be released
+      //! knowing only its size - for use in class specific operator new
+      //------------------------------------------------------------------------
+      static void *AllocateObject( size_t size );
+
+      //------------------------------------------------------------------------
+      //! Release an object allocated with AllocateObject
+      //------------------------------------------------------------------------
+      static void FreeObject( void *block, size_t size );
+
+      //------------------------------------------------------------------------
+      //! Enable or disable pooling, blocks allocated before still are
+      //! released properly
+      //------------------------------------------------------------------------
+      static void SetEnabled( bool enabled );
+
+      //------------------------------------------------------------------------
+      //! Check if pooling is enabled
+      //------------------------------------------------------------------------
+      static bool IsEnabled();
+
+      //------------------------------------------------------------------------
+      //! Get the counters summed over all the threads
+      //------------------------------------------------------------------------
+      static void GetStats( Stats &stats );
+
+      //------------------------------------------------------------------------
+      //! Lock the shared depot before forking
+      //------------------------------------------------------------------------
+      static void Lock();
+
+      //------------------------------------------------------------------------
+      //! Unlock the shared depot after forking
+      //------------------------------------------------------------------------
+      static void UnLock();
+  };
+}
+
+#endif // __XRD_CL_MEMORY_POOL_HH__
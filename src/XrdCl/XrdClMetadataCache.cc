@@ -0,0 +1,839 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClMetadataCache.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClLog.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XProtocol/XProtocol.hh"
+
+#include <sstream>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Strip the cgi, the locate wildcard and the trailing slashes so that all
+  // the requests for a path start with the same key prefix
+  //----------------------------------------------------------------------------
+  std::string BasePath( const std::string &path )
+  {
+    std::string base = path.substr( 0, path.find( '?' ) );
+    if( !base.empty() && base[0] == '*' )
+      base.erase( 0, 1 );
+    while( base.size() > 1 && base[base.size()-1] == '/' )
+      base.erase( base.size() - 1 );
+    return base;
+  }
+
+  //----------------------------------------------------------------------------
+  // The parent directory of a base path, empty for the root
+  //----------------------------------------------------------------------------
+  std::string ParentPath( const std::string &base )
+  {
+    size_t pos = base.rfind( '/' );
+    if( pos == std::string::npos || base.size() <= 1 )
+      return std::string();
+    if( pos == 0 )
+      return "/";
+    return base.substr( 0, pos );
+  }
+
+  //----------------------------------------------------------------------------
+  // Key layout: base path, request type and options, host, full path, the
+  // fields separated by '\0'
+  //----------------------------------------------------------------------------
+  uint16_t RequestOf( const std::string &key )
+  {
+    size_t pos = key.find( '\0' );
+    if( pos == std::string::npos || pos + 1 >= key.size() )
+      return 0;
+    switch( key[pos+1] )
+    {
+      case 's': return kXR_stat;
+      case 'l': return kXR_locate;
+      case 'd': return kXR_dirlist;
+    }
+    return 0;
+  }
+
+  std::string HostOf( const std::string &key )
+  {
+    size_t start = key.find( '\0', key.find( '\0' ) + 1 );
+    if( start == std::string::npos )
+      return std::string();
+    ++start;
+    return key.substr( start, key.find( '\0', start ) - start );
+  }
+
+  //----------------------------------------------------------------------------
+  // Copy a directory listing with the stat info of its entries
+  //----------------------------------------------------------------------------
+  XrdCl::DirectoryList *Copy( XrdCl::DirectoryList *list )
+  {
+    using XrdCl::DirectoryList;
+    using XrdCl::StatInfo;
+    DirectoryList *copy = new DirectoryList();
+    copy->SetParentName( list->GetParentName() );
+    DirectoryList::Iterator itr;
+    for( itr = list->Begin(); itr != list->End(); ++itr )
+    {
+      StatInfo *info = (*itr)->GetStatInfo();
+      copy->Add( new DirectoryList::ListEntry( (*itr)->GetHostAddress(),
+                                               (*itr)->GetName(),
+                                               info ? new StatInfo( *info ) : 0 ) );
+    }
+    return copy;
+  }
+
+  //----------------------------------------------------------------------------
+  // Serialize the stat info the way the server sends it
+  //----------------------------------------------------------------------------
+  std::string ToString( const XrdCl::StatInfo *info )
+  {
+    std::ostringstream o;
+    o << info->GetId() << " " << info->GetSize() << " " << info->GetFlags();
+    o << " " << info->GetModTime();
+    return o.str();
+  }
+
+  //----------------------------------------------------------------------------
+  // FNV-1a
+  //----------------------------------------------------------------------------
+  uint32_t Hash( const char *data, size_t len )
+  {
+    uint32_t hash = 2166136261U;
+    for( size_t i = 0; i < len; ++i )
+    {
+      hash ^= (unsigned char)data[i];
+      hash *= 16777619U;
+    }
+    return hash;
+  }
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // A cached response
+  //----------------------------------------------------------------------------
+  struct MetadataCache::Entry
+  {
+    Entry(): expires( 0 ), statInfo( 0 ), locationInfo( 0 ), dirList( 0 ) {}
+    ~Entry()
+    {
+      delete statInfo;
+      delete locationInfo;
+      delete dirList;
+    }
+
+    std::string                 key;
+    time_t                      expires;
+    XRootDStatus                status;
+    StatInfo                   *statInfo;
+    LocationInfo               *locationInfo;
+    DirectoryList              *dirList;
+    HostList                    hosts;
+    std::list<Entry*>::iterator lru;
+  };
+
+  //----------------------------------------------------------------------------
+  // Stat responses in a file mapped by all the processes sharing them.
+  //
+  // The slots are grouped in windows, all the keys of a path hash to the same
+  // window. Every slot is guarded by a sequence number which is odd while the
+  // slot is being written, next to it is the time the writer took it. Nobody
+  // waits for a slot: a slot that changes under a reader is a miss, a slot
+  // held by another writer is left alone unless it has been held for so long
+  // that the writer must be gone.
+  //
+  // The header counts the invalidations done by all the processes, so that
+  // they can drop their private entries, and the invalidations of whole
+  // trees. The entries below a tree cannot be found by their hash, so every
+  // slot records the tree generation it was written in and is only valid
+  // in that generation.
+  //----------------------------------------------------------------------------
+  class MetadataCache::SharedTable
+  {
+    public:
+      static const uint32_t Magic      = 0x58434d32; // XCM2
+      static const uint32_t NumSlots   = 16384;
+      static const uint32_t WindowSize = 8;
+      static const uint32_t KeyMax     = 416;
+      static const uint32_t DataMax    = 80;
+      static const uint32_t StaleLock  = 10;
+
+      struct Slot
+      {
+        uint64_t state;          // time locked << 32 | sequence
+        uint32_t generation;
+        uint32_t baseLen;
+        int64_t  expires;
+        int32_t  errNo;
+        uint16_t keyLen;
+        uint16_t dataLen;
+        char     key[KeyMax];
+        char     data[DataMax];
+      };
+
+      struct Header
+      {
+        uint32_t magic;
+        uint32_t generation;
+        uint32_t treeGeneration;
+        uint32_t padding[13];
+      };
+
+      SharedTable(): pHeader( 0 ), pSlots( 0 ), pSize( 0 ) {}
+
+      ~SharedTable()
+      {
+        if( pHeader )
+          munmap( pHeader, pSize );
+      }
+
+      //------------------------------------------------------------------------
+      // Map the table, creating the file if needed
+      //------------------------------------------------------------------------
+      bool Map( const std::string &path )
+      {
+        int fd = open( path.c_str(), O_RDWR | O_CREAT, 0600 );
+        if( fd < 0 )
+          return false;
+
+        pSize = sizeof( Header ) + NumSlots * sizeof( Slot );
+        struct stat st;
+        if( fstat( fd, &st ) || ( (size_t)st.st_size < pSize &&
+                                  ftruncate( fd, pSize ) ) )
+        {
+          close( fd );
+          return false;
+        }
+
+        void *ptr = mmap( 0, pSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+        close( fd );
+        if( ptr == MAP_FAILED )
+          return false;
+
+        pHeader = (Header*)ptr;
+        pSlots  = (Slot*)( pHeader + 1 );
+        if( !__sync_bool_compare_and_swap( &pHeader->magic, 0, Magic ) &&
+            pHeader->magic != Magic )
+        {
+          munmap( pHeader, pSize );
+          pHeader = 0;
+          return false;
+        }
+        return true;
+      }
+
+      //------------------------------------------------------------------------
+      // Get the invalidation counters, the tree generation first so that it
+      // is never newer than the generation
+      //------------------------------------------------------------------------
+      void GetGeneration( uint32_t &generation, uint32_t &treeGeneration )
+      {
+        treeGeneration = pHeader->treeGeneration;
+        __sync_synchronize();
+        generation = pHeader->generation;
+      }
+
+      //------------------------------------------------------------------------
+      // Count an invalidation, tell whether no other process counted one
+      // since the given generation
+      //------------------------------------------------------------------------
+      bool AddGeneration( bool tree, uint32_t generation,
+                          uint32_t treeGeneration )
+      {
+        bool alone = __sync_add_and_fetch( &pHeader->generation, 1 ) ==
+                     generation + 1;
+        if( tree )
+          alone = __sync_add_and_fetch( &pHeader->treeGeneration, 1 ) ==
+                  treeGeneration + 1 && alone;
+        return alone;
+      }
+
+      //------------------------------------------------------------------------
+      // Look up a key written in the given tree generation
+      //------------------------------------------------------------------------
+      bool Get( const std::string &key, size_t baseLen, time_t now,
+                uint32_t treeGeneration, int32_t &errNo, std::string &data )
+      {
+        if( key.size() > KeyMax )
+          return false;
+
+        Slot *window = Window( key.data(), baseLen );
+        for( uint32_t i = 0; i < WindowSize; ++i )
+        {
+          Slot     &slot  = window[i];
+          uint64_t  state = slot.state;
+          __sync_synchronize();
+          if( ( state & 1 ) || slot.keyLen != key.size() ||
+              slot.generation != treeGeneration )
+            continue;
+
+          int64_t  expires = slot.expires;
+          int32_t  err     = slot.errNo;
+          uint16_t dataLen = slot.dataLen;
+          char     buffer[DataMax];
+          bool     match   = !memcmp( slot.key, key.data(), key.size() );
+          if( dataLen > DataMax )
+            continue;
+          memcpy( buffer, slot.data, dataLen );
+
+          __sync_synchronize();
+          if( slot.state != state || !match || expires <= now )
+            continue;
+
+          errNo = err;
+          data.assign( buffer, dataLen );
+          return true;
+        }
+        return false;
+      }
+
+      //------------------------------------------------------------------------
+      // Store a key for the given tree generation, replacing the same key, an
+      // expired or abandoned slot or the one closest to expiring
+      //------------------------------------------------------------------------
+      void Put( const std::string &key, size_t baseLen, time_t now,
+                uint32_t treeGeneration, time_t expires, int32_t errNo,
+                const std::string &data )
+      {
+        if( key.size() > KeyMax )
+          return;
+        size_t dataLen = data.size() < DataMax ? data.size() : DataMax;
+
+        Slot *window = Window( key.data(), baseLen );
+        Slot *target = 0;
+        for( uint32_t i = 0; i < WindowSize && !target; ++i )
+        {
+          Slot &slot = window[i];
+          if( slot.keyLen == key.size() &&
+              !memcmp( slot.key, key.data(), key.size() ) )
+            target = &slot;
+        }
+
+        for( uint32_t i = 0; i < WindowSize && !target; ++i )
+        {
+          if( window[i].expires <= now || IsAbandoned( window[i], now ) )
+            target = &window[i];
+        }
+
+        if( !target )
+        {
+          target = window;
+          for( uint32_t i = 1; i < WindowSize; ++i )
+            if( window[i].expires < target->expires )
+              target = &window[i];
+        }
+
+        uint64_t state;
+        if( !Lock( *target, now, state ) )
+          return;
+
+        target->generation = treeGeneration;
+        target->baseLen    = baseLen;
+        target->expires = expires;
+        target->errNo   = errNo;
+        target->keyLen  = key.size();
+        target->dataLen = dataLen;
+        memcpy( target->key,  key.data(),  key.size() );
+        memcpy( target->data, data.data(), dataLen );
+        Unlock( *target, state );
+      }
+
+      //------------------------------------------------------------------------
+      // Expire all the keys of a base path
+      //------------------------------------------------------------------------
+      void Invalidate( const std::string &base, time_t now )
+      {
+        Slot *window = Window( base.data(), base.size() );
+        for( uint32_t i = 0; i < WindowSize; ++i )
+        {
+          Slot &slot = window[i];
+          if( slot.baseLen != base.size() ||
+              memcmp( slot.key, base.data(), base.size() ) )
+            continue;
+
+          uint64_t state;
+          if( !Lock( slot, now, state ) )
+            continue;
+          slot.expires = 0;
+          Unlock( slot, state );
+        }
+      }
+
+    private:
+      //------------------------------------------------------------------------
+      // Check whether the writer holding a slot is gone
+      //------------------------------------------------------------------------
+      static bool IsAbandoned( const Slot &slot, time_t now )
+      {
+        uint64_t state = slot.state;
+        return ( state & 1 ) &&
+               (uint32_t)now - (uint32_t)( state >> 32 ) >= StaleLock;
+      }
+
+      //------------------------------------------------------------------------
+      // Take a slot that is free or abandoned, the sequence stays odd
+      //------------------------------------------------------------------------
+      static bool Lock( Slot &slot, time_t now, uint64_t &state )
+      {
+        uint64_t old = slot.state;
+        uint32_t seq = (uint32_t)old;
+        if( seq & 1 )
+        {
+          if( !IsAbandoned( slot, now ) )
+            return false;
+          seq += 2;
+        }
+        else
+          ++seq;
+
+        state = ( (uint64_t)(uint32_t)now << 32 ) | seq;
+        return __sync_bool_compare_and_swap( &slot.state, old, state );
+      }
+
+      //------------------------------------------------------------------------
+      // Release a slot, unless somebody took it as abandoned in the meantime
+      //------------------------------------------------------------------------
+      static void Unlock( Slot &slot, uint64_t state )
+      {
+        uint64_t released = ( state & 0xffffffff00000000ULL ) |
+                            (uint32_t)( state + 1 );
+        __sync_bool_compare_and_swap( &slot.state, state, released );
+      }
+
+      Slot *Window( const char *base, size_t len )
+      {
+        uint32_t index = Hash( base, len ) % ( NumSlots / WindowSize );
+        return pSlots + index * WindowSize;
+      }
+
+      Header *pHeader;
+      Slot   *pSlots;
+      size_t  pSize;
+  };
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  MetadataCache::MetadataCache( uint32_t           statTTL,
+                                uint32_t           locateTTL,
+                                uint32_t           dirListTTL,
+                                uint32_t           negativeTTL,
+                                uint32_t           maxEntries,
+                                const std::string &shmPath ):
+    pStatTTL( statTTL ), pLocateTTL( locateTTL ), pDirListTTL( dirListTTL ),
+    pNegativeTTL( negativeTTL ), pMaxEntries( maxEntries ), pEpoch( 0 ),
+    pLastPublished( 0 ), pGeneration( 0 ), pTreeGeneration( 0 ), pShared( 0 )
+  {
+    if( !pMaxEntries )
+      pMaxEntries = 1;
+
+    if( !shmPath.empty() && pStatTTL )
+    {
+      pShared = new SharedTable();
+      if( !pShared->Map( shmPath ) )
+      {
+        Log *log = DefaultEnv::GetLog();
+        log->Error( UtilityMsg, "Unable to share the metadata cache through "
+                    "%s: %s", shmPath.c_str(), strerror( errno ) );
+        delete pShared;
+        pShared = 0;
+      }
+      else
+        pShared->GetGeneration( pGeneration, pTreeGeneration );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  MetadataCache::~MetadataCache()
+  {
+    std::list<Entry*>::iterator itr;
+    for( itr = pLRU.begin(); itr != pLRU.end(); ++itr )
+      delete *itr;
+    delete pShared;
+  }
+
+  //----------------------------------------------------------------------------
+  // Build the key of a request
+  //----------------------------------------------------------------------------
+  std::string MetadataCache::MakeKey( uint16_t           requestId,
+                                      const std::string &hostId,
+                                      const std::string &path,
+                                      uint32_t           options )
+  {
+    char type = 0;
+    switch( requestId )
+    {
+      case kXR_stat:    type = 's'; break;
+      case kXR_locate:  type = 'l'; break;
+      case kXR_dirlist: type = 'd'; break;
+    }
+
+    std::ostringstream o;
+    o << BasePath( path ) << '\0' << type << std::hex << options << '\0';
+    o << hostId << '\0' << path;
+    return o.str();
+  }
+
+  //----------------------------------------------------------------------------
+  // Look up a response
+  //----------------------------------------------------------------------------
+  bool MetadataCache::Lookup( const std::string  &key,
+                              XRootDStatus      *&status,
+                              AnyObject         *&response,
+                              HostList          *&hostList,
+                              uint64_t           &epoch )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    time_t now = ::time( 0 );
+    Sync();
+
+    std::map<std::string, Entry*>::iterator it = pEntries.find( key );
+    if( it != pEntries.end() && it->second->expires <= now )
+    {
+      Drop( it->second );
+      it = pEntries.end();
+    }
+
+    if( it != pEntries.end() )
+    {
+      Entry *entry = it->second;
+      pLRU.splice( pLRU.begin(), pLRU, entry->lru );
+
+      status   = new XRootDStatus( entry->status );
+      response = 0;
+      if( entry->statInfo )
+      {
+        response = new AnyObject();
+        response->Set( new StatInfo( *entry->statInfo ) );
+      }
+      else if( entry->locationInfo )
+      {
+        response = new AnyObject();
+        response->Set( new LocationInfo( *entry->locationInfo ) );
+      }
+      else if( entry->dirList )
+      {
+        response = new AnyObject();
+        response->Set( Copy( entry->dirList ) );
+      }
+      hostList = new HostList( entry->hosts );
+
+      ++pStats.hits;
+      if( !response ) ++pStats.negativeHits;
+      Publish( now );
+      return true;
+    }
+
+    //--------------------------------------------------------------------------
+    // Stat responses may have been stored by another process
+    //--------------------------------------------------------------------------
+    int32_t     errNo;
+    std::string data;
+    if( pShared && RequestOf( key ) == kXR_stat &&
+        pShared->Get( key, key.find( '\0' ), now, pTreeGeneration, errNo,
+                      data ) )
+    {
+      StatInfo *info = 0;
+      if( !errNo )
+      {
+        info = new StatInfo();
+        if( !info->ParseServerResponse( data.c_str() ) )
+        {
+          delete info;
+          info = 0;
+        }
+      }
+
+      if( errNo || info )
+      {
+        if( info )
+        {
+          status   = new XRootDStatus();
+          response = new AnyObject();
+          response->Set( info );
+        }
+        else
+        {
+          status   = new XRootDStatus( stError, errErrorResponse, errNo,
+                                       data );
+          response = 0;
+        }
+        hostList = new HostList();
+        hostList->push_back( HostInfo( URL( HostOf( key ) ) ) );
+
+        ++pStats.hits;
+        ++pStats.sharedHits;
+        if( !response ) ++pStats.negativeHits;
+        Publish( now );
+        return true;
+      }
+    }
+
+    ++pStats.misses;
+    epoch = pEpoch;
+    Publish( now );
+    return false;
+  }
+
+  //----------------------------------------------------------------------------
+  // Store a response
+  //----------------------------------------------------------------------------
+  void MetadataCache::Insert( const std::string  &key,
+                              uint64_t            epoch,
+                              const XRootDStatus *status,
+                              AnyObject          *response,
+                              const HostList     *hostList )
+  {
+    uint16_t requestId = RequestOf( key );
+    uint32_t ttl       = GetTTL( requestId );
+    bool     negative  = false;
+    if( !ttl || !status )
+      return;
+
+    if( !status->IsOK() )
+    {
+      if( status->code != errErrorResponse || status->errNo != kXR_NotFound ||
+          !pNegativeTTL )
+        return;
+      ttl      = pNegativeTTL;
+      negative = true;
+    }
+    else if( status->code != suDone || !response )
+      return;
+
+    //--------------------------------------------------------------------------
+    // Copy the response before taking the lock
+    //--------------------------------------------------------------------------
+    Entry *entry  = new Entry();
+    entry->key    = key;
+    entry->status = *status;
+    if( hostList )
+      entry->hosts = *hostList;
+
+    if( !negative )
+    {
+      switch( requestId )
+      {
+        case kXR_stat:
+        {
+          StatInfo *info = 0;
+          response->Get( info );
+          if( info ) entry->statInfo = new StatInfo( *info );
+          break;
+        }
+        case kXR_locate:
+        {
+          LocationInfo *info = 0;
+          response->Get( info );
+          if( info ) entry->locationInfo = new LocationInfo( *info );
+          break;
+        }
+        case kXR_dirlist:
+        {
+          DirectoryList *list = 0;
+          response->Get( list );
+          if( list ) entry->dirList = Copy( list );
+          break;
+        }
+      }
+
+      if( !entry->statInfo && !entry->locationInfo && !entry->dirList )
+      {
+        delete entry;
+        return;
+      }
+    }
+
+    XrdSysMutexHelper scopedLock( pMutex );
+    Sync();
+    if( epoch != pEpoch )
+    {
+      delete entry;
+      return;
+    }
+
+    time_t now = ::time( 0 );
+    entry->expires = now + ttl;
+
+    std::map<std::string, Entry*>::iterator it = pEntries.find( key );
+    if( it != pEntries.end() )
+      Drop( it->second );
+
+    pEntries[key] = entry;
+    pLRU.push_front( entry );
+    entry->lru = pLRU.begin();
+    ++pStats.inserts;
+
+    while( pEntries.size() > pMaxEntries )
+    {
+      Drop( pLRU.back() );
+      ++pStats.evictions;
+    }
+
+    if( pShared && requestId == kXR_stat )
+    {
+      if( negative )
+        pShared->Put( key, key.find( '\0' ), now, pTreeGeneration,
+                      entry->expires, status->errNo,
+                      status->GetErrorMessage() );
+      else
+        pShared->Put( key, key.find( '\0' ), now, pTreeGeneration,
+                      entry->expires, 0, ToString( entry->statInfo ) );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Drop the responses for the path, below it and for its parents
+  //----------------------------------------------------------------------------
+  void MetadataCache::Invalidate( const std::string &path, bool tree )
+  {
+    std::string base = BasePath( path );
+    if( base.empty() )
+      return;
+
+    XrdSysMutexHelper scopedLock( pMutex );
+    time_t now = ::time( 0 );
+    Sync();
+    ++pEpoch;
+    ++pStats.invalidations;
+
+    Erase( base + '\0' );
+    Erase( base == "/" ? base : base + '/' );
+    if( pShared )
+      pShared->Invalidate( base, now );
+
+    for( std::string parent = ParentPath( base ); !parent.empty();
+         parent = ParentPath( parent ) )
+    {
+      Erase( parent + '\0' );
+      if( pShared )
+        pShared->Invalidate( parent, now );
+    }
+
+    //--------------------------------------------------------------------------
+    // Tell the other processes, if nobody else did anything in the meantime
+    // there is no need to drop our own entries on the next sync
+    //--------------------------------------------------------------------------
+    if( pShared && pShared->AddGeneration( tree, pGeneration,
+                                           pTreeGeneration ) )
+    {
+      ++pGeneration;
+      if( tree ) ++pTreeGeneration;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the counters
+  //----------------------------------------------------------------------------
+  void MetadataCache::GetStats( Stats &stats )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    stats = pStats;
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the time to live of the responses to a request
+  //----------------------------------------------------------------------------
+  uint32_t MetadataCache::GetTTL( uint16_t requestId ) const
+  {
+    switch( requestId )
+    {
+      case kXR_stat:    return pStatTTL;
+      case kXR_locate:  return pLocateTTL;
+      case kXR_dirlist: return pDirListTTL;
+    }
+    return 0;
+  }
+
+  //----------------------------------------------------------------------------
+  // Drop all the entries if another process invalidated anything since the
+  // last time, the lock needs to be held
+  //----------------------------------------------------------------------------
+  void MetadataCache::Sync()
+  {
+    if( !pShared )
+      return;
+
+    uint32_t generation, treeGeneration;
+    pShared->GetGeneration( generation, treeGeneration );
+    if( generation == pGeneration )
+      return;
+
+    Erase( std::string() );
+    ++pEpoch;
+    pGeneration     = generation;
+    pTreeGeneration = treeGeneration;
+  }
+
+  //----------------------------------------------------------------------------
+  // Drop all the entries whose keys start with the prefix, the lock needs
+  // to be held
+  //----------------------------------------------------------------------------
+  void MetadataCache::Erase( const std::string &prefix )
+  {
+    std::map<std::string, Entry*>::iterator it = pEntries.lower_bound( prefix );
+    while( it != pEntries.end() &&
+           !it->first.compare( 0, prefix.size(), prefix ) )
+    {
+      Entry *entry = it->second;
+      ++it;
+      Drop( entry );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Drop an entry, the lock needs to be held
+  //----------------------------------------------------------------------------
+  void MetadataCache::Drop( Entry *entry )
+  {
+    pEntries.erase( entry->key );
+    pLRU.erase( entry->lru );
+    delete entry;
+  }
+
+  //----------------------------------------------------------------------------
+  // Make the counters available through the environment, at most once
+  // a second, the lock needs to be held
+  //----------------------------------------------------------------------------
+  void MetadataCache::Publish( time_t now )
+  {
+    if( now == pLastPublished )
+      return;
+    pLastPublished = now;
+
+    Env *env = DefaultEnv::GetEnv();
+    env->PutInt( "MetadataCacheHits",
+                 pStats.hits > INT_MAX ? INT_MAX : pStats.hits );
+    env->PutInt( "MetadataCacheNegativeHits",
+                 pStats.negativeHits > INT_MAX ? INT_MAX : pStats.negativeHits );
+    env->PutInt( "MetadataCacheMisses",
+                 pStats.misses > INT_MAX ? INT_MAX : pStats.misses );
+  }
+}
@@ -0,0 +1,195 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_METADATA_CACHE_HH__
+#define __XRD_CL_METADATA_CACHE_HH__
+
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <stdint.h>
+#include <time.h>
+#include <string>
+#include <list>
+#include <map>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Process wide cache of the responses to the metadata requests of
+  //! FileSystem: stat, locate and dirlist.
+  //!
+  //! Each request type is kept for its own time to live, "not found"
+  //! answers are kept for the negative time to live. The mutations done
+  //! through FileSystem (rm, mv, mkdir, rmdir, truncate, chmod) drop
+  //! everything this process cached for the path, below it and for its
+  //! parent directories. The stat responses may also be kept in a file
+  //! mapped in shared memory, so that all the processes on a node naming
+  //! the same file share them. The processes sharing the file also drop
+  //! everything they cached privately whenever one of them changes
+  //! anything, and the shared responses below a moved or removed directory.
+  //! Changes made by processes not sharing the file, or by other clients,
+  //! are only seen once the responses expire. Enabled by setting any of the
+  //! XRD_METADATACACHE*TTL variables.
+  //----------------------------------------------------------------------------
+  class MetadataCache
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Cache counters
+      //------------------------------------------------------------------------
+      struct Stats
+      {
+        Stats(): hits(0), negativeHits(0), sharedHits(0), misses(0),
+                 inserts(0), evictions(0), invalidations(0) {}
+        uint64_t hits;           //!< responses served from the cache
+        uint64_t negativeHits;   //!< of which "not found" responses
+        uint64_t sharedHits;     //!< of which found in the shared memory
+        uint64_t misses;         //!< requests sent to the server
+        uint64_t inserts;        //!< responses stored
+        uint64_t evictions;      //!< responses dropped to make room
+        uint64_t invalidations;  //!< paths invalidated by mutations
+      };
+
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param statTTL     time to live of stat responses [s], 0 disables
+      //! @param locateTTL   time to live of locate responses [s], 0 disables
+      //! @param dirListTTL  time to live of dirlist responses [s], 0
+      //!                    disables
+      //! @param negativeTTL time to live of "not found" responses [s], 0
+      //!                    disables
+      //! @param maxEntries  maximum number of responses kept in memory
+      //! @param shmPath     file to map for sharing the stat responses
+      //!                    between processes, empty for none
+      //------------------------------------------------------------------------
+      MetadataCache( uint32_t           statTTL,
+                     uint32_t           locateTTL,
+                     uint32_t           dirListTTL,
+                     uint32_t           negativeTTL,
+                     uint32_t           maxEntries,
+                     const std::string &shmPath );
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~MetadataCache();
+
+      //------------------------------------------------------------------------
+      //! Check whether the responses to the given request are cached
+      //!
+      //! @param requestId kXR_stat, kXR_locate or kXR_dirlist
+      //------------------------------------------------------------------------
+      bool IsCached( uint16_t requestId ) const
+      {
+        return GetTTL( requestId ) != 0;
+      }
+
+      //------------------------------------------------------------------------
+      //! Build the key of a request
+      //!
+      //! @param requestId kXR_stat, kXR_locate or kXR_dirlist
+      //! @param hostId    the server the request is sent to
+      //! @param path      the path as sent to the server, with the cgi
+      //! @param options   request options that change the response
+      //------------------------------------------------------------------------
+      static std::string MakeKey( uint16_t           requestId,
+                                  const std::string &hostId,
+                                  const std::string &path,
+                                  uint32_t           options );
+
+      //------------------------------------------------------------------------
+      //! Look up a response
+      //!
+      //! @param key      key of the request
+      //! @param status   the status of the response if found
+      //! @param response a copy of the response if found, 0 for a "not
+      //!                 found" response
+      //! @param hostList a copy of the hosts that were contacted if found
+      //! @param epoch    to be passed to Insert if not found
+      //! @return         true if found
+      //------------------------------------------------------------------------
+      bool Lookup( const std::string  &key,
+                   XRootDStatus      *&status,
+                   AnyObject         *&response,
+                   HostList          *&hostList,
+                   uint64_t           &epoch );
+
+      //------------------------------------------------------------------------
+      //! Store a response, ignored if it is not cacheable or if any path got
+      //! invalidated since the lookup
+      //!
+      //! @param key      key of the request
+      //! @param epoch    as returned by Lookup
+      //! @param status   status of the response
+      //! @param response the response, copied
+      //! @param hostList the hosts that were contacted, copied
+      //------------------------------------------------------------------------
+      void Insert( const std::string  &key,
+                   uint64_t            epoch,
+                   const XRootDStatus *status,
+                   AnyObject          *response,
+                   const HostList     *hostList );
+
+      //------------------------------------------------------------------------
+      //! Drop the responses for the path, for everything below it and for
+      //! its parent directories
+      //!
+      //! @param path the changed path
+      //! @param tree true if the path may be a directory that got moved or
+      //!             removed, the shared responses below it are dropped too
+      //------------------------------------------------------------------------
+      void Invalidate( const std::string &path, bool tree = false );
+
+      //------------------------------------------------------------------------
+      //! Get the counters
+      //------------------------------------------------------------------------
+      void GetStats( Stats &stats );
+
+      //------------------------------------------------------------------------
+      //! Internals, defined in the implementation
+      //------------------------------------------------------------------------
+      struct Entry;
+      class  SharedTable;
+
+    private:
+      uint32_t GetTTL( uint16_t requestId ) const;
+      void     Erase( const std::string &prefix );
+      void     Drop( Entry *entry );
+      void     Publish( time_t now );
+      void     Sync();
+
+      XrdSysMutex                   pMutex;
+      uint32_t                      pStatTTL;
+      uint32_t                      pLocateTTL;
+      uint32_t                      pDirListTTL;
+      uint32_t                      pNegativeTTL;
+      uint32_t                      pMaxEntries;
+      uint64_t                      pEpoch;
+      time_t                        pLastPublished;
+      uint32_t                      pGeneration;
+      uint32_t                      pTreeGeneration;
+      std::map<std::string, Entry*> pEntries;
+      std::list<Entry*>             pLRU;
+      SharedTable                  *pShared;
+      Stats                         pStats;
+  };
+}
+
+#endif // __XRD_CL_METADATA_CACHE_HH__
@@ -94,6 +94,33 @@ namespace XrdCl
         Status      status;  //!< Disconnection status
       };
 
+      //------------------------------------------------------------------------
+      //! Describe a substream event, substreams other than the main one
+      //! report when they are opened and closed, all the connected
+      //! substreams report their throughput every timeout resolution
+      //------------------------------------------------------------------------
+      struct SubStreamInfo
+      {
+        enum Action
+        {
+          Opened = 0,   //!< Substream connected
+          Closed,       //!< Substream closed, idle or broken
+          Stats         //!< Periodic throughput report
+        };
+
+        SubStreamInfo(): subStream(0), action(Stats), rBytes(0), sBytes(0),
+                         rRate(0), sRate(0), pending(0), active(0) {}
+        std::string server;     //!< "user@host:port"
+        uint16_t    subStream;  //!< Substream number, 0 is the main stream
+        Action      action;     //!< What happened
+        uint64_t    rBytes;     //!< Bytes received since connected
+        uint64_t    sBytes;     //!< Bytes sent since connected
+        uint64_t    rRate;      //!< Bytes/s received since the last report
+        uint64_t    sRate;      //!< Bytes/s sent since the last report
+        uint64_t    pending;    //!< Response bytes still expected
+        uint16_t    active;     //!< Number of connected substreams
+      };
+
       //------------------------------------------------------------------------
       //! Describe a file open event to the monitor
       //------------------------------------------------------------------------
@@ -218,7 +245,8 @@ namespace XrdCl
         EvClose,          //!< CloseInfo: File closed
         EvErrIO,          //!< ErrorInfo: An I/O error occurred
         EvConnect,        //!< ConnectInfo: Login  into a server
-        EvDisconnect      //!< DisconnectInfo: Logout from a server
+        EvDisconnect,     //!< DisconnectInfo: Logout from a server
+        EvSubStream       //!< SubStreamInfo: Substream opened, closed or stats
 
       };
 
@@ -0,0 +1,855 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClReadCache.hh"
+#include "XrdCl/XrdClFileStateHandler.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClPostMaster.hh"
+#include "XrdCl/XrdClJobManager.hh"
+#include "XrdCl/XrdClResponseJob.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClLog.hh"
+
+#include <algorithm>
+#include <cstring>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // A block of a file
+  //----------------------------------------------------------------------------
+  struct ReadCache::Block
+  {
+    enum State
+    {
+      Pending,    // being fetched
+      Ready,      // holds the data
+      Failed      // could not be fetched, not in the cache anymore
+    };
+
+    Block( Entry *e, uint64_t i, char *d ):
+      entry( e ), index( i ), data( d ), length( 0 ), state( Pending ),
+      pins( 0 ), readAhead( false ), inLRU( false ) {}
+
+    Entry                       *entry;
+    uint64_t                     index;
+    char                        *data;
+    uint32_t                     length;     // less than the block size at
+                                             // the end of the file
+    State                        state;
+    uint32_t                     pins;       // requests using the block
+    bool                         readAhead;  // fetched ahead, not used yet
+    bool                         inLRU;
+    std::list<Block*>::iterator  lru;
+    std::vector<Request*>        waiters;
+  };
+
+  //----------------------------------------------------------------------------
+  // The cached blocks of a file
+  //----------------------------------------------------------------------------
+  struct ReadCache::Entry
+  {
+    Entry( const std::string &k ): key( k ), users( 0 ) {}
+
+    std::string                 key;
+    std::map<uint64_t, Block*>  blocks;
+    uint32_t                    users;       // files reading through it
+  };
+
+  //----------------------------------------------------------------------------
+  // A user request waiting for the blocks
+  //----------------------------------------------------------------------------
+  struct ReadCache::Request
+  {
+    Request( ResponseHandler *h ):
+      handler( h ), pending( 0 ), vector( false ), offset( 0 ), size( 0 ),
+      buffer( 0 ) {}
+
+    ResponseHandler      *handler;
+    uint32_t              pending;           // blocks not there yet
+    XRootDStatus          status;
+    bool                  vector;
+    uint64_t              offset;            // read
+    uint32_t              size;
+    char                 *buffer;
+    ChunkList             chunks;            // vector read
+    std::vector<Block*>   blocks;            // ordered by index
+  };
+}
+
+namespace
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Maximum number of chunks of a vector read accepted by the servers
+  //----------------------------------------------------------------------------
+  const uint32_t MaxVectorChunks = 1024;
+
+  //----------------------------------------------------------------------------
+  // Vector reads that would need to fetch more than this many times the
+  // data they ask for bypass the cache, their chunks tend to be small and
+  // scattered and chosen by a reader that knows what it needs
+  //----------------------------------------------------------------------------
+  const uint32_t MaxVectorOverhead = 4;
+
+  //----------------------------------------------------------------------------
+  // Order the blocks by index
+  //----------------------------------------------------------------------------
+  bool IndexLess( const ReadCache::Block *block, uint64_t index )
+  {
+    return block->index < index;
+  }
+
+  //----------------------------------------------------------------------------
+  // Hand the fetched blocks over to the file
+  //----------------------------------------------------------------------------
+  class FetchHandler: public ResponseHandler
+  {
+    public:
+      FetchHandler( FileReadCache                        *file,
+                    const std::vector<ReadCache::Block*> &blocks ):
+        pFile( file ), pBlocks( blocks ) {}
+
+      virtual void HandleResponse( XRootDStatus *status, AnyObject *response )
+      {
+        std::vector<uint32_t> lengths( pBlocks.size(), 0 );
+        if( status->IsOK() && response )
+        {
+          if( pBlocks.size() == 1 )
+          {
+            ChunkInfo *chunk = 0;
+            response->Get( chunk );
+            if( chunk )
+              lengths[0] = chunk->length;
+          }
+          else
+          {
+            VectorReadInfo *info = 0;
+            response->Get( info );
+            if( info )
+            {
+              ChunkList &chunks = info->GetChunks();
+              for( size_t i = 0; i < chunks.size() && i < lengths.size(); ++i )
+                lengths[i] = chunks[i].length;
+            }
+          }
+        }
+
+        pFile->Fetched( pBlocks, *status, lengths );
+        delete status;
+        delete response;
+        delete this;
+      }
+
+    private:
+      FileReadCache                  *pFile;
+      std::vector<ReadCache::Block*>  pBlocks;
+  };
+
+  //----------------------------------------------------------------------------
+  // Call the user handler from the job manager
+  //----------------------------------------------------------------------------
+  void Respond( ResponseHandler *handler, XRootDStatus *status,
+                AnyObject *response )
+  {
+    JobManager *jobMgr = DefaultEnv::GetPostMaster()->GetJobManager();
+    jobMgr->QueueJob( new ResponseJob( handler, status, response, 0 ) );
+  }
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  ReadCache::ReadCache( uint64_t size, uint32_t blockSize,
+                        uint32_t readAheadBlocks ):
+    pBlockSize( blockSize ), pReadAheadBlocks( readAheadBlocks ), pBlocks( 0 )
+  {
+    if( pBlockSize < MinBlockSize ) pBlockSize = MinBlockSize;
+    if( pBlockSize > MaxBlockSize ) pBlockSize = MaxBlockSize;
+    pMaxBlocks = size / pBlockSize;
+    if( !pMaxBlocks )
+      pMaxBlocks = 1;
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  ReadCache::~ReadCache()
+  {
+    std::map<std::string, Entry*>::iterator it;
+    for( it = pEntries.begin(); it != pEntries.end(); ++it )
+    {
+      std::map<uint64_t, Block*>::iterator itB;
+      for( itB = it->second->blocks.begin(); itB != it->second->blocks.end();
+           ++itB )
+      {
+        delete [] itB->second->data;
+        delete itB->second;
+      }
+      delete it->second;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the counters
+  //----------------------------------------------------------------------------
+  void ReadCache::GetStats( Stats &stats )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    stats = pStats;
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the entry of a file
+  //----------------------------------------------------------------------------
+  ReadCache::Entry *ReadCache::Attach( const std::string &key )
+  {
+    Entry *&entry = pEntries[key];
+    if( !entry )
+      entry = new Entry( key );
+    ++entry->users;
+    return entry;
+  }
+
+  //----------------------------------------------------------------------------
+  // Release the entry of a file, its blocks stay in the cache
+  //----------------------------------------------------------------------------
+  void ReadCache::Detach( Entry *entry )
+  {
+    if( --entry->users || !entry->blocks.empty() )
+      return;
+    pEntries.erase( entry->key );
+    delete entry;
+  }
+
+  //----------------------------------------------------------------------------
+  // Find a block
+  //----------------------------------------------------------------------------
+  ReadCache::Block *ReadCache::Find( Entry *entry, uint64_t index )
+  {
+    std::map<uint64_t, Block*>::iterator it = entry->blocks.find( index );
+    if( it == entry->blocks.end() )
+      return 0;
+    return it->second;
+  }
+
+  //----------------------------------------------------------------------------
+  // Make room for the given number of blocks
+  //----------------------------------------------------------------------------
+  bool ReadCache::Reserve( uint64_t blocks )
+  {
+    while( pBlocks + blocks > pMaxBlocks && !pLRU.empty() )
+    {
+      Block *block = pLRU.back();
+      pLRU.pop_back();
+      block->inLRU = false;
+      Drop( block );
+      Free( block );
+      ++pStats.evictions;
+    }
+    return pBlocks + blocks <= pMaxBlocks;
+  }
+
+  //----------------------------------------------------------------------------
+  // Add a block waiting to be fetched
+  //----------------------------------------------------------------------------
+  ReadCache::Block *ReadCache::Allocate( Entry *entry, uint64_t index )
+  {
+    Block *block = new Block( entry, index, new char[pBlockSize] );
+    entry->blocks[index] = block;
+    ++pBlocks;
+    return block;
+  }
+
+  //----------------------------------------------------------------------------
+  // Keep the block in the cache while in use
+  //----------------------------------------------------------------------------
+  void ReadCache::Pin( Block *block )
+  {
+    if( block->inLRU )
+    {
+      pLRU.erase( block->lru );
+      block->inLRU = false;
+    }
+    ++block->pins;
+  }
+
+  //----------------------------------------------------------------------------
+  // The block is not used by the request anymore
+  //----------------------------------------------------------------------------
+  void ReadCache::Unpin( Block *block )
+  {
+    if( !--block->pins )
+      Settle( block );
+  }
+
+  //----------------------------------------------------------------------------
+  // Put a block nobody uses where it belongs: at the front of the LRU list
+  // if it holds data, away if it could not be fetched
+  //----------------------------------------------------------------------------
+  void ReadCache::Settle( Block *block )
+  {
+    if( block->state == Block::Ready )
+    {
+      pLRU.push_front( block );
+      block->lru   = pLRU.begin();
+      block->inLRU = true;
+    }
+    else if( block->state == Block::Failed )
+      Free( block );
+  }
+
+  //----------------------------------------------------------------------------
+  // Remove the block from its file
+  //----------------------------------------------------------------------------
+  void ReadCache::Drop( Block *block )
+  {
+    Entry *entry = block->entry;
+    entry->blocks.erase( block->index );
+    if( entry->blocks.empty() && !entry->users )
+    {
+      pEntries.erase( entry->key );
+      delete entry;
+    }
+    block->entry = 0;
+  }
+
+  //----------------------------------------------------------------------------
+  // Release the memory of a block
+  //----------------------------------------------------------------------------
+  void ReadCache::Free( Block *block )
+  {
+    delete [] block->data;
+    delete block;
+    --pBlocks;
+  }
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  FileReadCache::FileReadCache( ReadCache         *cache,
+                                FileStateHandler  *file,
+                                const std::string &key,
+                                uint64_t           size ):
+    pCache( cache ), pFile( file ), pEntry( 0 ), pSize( size ),
+    pLastBlock( -1 ), pWindow( 0 ), pReadAheadEnd( 0 ), pHits( 0 ),
+    pMisses( 0 ), pInFlight( 0 ), pClosing( false ), pCloseHandler( 0 ),
+    pCloseTimeout( 0 ), pCond( 0 )
+  {
+    XrdSysMutexHelper scopedLock( pCache->pMutex );
+    pEntry = pCache->Attach( key );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  FileReadCache::~FileReadCache()
+  {
+    Drain();
+
+    XrdSysMutexHelper scopedLock( pCache->pMutex );
+    Log *log = DefaultEnv::GetLog();
+    if( log )
+      log->Debug( FileMsg, "[0x%x@%s] Read cache: %llu block hits, %llu block "
+                  "misses", pFile, pEntry->key.c_str(),
+                  (unsigned long long)pHits, (unsigned long long)pMisses );
+    pCache->Detach( pEntry );
+  }
+
+  //----------------------------------------------------------------------------
+  // Read a data chunk at a given offset - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileReadCache::Read( uint64_t         offset,
+                                    uint32_t         size,
+                                    void            *buffer,
+                                    ResponseHandler *handler,
+                                    uint16_t         timeout )
+  {
+    if( !pFile->IsOpen() )
+      return XRootDStatus( stError, errInvalidOp );
+
+    //--------------------------------------------------------------------------
+    // What reaches past the end of the file goes to the server, the file
+    // may have grown since it has been opened
+    //--------------------------------------------------------------------------
+    if( !size || offset + size > pSize )
+    {
+      Bypassed();
+      return pFile->Read( offset, size, buffer, handler, timeout );
+    }
+
+    uint32_t              blockSize = pCache->GetBlockSize();
+    uint64_t              first     = offset / blockSize;
+    uint64_t              last      = (offset + size - 1) / blockSize;
+    std::vector<uint64_t> indices;
+    for( uint64_t i = first; i <= last; ++i )
+      indices.push_back( i );
+
+    ReadCache::Request *req = new ReadCache::Request( handler );
+    req->offset = offset;
+    req->size   = size;
+    req->buffer = (char*)buffer;
+
+    std::vector<ReadCache::Block*> fetch;
+    std::vector<ReadCache::Block*> readAhead;
+    bool                           ready = false;
+    {
+      XrdSysMutexHelper scopedLock( pCache->pMutex );
+      if( Collect( req, indices, (uint64_t)-1, fetch ) )
+      {
+        ReadAhead( first, last, readAhead );
+        ready = !req->pending;
+      }
+      else
+      {
+        ++pCache->pStats.bypassed;
+        delete req;
+        req = 0;
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    // The cache is full of blocks in use
+    //--------------------------------------------------------------------------
+    if( !req )
+      return pFile->Read( offset, size, buffer, handler, timeout );
+
+    Fetch( fetch, timeout );
+    Fetch( readAhead, timeout );
+    if( ready )
+      Complete( req );
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Read scattered data chunks in one operation - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileReadCache::VectorRead( const ChunkList &chunks,
+                                          void            *buffer,
+                                          ResponseHandler *handler,
+                                          uint16_t         timeout )
+  {
+    if( !pFile->IsOpen() )
+      return XRootDStatus( stError, errInvalidOp );
+
+    //--------------------------------------------------------------------------
+    // Figure out where the data goes and which blocks are needed
+    //--------------------------------------------------------------------------
+    uint32_t               blockSize = pCache->GetBlockSize();
+    uint64_t               requested = 0;
+    char                  *cursor    = (char*)buffer;
+    bool                   bypass    = chunks.empty();
+    std::vector<uint64_t>  indices;
+    ReadCache::Request    *req       = new ReadCache::Request( handler );
+    req->vector = true;
+
+    for( size_t i = 0; i < chunks.size(); ++i )
+    {
+      const ChunkInfo &chunk       = chunks[i];
+      char            *chunkBuffer = cursor ? cursor : (char*)chunk.buffer;
+      if( cursor )
+        cursor += chunk.length;
+
+      if( !chunkBuffer || chunk.offset + chunk.length > pSize )
+      {
+        bypass = true;
+        break;
+      }
+
+      req->chunks.push_back( ChunkInfo( chunk.offset, chunk.length,
+                                        chunkBuffer ) );
+      requested += chunk.length;
+      if( !chunk.length )
+        continue;
+
+      uint64_t last = (chunk.offset + chunk.length - 1) / blockSize;
+      for( uint64_t b = chunk.offset / blockSize; b <= last; ++b )
+        indices.push_back( b );
+    }
+
+    std::sort( indices.begin(), indices.end() );
+    indices.erase( std::unique( indices.begin(), indices.end() ),
+                   indices.end() );
+
+    std::vector<ReadCache::Block*> fetch;
+    bool                           ready = false;
+    if( !bypass )
+    {
+      XrdSysMutexHelper scopedLock( pCache->pMutex );
+      uint64_t maxMissing = MaxVectorOverhead * requested / blockSize;
+      if( Collect( req, indices, maxMissing, fetch ) )
+        ready = !req->pending;
+      else
+        bypass = true;
+    }
+
+    if( bypass )
+    {
+      delete req;
+      Bypassed();
+      return pFile->VectorRead( chunks, buffer, handler, timeout );
+    }
+
+    Fetch( fetch, timeout );
+    if( ready )
+      Complete( req );
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Wait until the blocks requested for this file have arrived
+  //----------------------------------------------------------------------------
+  void FileReadCache::Drain()
+  {
+    XrdSysCondVarHelper scopedLock( pCond );
+    while( pInFlight )
+      pCond.Wait();
+  }
+
+  //----------------------------------------------------------------------------
+  // Close the file once the blocks requested for it have arrived
+  //----------------------------------------------------------------------------
+  bool FileReadCache::CloseWhenDrained( ResponseHandler *handler,
+                                        uint16_t         timeout )
+  {
+    XrdSysCondVarHelper scopedLock( pCond );
+    if( !pInFlight )
+      return false;
+    pClosing      = true;
+    pCloseHandler = handler;
+    pCloseTimeout = timeout;
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Called when blocks have been fetched
+  //----------------------------------------------------------------------------
+  void FileReadCache::Fetched( std::vector<ReadCache::Block*> &blocks,
+                               const XRootDStatus             &status,
+                               const std::vector<uint32_t>    &lengths )
+  {
+    std::vector<ReadCache::Request*> done;
+    {
+      XrdSysMutexHelper scopedLock( pCache->pMutex );
+      for( size_t i = 0; i < blocks.size(); ++i )
+      {
+        ReadCache::Block *block = blocks[i];
+        if( status.IsOK() )
+        {
+          block->state  = ReadCache::Block::Ready;
+          block->length = lengths[i];
+          pCache->pStats.bytesFetched += lengths[i];
+        }
+        else
+        {
+          block->state = ReadCache::Block::Failed;
+          pCache->Drop( block );
+        }
+
+        for( size_t j = 0; j < block->waiters.size(); ++j )
+        {
+          ReadCache::Request *req = block->waiters[j];
+          if( !status.IsOK() )
+            req->status = status;
+          if( !--req->pending )
+            done.push_back( req );
+        }
+        block->waiters.clear();
+
+        //----------------------------------------------------------------------
+        // Read ahead, nobody is waiting for it yet
+        //----------------------------------------------------------------------
+        if( !block->pins )
+          pCache->Settle( block );
+      }
+    }
+
+    for( size_t i = 0; i < done.size(); ++i )
+      Complete( done[i] );
+
+    {
+      XrdSysCondVarHelper scopedLock( pCond );
+      if( --pInFlight )
+        return;
+      pCond.Broadcast();
+      if( !pClosing )
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // These were the last blocks the close of the file was waiting for
+    //--------------------------------------------------------------------------
+    FileStateHandler *file    = pFile;
+    ResponseHandler  *handler = pCloseHandler;
+    uint16_t          timeout = pCloseTimeout;
+    delete this;
+
+    XRootDStatus st = file->SendClose( handler, timeout );
+    if( !st.IsOK() && handler )
+      handler->HandleResponse( new XRootDStatus( st ), 0 );
+  }
+
+  //----------------------------------------------------------------------------
+  // Pin the blocks needed by the request and allocate the missing ones,
+  // fails if more than maxMissing blocks are missing or there is no room
+  // for them, the cache lock must be held
+  //----------------------------------------------------------------------------
+  bool FileReadCache::Collect( ReadCache::Request             *req,
+                               const std::vector<uint64_t>    &indices,
+                               uint64_t                        maxMissing,
+                               std::vector<ReadCache::Block*> &fetch )
+  {
+    //--------------------------------------------------------------------------
+    // Pin what we have first so that it does not get evicted to make room
+    // for the rest
+    //--------------------------------------------------------------------------
+    std::vector<ReadCache::Block*> blocks( indices.size(), 0 );
+    uint64_t                       missing = 0;
+    for( size_t i = 0; i < indices.size(); ++i )
+    {
+      blocks[i] = pCache->Find( pEntry, indices[i] );
+      if( blocks[i] )
+        pCache->Pin( blocks[i] );
+      else
+        ++missing;
+    }
+
+    if( missing > maxMissing || !pCache->Reserve( missing ) )
+    {
+      for( size_t i = 0; i < blocks.size(); ++i )
+        if( blocks[i] )
+          pCache->Unpin( blocks[i] );
+      return false;
+    }
+
+    for( size_t i = 0; i < indices.size(); ++i )
+    {
+      ReadCache::Block *block = blocks[i];
+      if( block )
+      {
+        ++pCache->pStats.hits;
+        ++pHits;
+        if( block->readAhead )
+        {
+          block->readAhead = false;
+          ++pCache->pStats.readAheadHits;
+        }
+      }
+      else
+      {
+        block = pCache->Allocate( pEntry, indices[i] );
+        pCache->Pin( block );
+        fetch.push_back( block );
+        ++pCache->pStats.misses;
+        ++pMisses;
+      }
+
+      if( block->state == ReadCache::Block::Pending )
+      {
+        block->waiters.push_back( req );
+        ++req->pending;
+      }
+      req->blocks.push_back( block );
+    }
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Decide what to read ahead, the window doubles every time the reader
+  // moves on to the next block and collapses when it jumps elsewhere, the
+  // cache lock must be held
+  //----------------------------------------------------------------------------
+  void FileReadCache::ReadAhead( uint64_t                        first,
+                                 uint64_t                        last,
+                                 std::vector<ReadCache::Block*> &fetch )
+  {
+    uint32_t maxWindow = pCache->pReadAheadBlocks;
+    if( (int64_t)first == pLastBlock + 1 )
+      pWindow = std::min( pWindow ? 2 * pWindow : 1, maxWindow );
+    else if( (int64_t)first != pLastBlock )
+    {
+      pWindow       = 0;
+      pReadAheadEnd = 0;
+    }
+    pLastBlock = last;
+
+    if( !pWindow )
+      return;
+
+    uint64_t lastBlock = (pSize - 1) / pCache->GetBlockSize();
+    uint64_t begin     = std::max( last + 1, pReadAheadEnd );
+    uint64_t end       = std::min( last + pWindow, lastBlock );
+    uint64_t i;
+    for( i = begin; i <= end; ++i )
+    {
+      if( pCache->Find( pEntry, i ) )
+        continue;
+      if( !pCache->Reserve( 1 ) )
+        break;
+
+      ReadCache::Block *block = pCache->Allocate( pEntry, i );
+      block->readAhead = true;
+      fetch.push_back( block );
+      ++pCache->pStats.readAheads;
+    }
+    if( i > pReadAheadEnd )
+      pReadAheadEnd = i;
+  }
+
+  //----------------------------------------------------------------------------
+  // Fetch the blocks, one vector read per MaxVectorChunks blocks
+  //----------------------------------------------------------------------------
+  void FileReadCache::Fetch( std::vector<ReadCache::Block*> &blocks,
+                             uint16_t                        timeout )
+  {
+    uint32_t blockSize = pCache->GetBlockSize();
+    for( size_t i = 0; i < blocks.size(); i += MaxVectorChunks )
+    {
+      size_t end = std::min( blocks.size(), i + MaxVectorChunks );
+      std::vector<ReadCache::Block*> group( blocks.begin() + i,
+                                            blocks.begin() + end );
+      ChunkList chunks;
+      for( size_t j = 0; j < group.size(); ++j )
+      {
+        uint64_t offset = group[j]->index * blockSize;
+        uint32_t length = std::min( (uint64_t)blockSize, pSize - offset );
+        chunks.push_back( ChunkInfo( offset, length, group[j]->data ) );
+      }
+
+      {
+        XrdSysCondVarHelper scopedLock( pCond );
+        ++pInFlight;
+      }
+
+      FetchHandler *handler = new FetchHandler( this, group );
+      XRootDStatus  st;
+      if( chunks.size() == 1 )
+        st = pFile->Read( chunks[0].offset, chunks[0].length,
+                          chunks[0].buffer, handler, timeout );
+      else
+        st = pFile->VectorRead( chunks, 0, handler, timeout );
+
+      if( !st.IsOK() )
+        handler->HandleResponse( new XRootDStatus( st ), 0 );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // All the blocks of the request are there, copy the data out and
+  // respond
+  //----------------------------------------------------------------------------
+  void FileReadCache::Complete( ReadCache::Request *req )
+  {
+    uint64_t bytes = 0;
+    if( req->status.IsOK() )
+    {
+      bool ok = true;
+      if( !req->vector )
+      {
+        ok    = Copy( req, req->offset, req->size, req->buffer );
+        bytes = req->size;
+      }
+      else
+      {
+        for( size_t i = 0; i < req->chunks.size() && ok; ++i )
+        {
+          ChunkInfo &chunk = req->chunks[i];
+          ok     = Copy( req, chunk.offset, chunk.length, (char*)chunk.buffer );
+          bytes += chunk.length;
+        }
+      }
+
+      //------------------------------------------------------------------------
+      // Got less than expected, the file has been truncated
+      //------------------------------------------------------------------------
+      if( !ok )
+        req->status = XRootDStatus( stError, errDataError, 0,
+                                    "File shrunk while read through the "
+                                    "cache" );
+    }
+
+    {
+      XrdSysMutexHelper scopedLock( pCache->pMutex );
+      for( size_t i = 0; i < req->blocks.size(); ++i )
+        pCache->Unpin( req->blocks[i] );
+      if( req->status.IsOK() )
+        pCache->pStats.bytesRead += bytes;
+    }
+
+    XRootDStatus *status   = new XRootDStatus( req->status );
+    AnyObject    *response = 0;
+    if( status->IsOK() )
+    {
+      response = new AnyObject();
+      if( !req->vector )
+        response->Set( new ChunkInfo( req->offset, req->size, req->buffer ) );
+      else
+      {
+        VectorReadInfo *info = new VectorReadInfo();
+        info->SetSize( bytes );
+        info->GetChunks() = req->chunks;
+        response->Set( info );
+      }
+    }
+
+    Respond( req->handler, status, response );
+    delete req;
+  }
+
+  //----------------------------------------------------------------------------
+  // Copy the data of the request blocks to the buffer
+  //----------------------------------------------------------------------------
+  bool FileReadCache::Copy( ReadCache::Request *req,
+                            uint64_t            offset,
+                            uint32_t            length,
+                            char               *buffer )
+  {
+    uint32_t blockSize = pCache->GetBlockSize();
+    while( length )
+    {
+      uint64_t index   = offset / blockSize;
+      uint32_t inBlock = offset - index * blockSize;
+      uint32_t toCopy  = std::min( length, blockSize - inBlock );
+
+      std::vector<ReadCache::Block*>::iterator it;
+      it = std::lower_bound( req->blocks.begin(), req->blocks.end(), index,
+                             IndexLess );
+      if( it == req->blocks.end() || (*it)->index != index ||
+          inBlock + toCopy > (*it)->length )
+        return false;
+
+      memcpy( buffer, (*it)->data + inBlock, toCopy );
+      buffer += toCopy;
+      offset += toCopy;
+      length -= toCopy;
+    }
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Count a request sent to the server directly
+  //----------------------------------------------------------------------------
+  void FileReadCache::Bypassed()
+  {
+    XrdSysMutexHelper scopedLock( pCache->pMutex );
+    ++pCache->pStats.bypassed;
+  }
+}
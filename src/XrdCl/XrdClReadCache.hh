@@ -0,0 +1,224 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_READ_CACHE_HH__
+#define __XRD_CL_READ_CACHE_HH__
+
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <stdint.h>
+#include <string>
+#include <list>
+#include <map>
+#include <vector>
+
+namespace XrdCl
+{
+  class FileStateHandler;
+  class FileReadCache;
+
+  //----------------------------------------------------------------------------
+  //! Process wide cache of file blocks, shared by all the File objects
+  //! reading the same file.
+  //!
+  //! Files opened for reading are cached in blocks of a fixed size, the
+  //! blocks that are not in use are evicted in the least recently used
+  //! order when the cache is full. A file is identified by its location,
+  //! size and modification time as returned by the open, so that a file
+  //! that has changed is not served from stale blocks. Enabled by setting
+  //! XRD_READCACHESIZE.
+  //----------------------------------------------------------------------------
+  class ReadCache
+  {
+    friend class FileReadCache;
+
+    public:
+      static const uint32_t MinBlockSize = 4096;
+      static const uint32_t MaxBlockSize = 1048576;
+
+      //------------------------------------------------------------------------
+      //! Cache counters
+      //------------------------------------------------------------------------
+      struct Stats
+      {
+        Stats(): hits(0), misses(0), readAheads(0), readAheadHits(0),
+                 evictions(0), bypassed(0), bytesRead(0), bytesFetched(0) {}
+        uint64_t hits;           //!< blocks found in the cache
+        uint64_t misses;         //!< blocks fetched on demand
+        uint64_t readAheads;     //!< blocks fetched ahead of time
+        uint64_t readAheadHits;  //!< blocks fetched ahead and used later on
+        uint64_t evictions;      //!< blocks dropped to make room
+        uint64_t bypassed;       //!< requests sent to the server directly
+        uint64_t bytesRead;      //!< bytes served through the cache
+        uint64_t bytesFetched;   //!< bytes fetched from the servers
+      };
+
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param size            maximum amount of memory used for blocks
+      //! @param blockSize       size of a block, between MinBlockSize and
+      //!                        MaxBlockSize
+      //! @param readAheadBlocks maximum number of blocks fetched ahead of
+      //!                        a sequential reader, 0 disables readahead
+      //------------------------------------------------------------------------
+      ReadCache( uint64_t size, uint32_t blockSize, uint32_t readAheadBlocks );
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~ReadCache();
+
+      //------------------------------------------------------------------------
+      //! Get the block size
+      //------------------------------------------------------------------------
+      uint32_t GetBlockSize() const
+      {
+        return pBlockSize;
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the counters
+      //------------------------------------------------------------------------
+      void GetStats( Stats &stats );
+
+      //------------------------------------------------------------------------
+      //! Internals, defined in the implementation
+      //------------------------------------------------------------------------
+      struct Block;
+      struct Entry;
+      struct Request;
+
+    private:
+      Entry *Attach( const std::string &key );
+      void   Detach( Entry *entry );
+      Block *Find( Entry *entry, uint64_t index );
+      bool   Reserve( uint64_t blocks );
+      Block *Allocate( Entry *entry, uint64_t index );
+      void   Pin( Block *block );
+      void   Unpin( Block *block );
+      void   Settle( Block *block );
+      void   Drop( Block *block );
+      void   Free( Block *block );
+
+      XrdSysMutex                    pMutex;
+      uint32_t                       pBlockSize;
+      uint32_t                       pReadAheadBlocks;
+      uint64_t                       pMaxBlocks;
+      uint64_t                       pBlocks;
+      std::map<std::string, Entry*>  pEntries;
+      std::list<Block*>              pLRU;
+      Stats                          pStats;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Reads of an open file going through the read cache, with adaptive
+  //! readahead for sequential readers
+  //----------------------------------------------------------------------------
+  class FileReadCache
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param cache the cache
+      //! @param file  the file the blocks are read from
+      //! @param key   identifies the file in the cache
+      //! @param size  size of the file
+      //------------------------------------------------------------------------
+      FileReadCache( ReadCache         *cache,
+                     FileStateHandler  *file,
+                     const std::string &key,
+                     uint64_t           size );
+
+      //------------------------------------------------------------------------
+      //! Destructor, waits for the blocks being fetched
+      //------------------------------------------------------------------------
+      ~FileReadCache();
+
+      //------------------------------------------------------------------------
+      //! Read a data chunk at a given offset - async, see File::Read
+      //------------------------------------------------------------------------
+      XRootDStatus Read( uint64_t         offset,
+                         uint32_t         size,
+                         void            *buffer,
+                         ResponseHandler *handler,
+                         uint16_t         timeout );
+
+      //------------------------------------------------------------------------
+      //! Read scattered data chunks in one operation - async, see
+      //! File::VectorRead
+      //------------------------------------------------------------------------
+      XRootDStatus VectorRead( const ChunkList &chunks,
+                               void            *buffer,
+                               ResponseHandler *handler,
+                               uint16_t         timeout );
+
+      //------------------------------------------------------------------------
+      //! Wait until the blocks requested for this file have arrived
+      //------------------------------------------------------------------------
+      void Drain();
+
+      //------------------------------------------------------------------------
+      //! Close the file once the blocks requested for it have arrived, the
+      //! object deletes itself then
+      //!
+      //! @return false if there is nothing in flight, the caller closes the
+      //!         file and deletes the object itself
+      //------------------------------------------------------------------------
+      bool CloseWhenDrained( ResponseHandler *handler, uint16_t timeout );
+
+      //------------------------------------------------------------------------
+      //! Called when blocks have been fetched
+      //------------------------------------------------------------------------
+      void Fetched( std::vector<ReadCache::Block*> &blocks,
+                    const XRootDStatus             &status,
+                    const std::vector<uint32_t>    &lengths );
+
+    private:
+      bool Collect( ReadCache::Request              *req,
+                    const std::vector<uint64_t>     &indices,
+                    uint64_t                         maxMissing,
+                    std::vector<ReadCache::Block*>  &fetch );
+      void Bypassed();
+      void ReadAhead( uint64_t first, uint64_t last,
+                      std::vector<ReadCache::Block*> &fetch );
+      void Fetch( std::vector<ReadCache::Block*> &blocks, uint16_t timeout );
+      void Complete( ReadCache::Request *req );
+      bool Copy( ReadCache::Request *req, uint64_t offset, uint32_t length,
+                 char *buffer );
+
+      ReadCache         *pCache;
+      FileStateHandler  *pFile;
+      ReadCache::Entry  *pEntry;
+      uint64_t           pSize;
+      int64_t            pLastBlock;
+      uint32_t           pWindow;
+      uint64_t           pReadAheadEnd;
+      uint64_t           pHits;
+      uint64_t           pMisses;
+      uint32_t           pInFlight;
+      bool               pClosing;
+      ResponseHandler   *pCloseHandler;
+      uint16_t           pCloseTimeout;
+      XrdSysCondVar      pCond;
+  };
+}
+
+#endif // __XRD_CL_READ_CACHE_HH__
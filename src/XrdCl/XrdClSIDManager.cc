@@ -18,37 +18,129 @@
 
 #include "XrdCl/XrdClSIDManager.hh"
 
+#include <cstring>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Replace the word if it has not changed in the meantime, without atomics
+  // the caller holds the lock
+  //----------------------------------------------------------------------------
+  inline bool SwapWord( uint64_t &word, uint64_t oldVal, uint64_t newVal )
+  {
+#ifdef HAVE_ATOMICS
+    return __sync_bool_compare_and_swap( &word, oldVal, newVal );
+#else
+    if( word != oldVal ) return false;
+    word = newVal;
+    return true;
+#endif
+  }
+
+  //----------------------------------------------------------------------------
+  // Clear the bits returning the old value of the word
+  //----------------------------------------------------------------------------
+  inline uint64_t ClearBits( uint64_t &word, uint64_t mask )
+  {
+#ifdef HAVE_ATOMICS
+    return __sync_fetch_and_and( &word, ~mask );
+#else
+    uint64_t old = word;
+    word &= ~mask;
+    return old;
+#endif
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the SID stored in a two byte array
+  //----------------------------------------------------------------------------
+  inline uint16_t ToSID( const uint8_t sid[2] )
+  {
+    uint16_t s = 0;
+    memcpy( &s, sid, 2 );
+    return s;
+  }
+}
+
 namespace XrdCl
 {
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  SIDManager::SIDManager(): pNext( 1 ), pNumInUse( 0 ), pNumTimedOut( 0 )
+  {
+    memset( pInUse,    0, sizeof( pInUse ) );
+    memset( pTimedOut, 0, sizeof( pTimedOut ) );
+
+    //--------------------------------------------------------------------------
+    // 0 and 0xffff are never handed out
+    //--------------------------------------------------------------------------
+    pInUse[0]          |= 1ULL;
+    pInUse[NumWords-1] |= 1ULL << 63;
+  }
+
   //----------------------------------------------------------------------------
   // Allocate a SID
   //---------------------------------------------------------------------------
   Status SIDManager::AllocateSID( uint8_t sid[2] )
   {
+#ifndef HAVE_ATOMICS
     XrdSysMutexHelper scopedLock( pMutex );
+#endif
 
-    uint16_t allocSID = 1;
-
-    //--------------------------------------------------------------------------
-    // Get a SID from the list of free SIDs if it's not empty
-    //--------------------------------------------------------------------------
-    if( !pFreeSIDs.empty() )
-    {
-      allocSID = pFreeSIDs.front();
-      pFreeSIDs.pop_front();
-    }
     //--------------------------------------------------------------------------
-    // Allocate a new SID if possible
+    // Claim the first free SID at or after the cursor, wrapping around, so
+    // that a released SID is handed out again only after all the others
+    // have been used - a late response to a request that was given up on
+    // is then unlikely to be matched with a new request
     //--------------------------------------------------------------------------
-    else
+    uint32_t start = pNext % 65536;
+    for( uint32_t i = 0; i <= NumWords; ++i )
     {
-      if( pSIDCeiling == 0xffff )
-        return Status( stError, errNoMoreFreeSIDs );
-      allocSID = pSIDCeiling++;
+      uint32_t  w    = (start / 64 + i) % NumWords;
+      uint64_t  skip = i == 0 ? ~(~0ULL << (start % 64)) : 0;
+      uint64_t &word = pInUse[w];
+      uint64_t  cur  = word;
+      while( (cur | skip) != ~0ULL )
+      {
+        uint32_t bit = __builtin_ctzll( ~(cur | skip) );
+        if( SwapWord( word, cur, cur | (1ULL << bit) ) )
+        {
+          pNext = w * 64 + bit + 1;
+#ifdef HAVE_ATOMICS
+          __sync_fetch_and_add( &pNumInUse, 1 );
+#else
+          ++pNumInUse;
+#endif
+          uint16_t allocSID = w * 64 + bit;
+          memcpy( sid, &allocSID, 2 );
+          return Status();
+        }
+        cur = word;
+      }
     }
+    return Status( stError, errNoMoreFreeSIDs );
+  }
+
+  //----------------------------------------------------------------------------
+  // Mark the SID as free
+  //----------------------------------------------------------------------------
+  bool SIDManager::FreeSID( uint16_t sid )
+  {
+    if( sid == 0 || sid == 0xffff )
+      return false;
 
-    memcpy( sid, &allocSID, 2 );
-    return Status();
+    uint32_t w    = sid / 64;
+    uint64_t mask = 1ULL << (sid % 64);
+    if( !(ClearBits( pInUse[w], mask ) & mask) )
+      return false;
+
+#ifdef HAVE_ATOMICS
+    __sync_fetch_and_sub( &pNumInUse, 1 );
+#else
+    --pNumInUse;
+#endif
+    return true;
   }
 
   //----------------------------------------------------------------------------
@@ -56,10 +148,10 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   void SIDManager::ReleaseSID( uint8_t sid[2] )
   {
+#ifndef HAVE_ATOMICS
     XrdSysMutexHelper scopedLock( pMutex );
-    uint16_t relSID = 0;
-    memcpy( &relSID, sid, 2 );
-    pFreeSIDs.push_back( relSID );
+#endif
+    FreeSID( ToSID( sid ) );
   }
 
   //----------------------------------------------------------------------------
@@ -68,9 +160,12 @@ namespace XrdCl
   void SIDManager::TimeOutSID( uint8_t sid[2] )
   {
     XrdSysMutexHelper scopedLock( pMutex );
-    uint16_t tiSID = 0;
-    memcpy( &tiSID, sid, 2 );
-    pTimeOutSIDs.insert( tiSID );
+    uint16_t tiSID = ToSID( sid );
+    uint64_t mask  = 1ULL << (tiSID % 64);
+    if( pTimedOut[tiSID / 64] & mask )
+      return;
+    pTimedOut[tiSID / 64] |= mask;
+    ++pNumTimedOut;
   }
 
   //----------------------------------------------------------------------------
@@ -79,12 +174,8 @@ namespace XrdCl
   bool SIDManager::IsTimedOut( uint8_t sid[2] )
   {
     XrdSysMutexHelper scopedLock( pMutex );
-    uint16_t tiSID = 0;
-    memcpy( &tiSID, sid, 2 );
-    std::set<uint16_t>::iterator it = pTimeOutSIDs.find( tiSID );
-    if( it != pTimeOutSIDs.end() )
-      return true;
-    return false;
+    uint16_t tiSID = ToSID( sid );
+    return pTimedOut[tiSID / 64] & (1ULL << (tiSID % 64));
   }
 
   //----------------------------------------------------------------------------
@@ -93,10 +184,14 @@ namespace XrdCl
   void SIDManager::ReleaseTimedOut( uint8_t sid[2] )
   {
     XrdSysMutexHelper scopedLock( pMutex );
-    uint16_t tiSID = 0;
-    memcpy( &tiSID, sid, 2 );
-    pTimeOutSIDs.erase( tiSID );
-    pFreeSIDs.push_back( tiSID );
+    uint16_t tiSID = ToSID( sid );
+    uint64_t mask  = 1ULL << (tiSID % 64);
+    if( pTimedOut[tiSID / 64] & mask )
+    {
+      pTimedOut[tiSID / 64] &= ~mask;
+      --pNumTimedOut;
+    }
+    FreeSID( tiSID );
   }
 
   //------------------------------------------------------------------------
@@ -105,10 +200,18 @@ namespace XrdCl
   void SIDManager::ReleaseAllTimedOut()
   {
     XrdSysMutexHelper scopedLock( pMutex );
-    std::set<uint16_t>::iterator it;
-    for( it = pTimeOutSIDs.begin(); it != pTimeOutSIDs.end(); ++it )
-      pFreeSIDs.push_back( *it );
-    pTimeOutSIDs.clear();
+    for( uint32_t w = 0; w < NumWords && pNumTimedOut; ++w )
+    {
+      uint64_t word = pTimedOut[w];
+      while( word )
+      {
+        uint32_t bit = __builtin_ctzll( word );
+        word &= word - 1;
+        FreeSID( w * 64 + bit );
+        --pNumTimedOut;
+      }
+      pTimedOut[w] = 0;
+    }
   }
 
   //----------------------------------------------------------------------------
@@ -117,6 +220,6 @@ namespace XrdCl
   uint16_t SIDManager::GetNumberOfAllocatedSIDs() const
   {
     XrdSysMutexHelper scopedLock( pMutex );
-    return pSIDCeiling - pFreeSIDs.size() - pTimeOutSIDs.size() - 1;
+    return pNumInUse - pNumTimedOut;
   }
 }
@@ -19,8 +19,6 @@
 #ifndef __XRD_CL_SID_MANAGER_HH__
 #define __XRD_CL_SID_MANAGER_HH__
 
-#include <list>
-#include <set>
 #include <stdint.h>
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdCl/XrdClStatus.hh"
@@ -29,6 +27,12 @@ namespace XrdCl
 {
   //----------------------------------------------------------------------------
   //! Handle XRootD stream IDs
+  //!
+  //! The SIDs in use are kept in a bitmap, the next free one after the
+  //! previously allocated SID is found with find-first-set and is claimed
+  //! with compare-and-swap, so allocating and releasing does not need
+  //! a lock.
+  //! SIDs of requests that timed out stay in use until released explicitly.
   //----------------------------------------------------------------------------
   class SIDManager
   {
@@ -37,7 +41,7 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Constructor
       //------------------------------------------------------------------------
-      SIDManager(): pSIDCeiling(1) {}
+      SIDManager();
 
       //------------------------------------------------------------------------
       //! Allocate a SID
@@ -77,8 +81,7 @@ namespace XrdCl
       //------------------------------------------------------------------------
       uint32_t NumberOfTimedOutSIDs() const
       {
-        XrdSysMutexHelper scopedLock( pMutex );
-        return pTimeOutSIDs.size();
+        return pNumTimedOut;
       }
 
       //------------------------------------------------------------------------
@@ -87,9 +90,18 @@ namespace XrdCl
       uint16_t GetNumberOfAllocatedSIDs() const;
 
     private:
-      std::list<uint16_t>  pFreeSIDs;
-      std::set<uint16_t>   pTimeOutSIDs;
-      uint16_t             pSIDCeiling;
+      static const uint32_t NumWords = 65536 / 64;
+
+      //------------------------------------------------------------------------
+      // Mark the SID as free, return false if it was not in use
+      //------------------------------------------------------------------------
+      bool FreeSID( uint16_t sid );
+
+      uint64_t             pInUse[NumWords];     // allocated or timed out
+      uint64_t             pTimedOut[NumWords];  // timed out, under pMutex
+      uint32_t             pNext;                // SID to start looking at
+      uint32_t             pNumInUse;
+      uint32_t             pNumTimedOut;
       mutable XrdSysMutex  pMutex;
   };
 }
@@ -88,22 +88,67 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   struct SubStreamData
   {
-    SubStreamData(): socket( 0 ), status( Socket::Disconnected )
+    SubStreamData(): socket( 0 ), status( Socket::Disconnected ),
+      pendingBytes( 0 ), bytesReceived( 0 ), bytesSent( 0 ),
+      reportedReceived( 0 ), reportedSent( 0 ), lastUsed( 0 ), lastError( 0 )
     {
       outQueue = new OutQueue();
+      reportTime.tv_sec = 0; reportTime.tv_usec = 0;
     }
     ~SubStreamData()
     {
       delete socket;
       delete outQueue;
     }
+    void ResetCounters()
+    {
+      bytesReceived    = 0;
+      bytesSent        = 0;
+      reportedReceived = 0;
+      reportedSent     = 0;
+      lastUsed         = ::time( 0 );
+      gettimeofday( &reportTime, 0 );
+    }
     AsyncSocketHandler   *socket;
     OutQueue             *outQueue;
     OutMessageHelper      outMsgHelper;
     InMessageHelper       inMsgHelper;
     Socket::SocketStatus  status;
+    uint64_t              pendingBytes;     // response bytes expected
+    uint64_t              bytesReceived;
+    uint64_t              bytesSent;
+    uint64_t              reportedReceived; // counters at the last report
+    uint64_t              reportedSent;
+    timeval               reportTime;
+    time_t                lastUsed;         // last request or response
+    time_t                lastError;        // last connection failure
   };
 
+  //----------------------------------------------------------------------------
+  // Number of bytes expected in response to a data request, 0 if the
+  // response is not going to be sent through a data substream
+  //----------------------------------------------------------------------------
+  static uint32_t GetResponseSize( Message *msg )
+  {
+    ClientRequest *req = (ClientRequest*)msg->GetBuffer();
+    switch( ntohs( req->header.requestid ) )
+    {
+      case kXR_read:
+        return sizeof( ServerResponseHeader ) + ntohl( req->read.rlen );
+
+      case kXR_readv:
+      {
+        uint32_t size = sizeof( ServerResponseHeader );
+        uint32_t n    = ntohl( req->header.dlen ) / sizeof( readahead_list );
+        readahead_list *chunk = (readahead_list*)msg->GetBuffer( 24 );
+        for( uint32_t i = 0; i < n; ++i )
+          size += sizeof( readahead_list ) + ntohl( chunk[i].rlen );
+        return size;
+      }
+    }
+    return 0;
+  }
+
   //----------------------------------------------------------------------------
   // Constructor
   //----------------------------------------------------------------------------
@@ -121,6 +166,7 @@ namespace XrdCl
     pConnectionInitTime( 0 ),
     pAddressType( Utils::IPAll ),
     pSessionId( 0 ),
+    pNextSubStream( 0 ),
     pQueueIncMsgJob(0),
     pBytesSent( 0 ),
     pBytesReceived( 0 )
@@ -139,6 +185,17 @@ namespace XrdCl
     pStreamErrorWindow = Utils::GetIntParameter( *url, "StreamErrorWindow",
                                                  DefaultStreamErrorWindow );
 
+    //--------------------------------------------------------------------------
+    // The substreams above the initial number are connected on demand
+    //--------------------------------------------------------------------------
+    int initSubStreams = Utils::GetIntParameter( *url, "SubStreamsPerChannel",
+                                                 DefaultSubStreamsPerChannel );
+    pInitSubStreams     = initSubStreams < 1 ? 1 : initSubStreams;
+    pSubStreamThreshold = Utils::GetIntParameter( *url, "SubStreamThreshold",
+                                                  DefaultSubStreamThreshold );
+    pSubStreamIdleTime  = Utils::GetIntParameter( *url, "SubStreamIdleTime",
+                                                  DefaultSubStreamIdleTime );
+
     std::string netStack = Utils::GetStringParameter( *url, "NetworkStack",
                                                       DefaultNetworkStack );
 
@@ -316,6 +373,18 @@ namespace XrdCl
       path.up = 0;
     }
 
+    //--------------------------------------------------------------------------
+    // The data responses go to the substream that has the least of them
+    // outstanding
+    //--------------------------------------------------------------------------
+    uint32_t respSize = 0;
+    if( pSubStreams.size() > 1 )
+    {
+      respSize = GetResponseSize( msg );
+      if( respSize )
+        path.down = SelectSubStream();
+    }
+
     log->Dump( PostMasterMsg, "[%s] Sending message %s (0x%x) through "
                "substream %d expecting answer at %d", pStreamName.c_str(),
                msg->GetDescription().c_str(), msg, path.up, path.down );
@@ -329,12 +398,213 @@ namespace XrdCl
       pTransport->MultiplexSubStream( msg, pStreamNum, *pChannelData, &path );
       pSubStreams[path.up]->outQueue->PushBack( msg, handler,
                                                 expires, stateful );
+
+      if( respSize )
+      {
+        ClientRequestHdr *hdr = (ClientRequestHdr*)msg->GetBuffer();
+        uint16_t sid; memcpy( &sid, hdr->streamid, 2 );
+        InFlightMap::iterator it = pInFlight.find( sid );
+        if( it != pInFlight.end() )
+          pSubStreams[it->second.subStream]->pendingBytes -= it->second.bytes;
+
+        InFlightRequest &req = pInFlight[sid];
+        req.subStream = path.down;
+        req.bytes     = respSize;
+        req.expires   = expires;
+        pSubStreams[path.down]->pendingBytes += respSize;
+        pSubStreams[path.down]->lastUsed      = ::time( 0 );
+        OpenSubStreamIfNeeded();
+      }
     }
     else
       st.status = stFatal;
     return st;
   }
 
+  //----------------------------------------------------------------------------
+  // Pick the least loaded data substream
+  //----------------------------------------------------------------------------
+  uint16_t Stream::SelectSubStream()
+  {
+    uint16_t numData  = pSubStreams.size() - 1;
+    uint16_t selected = 0;
+    for( uint16_t i = 0; i < numData; ++i )
+    {
+      uint16_t s = 1 + (pNextSubStream + i) % numData;
+      if( pSubStreams[s]->status != Socket::Connected )
+        continue;
+      if( !selected ||
+          pSubStreams[s]->pendingBytes < pSubStreams[selected]->pendingBytes )
+        selected = s;
+    }
+    pNextSubStream = (pNextSubStream + 1) % numData;
+    return selected;
+  }
+
+  //----------------------------------------------------------------------------
+  // Connect another substream if needed
+  //----------------------------------------------------------------------------
+  void Stream::OpenSubStreamIfNeeded()
+  {
+    if( pSubStreams[0]->status != Socket::Connected )
+      return;
+
+    //--------------------------------------------------------------------------
+    // We open the substreams one at a time and don't retry those that have
+    // failed recently
+    //--------------------------------------------------------------------------
+    time_t   now       = ::time( 0 );
+    uint64_t pending   = 0;
+    uint16_t active    = 0;
+    uint16_t candidate = 0;
+    for( uint16_t i = 0; i < pSubStreams.size(); ++i )
+    {
+      SubStreamData *s = pSubStreams[i];
+      if( s->status == Socket::Connecting )
+        return;
+      if( s->status == Socket::Connected )
+      {
+        pending += s->pendingBytes;
+        if( i ) ++active;
+      }
+      else if( i && !candidate && now - s->lastError >= pSubStreamIdleTime )
+        candidate = i;
+    }
+
+    if( !candidate || pending <= pSubStreamThreshold * (active ? active : 1) )
+      return;
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( PostMasterMsg, "[%s] %llu response bytes outstanding on %d "
+                "substreams, connecting substream %d.", pStreamName.c_str(),
+                (unsigned long long)pending, active, candidate );
+
+    SubStreamData *s = pSubStreams[candidate];
+    s->socket->SetAddress( pSubStreams[0]->socket->GetAddress() );
+    Status st = s->socket->Connect( pConnectionWindow );
+    if( st.IsOK() )
+      s->status = Socket::Connecting;
+    else
+    {
+      s->socket->Close();
+      s->lastError = now;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Close the substream if it is idle
+  //----------------------------------------------------------------------------
+  void Stream::CloseSubStreamIfIdle( uint16_t subStream, time_t now )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    SubStreamData *s = pSubStreams[subStream];
+    if( subStream < pInitSubStreams || s->status != Socket::Connected )
+      return;
+
+    if( s->pendingBytes || !s->outQueue->IsEmpty() || s->outMsgHelper.msg ||
+        s->inMsgHelper.handler )
+      return;
+
+    time_t lastActivity = std::max( s->lastUsed, s->socket->GetLastActivity() );
+    if( now - lastActivity < pSubStreamIdleTime )
+      return;
+
+    InFlightMap::iterator it;
+    for( it = pInFlight.begin(); it != pInFlight.end(); ++it )
+      if( it->second.subStream == subStream )
+        return;
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( PostMasterMsg, "[%s] Closing substream %d idle for %d "
+                "seconds.", pStreamName.c_str(), subStream, now-lastActivity );
+
+    MonitorSubStream( subStream, Monitor::SubStreamInfo::Closed );
+    s->socket->Close();
+    s->status = Socket::Disconnected;
+  }
+
+  //----------------------------------------------------------------------------
+  // Account for a response to a tracked request
+  //----------------------------------------------------------------------------
+  void Stream::ResponseReceived( Message *msg, uint32_t bytesReceived )
+  {
+    ServerResponseHeader *rsp = (ServerResponseHeader*)msg->GetBuffer();
+    if( rsp->status == kXR_attn || rsp->status == kXR_waitresp )
+      return;
+
+    uint16_t sid; memcpy( &sid, rsp->streamid, 2 );
+    XrdSysMutexHelper scopedLock( pMutex );
+    InFlightMap::iterator it = pInFlight.find( sid );
+    if( it == pInFlight.end() )
+      return;
+
+    SubStreamData *s    = pSubStreams[it->second.subStream];
+    uint32_t       done = it->second.bytes;
+    if( rsp->status == kXR_oksofar && bytesReceived < done )
+      done = bytesReceived;
+
+    s->pendingBytes  -= done;
+    it->second.bytes -= done;
+    s->lastUsed       = ::time( 0 );
+    if( rsp->status != kXR_oksofar )
+      pInFlight.erase( it );
+  }
+
+  //----------------------------------------------------------------------------
+  // Forget the requests expecting their responses at the substream
+  //----------------------------------------------------------------------------
+  void Stream::DropInFlight( uint16_t subStream )
+  {
+    InFlightMap::iterator it = pInFlight.begin();
+    while( it != pInFlight.end() )
+    {
+      if( it->second.subStream == subStream )
+      {
+        pSubStreams[subStream]->pendingBytes -= it->second.bytes;
+        pInFlight.erase( it++ );
+      }
+      else
+        ++it;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Inform the monitoring about a substream event
+  //----------------------------------------------------------------------------
+  void Stream::MonitorSubStream( uint16_t subStream, int action )
+  {
+    Monitor *mon = DefaultEnv::GetMonitor();
+    if( !mon )
+      return;
+
+    SubStreamData *s = pSubStreams[subStream];
+    timeval now;
+    gettimeofday( &now, 0 );
+    double elapsed = (now.tv_sec - s->reportTime.tv_sec) +
+                     (now.tv_usec - s->reportTime.tv_usec) / 1e6;
+
+    Monitor::SubStreamInfo i;
+    i.server    = pUrl->GetHostId();
+    i.subStream = subStream;
+    i.action    = (Monitor::SubStreamInfo::Action)action;
+    i.rBytes    = s->bytesReceived;
+    i.sBytes    = s->bytesSent;
+    i.pending   = s->pendingBytes;
+    if( elapsed > 0 )
+    {
+      i.rRate = (uint64_t)( (s->bytesReceived - s->reportedReceived) / elapsed );
+      i.sRate = (uint64_t)( (s->bytesSent - s->reportedSent) / elapsed );
+    }
+    for( size_t j = 0; j < pSubStreams.size(); ++j )
+      if( pSubStreams[j]->status == Socket::Connected )
+        ++i.active;
+
+    s->reportedReceived = s->bytesReceived;
+    s->reportedSent     = s->bytesSent;
+    s->reportTime       = now;
+    mon->Event( Monitor::EvSubStream, &i );
+  }
+
   //----------------------------------------------------------------------------
   // Force connection
   //----------------------------------------------------------------------------
@@ -375,6 +645,26 @@ namespace XrdCl
     SubStreamList::iterator it;
     for( it = pSubStreams.begin(); it != pSubStreams.end(); ++it )
       q.GrabExpired( *(*it)->outQueue, now );
+
+    //--------------------------------------------------------------------------
+    // Forget the expired requests still waiting for data and report the
+    // throughput of the substreams
+    //--------------------------------------------------------------------------
+    InFlightMap::iterator inIt = pInFlight.begin();
+    while( inIt != pInFlight.end() )
+    {
+      if( inIt->second.expires && inIt->second.expires <= now )
+      {
+        pSubStreams[inIt->second.subStream]->pendingBytes -= inIt->second.bytes;
+        pInFlight.erase( inIt++ );
+      }
+      else
+        ++inIt;
+    }
+
+    for( uint16_t i = 0; i < pSubStreams.size(); ++i )
+      if( pSubStreams[i]->status == Socket::Connected )
+        MonitorSubStream( i, Monitor::SubStreamInfo::Stats );
     pMutex.UnLock();
 
     q.Report( Status( stError, errOperationExpired ) );
@@ -447,6 +737,9 @@ namespace XrdCl
   {
     msg->SetSessionId( pSessionId );
     pBytesReceived += bytesReceived;
+    pSubStreams[subStream]->bytesReceived += bytesReceived;
+    if( pSubStreams.size() > 1 )
+      ResponseReceived( msg, bytesReceived );
 
     uint32_t streamAction = pTransport->MessageReceived( msg, pStreamNum,
                                                          subStream,
@@ -551,6 +844,7 @@ namespace XrdCl
                              *pChannelData );
     OutMessageHelper &h = pSubStreams[subStream]->outMsgHelper;
     pBytesSent += bytesSent;
+    pSubStreams[subStream]->bytesSent += bytesSent;
     if( h.handler )
       h.handler->OnStatusReady( msg, Status() );
     pSubStreams[subStream]->outMsgHelper.Reset();
@@ -566,6 +860,10 @@ namespace XrdCl
     Log *log = DefaultEnv::GetLog();
     log->Debug( PostMasterMsg, "[%s] Stream %d connected.", pStreamName.c_str(),
                 subStream );
+    pSubStreams[subStream]->ResetCounters();
+
+    if( subStream > 0 )
+      MonitorSubStream( subStream, Monitor::SubStreamInfo::Opened );
 
     if( subStream == 0 )
     {
@@ -590,16 +888,28 @@ namespace XrdCl
         }
       }
 
+      //------------------------------------------------------------------------
+      // The requests tracked so far belonged to the previous session
+      //------------------------------------------------------------------------
+      pInFlight.clear();
+      for( size_t i = 0; i < pSubStreams.size(); ++i )
+      {
+        pSubStreams[i]->pendingBytes = 0;
+        pSubStreams[i]->lastError    = 0;
+      }
+
       //------------------------------------------------------------------------
       // Connect the extra streams, if we fail we move all the outgoing items
       // to stream 0, we don't need to enable the uplink here, because it
       // should be already enabled after the handshaking process is completed.
+      // The streams above the initial number are connected on demand.
       //------------------------------------------------------------------------
-      if( pSubStreams.size() > 1 )
+      size_t numInit = std::min( pSubStreams.size(), (size_t)pInitSubStreams );
+      if( numInit > 1 )
       {
         log->Debug( PostMasterMsg, "[%s] Attempting to connect %d additional "
-                    "streams.", pStreamName.c_str(), pSubStreams.size()-1 );
-        for( size_t i = 1; i < pSubStreams.size(); ++i )
+                    "streams.", pStreamName.c_str(), numInit-1 );
+        for( size_t i = 1; i < numInit; ++i )
         {
           pSubStreams[i]->socket->SetAddress( pSubStreams[0]->socket->GetAddress() );
           Status st = pSubStreams[i]->socket->Connect( pConnectionWindow );
@@ -628,7 +938,7 @@ namespace XrdCl
         i.server  = pUrl->GetHostId();
         i.sTOD    = pConnectionStarted;
         i.eTOD    = pConnectionDone;
-        i.streams = pSubStreams.size();
+        i.streams = numInit;
 
         AnyObject    qryResult;
         std::string *qryResponse = 0;
@@ -657,7 +967,8 @@ namespace XrdCl
     //--------------------------------------------------------------------------
     if( subStream > 0 )
     {
-      pSubStreams[subStream]->status = Socket::Disconnected;
+      pSubStreams[subStream]->status    = Socket::Disconnected;
+      pSubStreams[subStream]->lastError = now;
       pSubStreams[0]->outQueue->GrabItems( *pSubStreams[subStream]->outQueue );
       if( pSubStreams[0]->status == Socket::Connected )
       {
@@ -743,6 +1054,8 @@ namespace XrdCl
   {
     XrdSysMutexHelper scopedLock( pMutex );
     Log *log = DefaultEnv::GetLog();
+    if( subStream > 0 && pSubStreams[subStream]->status == Socket::Connected )
+      MonitorSubStream( subStream, Monitor::SubStreamInfo::Closed );
     pSubStreams[subStream]->socket->Close();
     pSubStreams[subStream]->status = Socket::Disconnected;
 
@@ -777,6 +1090,8 @@ namespace XrdCl
     //--------------------------------------------------------------------------
     if( subStream > 0 )
     {
+      pSubStreams[subStream]->lastError = ::time( 0 );
+      DropInFlight( subStream );
       if( pSubStreams[subStream]->outQueue->IsEmpty() )
         return;
 
@@ -803,6 +1118,8 @@ namespace XrdCl
     if( subStream == 0 )
     {
       MonitorDisconnection( status );
+      for( uint16_t i = 0; i < pSubStreams.size(); ++i )
+        DropInFlight( i );
 
       SubStreamList::iterator it;
       size_t outstanding = 0;
@@ -897,10 +1214,14 @@ namespace XrdCl
     isBroken = false;
 
     //--------------------------------------------------------------------------
-    // We only take the main stream into account
+    // We only take the main stream into account, the other ones may only
+    // be closed if they have been opened on demand and are idle
     //--------------------------------------------------------------------------
     if( substream != 0 )
+    {
+      CloseSubStreamIfIdle( substream, time(0) );
       return;
+    }
 
     //--------------------------------------------------------------------------
     // Check if there is no outgoing messages and if the stream TTL is elapesed.
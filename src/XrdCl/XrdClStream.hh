@@ -31,6 +31,7 @@
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdNet/XrdNetAddr.hh"
 #include <list>
+#include <map>
 #include <vector>
 
 namespace XrdCl
@@ -305,7 +306,51 @@ namespace XrdCl
       //------------------------------------------------------------------------
       Status RequestClose( Message  *resp );
 
-      typedef std::vector<SubStreamData*> SubStreamList;
+      //------------------------------------------------------------------------
+      //! Pick the connected data substream with the least response bytes
+      //! outstanding, 0 if there is none
+      //------------------------------------------------------------------------
+      uint16_t SelectSubStream();
+
+      //------------------------------------------------------------------------
+      //! Connect another substream if the connected ones have more than
+      //! the threshold of response bytes outstanding
+      //------------------------------------------------------------------------
+      void OpenSubStreamIfNeeded();
+
+      //------------------------------------------------------------------------
+      //! Close the substream if it has been opened on demand and has been
+      //! idle for long enough
+      //------------------------------------------------------------------------
+      void CloseSubStreamIfIdle( uint16_t subStream, time_t now );
+
+      //------------------------------------------------------------------------
+      //! Account for a response, or a part of it, to a tracked request
+      //------------------------------------------------------------------------
+      void ResponseReceived( Message *msg, uint32_t bytesReceived );
+
+      //------------------------------------------------------------------------
+      //! Forget the requests expecting their responses at the substream
+      //------------------------------------------------------------------------
+      void DropInFlight( uint16_t subStream );
+
+      //------------------------------------------------------------------------
+      //! Inform the monitoring about a substream event
+      //------------------------------------------------------------------------
+      void MonitorSubStream( uint16_t subStream, int action );
+
+      //------------------------------------------------------------------------
+      // Request whose response is expected at a data substream
+      //------------------------------------------------------------------------
+      struct InFlightRequest
+      {
+        uint16_t subStream;
+        uint32_t bytes;
+        time_t   expires;
+      };
+
+      typedef std::vector<SubStreamData*>         SubStreamList;
+      typedef std::map<uint16_t, InFlightRequest> InFlightMap;
 
       //------------------------------------------------------------------------
       // Data members
@@ -333,6 +378,15 @@ namespace XrdCl
       ChannelHandlerList             pChannelEvHandlers;
       uint64_t                       pSessionId;
 
+      //------------------------------------------------------------------------
+      // Adaptive substreams
+      //------------------------------------------------------------------------
+      uint16_t                       pInitSubStreams;
+      uint64_t                       pSubStreamThreshold;
+      time_t                         pSubStreamIdleTime;
+      uint16_t                       pNextSubStream;
+      InFlightMap                    pInFlight;
+
       //------------------------------------------------------------------------
       // Jobs
       //------------------------------------------------------------------------
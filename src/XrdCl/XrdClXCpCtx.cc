@@ -86,9 +86,49 @@ XCpSrc* XCpCtx::WeakestLink( XCpSrc *exclude )
 
 void XCpCtx::PutChunk( ChunkInfo* chunk )
 {
+  if( chunk )
+  {
+    XrdSysMutexHelper lck( pHedgedMtx );
+    std::map<uint64_t, bool>::iterator itr = pHedged.find( chunk->offset );
+    if( itr != pHedged.end() )
+    {
+      // the other copy made it first
+      if( itr->second )
+      {
+        lck.UnLock();
+        XCpSrc::DeleteChunk( chunk );
+        return;
+      }
+      itr->second = true;
+    }
+  }
+
   pSink.Put( chunk );
 }
 
+bool XCpCtx::Hedge( uint64_t offset )
+{
+  XrdSysMutexHelper lck( pHedgedMtx );
+  return pHedged.insert( std::make_pair( offset, false ) ).second;
+}
+
+void XCpCtx::GetSourceStats( std::vector<SourceStats> &stats )
+{
+  XrdSysMutexHelper lck( pMtx );
+  stats.clear();
+  std::list<XCpSrc*>::iterator itr;
+  for( itr = pSources.begin() ; itr != pSources.end() ; ++itr )
+  {
+    XCpSrc *src = *itr;
+    if( !src->IsRunning() ) continue;
+    SourceStats s;
+    s.url          = src->GetUrl();
+    s.bytes        = src->GetDataTransfered();
+    s.transferRate = src->TransferRate();
+    stats.push_back( s );
+  }
+}
+
 std::pair<uint64_t, uint64_t> XCpCtx::GetBlock()
 {
   XrdSysMutexHelper lck( pMtx );
@@ -179,7 +219,7 @@ bool XCpCtx::AllDone()
   XrdSysCondVarHelper lck( pDoneCV );
 
   if( !pDone )
-    pDoneCV.Wait( 60 );
+    pDoneCV.Wait( 1 );
 
   return pDone;
 }
@@ -31,6 +31,8 @@
 
 #include <stdint.h>
 #include <iostream>
+#include <map>
+#include <vector>
 
 namespace XrdCl
 {
@@ -41,6 +43,16 @@ class XCpCtx
 {
   public:
 
+    /**
+     * Statistics of a source
+     */
+    struct SourceStats
+    {
+      std::string url;           //< the replica currently used
+      uint64_t    bytes;         //< data received so far
+      uint64_t    transferRate;  //< current transfer rate [B/s]
+    };
+
     /**
      * Constructor
      *
@@ -100,12 +112,29 @@ class XCpCtx
     XCpSrc* WeakestLink( XCpSrc *exclude );
 
     /**
-     * Put a chunk into the sink
+     * Put a chunk into the sink, of the copies of a hedged
+     * chunk only the first one goes to the sink
      *
      * @param chunk : the chunk
      */
     void PutChunk( ChunkInfo* chunk );
 
+    /**
+     * Register a chunk that is going to be read by a second
+     * source while the first one is still reading it
+     *
+     * @param offset : the offset of the chunk
+     * @return       : false if the chunk is being hedged already
+     */
+    bool Hedge( uint64_t offset );
+
+    /**
+     * Get the statistics of the active sources
+     *
+     * @param stats : output parameter
+     */
+    void GetSourceStats( std::vector<SourceStats> &stats );
+
     /**
      * Get next block that has to be transfered
      *
@@ -182,7 +211,7 @@ class XCpCtx
     /**
      * Returns true if all chunks have been transfered,
      * otherwise blocks until NotifyIdleSrc is called,
-     * or a 1 minute timeout occurs.
+     * or a 1 second timeout occurs.
      *
      * @return : true is all chunks have been transfered,
      *           false otherwise.
@@ -277,6 +306,18 @@ class XCpCtx
      */
     uint64_t                   pDataReceived;
 
+    /**
+     * Chunks read by two sources (the offset is the key,
+     * the value is true once the first copy has arrived)
+     */
+    std::map<uint64_t, bool>   pHedged;
+
+    /**
+     * A mutex guarding the hedged chunks (taken by sources
+     * holding their own locks)
+     */
+    XrdSysMutex                pHedgedMtx;
+
     /**
      * A flag, true if all chunks have been received and we are done,
      * false otherwise
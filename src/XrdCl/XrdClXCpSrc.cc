@@ -30,6 +30,21 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <sys/time.h>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Current time in milliseconds, the transfer rates of fast sources differ
+  // by much less than what a second resolution would show
+  //----------------------------------------------------------------------------
+  uint64_t NowMs()
+  {
+    timeval now;
+    gettimeofday( &now, 0 );
+    return uint64_t( now.tv_sec ) * 1000 + now.tv_usec / 1000;
+  }
+}
 
 namespace XrdCl
 {
@@ -143,7 +158,7 @@ void XCpSrc::StartDownloading()
   }
 
   // start counting transfer time
-  pStartTime = time( 0 );
+  pStartTime = NowMs();
 
   while( pRunning )
   {
@@ -160,18 +175,19 @@ void XCpSrc::StartDownloading()
       // if successful continue
       if( GetWork().IsOK() ) continue;
       // keep track of the time before we go idle
-      pTransferTime += time( 0 ) - pStartTime;
+      pTransferTime += NowMs() - pStartTime;
       // check if the overall download process is
       // done, this makes the thread wait until
       // either the download is done, or a source
-      // went to error, or a 60s timeout has been
+      // went to error, or a 1s timeout has been
       // reached (the timeout is there so we can
       // check if a source degraded in the meanwhile
-      // and now we can steal from it)
+      // and now we can steal from it or hedge its
+      // last chunks)
       if( !pCtx->AllDone() )
       {
         // reset start time after pause
-        pStartTime = time( 0 );
+        pStartTime = NowMs();
         continue;
       }
       // stop counting
@@ -298,7 +314,7 @@ XRootDStatus XCpSrc::Recover()
   // since we have a brand new source, we need
   // to restart transfer rate statistics
   pTransferTime   = 0;
-  pStartTime      = time( 0 );
+  pStartTime      = NowMs();
   pDataTransfered = 0;
 
   return st;
@@ -443,7 +459,7 @@ void XCpSrc::Steal( XCpSrc *src )
     // need to notify
     pCtx->NotifyIdleSrc();
 
-    log->Debug( UtilityMsg, "s%: Stealing everything from %s", myHost.c_str(), srcHost.c_str() );
+    log->Debug( UtilityMsg, "%s: Stealing everything from %s", myHost.c_str(), srcHost.c_str() );
 
     return;
   }
@@ -451,24 +467,22 @@ void XCpSrc::Steal( XCpSrc *src )
   // the source we are stealing from is just slower, only take part of its work
   // so we want a fraction of its work we want for ourself
   uint64_t myTransferRate = TransferRate(), srcTransferRate = src->TransferRate();
-  if( myTransferRate == 0 ) return;
-  double fraction = double( myTransferRate ) / double( myTransferRate + srcTransferRate );
+  double fraction = StealFraction( myTransferRate, srcTransferRate );
+  if( fraction == 0 ) return;
 
   if( src->pCurrentOffset < src->pBlkEnd )
   {
     // the source still has a block of data
     uint64_t blkSize = src->pBlkEnd - src->pCurrentOffset;
-    uint64_t steal = static_cast<uint64_t>( round( fraction * blkSize ) );
     // if after stealing there will be less than one chunk
     // take everything
-    if( blkSize - steal <= pChunkSize )
-      steal = blkSize;
+    uint64_t steal = StealSize( fraction, blkSize, pChunkSize );
 
     pCurrentOffset = src->pBlkEnd - steal;
     pBlkEnd        = src->pBlkEnd;
     src->pBlkEnd  -= steal;
 
-    log->Debug( UtilityMsg, "s%: Stealing fraction (%f) of block from %s", myHost.c_str(), fraction, srcHost.c_str() );
+    log->Debug( UtilityMsg, "%s: Stealing fraction (%f) of block from %s", myHost.c_str(), fraction, srcHost.c_str() );
 
     return;
   }
@@ -483,28 +497,29 @@ void XCpSrc::Steal( XCpSrc *src )
       src->pRecovered.erase( itr );
     }
 
-    log->Debug( UtilityMsg, "s%: Stealing fraction (%f) of recovered chunks from %s", myHost.c_str(), fraction, srcHost.c_str() );
+    log->Debug( UtilityMsg, "%s: Stealing fraction (%f) of recovered chunks from %s", myHost.c_str(), fraction, srcHost.c_str() );
 
     return;
   }
 
-  // * a fraction < 0.5 means that we are actually slower (so it does
-  //   not make sense to steal ongoing's from someone who's faster)
-  // * a fraction ~ 0.5 means that we have more or less the same transfer
-  //   rate (similarly, it doesn't make sense to steal)
-  // * the source needs to be really faster (though, this is an arbitrary
-  //   choice) to actually steal something
-  if( !src->pOngoing.empty() && fraction > 0.7 )
+  // Only the ongoing chunks of the slower source are left, these are the
+  // last chunks of the file. We read them again (hedge) instead of taking
+  // them away, the source keeps waiting for its own copies and whichever
+  // arrives first is used. We only hedge if we are the faster one, i.e.
+  // our share of the combined transfer rate is more than half.
+  if( !src->pOngoing.empty() && ShouldHedge( fraction ) )
   {
-    size_t count = static_cast<size_t>( round( fraction * src->pOngoing.size() ) );
-    while( count-- )
+    size_t count = 0;
+    std::map<uint64_t, uint64_t>::iterator itr;
+    for( itr = src->pOngoing.begin() ; itr != src->pOngoing.end() ; ++itr )
     {
-      std::map<uint64_t, uint64_t>::iterator itr = src->pOngoing.begin();
+      if( !pCtx->Hedge( itr->first ) ) continue;
       pRecovered.insert( *itr );
-      src->pOngoing.erase( itr );
+      ++count;
     }
 
-    log->Debug( UtilityMsg, "s%: Stealing fraction (%f) of ongoing chunks from %s", myHost.c_str(), fraction, srcHost.c_str() );
+    if( count )
+      log->Debug( UtilityMsg, "%s: Hedging %d ongoing chunks (fraction %f) of %s", myHost.c_str(), count, fraction, srcHost.c_str() );
   }
 }
 
@@ -520,7 +535,7 @@ XRootDStatus XCpSrc::GetWork()
 
     Log *log = DefaultEnv::GetLog();
     std::string myHost = URL( pUrl ).GetHostName();
-    log->Debug( UtilityMsg, "s% got next block", myHost.c_str() );
+    log->Debug( UtilityMsg, "%s got next block", myHost.c_str() );
 
     return XRootDStatus();
   }
@@ -536,8 +551,8 @@ XRootDStatus XCpSrc::GetWork()
 
 uint64_t XCpSrc::TransferRate()
 {
-  time_t duration = pTransferTime + time( 0 ) - pStartTime;
-  return pDataTransfered / ( duration + 1 ); // add one to avoid floating point exception
+  uint64_t duration = pTransferTime + NowMs() - pStartTime;
+  return pDataTransfered * 1000 / ( duration + 1 ); // add one to avoid floating point exception
 }
 
 } /* namespace XrdCl */
@@ -29,6 +29,8 @@
 #include "XrdCl/XrdClSyncQueue.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
+#include <cmath>
+
 namespace XrdCl
 {
 
@@ -118,6 +120,24 @@ class XCpSrc
      */
     uint64_t TransferRate();
 
+    /**
+     * @return : the URL of the replica currently used
+     */
+    std::string GetUrl()
+    {
+      XrdSysMutexHelper lck( pMtx );
+      return pUrl;
+    }
+
+    /**
+     * @return : total amount of data received from this source
+     */
+    uint64_t GetDataTransfered()
+    {
+      XrdSysMutexHelper lck( pMtx );
+      return pDataTransfered;
+    }
+
     /**
      * Delete ChunkInfo object, and set the pointer to null.
      *
@@ -133,6 +153,52 @@ class XCpSrc
       }
     }
 
+    /**
+     * Share of the work of a slower source we take over
+     * when stealing from it.
+     *
+     * @param myRate  : our transfer rate [B/s]
+     * @param srcRate : transfer rate of the source [B/s]
+     * @return        : our share of the combined transfer rate,
+     *                  0 if we did not transfer anything yet
+     */
+    static double StealFraction( uint64_t myRate, uint64_t srcRate )
+    {
+      if( myRate == 0 ) return 0;
+      return double( myRate ) / double( myRate + srcRate );
+    }
+
+    /**
+     * Number of bytes to steal from the block of a slower source.
+     *
+     * @param fraction  : share of the block to take (see StealFraction)
+     * @param blkSize   : bytes left in the block of the source
+     * @param chunkSize : chunk size
+     * @return          : the whole block if at most one chunk would
+     *                    be left to the source, the fraction otherwise
+     */
+    static uint64_t StealSize( double fraction, uint64_t blkSize,
+                               uint32_t chunkSize )
+    {
+      uint64_t steal = static_cast<uint64_t>( round( fraction * blkSize ) );
+      if( blkSize - steal <= chunkSize ) steal = blkSize;
+      return steal;
+    }
+
+    /**
+     * Should the ongoing chunks of a source be hedged, i.e.
+     * read again by us?
+     *
+     * @param fraction : our share of the combined transfer
+     *                   rate (see StealFraction)
+     * @return         : true if we are faster than the source,
+     *                   i.e. our share is more than half
+     */
+    static bool ShouldHedge( double fraction )
+    {
+      return fraction > 0.5;
+    }
+
   private:
 
     /**
@@ -197,8 +263,9 @@ class XCpSrc
      *   the block
      * - otherwise, if the source has recovered chunks,
      *   steal respective fraction of those chunks
-     * - otherwise, steal respective fraction of ongoing
-     *   chunks, if we are a faster source
+     * - otherwise, if we are a faster source, hedge the
+     *   ongoing chunks: read them again ourselves, the
+     *   copy that arrives first is used
      *
      * @param src : the source from whom we are stealing
      */
@@ -351,15 +418,15 @@ class XCpSrc
     bool                          pRunning;
 
     /**
-     * The time when we started / restarted  chunks
+     * The time when we started / restarted  chunks [ms]
      */
-    time_t                        pStartTime;
+    uint64_t                      pStartTime;
 
     /**
      * The total time we were transferring data, before
-     * the restart
+     * the restart [ms]
      */
-    time_t                        pTransferTime;
+    uint64_t                      pTransferTime;
 };
 
 } /* namespace XrdCl */
@@ -730,6 +730,39 @@ namespace XrdCl
     return ReadRawOther( msg, socket, bytesRead );
   }
 
+  //----------------------------------------------------------------------------
+  // Read message body, part of which has already been read from the socket
+  //----------------------------------------------------------------------------
+  Status XRootDMsgHandler::ReadMessageBody( Message     *msg,
+                                            int          socket,
+                                            const char *&buffer,
+                                            uint32_t    &size,
+                                            uint32_t    &bytesRead )
+  {
+    pReadAheadBuffer = buffer;
+    pReadAheadSize   = size;
+
+    //--------------------------------------------------------------------------
+    // The readv reader stops at every chunk boundary waiting for the socket
+    // to become readable again, which it will not if the rest of the
+    // response has already been buffered
+    //--------------------------------------------------------------------------
+    Status st;
+    do
+    {
+      uint32_t read = 0;
+      st = ReadMessageBody( msg, socket, read );
+      bytesRead += read;
+    }
+    while( st.IsOK() && st.code == suRetry && pReadAheadSize );
+
+    buffer = pReadAheadBuffer;
+    size   = pReadAheadSize;
+    pReadAheadBuffer = 0;
+    pReadAheadSize   = 0;
+    return st;
+  }
+
   //----------------------------------------------------------------------------
   // Handle a kXR_read in raw mode
   //----------------------------------------------------------------------------
@@ -1010,6 +1043,23 @@ namespace XrdCl
     while( pAsyncOffset < pAsyncReadSize )
     {
       uint32_t toBeRead = pAsyncReadSize - pAsyncOffset;
+
+      //------------------------------------------------------------------------
+      // Consume the data read ahead together with the message header first
+      //------------------------------------------------------------------------
+      if( pReadAheadSize )
+      {
+        if( toBeRead > pReadAheadSize )
+          toBeRead = pReadAheadSize;
+        memcpy( buffer, pReadAheadBuffer, toBeRead );
+        pReadAheadBuffer += toBeRead;
+        pReadAheadSize   -= toBeRead;
+        pAsyncOffset     += toBeRead;
+        buffer           += toBeRead;
+        bytesRead        += toBeRead;
+        continue;
+      }
+
       int status = ::read( socket, buffer, toBeRead );
       if( status < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) )
         return Status( stOK, suRetry );
@@ -26,9 +26,11 @@
 #define __XRD_CL_XROOTD_MSG_HANDLER_HH__
 
 #include "XrdCl/XrdClPostMasterInterfaces.hh"
+#include "XrdCl/XrdClBufferedRead.hh"
 #include "XrdCl/XrdClXRootDResponses.hh"
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdCl/XrdClMessage.hh"
+#include "XrdCl/XrdClMemoryPool.hh"
 #include "XProtocol/XProtocol.hh"
 
 #include <sys/uio.h>
@@ -43,7 +45,7 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   //! Handle/Process/Forward XRootD messages
   //----------------------------------------------------------------------------
-  class XRootDMsgHandler: public IncomingMsgHandler,
+  class XRootDMsgHandler: public BufferedIncomingMsgHandler,
                           public OutgoingMsgHandler
   {
       friend class HandleRspJob;
@@ -83,6 +85,9 @@ namespace XrdCl
         pAsyncReadBuffer( 0 ),
         pAsyncMsgSize( 0 ),
 
+        pReadAheadBuffer( 0 ),
+        pReadAheadSize( 0 ),
+
         pReadRawStarted( false ),
         pReadRawCurrentOffset( 0 ),
 
@@ -116,6 +121,19 @@ namespace XrdCl
           delete *it;
       }
 
+      //------------------------------------------------------------------------
+      //! Handlers come from the memory pool
+      //------------------------------------------------------------------------
+      static void *operator new( size_t size )
+      {
+        return MemoryPool::AllocateObject( size );
+      }
+
+      static void operator delete( void *ptr, size_t size )
+      {
+        MemoryPool::FreeObject( ptr, size );
+      }
+
       //------------------------------------------------------------------------
       //! Examine an incoming message, and decide on the action to be taken
       //!
@@ -154,6 +172,16 @@ namespace XrdCl
                                       int       socket,
                                       uint32_t &bytesRead );
 
+      //------------------------------------------------------------------------
+      //! Read message body - the buffered data is consumed before reading
+      //! from the socket
+      //------------------------------------------------------------------------
+      virtual Status ReadMessageBody( Message     *msg,
+                                      int          socket,
+                                      const char *&buffer,
+                                      uint32_t    &size,
+                                      uint32_t    &bytesRead );
+
       //------------------------------------------------------------------------
       //! Handle an event other that a message arrival
       //!
@@ -411,6 +439,9 @@ namespace XrdCl
       char*                      pAsyncReadBuffer;
       uint32_t                   pAsyncMsgSize;
 
+      const char                *pReadAheadBuffer;
+      uint32_t                   pReadAheadSize;
+
       bool                       pReadRawStarted;
       uint32_t                   pReadRawCurrentOffset;
 
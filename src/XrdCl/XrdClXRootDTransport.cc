@@ -278,6 +278,67 @@ namespace XrdCl
     return Status( stOK, suDone );
   }
 
+  //----------------------------------------------------------------------------
+  // Get message header from buffered data
+  //----------------------------------------------------------------------------
+  Status XRootDTransport::GetHeader( Message     *message,
+                                     const char *&buffer,
+                                     uint32_t    &size )
+  {
+    if( message->GetCursor() == 0 && message->GetSize() < 8 )
+      message->Allocate( 8 );
+
+    if( message->GetCursor() >= 8 )
+      return Status( stError, errInternal );
+
+    uint32_t toCopy = 8 - message->GetCursor();
+    if( toCopy > size )
+      toCopy = size;
+
+    memcpy( message->GetBufferAtCursor(), buffer, toCopy );
+    message->AdvanceCursor( toCopy );
+    buffer += toCopy;
+    size   -= toCopy;
+
+    if( message->GetCursor() < 8 )
+      return Status( stOK, suRetry );
+
+    UnMarshallHeader( message );
+
+    uint32_t bodySize = *(uint32_t*)(message->GetBuffer(4));
+    Log *log = DefaultEnv::GetLog();
+    log->Dump( XRootDTransportMsg, "[msg: 0x%x] Expecting %d bytes of message "
+               "body", message, bodySize );
+
+    return Status( stOK, suDone );
+  }
+
+  //----------------------------------------------------------------------------
+  // Get message body from buffered data
+  //----------------------------------------------------------------------------
+  Status XRootDTransport::GetBody( Message     *message,
+                                   const char *&buffer,
+                                   uint32_t    &size )
+  {
+    uint32_t bodySize = *(uint32_t*)(message->GetBuffer(4));
+
+    if( message->GetCursor() == 8 )
+      message->ReAllocate( bodySize + 8 );
+
+    uint32_t toCopy = bodySize-(message->GetCursor()-8);
+    if( toCopy > size )
+      toCopy = size;
+
+    memcpy( message->GetBufferAtCursor(), buffer, toCopy );
+    message->AdvanceCursor( toCopy );
+    buffer += toCopy;
+    size   -= toCopy;
+
+    if( message->GetCursor() < bodySize + 8 )
+      return Status( stOK, suRetry );
+    return Status( stOK, suDone );
+  }
+
   //----------------------------------------------------------------------------
   // Initialize channel
   //----------------------------------------------------------------------------
@@ -288,9 +349,12 @@ namespace XrdCl
     channelData.Set( info );
 
     Env *env = DefaultEnv::GetEnv();
-    int streams = DefaultSubStreamsPerChannel;
+    int streams    = DefaultSubStreamsPerChannel;
+    int maxStreams = DefaultMaxSubStreamsPerChannel;
     env->GetInt( "SubStreamsPerChannel", streams );
+    env->GetInt( "MaxSubStreamsPerChannel", maxStreams );
     if( streams < 1 ) streams = 1;
+    if( streams < maxStreams ) streams = maxStreams;
     info->stream.resize( streams );
   }
 
@@ -763,7 +827,8 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   // Return a number of substreams per stream that should be created
   // This depends on the environment and whether we are connected to
-  // a data server or not
+  // a data server or not, the stream decides how many of them are
+  // actually connected
   //----------------------------------------------------------------------------
   uint16_t XRootDTransport::SubStreamNumber( AnyObject &channelData )
   {
@@ -1100,6 +1165,19 @@ namespace XrdCl
       case XRootDQuery::ProtocolVersion:
         result.Set( new int( info->protocolVersion ), false );
         return Status();
+
+      //------------------------------------------------------------------------
+      // Connected substreams
+      //------------------------------------------------------------------------
+      case XRootDQuery::SubStreams:
+      {
+        int connected = 0;
+        for( size_t i = 0; i < info->stream.size(); ++i )
+          if( info->stream[i].status == XRootDStreamInfo::Connected )
+            ++connected;
+        result.Set( new int( connected ), false );
+        return Status();
+      }
     };
     return Status( stError, errQueryNotSupported );
   }
@@ -26,6 +26,7 @@
 #define __XRD_CL_XROOTD_TRANSPORT_HH__
 
 #include "XrdCl/XrdClPostMaster.hh"
+#include "XrdCl/XrdClBufferedRead.hh"
 #include "XProtocol/XProtocol.hh"
 #include "XrdSec/XrdSecInterface.hh"
 #include "XrdOuc/XrdOucEnv.hh"
@@ -46,12 +47,14 @@ namespace XrdCl
     static const uint16_t SIDManager      = 1001; //!< returns the SIDManager object
     static const uint16_t ServerFlags     = 1002; //!< returns server flags
     static const uint16_t ProtocolVersion = 1003; //!< returns the protocol version
+    static const uint16_t SubStreams      = 1004; //!< returns the number of
+                                                  //!< connected substreams
   };
 
   //----------------------------------------------------------------------------
   //! XRootD transport handler
   //----------------------------------------------------------------------------
-  class XRootDTransport: public TransportHandler
+  class XRootDTransport: public BufferedTransportHandler
   {
     public:
       //------------------------------------------------------------------------
@@ -90,6 +93,20 @@ namespace XrdCl
       //------------------------------------------------------------------------
       virtual Status GetBody( Message *message, int socket );
 
+      //------------------------------------------------------------------------
+      //! Get the message header from data already read from the socket
+      //------------------------------------------------------------------------
+      virtual Status GetHeader( Message     *message,
+                                const char *&buffer,
+                                uint32_t    &size );
+
+      //------------------------------------------------------------------------
+      //! Get the message body from data already read from the socket
+      //------------------------------------------------------------------------
+      virtual Status GetBody( Message     *message,
+                              const char *&buffer,
+                              uint32_t    &size );
+
       //------------------------------------------------------------------------
       //! Initialize channel
       //------------------------------------------------------------------------
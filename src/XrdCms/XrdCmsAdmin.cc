@@ -42,8 +42,10 @@
 #include "XrdCms/XrdCmsAdmin.hh"
 #include "XrdCms/XrdCmsConfig.hh"
 #include "XrdCms/XrdCmsManager.hh"
+#include "XrdCms/XrdCmsNotify.hh"
 #include "XrdCms/XrdCmsPrepare.hh"
 #include "XrdCms/XrdCmsState.hh"
+#include "XrdCms/XrdCmsSummary.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 #include "XrdNet/XrdNetSocket.hh"
 #include "XrdOuc/XrdOuca2x.hh"
@@ -414,7 +416,7 @@ do{areMutex.Lock();
             }
          (*areFunc)(evP->text, 0, evType, 0, evP->text);
          DEBUG("sending managers " <<evWhat <<evP->text);
-         XrdCmsManager::Inform(reqCode, mod, evP->text, strlen(evP->text)+1);
+         Notifier.Add(reqCode, mod, evP->text, strlen(evP->text));
          delete evP;
          areMutex.Lock();
         }
@@ -772,7 +774,7 @@ void XrdCmsAdmin::do_RmDid(int isPfn)
 //
    if (areFunc) AddEvent(tp, kYR_gone, kYR_raw);
       else {DEBUG("sending managers gone " <<tp);
-            XrdCmsManager::Inform(kYR_gone, kYR_raw, tp, strlen(tp)+1);
+            Notifier.Add(kYR_gone, kYR_raw, tp, strlen(tp));
            }
 }
  
@@ -801,10 +803,14 @@ void XrdCmsAdmin::do_RmDud(int isPfn)
           } else tp = apath;
       }
 
+// Make sure our namespace summary does not hide the new file
+//
+   Summarizer.Added(tp);
+
 // Check if we are relaying remove events and, if so, vector through that.
 //
    if (areFunc) AddEvent(tp, kYR_have, Mods);
       else {DEBUG("sending managers have online " <<tp);
-            XrdCmsManager::Inform(kYR_have, Mods, tp, strlen(tp)+1);
+            Notifier.Add(kYR_have, Mods, tp, strlen(tp));
            }
 }
@@ -85,7 +85,7 @@ int XrdCmsBaseFS::Bypass()
 // do this to bypass the queue unless until we get flooded by requests.
 //
    theQ.Mutex.Lock();
-   if (!theQ.rLeft && !theQ.pqFirst)
+   if (!theQ.rLeft && !theQ.pqNum)
       {unsigned long Interval = 0;
        Window.Report(Interval);
        if (Interval >= 450)
@@ -112,7 +112,8 @@ int XrdCmsBaseFS::Bypass()
 /* Public:                        E x i s t s                                 */
 /******************************************************************************/
   
-int XrdCmsBaseFS::Exists(XrdCmsRRData &Arg, XrdCmsPInfo &Who, int noLim)
+int XrdCmsBaseFS::Exists(XrdCmsRRData &Arg, XrdCmsPInfo &Who, int noLim,
+                         int rqCls)
 {
    int aOK, fnPos;
 
@@ -121,7 +122,7 @@ int XrdCmsBaseFS::Exists(XrdCmsRRData &Arg, XrdCmsPInfo &Who, int noLim)
 //
    if (!lclStat)
       {aOK = (!theQ.rLimit || noLim || (!Fixed && Bypass()));
-       if (Who.rovec) Queue(Arg, Who, -(Arg.PathLen-1), !aOK);
+       if (Who.rovec) Queue(Arg, Who, -(Arg.PathLen-1), !aOK, rqCls);
        return 0;
       }
 
@@ -142,7 +143,7 @@ int XrdCmsBaseFS::Exists(XrdCmsRRData &Arg, XrdCmsPInfo &Who, int noLim)
 
 // We can't do this now, so forcibly queue the request
 //
-   if (Who.rovec) Queue(Arg, Who, fnPos, 1);
+   if (Who.rovec) Queue(Arg, Who, fnPos, 1, rqCls);
    return 0;
 }
 
@@ -237,8 +238,9 @@ void XrdCmsBaseFS::Init(int Opts, int DMLife, int DPLife)
 /*                                 L i m i t                                  */
 /******************************************************************************/
   
-void XrdCmsBaseFS::Limit(int rLim, int Qmax)
+void XrdCmsBaseFS::Limit(int rLim, int Qmax, int tNum, int Share)
 {
+   int i;
 
 // Establish the limits
 //
@@ -247,6 +249,61 @@ void XrdCmsBaseFS::Limit(int rLim, int Qmax)
    theQ.rLimit = (rLim <= 1000 ? rLim : 0);
    if (Qmax > 0) theQ.qMax = Qmax;
       else if (!(theQ.qMax = theQ.rLimit*2 + theQ.rLimit/2)) theQ.qMax = 1;
+
+// Establish the lookup pool and how much of the rate any one requester may use.
+// Each requester class gets a token bucket holding up to half a second's worth.
+//
+   theQ.tNum = (tNum > 0 ? tNum : 1);
+   if (Share > 0 && Share < 100 && theQ.rLimit)
+      {if (!(theQ.cRate = theQ.rLimit*Share/100)) theQ.cRate = 1;
+       theQ.cBurst = (theQ.cRate > 1 ? theQ.cRate/2 : 1);
+       for (i = 0; i < maxCls; i++) theQ.pq[i].Tokens = theQ.cBurst*1000;
+      } else theQ.cRate = theQ.cBurst = 0;
+}
+
+/******************************************************************************/
+/* Private:                         N e x t                                   */
+/******************************************************************************/
+
+// Next() must be called with the queue mutex held. It returns the next request
+// to be processed, taking one from each requester class in turn so that a
+// requester flooding us does not delay everyone else. If classes are rate
+// limited, a class may only be served when its token bucket allows it. A null
+// pointer is returned if every waiting class has exhausted its tokens.
+//
+XrdCmsBaseFR *XrdCmsBaseFS::Next()
+{
+   static XrdSysTimer Window;
+   XrdCmsBaseFR *rP;
+   int i, k;
+
+// Refill the token buckets for the time that has passed
+//
+   if (theQ.cRate)
+      {unsigned long Interval = 0;
+       int Add, Max = theQ.cBurst*1000;
+       Window.Report(Interval);
+       if (Interval)
+          {Window.Reset();
+           Add = (Interval >= 1000 ? Max : int(Interval)*theQ.cRate);
+           for (i = 0; i < maxCls; i++)
+               if ((theQ.pq[i].Tokens += Add) > Max) theQ.pq[i].Tokens = Max;
+          }
+      }
+
+// Find the next class with a request we can process
+//
+   for (i = 0; i < maxCls; i++)
+       {ClassQ &cQ = theQ.pq[(k = (theQ.pqNext + i) % maxCls)];
+        if (!(rP = cQ.First) || (theQ.cRate && cQ.Tokens < 1000)) continue;
+        if (!(cQ.First = rP->Next)) cQ.Last = 0;
+        if (theQ.cRate) cQ.Tokens -= 1000;
+        theQ.pqNext = k+1;
+        theQ.pqNum--;
+        rP->Next = 0;
+        return rP;
+       }
+   return 0;
 }
 
 /******************************************************************************/
@@ -255,27 +312,39 @@ void XrdCmsBaseFS::Limit(int rLim, int Qmax)
   
 void XrdCmsBaseFS::Pacer()
 {
-   XrdCmsBaseFR *rP;
-   int inQ, rqRate = 1000/theQ.rLimit;
+   XrdCmsBaseFR *rP, *dP;
+   int rqRate = 1000/theQ.rLimit;
 
-// Process requests at the given rate
+// Process requests at the given rate. The semaphore is posted once for each
+// queued request. Should every waiting requester be over its share, we simply
+// wait until one of them gets another token.
 //
 do{theQ.pqAvail.Wait();
-   theQ.Mutex.Lock(); inQ = 1;
-   while((rP = theQ.pqFirst))
-        {if (!(theQ.pqFirst = rP->Next)) {theQ.pqLast = 0; inQ = 0;}
-         theQ.Mutex.UnLock();
-         if (rP->PDirLen > 0 && !hasDir(rP->Path, rP->PDirLen))
-            {delete rP; continue;}
-         theQ.Mutex.Lock();
-         if (theQ.rqFirst) {theQ.rqLast->Next = rP; theQ.rqLast = rP;}
-            else {theQ.rqFirst  = theQ.rqLast = rP; theQ.rqAvail.Post();}
-         theQ.Mutex.UnLock();
+   theQ.Mutex.Lock();
+   while(!(rP = Next()))
+        {theQ.Mutex.UnLock();
          XrdSysTimer::Wait(rqRate);
-         if (!inQ) break;
          theQ.Mutex.Lock();
         }
-   if (inQ) theQ.Mutex.UnLock();
+   theQ.Mutex.UnLock();
+
+// Requests for files in directories known not to exist are simply dropped
+//
+   if (rP->PDirLen > 0 && !hasDir(rP->Path, rP->PDirLen))
+      {dP = Unhook(rP); delete rP;
+       while((rP = dP)) {dP = rP->Next; delete rP;}
+       theQ.Mutex.Lock(); theQ.qNum--; theQ.Mutex.UnLock();
+       continue;
+      }
+
+// Hand off the request to a runner thread
+//
+   theQ.Mutex.Lock();
+   if (theQ.rqFirst) {theQ.rqLast->Next = rP; theQ.rqLast = rP;}
+      else theQ.rqFirst  = theQ.rqLast = rP;
+   theQ.Mutex.UnLock();
+   theQ.rqAvail.Post();
+   XrdSysTimer::Wait(rqRate);
   } while(1);
 }
   
@@ -284,11 +353,11 @@ do{theQ.pqAvail.Wait();
 /******************************************************************************/
 
 void XrdCmsBaseFS::Queue(XrdCmsRRData &Arg, XrdCmsPInfo &Who,
-                         int fnpos, int Force)
+                         int fnpos, int Force, int rqCls)
 {
    EPNAME("Queue");
    static int noMsg = 1;
-   XrdCmsBaseFR *rP;
+   XrdCmsBaseFR *rP, *lP;
    int Msg, n, prevHWM;
 
 // If we can bypass the queue and execute this now. Avoid the grabbing the buff.
@@ -304,15 +373,32 @@ void XrdCmsBaseFS::Queue(XrdCmsRRData &Arg, XrdCmsPInfo &Who,
 //
    DEBUG("inq " <<theQ.qNum <<" pace " <<Arg.Path);
    rP = new XrdCmsBaseFR(Arg, Who, fnpos);
+   rP->Cls = static_cast<short>(rqCls < 0 ? 0 : rqCls % maxCls);
 
-// Add the element to the queue
+// If we are doing the lookups and one for this path is already queued, this
+// request simply rides along with it as its answer will be the same.
 //
    theQ.Mutex.Lock();
+   if (lclStat)
+      {if ((lP = theQ.Active.Find(rP->Path)))
+          {rP->Next = lP->Dups; lP->Dups = rP;
+           theQ.Mutex.UnLock();
+           DEBUG("dup " <<rP->Path);
+           return;
+          }
+       theQ.Active.Add(rP->Path, rP, 0, Hash_keepdata);
+      }
+
+// Add the element to the queue of its class
+//
+   ClassQ &cQ = theQ.pq[rP->Cls];
    n = ++theQ.qNum; prevHWM = theQ.qHWM;
    if ((Msg = (n > prevHWM))) theQ.qHWM = n;
-   if (theQ.pqFirst) {theQ.pqLast->Next = rP; theQ.pqLast = rP;}
-      else {theQ.pqFirst = theQ.pqLast  = rP; theQ.pqAvail.Post();}
+   if (cQ.First) {cQ.Last->Next = rP; cQ.Last = rP;}
+      else cQ.First = cQ.Last = rP;
+   theQ.pqNum++;
    theQ.Mutex.UnLock();
+   theQ.pqAvail.Post();
 
 // Issue a warning message if we have an excessive number of requests queued
 //
@@ -332,21 +418,18 @@ void XrdCmsBaseFS::Queue(XrdCmsRRData &Arg, XrdCmsPInfo &Who,
 void XrdCmsBaseFS::Runner()
 {
    XrdCmsBaseFR *rP;
-   int inQ;
 
-// Process requests at the given rate
+// Process requests as the pacer releases them. There may be several runners
+// so that a slow lookup does not hold up the ones behind it.
 //
 do{theQ.rqAvail.Wait();
-   theQ.Mutex.Lock(); inQ = 1;
-   while((rP = theQ.rqFirst))
-        {if (!(theQ.rqFirst = rP->Next)) {theQ.rqLast = 0; inQ = 0;}
-         theQ.qNum--;
-         theQ.Mutex.UnLock();
-         Xeq(rP); delete rP;
-         if (!inQ) break;
-         theQ.Mutex.Lock();
-        }
-   if (inQ) theQ.Mutex.UnLock();
+   theQ.Mutex.Lock();
+   if ((rP = theQ.rqFirst))
+      {if (!(theQ.rqFirst = rP->Next)) theQ.rqLast = 0;
+       theQ.qNum--;
+      }
+   theQ.Mutex.UnLock();
+   if (rP) {Xeq(rP); delete rP;}
   } while(1);
 }
 
@@ -359,37 +442,63 @@ void XrdCmsBaseFS::Start()
    EPNAME("Start");
    void *Me = (void *)this;
    pthread_t tid;
+   int i;
 
 // Issue some debugging here so we know how we are starting up
 //
    DEBUG("Srv=" <<int(Server) <<" dfs=" <<int(dfsSys) <<" lcl=" <<int(lclStat)
          <<" Pre=" <<int(preSel) <<" dmLife=" <<dmLife <<' ' <<dpLife);
    DEBUG("Lim=" <<theQ.rLimit <<' ' <<theQ.rAgain <<" fix=" <<int(Fixed)
-         <<" Qmax=" <<theQ.qMax);
+         <<" Qmax=" <<theQ.qMax <<" thr=" <<theQ.tNum <<" cls=" <<theQ.cRate);
 
 // Set the passthru option if we can't do this locally and have no limit
 //
    Punt = (!theQ.rLimit && !lclStat);
 
-// If we need to throttle we will need two threads for the queue. The first is
-// the pacer thread that feeds the runner thread at a fixed rate.
+// If we need to throttle we will need at least two threads for the queue. The
+// first is the pacer thread that feeds the runner threads at a fixed rate.
 //
    if (theQ.rLimit)
-      {if (XrdSysThread::Run(&tid, XrdCmsBasePacer,  Me, 0, "fsQ pacer")
-       ||  XrdSysThread::Run(&tid, XrdCmsBaseRunner, Me, 0, "fsQ runner"))
+      {if (XrdSysThread::Run(&tid, XrdCmsBasePacer,  Me, 0, "fsQ pacer"))
           {Say.Emsg("cmsd", errno, "start baseFS queue handler");
            theQ.rLimit = 0;
+           return;
           }
+       for (i = 0; i < theQ.tNum; i++)
+           if (XrdSysThread::Run(&tid, XrdCmsBaseRunner, Me, 0, "fsQ runner"))
+              {Say.Emsg("cmsd", errno, "start baseFS queue runner");
+               if (!i) theQ.rLimit = 0;
+               break;
+              }
       }
 }
 
+/******************************************************************************/
+/* Private:                       U n h o o k                                 */
+/******************************************************************************/
+
+// Unhook() removes a request from the table of queued lookups and returns the
+// list of requests for the same path that were waiting on it.
+//
+XrdCmsBaseFR *XrdCmsBaseFS::Unhook(XrdCmsBaseFR *rP)
+{
+   XrdCmsBaseFR *dP;
+
+   theQ.Mutex.Lock();
+   if (theQ.Active.Find(rP->Path) == rP) theQ.Active.Del(rP->Path);
+   dP = rP->Dups; rP->Dups = 0;
+   theQ.Mutex.UnLock();
+   return dP;
+}
+
 /******************************************************************************/
 /* Pricate:                          X e q                                    */
 /******************************************************************************/
 
 void XrdCmsBaseFS::Xeq(XrdCmsBaseFR *rP)
 {
-   int rc;
+   XrdCmsBaseFR *dP;
+   int rc = 0, Reply = 1;
   
 // If we are not doing local stat calls, callback indicating a forward is needed
 //
@@ -398,23 +507,24 @@ void XrdCmsBaseFS::Xeq(XrdCmsBaseFR *rP)
        return;
       }
 
-// Check if we can avoid doing a stat()
-//
-   if (dmLife && rP->PDirLen > 0 && !hasDir(rP->Path, rP->PDirLen))
-      {if (cBack) (*cBack)(rP, -1);
-       return;
-      }
-
-// If we have exceeded the queue limit and this is a meta-manager request
-// then just deep-six it. Local requests must complete
+// Check if we can avoid doing a stat(). If we have exceeded the queue limit and
+// this is a meta-manager request then just deep-six it. Otherwise, perform a
+// local stat() to see if we have the file.
 //
-   if (theQ.qNum > theQ.qMax)
-      {Say.Emsg("Xeq", "Queue limit exceeded; ignoring lkup for", rP->Path);
-       return;
-      }
-
-// Perform a local stat() and if we don't have the file
+   if (dmLife && rP->PDirLen > 0 && !hasDir(rP->Path, rP->PDirLen)) rc = -1;
+      else if (theQ.qNum > theQ.qMax)
+              {Say.Emsg("Xeq","Queue limit exceeded; ignoring lkup for",rP->Path);
+               Reply = 0;
+              }
+      else rc = Exists(rP->Path, rP->PDirLen);
+
+// Give the answer to this request and any that were waiting on it
 //
-   rc = Exists(rP->Path, rP->PDirLen);
-   if (cBack) (*cBack)(rP, rc);
+   dP = Unhook(rP);
+   if (Reply && cBack) (*cBack)(rP, rc);
+   while((rP = dP))
+        {dP = rP->Next;
+         if (Reply && cBack) (*cBack)(rP, rc);
+         delete rP;
+        }
 }
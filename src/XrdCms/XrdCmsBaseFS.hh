@@ -52,18 +52,20 @@ public:
 SMask_t          Route;
 SMask_t          RouteW;
 XrdCmsBaseFR    *Next;
+XrdCmsBaseFR    *Dups;    // Queued requests for the same path awaiting ours
 char            *Buff;
 char            *Path;
 short            PathLen;
 short            PDirLen;
 kXR_unt32        Sid;
 kXR_char         Mod;
+short            Cls;     // Requester class for fair queuing
 
                  XrdCmsBaseFR(XrdCmsRRData &Arg, XrdCmsPInfo &Who, int Dln)
                              : Route(Who.rovec), RouteW(Who.rwvec), Next(0),
-                               PathLen(Arg.PathLen), PDirLen(Dln),
+                               Dups(0), PathLen(Arg.PathLen), PDirLen(Dln),
                                Sid(Arg.Request.streamid),
-                               Mod(Arg.Request.modifier)
+                               Mod(Arg.Request.modifier), Cls(0)
                              {if (Arg.Buff)
                                  {Path=Arg.Path; Buff=Arg.Buff; Arg.Buff=0;}
                                  else Buff = Path = strdup(Arg.Path);
@@ -71,10 +73,10 @@ kXR_char         Mod;
 
                  XrdCmsBaseFR(XrdCmsRRData *aP,  XrdCmsPInfo &Who, int Dln)
                              : Route(Who.rovec), RouteW(Who.rwvec),
-                               Next(0), Buff(0), Path(aP->Path),
+                               Next(0), Dups(0), Buff(0), Path(aP->Path),
                                PathLen(aP->PathLen), PDirLen(Dln),
                                Sid(aP->Request.streamid),
-                               Mod(aP->Request.modifier)
+                               Mod(aP->Request.modifier), Cls(0)
                              {}
 
                ~XrdCmsBaseFR() {if (Buff) free(Buff); Buff = 0;}
@@ -96,7 +98,11 @@ public:
 //  0                      -> File state unknown, result will be provided later
 // -1                      -> File is known not to exist
 //
-       int              Exists(XrdCmsRRData &Arg,XrdCmsPInfo &Who,int noLim=0);
+// When requests are queued, rqCls identifies the requester (typically its node
+// number) so that the queue is shared fairly amongst requesters.
+//
+       int              Exists(XrdCmsRRData &Arg,XrdCmsPInfo &Who,int noLim=0,
+                               int rqCls=0);
 
 // The following exists works as above but limits are never enforced and it
 // never returns 0. Additionally, the fnpos parameter works as follows:
@@ -120,7 +126,7 @@ inline int              isDFS() {return dfsSys;}
 
 inline int              Limit() {return theQ.rLimit;}
 
-       void             Limit(int rLim, int qMax);
+       void             Limit(int rLim, int qMax, int tNum=1, int Share=100);
 
 inline int              Local() {return lclStat;}
 
@@ -160,20 +166,32 @@ struct dMoP {int        Present;};
        int              Bypass();
        int              FStat( char *Path, int fnPos, int upat=0);
        int              hasDir(char *Path, int fnPos);
+       XrdCmsBaseFR    *Next();
        void             Queue(XrdCmsRRData &Arg, XrdCmsPInfo &Who,
-                              int dln, int Frc=0);
+                              int dln, int Frc=0, int rqCls=0);
+       XrdCmsBaseFR    *Unhook(XrdCmsBaseFR *rP);
        void             Xeq(XrdCmsBaseFR *rP);
 
        XrdSysMutex      fsMutex;
        XrdOucHash<dMoP> fsDirMP;
        void             (*cBack)(XrdCmsBaseFR *, int);
 
+static const int        maxCls = STMax; // One requester class per node
+
+struct ClassQ
+      {XrdCmsBaseFR    *First;
+       XrdCmsBaseFR    *Last;
+       int              Tokens;   // Token bucket in thousandths of a request
+       ClassQ() : First(0), Last(0), Tokens(0) {}
+      ~ClassQ() {}
+      };
+
 struct RequestQ
       {XrdSysMutex      Mutex;
        XrdSysSemaphore  pqAvail;
        XrdSysSemaphore  rqAvail;
-       XrdCmsBaseFR    *pqFirst;
-       XrdCmsBaseFR    *pqLast;
+       XrdOucHash<XrdCmsBaseFR> Active; // Queued lookups by path
+       ClassQ           pq[maxCls];
        XrdCmsBaseFR    *rqFirst;
        XrdCmsBaseFR    *rqLast;
        int              rLimit;   // Maximum number of requests per second
@@ -182,10 +200,16 @@ struct RequestQ
        int              qNum;     // Total number of queued elements (pq + rq)
        int              rLeft;    // Number of non-queue requests allowed
        int              rAgain;   // Value to reinitialize rLeft
+       int              pqNum;    // Number of elements in the class queues
+       int              pqNext;   // Next class queue to be served
+       int              cRate;    // Requests per second per class (0 -> any)
+       int              cBurst;   // Maximum requests a class may save up
+       int              tNum;     // Number of runner threads
        RequestQ() : pqAvail(0), rqAvail(0),
-                    pqFirst(0), pqLast(0), rqFirst(0), rqLast(0),
+                    rqFirst(0), rqLast(0),
                     rLimit(0),  qHWM(0),   qMax(1),    qNum(0),
-                    rLeft(0),   rAgain(0)  {}
+                    rLeft(0),   rAgain(0), pqNum(0),   pqNext(0),
+                    cRate(0),   cBurst(0), tNum(1)  {}
       ~RequestQ() {}
       }                 theQ;
 
@@ -29,6 +29,7 @@
 /******************************************************************************/
   
 #include <stdio.h>
+#include <string.h>
 #include <sys/types.h>
 
 #include "XrdCms/XrdCmsCache.hh"
@@ -61,15 +62,15 @@ class XrdCmsCacheJob : XrdJob
 {
 public:
 
-void   DoIt() {Cache.Recycle(myList); delete this;}
+void   DoIt() {Cache.Recycle(myLists); delete this;}
 
-       XrdCmsCacheJob(XrdCmsKeyItem *List)
-                     : XrdJob("cache scrubber"), myList(List) {}
+       XrdCmsCacheJob(XrdCmsKeyItem **Lists) : XrdJob("cache scrubber")
+                     {memcpy(myLists, Lists, sizeof(myLists));}
       ~XrdCmsCacheJob() {}
 
 private:
 
-XrdCmsKeyItem *myList;
+XrdCmsKeyItem      *myLists[XrdCmsCache::ShardCnt];
 };
 
 /******************************************************************************/
@@ -100,7 +101,9 @@ void *XrdCmsStartTickTock(void *carg)
 //                 For a r/w location, the deadline is satisfied and all
 //                 callbacks are dispatched. For an r/o location the deadline
 //                 is satisfied if no r/w callback is pending. Any r/o
-//                 callback is dispatched. The Info object is ignored.
+//                 callback is dispatched. The Info object is ignored. Should
+//                 this be the last queried server to respond, the lookup is
+//                 resolved (see Resolve()).
 
 // Key not found:  A selective addition occurs, depending on Sel.Opts
 // Opts !Advisory: The entry is added to the cache with location information
@@ -116,18 +119,29 @@ void *XrdCmsStartTickTock(void *carg)
   
 int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
 {
-   XrdCmsKeyItem *iP;
-   SMask_t xmask;
-   int isrw = (Sel.Opts & XrdCmsSelect::Write), isnew = 0;
+   Shard &sh = getShard(Sel.Path);
+   int isnew;
 
 // Serialize processing
 //
-   myMutex.Lock();
+   sh.Lock();
+   isnew = AddItem(sh, Sel, mask);
+   sh.UnLock();
+   return isnew;
+}
+
+/******************************************************************************/
+
+int XrdCmsCache::AddItem(Shard &sh, XrdCmsSelect &Sel, SMask_t mask)
+{
+   XrdCmsKeyItem *iP;
+   SMask_t xmask;
+   int isrw = (Sel.Opts & XrdCmsSelect::Write), isnew = 0;
 
 // Check for fast path processing
 //
    if (  !(iP = Sel.Path.TODRef) || !(iP->Key.Equiv(Sel.Path)))
-      if ((iP = Sel.Path.TODRef = CTable.Find(Sel.Path)))
+      if ((iP = Sel.Path.TODRef = sh.CTable.Find(Sel.Path)))
          Sel.Path.Ref = iP->Key.Ref;
 
 // Add/Modify the entry
@@ -137,8 +151,9 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
           {iP->Loc.deadline = QDelay + time(0);
            iP->Loc.lifeline = nilTMO + iP->Loc.deadline;
            iP->Loc.hfvec = 0; iP->Loc.pfvec = 0; iP->Loc.qfvec = 0;
-           iP->Loc.TOD_B = BClock;
-           iP->Key.TOD = Tock;
+           iP->Loc.rfvec = 0;
+           iP->Loc.TOD_B = sh.BClock;
+           iP->Key.TOD = sh.Tock;
           } else {
            xmask = iP->Loc.pfvec;
            if (Sel.Opts & XrdCmsSelect::Pending) iP->Loc.pfvec |= mask;
@@ -153,14 +168,16 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
               else   {if (!iP->Loc.rwPend) iP->Loc.deadline = 0;
                       if (iP->Loc.roPend) Dispatch(Sel, iP, iP->Loc.roPend, 0);
                      }
+           if (iP->Loc.rfvec && !(iP->Loc.rfvec &= ~mask)) Resolve(iP);
           }
       } else if (!(Sel.Opts & XrdCmsSelect::Advisory))
-                {Sel.Path.TOD = Tock;
-                 if ((iP = CTable.Add(Sel.Path)))
+                {Sel.Path.TOD = sh.Tock;
+                 if ((iP = sh.CTable.Add(Sel.Path)))
                     {iP->Loc.pfvec    = (Sel.Opts&XrdCmsSelect::Pending?mask:0);
                      iP->Loc.hfvec    = mask;
-                     iP->Loc.TOD_B    = BClock;
+                     iP->Loc.TOD_B    = sh.BClock;
                      iP->Loc.qfvec    = 0;
+                     iP->Loc.rfvec    = 0;
                      iP->Loc.deadline = QDelay + time(0);
                      iP->Loc.lifeline = nilTMO + iP->Loc.deadline;
                      Sel.Path.Ref     = iP->Key.Ref;
@@ -170,10 +187,32 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
 
 // All done
 //
-   myMutex.UnLock();
    return isnew;
 }
   
+/******************************************************************************/
+/* Public                        A s k F i l e                                */
+/******************************************************************************/
+
+// Servers that have the file say so but those that do not stay silent unless
+// asked to respond with a miss. The set of servers being asked is recorded so
+// that the lookup can be resolved when the last of them has responded instead
+// of when the deadline passes.
+  
+void XrdCmsCache::AskFile(XrdCmsSelect &Sel, SMask_t mask)
+{
+   Shard &sh = getShard(Sel.Path);
+   XrdCmsKeyItem *iP;
+
+// Look up the entry and if valid update the query vector. Note that this
+// method may only be called after GetFile() or AddFile() for a new entry
+//
+   sh.Lock();
+   if ((iP = Sel.Path.TODRef) && iP->Key.Equiv(Sel.Path)
+   &&  !(iP->Loc.rfvec = mask & ~iP->Loc.hfvec)) Resolve(iP);
+   sh.UnLock();
+}
+
 /******************************************************************************/
 /* Public                        D e l F i l e                                */
 /******************************************************************************/
@@ -190,29 +229,39 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
   
 int XrdCmsCache::DelFile(XrdCmsSelect &Sel, SMask_t mask)
 {
-   XrdCmsKeyItem *iP;
+   Shard &sh = getShard(Sel.Path);
    int gone4good;
 
 // Lock the hash table
 //
-   myMutex.Lock();
+   sh.Lock();
+   gone4good = DelItem(sh, Sel, mask);
+   sh.UnLock();
+   return gone4good;
+}
+
+/******************************************************************************/
+
+int XrdCmsCache::DelItem(Shard &sh, XrdCmsSelect &Sel, SMask_t mask)
+{
+   XrdCmsKeyItem *iP;
+   int gone4good;
 
 // Look up the entry and remove server
 //
-   if ((iP = CTable.Find(Sel.Path)))
+   if ((iP = sh.CTable.Find(Sel.Path)))
       {iP->Loc.hfvec &= ~mask;
        iP->Loc.pfvec &= ~mask;
        if ((gone4good = (iP->Loc.hfvec == 0)))
           {if (nilTMO) iP->Loc.lifeline = nilTMO + time(0);
            if (!(Sel.Opts & XrdCmsSelect::Advisory)
-           &&  XrdCmsKeyItem::Unload(iP) && !CTable.Recycle(iP))
+           &&  sh.Items.Unload(iP) && !sh.CTable.Recycle(iP))
               Say.Emsg("DelFile", "Delete failed for", iP->Key.Val);
           }
       } else gone4good = 0;
 
 // All done
 //
-   myMutex.UnLock();
    return gone4good;
 }
   
@@ -231,22 +280,24 @@ int XrdCmsCache::DelFile(XrdCmsSelect &Sel, SMask_t mask)
   
 int  XrdCmsCache::GetFile(XrdCmsSelect &Sel, SMask_t mask)
 {
+   Shard &sh = getShard(Sel.Path);
    XrdCmsKeyItem *iP;
    SMask_t bVec;
    int retc;
 
 // Lock the hash table
 //
-   myMutex.Lock();
+   sh.Lock();
 
 // Look up the entry and return location information
 //
-   if ((iP = CTable.Find(Sel.Path)))
-      {if ((bVec = (iP->Loc.TOD_B < BClock 
-                 ? getBVec(iP->Key.TOD, iP->Loc.TOD_B) & mask : 0)))
+   if ((iP = sh.CTable.Find(Sel.Path)))
+      {if ((bVec = (iP->Loc.TOD_B < sh.BClock
+                 ? getBVec(sh, iP->Key.TOD, iP->Loc.TOD_B) & mask : 0)))
           {iP->Loc.hfvec &= ~bVec; 
            iP->Loc.pfvec &= ~bVec;
            iP->Loc.qfvec &= ~mask;
+           iP->Loc.rfvec  = 0;
            iP->Loc.deadline = QDelay + time(0);
            iP->Loc.lifeline = nilTMO + iP->Loc.deadline;
            retc = -1;
@@ -258,19 +309,81 @@ int  XrdCmsCache::GetFile(XrdCmsSelect &Sel, SMask_t mask)
        if (nilTMO && retc == 1 && iP->Loc.hfvec == 0
        &&  iP->Loc.lifeline <= time(0)) retc = 0;
 
-       Sel.Vec.hf      = okVec & iP->Loc.hfvec;
-       Sel.Vec.pf      = okVec & iP->Loc.pfvec;
-       Sel.Vec.bf      = okVec & (bVec | iP->Loc.qfvec); iP->Loc.qfvec = 0;
+       Sel.Vec.hf      = sh.okVec & iP->Loc.hfvec;
+       Sel.Vec.pf      = sh.okVec & iP->Loc.pfvec;
+       Sel.Vec.bf      = sh.okVec & (bVec | iP->Loc.qfvec); iP->Loc.qfvec = 0;
        Sel.Path.Ref    = iP->Key.Ref;
       } else retc = 0;
 
 // All done
 //
-   myMutex.UnLock();
+   sh.UnLock();
    Sel.Path.TODRef = iP;
    return retc;
 }
 
+/******************************************************************************/
+/* Public                        N a k F i l e                                */
+/******************************************************************************/
+
+// This method is called when a queried server responds that it does not have
+// the file or when a server could not be queried at all. When no queried
+// server remains outstanding and all servers were queried, the lookup is
+// resolved (see Resolve()).
+  
+void XrdCmsCache::NakFile(XrdCmsSelect &Sel, SMask_t mask)
+{
+   Shard &sh = getShard(Sel.Path);
+   XrdCmsKeyItem *iP;
+
+// Lock the hash table
+//
+   sh.Lock();
+
+// Look up the entry and remove the servers from the outstanding set
+//
+   if ((iP = sh.CTable.Find(Sel.Path))
+   &&  iP->Loc.rfvec && !(iP->Loc.rfvec &= ~mask)) Resolve(iP);
+
+// All done
+//
+   sh.UnLock();
+}
+
+/******************************************************************************/
+/* Public                       P u t F i l e s                               */
+/******************************************************************************/
+
+// This method applies a batch of have and gone updates from the same servers.
+// The updates are applied shard by shard, each shard being locked only once,
+// and in batch order within a shard so updates to any one path stay ordered.
+  
+void XrdCmsCache::PutFiles(Update *uP, int uNum, SMask_t mask)
+{
+   unsigned int todo = 0;
+   int i, s;
+
+// Find the shard of each update
+//
+   for (i = 0; i < uNum; i++)
+       {uP[i].sNum = getSNum(uP[i].Sel->Path);
+        todo |= 1U << uP[i].sNum;
+       }
+
+// Apply the updates for each shard that has any
+//
+   for (s = 0; s < ShardCnt; s++)
+       {if (!(todo & (1U << s))) continue;
+        Shard &sh = Shards[s];
+        sh.Lock();
+        for (i = 0; i < uNum; i++)
+            if (uP[i].sNum == s)
+               uP[i].Rc = (uP[i].Have ? AddItem(sh, *uP[i].Sel, mask)
+                                      : DelItem(sh, *uP[i].Sel, mask));
+        sh.UnLock();
+       }
+}
+
 /******************************************************************************/
 /* Public                        U n k F i l e                                */
 /******************************************************************************/
@@ -278,11 +391,12 @@ int  XrdCmsCache::GetFile(XrdCmsSelect &Sel, SMask_t mask)
 int XrdCmsCache::UnkFile(XrdCmsSelect &Sel, SMask_t mask)
 {
    EPNAME("UnkFile");
+   Shard &sh = getShard(Sel.Path);
    XrdCmsKeyItem *iP;
 
 // Make sure we have the proper information. If so, lock the hash table
 //
-   myMutex.Lock();
+   sh.Lock();
 
 // Look up the entry and if valid update the unqueried vector. Note that
 // this method may only be called after GetFile() or AddFile() for a new entry
@@ -294,7 +408,7 @@ int XrdCmsCache::UnkFile(XrdCmsSelect &Sel, SMask_t mask)
 
 // Return result
 //
-   myMutex.UnLock();
+   sh.UnLock();
    DEBUG("rc=" <<(iP ? 1 : 0) <<" path=" <<Sel.Path.Val);
    return (iP ? 1 : 0);
 }
@@ -313,7 +427,8 @@ int XrdCmsCache::WT4File(XrdCmsSelect &Sel, SMask_t mask)
 // Make sure we have the proper information. If so, lock the hash table
 //
    if (!Sel.InfoP) return DLTime;
-   myMutex.Lock();
+   Shard &sh = getShard(Sel.Path);
+   sh.Lock();
 
 // Look up the entry and if valid add it to the callback queue. Note that
 // this method may only be called after GetFile() or AddFile() for a new entry
@@ -328,7 +443,7 @@ int XrdCmsCache::WT4File(XrdCmsSelect &Sel, SMask_t mask)
 
 // Return result
 //
-   myMutex.UnLock();
+   sh.UnLock();
    DEBUG("rc=" <<retc <<" path=" <<Sel.Path.Val);
    return retc;
 }
@@ -343,13 +458,17 @@ int XrdCmsCache::WT4File(XrdCmsSelect &Sel, SMask_t mask)
 void XrdCmsCache::Bounce(SMask_t smask, int SNum)
 {
 
-// Simply indicate that this server bounced
-//
-   myMutex.Lock();
-   Bounced[SNum] = ++BClock;
-   okVec |= smask;
-   if (SNum > vecHi) vecHi = SNum;
-   myMutex.UnLock();
+// Simply indicate that this server bounced. Each shard keeps its own copy of
+// the bounce state so we visit them one at a time.
+//
+   for (int i = 0; i < ShardCnt; i++)
+       {Shard &sh = Shards[i];
+        sh.Lock();
+        sh.Bounced[SNum] = ++sh.BClock;
+        sh.okVec |= smask;
+        if (SNum > sh.vecHi) sh.vecHi = SNum;
+        sh.UnLock();
+       }
 }
 
 /******************************************************************************/
@@ -364,13 +483,16 @@ void XrdCmsCache::Drop(SMask_t smask, int SNum, int xHi)
 //
    Paths.Remove(smask);
 
-// Remove the node from the list of valid nodes
+// Remove the node from the list of valid nodes in each shard
 //
-   myMutex.Lock();
-   Bounced[SNum] = 0;
-   okVec &= nmask;
-   vecHi = xHi;
-   myMutex.UnLock();
+   for (int i = 0; i < ShardCnt; i++)
+       {Shard &sh = Shards[i];
+        sh.Lock();
+        sh.Bounced[SNum] = 0;
+        sh.okVec &= nmask;
+        sh.vecHi = xHi;
+        sh.UnLock();
+       }
 }
 
 /******************************************************************************/
@@ -409,34 +531,86 @@ int XrdCmsCache::Init(int fxHold, int fxDelay, int fxQuery, int seFS, int nxHold
        return 0;
       }
 
-// Get the first reserve of cache items
+// Get the first reserve of cache items for each shard
 //
-   iP = XrdCmsKeyItem::Alloc(0);
-   XrdCmsKeyItem::Unload((unsigned int)0);
-   iP->Recycle();
+   for (int i = 0; i < ShardCnt; i++)
+       {Shards[i].Lock();
+        if ((iP = Shards[i].Items.Alloc(0)))
+           {Shards[i].Items.Unload((unsigned int)0);
+            Shards[i].Items.Recycle(iP);
+           }
+        Shards[i].UnLock();
+       }
 
 // All done
 //
    return 1;
 }
 
+/******************************************************************************/
+/* public                          S t a t s                                  */
+/******************************************************************************/
+
+// Report the number of entries, lock acquisitions, and contended lock
+// acquisitions for each shard.
+  
+int XrdCmsCache::Stats(char *bfr, int bln)
+{
+   static const char statfmt0[] = "</cch>";
+   static const char statfmt1[] = "<cch>";
+   static const char statfmt2[] = "<s id=\"%d\"><n>%d</n><l>%lld</l><w>%lld</w></s>";
+   int mlen, num, tlen;
+   long long locks, waits;
+
+// Check if actual length wanted
+//
+   if (!bfr) return sizeof(statfmt0) + sizeof(statfmt1)
+                  + (sizeof(statfmt2) + 4 + 10 + 20*2) * ShardCnt;
+
+// Format the statistics
+//
+   if (bln < (int)sizeof(statfmt1)) return 0;
+   strcpy(bfr, statfmt1); tlen = sizeof(statfmt1) - 1;
+   bfr += tlen; bln -= tlen;
+
+   for (int i = 0; i < ShardCnt && bln > 0; i++)
+       {Shards[i].myMutex.Lock();
+        num   = Shards[i].CTable.Num();
+        locks = Shards[i].Locks;
+        waits = Shards[i].Waits;
+        Shards[i].myMutex.UnLock();
+        mlen = snprintf(bfr, bln, statfmt2, i, num, locks, waits);
+        bfr += mlen; bln -= mlen; tlen += mlen;
+       }
+
+   if (bln < (int)sizeof(statfmt0)) return 0;
+   strcpy(bfr, statfmt0);
+   return tlen + sizeof(statfmt0) - 1;
+}
+
 /******************************************************************************/
 /* public                       T i c k T o c k                               */
 /******************************************************************************/
 
 void *XrdCmsCache::TickTock()
 {
-   XrdCmsKeyItem *iP;
+   XrdCmsKeyItem *iP[ShardCnt];
+   bool anyItems;
 
-// Simply adjust the clock and trim old entries
+// Simply adjust the clock and trim old entries, one shard at a time. The
+// expired entries of all the shards are recycled by a single job.
 //
    do {XrdSysTimer::Snooze(Tick);
-       myMutex.Lock();
-       Tock = (Tock+1) & XrdCmsKeyItem::TickMask;
-       Bhistory[Tock].Start = Bhistory[Tock].End = 0;
-       iP = XrdCmsKeyItem::Unload(Tock);
-       myMutex.UnLock();
-       if (iP) Sched->Schedule((XrdJob *)new XrdCmsCacheJob(iP));
+       anyItems = false;
+       for (int i = 0; i < ShardCnt; i++)
+           {Shard &sh = Shards[i];
+            sh.Lock();
+            sh.Tock = (sh.Tock+1) & XrdCmsKeyItem::TickMask;
+            sh.Bhistory[sh.Tock].Start = sh.Bhistory[sh.Tock].End = 0;
+            if ((iP[i] = sh.Items.Unload(sh.Tock))) anyItems = true;
+            sh.UnLock();
+           }
+       if (anyItems) Sched->Schedule((XrdJob *)new XrdCmsCacheJob(iP));
       } while(1);
 
 // Keep compiler happy
@@ -502,7 +676,7 @@ void XrdCmsCache::Dispatch(XrdCmsSelect &Sel, XrdCmsKeyItem *iP,
 /*                               g e t B V e c                                */
 /******************************************************************************/
   
-SMask_t XrdCmsCache::getBVec(unsigned int TODa, unsigned int &TODb)
+SMask_t XrdCmsCache::getBVec(Shard &sh, unsigned int TODa, unsigned int &TODb)
 {
    EPNAME("getBVec");
    SMask_t BVec(0);
@@ -510,61 +684,87 @@ SMask_t XrdCmsCache::getBVec(unsigned int TODa, unsigned int &TODb)
 
 // See if we can use a previously calculated bVec
 //
-   if (Bhistory[TODa].End == BClock && Bhistory[TODa].Start <= TODb)
-      {Bhits++; TODb = BClock; return Bhistory[TODa].Vec;}
+   if (sh.Bhistory[TODa].End == sh.BClock && sh.Bhistory[TODa].Start <= TODb)
+      {sh.Bhits++; TODb = sh.BClock; return sh.Bhistory[TODa].Vec;}
 
 // Calculate the new vector
 //
-   for (i = 0; i <= vecHi; i++)
-       if (TODb < Bounced[i]) BVec |= 1ULL << i;
+   for (i = 0; i <= sh.vecHi; i++)
+       if (TODb < sh.Bounced[i]) BVec |= SMask_t(1) << i;
 
-   Bhistory[TODa].Vec   = BVec;
-   Bhistory[TODa].Start = TODb;
-   Bhistory[TODa].End   = BClock;
-   TODb                 = BClock;
-   Bmiss++;
-   if (!(Bmiss & 0xff)) DEBUG("hits=" <<Bhits <<" miss=" <<Bmiss);
+   sh.Bhistory[TODa].Vec   = BVec;
+   sh.Bhistory[TODa].Start = TODb;
+   sh.Bhistory[TODa].End   = sh.BClock;
+   TODb                    = sh.BClock;
+   sh.Bmiss++;
+   if (!(sh.Bmiss & 0xff)) DEBUG("hits=" <<sh.Bhits <<" miss=" <<sh.Bmiss);
    return BVec;
 }
 
+/******************************************************************************/
+/*                               R e s o l v e                                */
+/******************************************************************************/
+
+// Called with the shard locked when every queried server has responded. The
+// location is now as well known as it will ever be, so the deadline is
+// satisfied and all waiting clients are released with whatever was found.
+// Should some servers remain unqueried, the deadline must take its course.
+  
+void XrdCmsCache::Resolve(XrdCmsKeyItem *iP)
+{
+   if (!iP->Loc.deadline || iP->Loc.qfvec) return;
+
+   iP->Loc.deadline = 0;
+   if (iP->Loc.roPend && RRQ.Resolve(iP->Loc.roPend, iP)) iP->Loc.roPend = 0;
+   if (iP->Loc.rwPend && RRQ.Resolve(iP->Loc.rwPend, iP)) iP->Loc.rwPend = 0;
+}
+
 /******************************************************************************/
 /*                               R e c y c l e                                */
 /******************************************************************************/
   
-void XrdCmsCache::Recycle(XrdCmsKeyItem *theList)
+void XrdCmsCache::Recycle(XrdCmsKeyItem **theLists)
 {
-   XrdCmsKeyItem *iP;
+   XrdCmsKeyItem *iP, *theList;
    char msgBuff[100];
-   int numNull, numHave, numFree, numRecycled = 0;
+   int numNull, numHave, numFree, numRecycled = 0, totHave = 0, totFree = 0;
+
+// Process each shard's list, shards without expired items are left alone
+//
+   for (int i = 0; i < ShardCnt; i++)
+       {Shard *sh = &Shards[i];
+        if (!(theList = theLists[i])) continue;
 
 // Recycle the list of cache items, as needed
 //
-   while((iP = theList))
-        {theList = iP->Key.TODRef;
-         if (iP->Loc.roPend) RRQ.Del(iP->Loc.roPend, iP);
-         if (iP->Loc.rwPend) RRQ.Del(iP->Loc.rwPend, iP);
-         myMutex.Lock(); CTable.Recycle(iP); myMutex.UnLock();
-         numRecycled++;
-        }
+        while((iP = theList))
+             {theList = iP->Key.TODRef;
+              if (iP->Loc.roPend) RRQ.Del(iP->Loc.roPend, iP);
+              if (iP->Loc.rwPend) RRQ.Del(iP->Loc.rwPend, iP);
+              sh->Lock(); sh->CTable.Recycle(iP); sh->UnLock();
+              numRecycled++;
+             }
 
 // See if we have enough items in reserve
 //
-   myMutex.Lock();
-   XrdCmsKeyItem::Stats(numHave, numFree, numNull);
-   if (numFree < XrdCmsKeyItem::minFree)
-      {myMutex.UnLock();
-       if (!(numNull /= 4)) numNull = 1;
-       numHave += XrdCmsKeyItem::minAlloc * numNull;
-       while(numNull--)
-            {myMutex.Lock();
-             numFree = XrdCmsKeyItem::Replenish();
-             myMutex.UnLock();
-            }
-      } else myMutex.UnLock();
-
-// Log the stats
+        sh->Lock();
+        sh->Items.Stats(numHave, numFree, numNull);
+        if (numFree < sh->Items.minFree)
+           {sh->UnLock();
+            if (!(numNull /= 4)) numNull = 1;
+            numHave += sh->Items.minAlloc * numNull;
+            while(numNull--)
+                 {sh->Lock();
+                  numFree = sh->Items.Replenish();
+                  sh->UnLock();
+                 }
+           } else sh->UnLock();
+        totHave += numHave; totFree += numFree;
+       }
+
+// Log the stats once for all of the shards
 //
    sprintf(msgBuff, "%d cache items; %d allocated %d free",
-           numRecycled, numHave, numFree);
+           numRecycled, totHave, totFree);
    Say.Emsg("Recycle", msgBuff);
 }
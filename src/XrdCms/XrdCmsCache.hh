@@ -53,6 +53,13 @@ XrdCmsPList_Anchor Paths;
 //
 int         AddFile(XrdCmsSelect &Sel, SMask_t mask);
 
+// AskFile() records the servers about to be queried for the file so that the
+//           lookup can be resolved as soon as all of them have responded
+//           (right away if there are none). It must be called after GetFile()
+//           or AddFile() for a new entry.
+//
+void        AskFile(XrdCmsSelect &Sel, SMask_t mask);
+
 // DelFile() returns true if this is the last deletion, false otherwise
 //
 int         DelFile(XrdCmsSelect &Sel, SMask_t mask);
@@ -61,6 +68,20 @@ int         DelFile(XrdCmsSelect &Sel, SMask_t mask);
 //
 int         GetFile(XrdCmsSelect &Sel, SMask_t mask);
 
+// NakFile() records that the servers in mask do not have the file or will
+//           never say so. Waiting clients are released once no queried server
+//           is left to respond.
+//
+void        NakFile(XrdCmsSelect &Sel, SMask_t mask);
+
+// PutFiles() applies a batch of updates from the servers in mask, each as
+//            AddFile() (have) or DelFile() (!have) would, locking each shard
+//            only once. The result of each update is returned in its Rc.
+//
+struct Update {XrdCmsSelect *Sel; int Rc; int sNum; bool Have;};
+
+void        PutFiles(Update *uP, int uNum, SMask_t mask);
+
 // UnkFile() updates the unqueried vector and returns 1 upon success, 0 o/w.
 //
 int         UnkFile(XrdCmsSelect &Sel, SMask_t mask);
@@ -76,45 +97,79 @@ void        Drop(SMask_t mask, int SNum, int xHi);
 
 int         Init(int fxHold, int fxDelay, int fxQuery, int seFS, int nxHold);
 
+// Stats() formats the per-shard statistics and returns the length or, when
+//         bfr is nil, the maximum length needed.
+//
+int         Stats(char *bfr, int bln);
+
 void       *TickTock();
 
 static const int min_nxTime = 60;
 
-            XrdCmsCache() : okVec(0), Tick(8*60*60), Tock(0), BClock(0), 
-                            nilTMO(0),
-                            DLTime(5), QDelay(5), Bhits(0), Bmiss(0), vecHi(-1),
-                            isDFS(0)
-                          {memset(Bounced,  0, sizeof(Bounced));
-                           memset(Bhistory, 0, sizeof(Bhistory));
-                          }
+// The cache is split by key hash into independently locked shards, each with
+// its own table, item pool, aging clock, and copy of the bounce state.
+//
+static const int ShardBits  =  4;
+static const int ShardCnt   =  1 << ShardBits;
+
+            XrdCmsCache() : Tick(8*60*60), nilTMO(0),
+                            DLTime(5), QDelay(5), isDFS(0) {}
            ~XrdCmsCache() {}   // Never gets deleted
 
 private:
 
+struct Shard
+      {XrdSysMutex    myMutex;
+       XrdCmsKeyPool  Items;
+       XrdCmsNash     CTable;
+       struct {SMask_t      Vec;
+               unsigned int Start;
+               unsigned int End;
+              }       Bhistory[XrdCmsKeyItem::TickRate];
+       unsigned int   Bounced[STMax];
+       SMask_t        okVec;
+       unsigned int   Tock;
+       unsigned int   BClock;
+                int   Bhits;
+                int   Bmiss;
+                int   vecHi;
+       long long      Locks;    // Number of times the shard was locked
+       long long      Waits;    // Number of times the lock was contended
+
+       void           Lock() {if (!myMutex.CondLock()) {myMutex.Lock(); Waits++;}
+                              Locks++;
+                             }
+       void           UnLock() {myMutex.UnLock();}
+
+                      Shard() : Items(XrdCmsKeyItem::minAlloc/ShardCnt,
+                                      XrdCmsKeyItem::minFree /ShardCnt),
+                                CTable(Items, 1597, 2584),
+                                okVec(0), Tock(0), BClock(0), Bhits(0),
+                                Bmiss(0), vecHi(-1), Locks(0), Waits(0)
+                              {memset(Bounced,  0, sizeof(Bounced));
+                               memset(Bhistory, 0, sizeof(Bhistory));
+                              }
+      };
+
 void          Add2Q(XrdCmsRRQInfo *Info, XrdCmsKeyItem *cp, int selOpts);
+int           AddItem(Shard &sh, XrdCmsSelect &Sel, SMask_t mask);
+int           DelItem(Shard &sh, XrdCmsSelect &Sel, SMask_t mask);
 void          Dispatch(XrdCmsSelect &Sel, XrdCmsKeyItem *cinfo,
                        short roQ, short rwQ);
-SMask_t       getBVec(unsigned int todA, unsigned int &todB);
-void          Recycle(XrdCmsKeyItem *theList);
-
-struct  {SMask_t      Vec;
-         unsigned int Start;
-         unsigned int End;
-        }             Bhistory[XrdCmsKeyItem::TickRate];
-
-XrdSysMutex   myMutex;
-XrdCmsNash    CTable;
-unsigned int  Bounced[STMax];
-SMask_t       okVec;
+SMask_t       getBVec(Shard &sh, unsigned int todA, unsigned int &todB);
+Shard        &getShard(XrdCmsKey &Key) {return Shards[getSNum(Key)];}
+int           getSNum(XrdCmsKey &Key)
+                      {if (!Key.Hash) Key.setHash();
+                       return Key.Hash >> (32 - ShardBits);
+                      }
+void          Recycle(XrdCmsKeyItem **theLists);
+void          Resolve(XrdCmsKeyItem *iP);
+
+Shard         Shards[ShardCnt];
 unsigned int  Tick;
-unsigned int  Tock;
-unsigned int  BClock;
          int  nilTMO;
          int  DLTime;
          int  QDelay;
-         int  Bhits;
-         int  Bmiss;
-         int  vecHi;
          int  isDFS;
 };
 
@@ -495,12 +495,16 @@ int XrdCmsClientConfig::xmang(XrdOucStream &Config)
 
    Purpose:  To parse the directive: request [repwait <sec1>] [delay <sec2>]
                                              [noresp <cnt>] [prep <ms>]
-                                             [fwd <ms>]
+                                             [fwd <ms>] [rdrcache <sec3>]
+                                             [rdrmax <num>]
 
              <sec1>  max number of seconds to wait for a cmsd reply
              <sec2>  number of seconds to delay a retry upon failure
              <cnt>   number of no-responses before cms fault declared.
              <ms>    milliseconds between prepare/forward requests
+             <sec3>  number of seconds to reuse a redirect for opens of the
+                     same file (default is not to).
+             <num>   maximum number of files whose redirects are reused.
 
    Type: Remote server only, dynamic.
 
@@ -517,6 +521,8 @@ int XrdCmsClientConfig::xreqs(XrdOucStream &Config)
         {"fwd",      0, &FwdWait},
         {"noresp",   0, &RepNone},
         {"prep",     0, &PrepWait},
+        {"rdrcache", 1, &RdrTTL},
+        {"rdrmax",   0, &RdrMax},
         {"repwait",  1, &RepWait}
        };
     int i, ppp, numopts = sizeof(rqopts)/sizeof(struct reqsopts);
@@ -56,6 +56,8 @@ int           RepNone;      // Max number of consecutive non-responses
 int           PrepWait;     // Millisecond wait between prepare requests
 int           FwdWait;      // Millisecond wait between foward  requests
 int           haveMeta;     // Have a meta manager (only if we are a manager)
+int           RdrTTL;       // Seconds to remember redirects (0 -> don't)
+int           RdrMax;       // Maximum number of paths whose redirects we keep
 
 char         *CMSPath;      // Path to the local cmsd for target nodes
 const char   *myHost;
@@ -72,7 +74,8 @@ enum {FailOver = 'f', RoundRob = 'r'};
 
       XrdCmsClientConfig() : ConWait(10), RepWait(3),  RepWaitMS(3000),
                              RepDelay(5), RepNone(8),  PrepWait(33),
-                             FwdWait(0),  haveMeta(0), CMSPath(0),
+                             FwdWait(0),  haveMeta(0), RdrTTL(0),
+                             RdrMax(65536), CMSPath(0),
                              myHost(0),   myName(0),   myVNID(0),
                              cidTag(0),   ManList(0),  PanList(0),
                              SMode(FailOver), SModeP(FailOver),
@@ -33,6 +33,9 @@
 #include "XrdCms/XrdCmsClientMan.hh"
 #include "XrdCms/XrdCmsClientMsg.hh"
 #include "XrdCms/XrdCmsLogin.hh"
+#include "XrdCms/XrdCmsParser.hh"
+#include "XrdCms/XrdCmsRdrCache.hh"
+#include "XrdCms/XrdCmsRRData.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 
 #include "XrdSfs/XrdSfsInterface.hh"
@@ -57,6 +60,8 @@ char          XrdCmsClientMan::doDebug   = 0;
 
 const char   *XrdCmsClientMan::ConfigFN  = 0;
 
+XrdCmsRdrCache *XrdCmsClientMan::rdrCache = 0;
+
 XrdSysMutex   XrdCmsClientMan::manMutex;
 
 /******************************************************************************/
@@ -239,6 +244,8 @@ void *XrdCmsClientMan::Start()
        while(Receive())
                  if (Response.modifier & CmsResponse::kYR_async) relayResp();
             else if (Response.rrCode == kYR_status) setStatus();
+            else if (Response.rrCode == kYR_have
+                 ||  Response.rrCode == kYR_gone)   rdrForget();
             else if (XrdCmsClientMsg::Reply(HPfx, Response, NetBuff))
                     {if (Response.rrCode == kYR_waitresp) syncResp.Wait();}
 
@@ -344,6 +351,7 @@ int XrdCmsClientMan::Hookup()
 //     lp->Bind(XrdSysThread::ID());
        memset(&Data, 0, sizeof(Data));
        Data.Mode = CmsLoginData::kYR_director;
+       if (rdrCache) Data.Mode |= CmsLoginData::kYR_rdrcache;
        Data.HoldTime = static_cast<int>(getpid());
        if (!(rc = XrdCmsLogin::Login(lp, Data))) break;
        lp->Close();
@@ -417,6 +425,28 @@ int XrdCmsClientMan::Receive()
    return 0;
 }
 
+/******************************************************************************/
+/*                             r d r F o r g e t                              */
+/******************************************************************************/
+
+// The manager tells us about files added to or removed from a server only if
+// we cache redirects. Where we redirected opens of the file no longer holds.
+//
+void XrdCmsClientMan::rdrForget()
+{
+   XrdCmsRRData Data;
+   char *data = NetBuff->Buffer();
+   int   dlen = NetBuff->DataLen();
+
+// The path is either all there is or it has to be unpacked
+//
+   if (!rdrCache || !ntohs(Response.datalen) || dlen <= 0) return;
+   if (Response.modifier & kYR_raw) {data[dlen-1] = 0; Data.Path = data;}
+      else if (!Parser.Parse(Response.rrCode, data, data+dlen, &Data)
+           ||  !Data.Path) return;
+   rdrCache->Del(Data.Path);
+}
+
 /******************************************************************************/
 /*                             r e l a y R e s p                              */
 /******************************************************************************/
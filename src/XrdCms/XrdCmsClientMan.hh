@@ -41,6 +41,7 @@
 #include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
+class XrdCmsRdrCache;
 class XrdInet;
 class XrdLink;
 
@@ -76,6 +77,8 @@ inline int           Suspended() {AtomicBeg(myData);
 
 void                 setNext(XrdCmsClientMan *np) {Next = np;}
 
+static void          setCache(XrdCmsRdrCache *cP) {rdrCache = cP;}
+
 static void          setNetwork(XrdInet *nP) {Network = nP;}
 
 static void          setConfig(const char *cfn) {ConfigFN = cfn;}
@@ -92,6 +95,7 @@ private:
 int   Hookup();
 int   Receive();
 void  relayResp();
+void  rdrForget();
 int   chkStatus();
 void  setStatus();
 
@@ -99,6 +103,7 @@ static XrdSysMutex   manMutex;
 static XrdOucBuffPool BuffPool;
 static XrdInet      *Network;
 static const char   *ConfigFN;
+static XrdCmsRdrCache *rdrCache;
 static const int     chkVal = 256;
 
 XrdSysSemaphore   syncResp;
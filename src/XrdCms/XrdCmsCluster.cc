@@ -53,6 +53,7 @@
 #include "XrdCms/XrdCmsRRQ.hh"
 #include "XrdCms/XrdCmsState.hh"
 #include "XrdCms/XrdCmsSelect.hh"
+#include "XrdCms/XrdCmsSummary.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 #include "XrdCms/XrdCmsTypes.hh"
 
@@ -108,6 +109,10 @@ int         nodeInst;
 XrdCmsCluster::XrdCmsCluster()
 {
      memset((void *)NodeTab, 0, sizeof(NodeTab));
+     memset((void *)SumTab,  0, sizeof(SumTab));
+     memset((void *)SumPnd,  0, sizeof(SumPnd));
+     SumCnt  =  0;
+     SumRes  =  0;
      memset((void *)AltMans, (int)' ', sizeof(AltMans));
      AltMend = AltMans;
      AltMent = -1;
@@ -118,6 +123,7 @@ XrdCmsCluster::XrdCmsCluster()
      SelRcnt = 0;
      SelRtot = 0;
      SelTcnt = 0;
+     selSeed = static_cast<unsigned int>(time(0)) ^ getpid();
      doReset = 0;
      resetMask = 0;
      peerHost  = 0;
@@ -216,9 +222,13 @@ XrdCmsNode *XrdCmsCluster::Add(XrdLink *lp, int port, int Status, int sport,
                 act = "Shoved ";
                }
        NodeTab[Slot] = nP = new XrdCmsNode(lp, theIF, theNID, port, 0, Slot);
+       SumDrop(Slot);
        if (!cidP) cidP = XrdCmsClustID::AddID(theNID);
        if ((cidP->AddNode(nP, SpecAlt))) nP->cidP = cidP;
-          else {delete nP; NodeTab[Slot] = 0; return 0;} // OK to do delete!
+          else {delete nP; NodeTab[Slot] = 0;            // OK to do delete!
+                selVec.Set(Slot, 0);
+                return 0;
+               }
       }
 
 // Indicate whether this snode can be redirected
@@ -237,6 +247,7 @@ XrdCmsNode *XrdCmsCluster::Add(XrdLink *lp, int port, int Status, int sport,
    nP->isPeer    = 0 != (Status & CMS_isPeer);
    nP->isBad    |= XrdCmsNode::isDisabled;
    nP->subsPort  = sport;
+   Update(nP);
 
 // If this is an actual non-hidden node, count it
 //
@@ -316,7 +327,8 @@ XrdCmsNode *XrdCmsCluster::AddAlt(XrdCmsClustID *cidP, XrdLink *lp,
    if ((pP = NodeTab[slot]) && !(pP->isBound))
       {setAltMan(nP->NodeID, nP->Link, sport);
        Say.Emsg("AddAlt", nP->Ident, "replacing dropped", pP->Ident);
-       NodeTab[slot] = nP;
+       NodeTab[slot] = nP; SumDrop(slot);
+       selVec.Set(slot, nP);
        pP->DropJob = new XrdCmsDrop(pP); // Schedule deletion
       }
 
@@ -364,6 +376,7 @@ void XrdCmsCluster::BlackList(XrdOucTList *blP)
                 nP->isBad &= ~(XrdCmsNode::isBlisted | XrdCmsNode::isDoomed);
                 Say.Emsg("Manager", nP->Name(), "removed from blacklist.");
                }
+            Update(nP);
             nP->n2gLock(STMutex);
            }
        }
@@ -375,35 +388,54 @@ void XrdCmsCluster::BlackList(XrdOucTList *blP)
 /******************************************************************************/
 
 SMask_t XrdCmsCluster::Broadcast(SMask_t smask, const struct iovec *iod,
-                                 int iovcnt, int iotot)
+                                 int iovcnt, int iotot, SMask_t *qmask)
 {
    EPNAME("Broadcast")
-   int i;
-   XrdCmsNode *nP;
-   SMask_t bmask, unQueried(0);
+   XrdCmsNode *nP, *nodeVec[STMax];
+   SMask_t bmask, sentTo(0), unQueried(0);
+   int i, nNum = 0;
 
 // Obtain a lock on the table and screen out peer nodes
 //
    STMutex.Lock();
    bmask = smask & peerMask;
 
-// Run through the table looking for nodes to send messages to. We don't need
+// Run through the table collecting the nodes to send messages to. We don't need
 // the node lock for this but we do need to up the reference count to keep the
 // node pointer valid for the duration of the send() (may or may not block).
 //
    for (i = 0; i <= STHi; i++)
        {if ((nP = NodeTab[i]) && nP->isNode(bmask))
            {if (nP->isOffline) unQueried |= nP->Mask();
-               else {nP->g2Ref(STMutex);
-                     if (nP->Send(iod, iovcnt, iotot) < 0)
-                        {unQueried |= nP->Mask();
-                         DEBUG(nP->Ident <<" is unreachable");
-                        }
-                     nP->Ref2g(STMutex);
-                    }
+               else {nP->gRef(); nodeVec[nNum++] = nP;}
            }
        }
+
+// Now send the message to all of the nodes without holding the table lock so
+// that a slow node does not hold up everyone else. Sends are non-blocking when
+// the nbsendq is in effect, so the query reaches all nodes at about the same
+// time and the responses can be aggregated as they arrive.
+//
    STMutex.UnLock();
+   for (i = 0; i < nNum; i++)
+       {nP = nodeVec[i];
+        if (nP->Send(iod, iovcnt, iotot) < 0)
+           {unQueried |= nP->Mask();
+            DEBUG(nP->Ident <<" is unreachable");
+           } else sentTo |= nP->Mask();
+       }
+
+// Drop the references we obtained
+//
+   if (nNum)
+      {STMutex.Lock();
+       for (i = 0; i < nNum; i++) nodeVec[i]->gUnRef();
+       STMutex.UnLock();
+      }
+
+// Return the nodes that were not queried
+//
+   if (qmask) *qmask = sentTo;
    return unQueried;
 }
 
@@ -431,7 +463,7 @@ SMask_t XrdCmsCluster::Broadcast(SMask_t smask, XrdCms::CmsRRHdr &Hdr,
 /******************************************************************************/
 
 SMask_t XrdCmsCluster::Broadcast(SMask_t smask, XrdCms::CmsRRHdr &Hdr,
-                                 void *Data,    int Dlen)
+                                 void *Data,    int Dlen, SMask_t *qmask)
 {
    struct iovec ioV[2] = {{(char *)&Hdr, sizeof(Hdr)},
                           {(char *)Data, (size_t)Dlen}};
@@ -439,7 +471,7 @@ SMask_t XrdCmsCluster::Broadcast(SMask_t smask, XrdCms::CmsRRHdr &Hdr,
 // Send of the data as eveything was constructed properly
 //
    Hdr.datalen = htons(static_cast<unsigned short>(Dlen));
-   return Broadcast(smask, ioV, 2, Dlen+sizeof(Hdr));
+   return Broadcast(smask, ioV, 2, Dlen+sizeof(Hdr), qmask);
 }
 
 /******************************************************************************/
@@ -654,6 +686,8 @@ int XrdCmsCluster::Locate(XrdCmsSelect &Sel)
    || !(retc = Cache.GetFile(Sel, pinfo.rovec)))
       {Cache.AddFile(Sel, 0);
        qfVec = pinfo.rovec; Sel.Vec.hf = 0;
+       if (!(Sel.Opts & XrdCmsSelect::Refresh))
+          qfVec = Screen(Sel, qfVec, pinfo.ssvec);
       } else qfVec = Sel.Vec.bf;
 
 // Compute the delay, if any
@@ -667,10 +701,9 @@ int XrdCmsCluster::Locate(XrdCmsSelect &Sel)
       {CmsStateRequest QReq = {{Sel.Path.Hash, kYR_state, kYR_raw, 0}};
        if (Sel.Opts & XrdCmsSelect::Refresh)
           QReq.Hdr.modifier |= CmsStateRequest::kYR_refresh;
+       QReq.Hdr.modifier |= CmsStateRequest::kYR_misresp;
        TRACE(Files, "seeking " <<Sel.Path.Val);
-       qfVec = Cluster.Broadcast(qfVec, QReq.Hdr, 
-                                 (void *)Sel.Path.Val, Sel.Path.Len+1);
-       if (qfVec) Cache.UnkFile(Sel, qfVec);
+       Query(Sel, QReq.Hdr, qfVec);
       }
    return retc;
 }
@@ -686,12 +719,16 @@ void *XrdCmsCluster::MonPerf()
    int ioVnum = sizeof(ioV)/sizeof(struct iovec);
    int ioVtot = sizeof(Usage);
    SMask_t allNodes(~0);
-   int uInterval = Config.AskPing*Config.AskPerf;
+   int i, uInterval = Config.AskPing*Config.AskPerf;
 
-// Sleep for the indicated amount of time, then ask for load on each server
+// Sleep for the indicated amount of time, then ask for load on each server.
+// The answer also tells us how quickly each one responds.
 //
    while(uInterval)
         {XrdSysTimer::Snooze(uInterval);
+         STMutex.Lock();
+         for (i = 0; i <= STHi; i++) if (NodeTab[i]) NodeTab[i]->Probe();
+         STMutex.UnLock();
          Broadcast(allNodes, ioV, ioVnum, ioVtot);
         }
    return (void *)0;
@@ -815,6 +852,7 @@ void XrdCmsCluster::Remove(const char *reason, XrdCmsNode *theNode, int immed)
 // Mark node as being offline and remove any drop job from it
 //
    theNode->isOffline = 1; // STMutex is held here
+   Update(theNode);
 
 // If the node is connected we simply close the connection. This will cause
 // the connection handler to re-initiate the node removal. This condition
@@ -857,7 +895,8 @@ void XrdCmsCluster::Remove(const char *reason, XrdCmsNode *theNode, int immed)
    if (theNode->isMan && theNode->cidP && !(theNode->cidP->IsSingle())
    && (altNode = theNode->cidP->RemNode(theNode)))
       {if (altNode->isBound) NodeCnt++;
-       NodeTab[NodeID] = altNode;
+       NodeTab[NodeID] = altNode; SumDrop(NodeID);
+       selVec.Set(NodeID, altNode);
        if (Config.asManager())
           CmsState.Update(XrdCmsState::Counts,
                           altNode->isBad & XrdCmsNode::isSuspend ? 0 :  1,
@@ -1014,6 +1053,9 @@ int XrdCmsCluster::Select(XrdCmsSelect &Sel)
        Sel.Vec.bf = pinfo.rovec; 
        Sel.Vec.hf = Sel.Vec.pf = pmask = smask = 0;
        retc = 0;
+       if (!(Sel.Opts & XrdCmsSelect::Refresh)
+       &&  !(Sel.Vec.bf = Screen(Sel, Sel.Vec.bf, pinfo.ssvec)))
+          return Select(Sel); // The lookup is resolved, so this won't recurse
       }
 
 // A wait is required if we don't have any primary or seconday servers
@@ -1028,10 +1070,9 @@ int XrdCmsCluster::Select(XrdCmsSelect &Sel)
        if (Sel.Opts & XrdCmsSelect::Refresh)
           QReq.Hdr.modifier |= CmsStateRequest::kYR_refresh;
        if (dowt) retc= (fRD ? Cache.WT4File(Sel,Sel.Vec.hf) : Config.LUPDelay);
+       QReq.Hdr.modifier |= CmsStateRequest::kYR_misresp;
        TRACE(Files, "seeking " <<Sel.Path.Val);
-       amask = Cluster.Broadcast(Sel.Vec.bf, QReq.Hdr,
-                                 (void *)Sel.Path.Val,Sel.Path.Len+1);
-       if (amask) Cache.UnkFile(Sel, amask);
+       Query(Sel, QReq.Hdr, Sel.Vec.bf);
        if (dowt) return retc;
       } else if (dowt && retc < 0 && !noSel)
                 return (fRD ? Cache.WT4File(Sel,Sel.Vec.hf) : Config.LUPDelay);
@@ -1074,10 +1115,8 @@ int XrdCmsCluster::Select(XrdCmsSelect &Sel)
 int XrdCmsCluster::Select(SMask_t pmask, int &port, char *hbuff, int &hlen,
                           int isrw, int isMulti, int ifWant)
 {
-   static const SMask_t smLow(255);
    XrdCmsSelector selR;
    XrdCmsNode *nP = 0;
-   SMask_t tmask;
    int Snum = 0;
    XrdNetIF::ifType nType = static_cast<XrdNetIF::ifType>(ifWant);
 
@@ -1110,9 +1149,7 @@ int XrdCmsCluster::Select(SMask_t pmask, int &port, char *hbuff, int &hlen,
 // In shared-nothing systems the incomming mask will only have a single node.
 // Compute the a single node number that is contained in the mask.
 //
-   do {if (!(tmask = pmask & smLow)) Snum += 8;
-         else {while((tmask = tmask>>1)) Snum++; break;}
-      } while((pmask = pmask >> 8));
+   Snum = XrdCmsSMaskFirst(pmask);
 
 // See if the node passes muster
 //
@@ -1253,6 +1290,7 @@ int XrdCmsCluster::Statt(char *bfr, int bln)
           "<lf>%lld</lf><ls>%lld</ls><rf>%lld</rf><rs>%lld</rs></frq>";
 
    static int AddFrq = (Config.RepStats & XrdCmsConfig::RepStat_frq);
+   static int AddCch = (Config.RepStats & XrdCmsConfig::RepStat_cch);
    static int AddShr = (Config.RepStats & XrdCmsConfig::RepStat_shr)
                        && Config.asMetaMan();
 
@@ -1280,6 +1318,7 @@ int XrdCmsCluster::Statt(char *bfr, int bln)
           (sizeof(statfmt2) + 10*2 + 256 + 16) * STMax + sizeof(statfmt4);
        if (AddShr) n += sizeof(statfmt3) + 12;
        if (AddFrq) n += sizeof(statfmt4) + (10*8);
+       if (AddCch) n += Cache.Stats(0, 0);
        return n;
       }
 
@@ -1336,6 +1375,11 @@ int XrdCmsCluster::Statt(char *bfr, int bln)
        bfr += mlen; bln -= mlen; tlen += mlen;
       }
 
+   if (AddCch && bln > 0)
+      {if (!(mlen = Cache.Stats(bfr, bln))) return 0;
+       bfr += mlen; bln -= mlen; tlen += mlen;
+      }
+
 // See if we overflowed. otherwise finish up
 //
    if (sp || bln < (int)sizeof(statfmt0)) return 0;
@@ -1343,6 +1387,85 @@ int XrdCmsCluster::Statt(char *bfr, int bln)
    return tlen + sizeof(statfmt0) - 1;
 }
   
+/******************************************************************************/
+/*                                S u m A d d                                 */
+/******************************************************************************/
+
+// This is called when a node tells us it has a new file so that its summary
+// does not hide the file until the node sends a new one.
+//
+void XrdCmsCluster::SumAdd(int sNum, const char *path)
+{
+   if (!SumCnt && !SumPnd[sNum]) return;
+
+   XrdSysMutexHelper sumHelp(sumLock(sNum));
+   if (SumTab[sNum]) SumTab[sNum]->Add(path);
+   if (SumPnd[sNum]) SumPnd[sNum]->Add(path);
+}
+
+/******************************************************************************/
+/*                               S u m m a r y                                */
+/******************************************************************************/
+  
+bool XrdCmsCluster::Summary(int sNum, unsigned int gen, int lgbits, int hashes,
+                            bool resolve, int offset, const char *data,
+                            int dlen)
+{
+   EPNAME("Summary");
+   XrdCmsSummary *sP, *oldSum = 0;
+   bool aOK = true;
+
+// Validate the parameters
+//
+   if (sNum < 0 || sNum >= STMax
+   ||  lgbits < XrdCmsSummary::minLgBits || lgbits > XrdCmsSummary::maxLgBits
+   ||  hashes < 1 || hashes > XrdCmsSummary::maxHashes) return false;
+
+// A piece at offset zero starts a new summary. Any other piece must continue
+// the summary being received, otherwise that summary is abandoned.
+//
+   sumLock(sNum).Lock();
+   if (!offset)
+      {if (SumPnd[sNum]) delete SumPnd[sNum];
+       SumPnd[sNum] = new XrdCmsSummary(lgbits, hashes, gen);
+      }
+   if (!(sP = SumPnd[sNum])) aOK = false;
+      else if (sP->Gen() != gen || sP->lgBits() != lgbits
+           ||  sP->Hashes() != hashes || !sP->Set(offset, data, dlen))
+              {delete sP; SumPnd[sNum] = 0; aOK = false;}
+
+// Once the summary is complete it replaces the current one
+//
+   if (aOK && sP->Done())
+      {if (!(oldSum = SumTab[sNum])) __sync_fetch_and_add(&SumCnt, 1);
+       SumTab[sNum] = sP; SumPnd[sNum] = 0;
+       if (resolve) __sync_fetch_and_or (&SumRes,  (SMask_t(1) << sNum));
+          else      __sync_fetch_and_and(&SumRes, ~(SMask_t(1) << sNum));
+       DEBUG("node " <<sNum <<" summary " <<gen <<" installed; "
+             <<sP->Size() <<" bytes.");
+      }
+   sumLock(sNum).UnLock();
+
+// Delete the old summary outside of the lock
+//
+   if (oldSum) delete oldSum;
+   return aOK;
+}
+
+/******************************************************************************/
+/*                                U p d a t e                                 */
+/******************************************************************************/
+
+// Nodes not in the node table (e.g. alternates) are not selected directly and
+// need not be tracked.
+//
+void XrdCmsCluster::Update(XrdCmsNode *nP)
+{
+   int n = nP->NodeID;
+
+   if (n >= 0 && n < STMax && NodeTab[n] == nP) selVec.Set(n, nP);
+}
+
 /******************************************************************************/
 /*                       P r i v a t e   M e t h o d s                        */
 /******************************************************************************/
@@ -1418,7 +1541,8 @@ int XrdCmsCluster::Drop(int sent, int sinst, XrdCmsDrop *djp)
 
 // Cleanup status
 //
-   NodeTab[sent] = 0;
+   NodeTab[sent] = 0; SumDrop(sent);
+   selVec.Set(sent, 0);
    nP->isOffline = 1; // STMutex is locked
    nP->DropTime  = 0;
    nP->DropJob   = 0;
@@ -1468,30 +1592,7 @@ int XrdCmsCluster::Drop(int sent, int sinst, XrdCmsDrop *djp)
 
 int XrdCmsCluster::Multiple(SMask_t mVec)
 {
-   static const unsigned long long Left32  = 0xffffffff00000000LL;
-   static const unsigned long long Right32 = 0x00000000ffffffffLL;
-   static const unsigned long long Left16  = 0x00000000ffff0000LL;
-   static const unsigned long long Right16 = 0x000000000000ffffLL;
-   static const unsigned long long Left08  = 0x000000000000ff00LL;
-   static const unsigned long long Right08 = 0x00000000000000ffLL;
-   static const unsigned long long Left04  = 0x00000000000000f0LL;
-   static const unsigned long long Right04 = 0x000000000000000fLL;
-//                                0 1 2 3 4 5 6 7 8 9 A B C D E F
-   static const int isMult[16] = {0,0,0,1,0,1,1,1,0,1,1,1,1,1,1,1};
-
-   if (mVec & Left32) {if (mVec & Right32) return 1;
-                          else mVec = mVec >> 32LL;
-                      }
-   if (mVec & Left16) {if (mVec & Right16) return 1;
-                          else mVec = mVec >> 16LL;
-                      }
-   if (mVec & Left08) {if (mVec & Right08) return 1;
-                          else mVec = mVec >>  8LL;
-                      }
-   if (mVec & Left04) {if (mVec & Right04) return 1;
-                          else mVec = mVec >>  4LL;
-                      }
-   return isMult[mVec];
+   return XrdCmsSMaskCount(mVec) > 1;
 }
   
 /******************************************************************************/
@@ -1500,19 +1601,28 @@ int XrdCmsCluster::Multiple(SMask_t mVec)
   
 bool XrdCmsCluster::maxBits(SMask_t mVec, int mbits)
 {
-   int count = 0;
+   return XrdCmsSMaskCount(mVec) >= mbits;
+}
 
-// Count bits. This is the fastest way assuming few bits are set
-//
-   while(mVec)
-        {mVec &= (mVec - 1);
-         count++;
-         if (count >= mbits) return true;
-        }
+/******************************************************************************/
+/*                                 Q u e r y                                  */
+/******************************************************************************/
 
-// Indicate we have not reached the maximum bits set
-//
-   return false;
+// Ask the nodes in qmask whether they have the file. The nodes being asked
+// are recorded in the cache beforehand so that responses arriving during the
+// broadcast are accounted for. Nodes that could not be asked are remembered
+// as unqueried and keep the lookup open until the deadline. Peers are never
+// asked, so they are immediately counted as having responded.
+  
+void XrdCmsCluster::Query(XrdCmsSelect &Sel, CmsRRHdr &Hdr, SMask_t qmask)
+{
+   SMask_t sentTo, unQueried;
+
+   Cache.AskFile(Sel, qmask);
+   unQueried = Broadcast(qmask, Hdr, (void *)Sel.Path.Val, Sel.Path.Len+1,
+                         &sentTo);
+   if (unQueried) Cache.UnkFile(Sel, unQueried);
+   if ((qmask &= ~(sentTo | unQueried))) Cache.NakFile(Sel, qmask);
 }
 
 /******************************************************************************/
@@ -1534,6 +1644,53 @@ void XrdCmsCluster::Record(char *path, const char *reason, bool force)
    if (!skipmsg) Say.Emsg(epname, "client defered;", reason, path);
 }
  
+/******************************************************************************/
+/*                                S c r e e n                                 */
+/******************************************************************************/
+
+// Remove from qmask the nodes whose namespace summary shows that they do not
+// have the file. Staging nodes (smask) are always asked as their summary only
+// covers their disk. If no node would remain, the nodes that may have the
+// file behind xrootd's back (i.e. did not say resolve) are asked anyway. If
+// still no node remains, the lookup is resolved right away.
+//
+SMask_t XrdCmsCluster::Screen(XrdCmsSelect &Sel, SMask_t qmask, SMask_t smask)
+{
+   EPNAME("Screen");
+   SMask_t cmask = qmask & ~smask, nmask(0);
+   XrdSysMutex *mP = 0, *sP;
+   unsigned int h1, h2;
+   int i;
+
+// Check if there is anything to screen
+//
+   if (!SumCnt || !cmask) return qmask;
+
+// Find the nodes that certainly do not have the file. Nodes come in ascending
+// order so each shard is locked at most once.
+//
+   XrdCmsSummary::Hash(Sel.Path.Val, h1, h2);
+   for (i = XrdCmsSMaskFirst(cmask); i >= 0; i = XrdCmsSMaskNext(cmask, i))
+       {if ((sP = &sumLock(i)) != mP)
+           {if (mP) mP->UnLock();
+            (mP = sP)->Lock();
+           }
+        if (SumTab[i] && !SumTab[i]->Has(h1, h2))
+           nmask |= SMask_t(1) << i;
+       }
+   if (mP) mP->UnLock();
+   if (!(qmask & ~nmask)) nmask &= SumRes;
+
+// Remove those nodes from the query
+//
+   if (nmask)
+      {qmask &= ~nmask;
+       DEBUG(XrdCmsSMaskCount(nmask) <<" node(s) skipped for " <<Sel.Path.Val);
+       if (!qmask) Cache.AskFile(Sel, qmask);
+      }
+   return qmask;
+}
+
 /******************************************************************************/
 /*                               S e l N o d e                                */
 /******************************************************************************/
@@ -1670,6 +1827,7 @@ int XrdCmsCluster::SelNode(XrdCmsSelect &Sel, SMask_t pmask, SMask_t amask)
 #define RefCount(sP, sPMulti, NeedSpace)                       \
         if (NeedSpace) {SelWcnt++; sP->RefTotW++; sP->RefW++;} \
            else        {SelRcnt++; sP->RefTotR++; sP->RefR++;} \
+        sP->RefSince++;                                        \
         if (sPMulti && sP->Share && !sP->Shrem--)              \
            {sP->RefW += sP->Shrip; sP->RefR += sP->Shrip;      \
             sP->Shrem = sP->Share; sP->Shrin++;                \
@@ -1686,39 +1844,16 @@ int XrdCmsCluster::SelNode(XrdCmsSelect &Sel, SMask_t pmask, SMask_t amask)
 
 XrdCmsNode *XrdCmsCluster::SelbyCost(SMask_t mask, XrdCmsSelector &selR)
 {
-    XrdCmsNode *np, *sp = 0;
-    bool Multi = false;
+   SMask_t full = (selR.needSpace ? selVec.isNoStage : SMask_t(0));
+   int lim;
 
-// Scan for a node (sp points to the selected one)
+// Find the eligible nodes and then those whose cost is close to the lowest
 //
    selR.Reset(); SelTcnt++;
-   for (int i = 0; i <= STHi; i++)
-       if ((np = NodeTab[i]) && (np->NodeMask & mask))
-          {if (!(selR.needNet &  np->hasNet))    {selR.xNoNet= true; continue;}
-           selR.nPick++;
-           if (np->isOffline)                    {selR.xOff  = true; continue;}
-           if (np->isBad)                        {selR.xSusp = true; continue;}
-           if (selR.needSpace && np->isNoStage)  {selR.xFull = true; continue;}
-           if (!sp) sp = np;
-              else{if (abs(sp->myCost - np->myCost) <= Config.P_fuzz)
-                      {     if (selR.selPack)
-                               {if (sp->Inst() > np->Inst()) sp=np;}
-                       else if (selR.needSpace)
-                               {if (sp->RefW > (np->RefW+Config.DiskLinger))
-                                   sp=np;
-                               }
-                       else if (sp->RefR > np->RefR) sp=np;
-                      }
-                       else if (sp->myCost > np->myCost) sp=np;
-                   Multi = true;
-                  }
-          }
-
-// Check for overloaded node and return result
-//
-   if (!sp) return calcDelay(selR);
-   RefCount(sp, Multi, selR.needSpace);
-   return sp;
+   if (!(mask = SelElig(mask, selR, full, false))) return calcDelay(selR);
+   lim  = XrdCmsSelVec::Min(mask, selVec.myCost) + Config.P_fuzz;
+   return SelbyTie(XrdCmsSelVec::Upto(mask, selVec.myCost, lim), selR,
+                   XrdCmsSMaskCount(mask) > 1);
 }
   
 /******************************************************************************/
@@ -1729,48 +1864,21 @@ XrdCmsNode *XrdCmsCluster::SelbyCost(SMask_t mask, XrdCmsSelector &selR)
   
 XrdCmsNode *XrdCmsCluster::SelbyLoad(SMask_t mask, XrdCmsSelector &selR)
 {
-    XrdCmsNode *np, *sp = 0;
-    bool Multi = false, reqSS = (selR.needSpace & XrdCmsNode::allowsSS) != 0;
+   bool reqSS = (selR.needSpace & XrdCmsNode::allowsSS) != 0;
+   SMask_t full = selVec.isFull | (reqSS ? selVec.isNoStage : SMask_t(0));
+   const int *vals = (selR.needSpace ? selVec.myMass : selVec.myLoad);
+   int lim;
 
-// Scan for a node (preset possible, suspended, overloaded, full, and dead)
+// Find the eligible nodes (suspended, overloaded, full, and dead ones are not)
+// and then those whose load is close to the lowest. When space is needed the
+// load includes space utilization.
 //
    selR.Reset(); SelTcnt++;
-   for (int i = 0; i <= STHi; i++)
-       if ((np = NodeTab[i]) && (np->NodeMask & mask))
-          {if (!(selR.needNet & np->hasNet))      {selR.xNoNet= true; continue;}
-           selR.nPick++;
-           if (np->isOffline)                     {selR.xOff  = true; continue;}
-           if (np->isBad)                         {selR.xSusp = true; continue;}
-           if (np->myLoad > Config.MaxLoad)       {selR.xOvld = true; continue;}
-           if (selR.needSpace && (np->DiskFree < np->DiskMinF
-                                  || (reqSS && np->isNoStage)))
-              {selR.xFull = true; continue;}
-           if (!sp) sp = np;
-              else{if (selR.needSpace)
-                      {if (abs(sp->myMass - np->myMass) <= Config.P_fuzz)
-                          {if (selR.selPack)
-                              {if (sp->Inst() > np->Inst())             sp=np;}
-                           else
-                           if (sp->RefW > (np->RefW+Config.DiskLinger)) sp=np;
-                          }
-                          else if (sp->myMass > np->myMass)             sp=np;
-                      } else {
-                       if (abs(sp->myLoad - np->myLoad) <= Config.P_fuzz)
-                          {if (selR.selPack)
-                              {if (sp->Inst() > np->Inst())             sp=np;}
-                              else if (sp->RefR > np->RefR)             sp=np;
-                          }
-                          else if (sp->myLoad > np->myLoad)             sp=np;
-                      }
-                   Multi = true;
-                  }
-          }
-
-// Check for overloaded node and return result
-//
-   if (!sp) return calcDelay(selR);
-   RefCount(sp, Multi, selR.needSpace);
-   return sp;
+   if (!(mask = SelElig(mask, selR, full, true))) return calcDelay(selR);
+   if (Config.sched_P2C && !selR.selPack) return SelbyTwo(mask, selR, vals);
+   lim  = XrdCmsSelVec::Min(mask, vals) + Config.P_fuzz;
+   return SelbyTie(XrdCmsSelVec::Upto(mask, vals, lim), selR,
+                   XrdCmsSMaskCount(mask) > 1);
 }
 
 /******************************************************************************/
@@ -1781,37 +1889,123 @@ XrdCmsNode *XrdCmsCluster::SelbyLoad(SMask_t mask, XrdCmsSelector &selR)
 
 XrdCmsNode *XrdCmsCluster::SelbyRef(SMask_t mask, XrdCmsSelector &selR)
 {
-    XrdCmsNode *np, *sp = 0;
-    bool Multi = false, reqSS = (selR.needSpace & XrdCmsNode::allowsSS) != 0;
+   bool reqSS = (selR.needSpace & XrdCmsNode::allowsSS) != 0;
+   SMask_t full = selVec.isFull | (reqSS ? selVec.isNoStage : SMask_t(0));
 
-// Scan for a node (sp points to the selected one)
+// All eligible nodes are equally good here
 //
    selR.Reset(); SelTcnt++;
-   for (int i = 0; i <= STHi; i++)
-       if ((np = NodeTab[i]) && (np->NodeMask & mask))
-          {if (!(selR.needNet & np->hasNet))    {selR.xNoNet= true; continue;}
-           selR.nPick++;
-           if (np->isOffline)                   {selR.xOff  = true; continue;}
-           if (np->isBad)                       {selR.xSusp = true; continue;}
-           if (selR.needSpace && (np->DiskFree < np->DiskMinF
-                                  || (reqSS && np->isNoStage)))
-              {selR.xFull = true; continue;}
-           if (!sp) sp = np;
-              else {Multi = true;
-                         if (selR.selPack) {if (sp->Inst() > np->Inst())sp=np;}
-                    else if (selR.needSpace)
-                            {if (sp->RefW > (np->RefW+Config.DiskLinger)) sp=np;}
-                    else if (sp->RefR > np->RefR)                         sp=np;
-                   }
-          }
+   if (!(mask = SelElig(mask, selR, full, false))) return calcDelay(selR);
+   return SelbyTie(mask, selR, XrdCmsSMaskCount(mask) > 1);
+}
+
+/******************************************************************************/
+/*                              S e l b y T i e                               */
+/******************************************************************************/
 
-// Check for overloaded node and return result
+// Choose among equally good nodes: the oldest one when packing, otherwise the
+// one least used (for writing, only if it is used noticeably less). These are
+// normally few, so the node objects are looked at directly. A node that turns
+// out to be unselectable after all is skipped and its attributes refreshed.
+// Caller must have the STMutex locked. The returned node. if any, is unlocked.
+  
+XrdCmsNode *XrdCmsCluster::SelbyTie(SMask_t mask, XrdCmsSelector &selR,
+                                    bool Multi)
+{
+   XrdCmsNode *np, *sp = 0;
+
+   for (int i = XrdCmsSMaskFirst(mask); i >= 0; i = XrdCmsSMaskNext(mask, i))
+       {if (!(np = NodeTab[i])) continue;
+        if (np->isOffline || np->isBad) {selVec.Set(i, np); continue;}
+        if (!sp) sp = np;
+           else if (selR.selPack)   {if (sp->Inst() > np->Inst()) sp=np;}
+           else if (selR.needSpace)
+                   {if (sp->RefW > (np->RefW+Config.DiskLinger)) sp=np;}
+           else if (sp->RefR > np->RefR)                          sp=np;
+       }
+
+// Return the result
 //
    if (!sp) return calcDelay(selR);
    RefCount(sp, Multi, selR.needSpace);
    return sp;
 }
- 
+
+/******************************************************************************/
+/*                              S e l b y T w o                               */
+/******************************************************************************/
+
+// Take the less loaded of two eligible nodes picked at random. As loads are
+// reported only now and then, the load is increased by the number of times
+// the node was chosen since its last report and by how slowly it responds.
+// This keeps a burst of requests from all going to the one node that last
+// reported the lowest load. Caller must have the STMutex locked. The returned
+// node. if any, is unlocked.
+
+XrdCmsNode *XrdCmsCluster::SelbyTwo(SMask_t mask, XrdCmsSelector &selR,
+                                    const int *vals)
+{
+   XrdCmsNode *np, *sp = 0;
+   int i, k, n = XrdCmsSMaskCount(mask), pick[2], cost, best = 0;
+
+// Pick two different nodes (or the only one)
+//
+   k = rand_r(&selSeed) % n;
+   pick[0] = XrdCmsSelVec::Nth(mask, k);
+   if (n > 1)
+      {k = (k + 1 + rand_r(&selSeed) % (n-1)) % n;
+       pick[1] = XrdCmsSelVec::Nth(mask, k);
+      }
+
+// Compare them. A node that turns out to be unselectable is refreshed.
+//
+   for (i = 0; i < (n > 1 ? 2 : 1); i++)
+       {if (!(np = NodeTab[pick[i]])) continue;
+        if (np->isOffline || np->isBad) {selVec.Set(pick[i], np); continue;}
+        cost = vals[pick[i]] + np->RefSince*Config.P_refc
+                             + np->RspTime.Time()*Config.P_rspc/16;
+        if (!sp || cost < best) {sp = np; best = cost;}
+       }
+
+// If neither was any good, look at all of them
+//
+   if (!sp) return SelbyTie(mask, selR, n > 1);
+   RefCount(sp, n > 1, selR.needSpace);
+   return sp;
+}
+
+/******************************************************************************/
+/*                               S e l E l i g                                */
+/******************************************************************************/
+
+// Return the nodes in mask that may be selected and record in selR why any
+// were not. The reasons are checked in order so that a node only counts for
+// the first one that applies; nodes in full only count when space is needed.
+  
+SMask_t XrdCmsCluster::SelElig(SMask_t mask, XrdCmsSelector &selR,
+                               SMask_t full, bool chkLoad)
+{
+   SMask_t emask, xmask;
+
+// Only nodes reachable via the wanted network count as possible choices
+//
+   mask &= selVec.inTab;
+   if ((emask = selVec.Net(mask, selR.needNet)) != mask) selR.xNoNet = true;
+   if (!(selR.nPick = XrdCmsSMaskCount(emask))) return emask;
+
+// Weed out the offline, suspended, overloaded, and full nodes
+//
+   if ((xmask = emask & selVec.isOffline)) {selR.xOff  = true; emask ^= xmask;}
+   if ((xmask = emask & selVec.isBad))     {selR.xSusp = true; emask ^= xmask;}
+   if (chkLoad && emask)
+      {xmask = emask ^ XrdCmsSelVec::Upto(emask,selVec.myLoad,Config.MaxLoad);
+       if (xmask) {selR.xOvld = true; emask ^= xmask;}
+      }
+   if (selR.needSpace && (xmask = emask & full))
+      {selR.xFull = true; emask ^= xmask;}
+   return emask;
+}
+
 /******************************************************************************/
 /*                                S e l D F S                                 */
 /******************************************************************************/
@@ -1946,6 +2140,26 @@ void XrdCmsCluster::setAltMan(int snum, XrdLink *lp, int port)
    if (ap >= AltMend) {AltMend = ap + AltSize; AltMent = snum;}
 }
 
+/******************************************************************************/
+/*                               S u m D r o p                                */
+/******************************************************************************/
+
+// Called when a slot gets a new node as the summaries describe the former one
+//
+void XrdCmsCluster::SumDrop(int sNum)
+{
+   XrdCmsSummary *sP, *pP;
+
+   sumLock(sNum).Lock();
+   if ((sP = SumTab[sNum])) {SumTab[sNum] = 0; __sync_fetch_and_sub(&SumCnt, 1);}
+   __sync_fetch_and_and(&SumRes, ~(SMask_t(1) << sNum));
+   pP = SumPnd[sNum]; SumPnd[sNum] = 0;
+   sumLock(sNum).UnLock();
+
+   if (sP) delete sP;
+   if (pP) delete pP;
+}
+
 /******************************************************************************/
 /*                           U n r e a c h a b l e                            */
 /******************************************************************************/
@@ -35,6 +35,7 @@
 #include <strings.h>
 #include <netinet/in.h>
   
+#include "XrdCms/XrdCmsSelVec.hh"
 #include "XrdCms/XrdCmsTypes.hh"
 #include "XrdOuc/XrdOucTList.hh"
 #include "XrdOuc/XrdOucEnum.hh"
@@ -108,6 +109,7 @@ int       sUtil;    // Average utilization (largest one)
 class XrdCmsBaseFR;
 class XrdCmsClustID;
 class XrdCmsSelected;
+class XrdCmsSummary;
 class XrdOucTList;
 
 class XrdCmsCluster
@@ -126,15 +128,18 @@ XrdCmsNode     *Add(XrdLink *lp, int dport, int Status,
 //
 virtual void    BlackList(XrdOucTList *blP);
 
-// Sends a message to all nodes matching smask (three forms for convenience)
+// Sends a message to all nodes matching smask (three forms for convenience).
+// The nodes that could not be sent the message are returned. If qmask is
+// supplied it is set to the nodes that were actually sent the message.
 //
-SMask_t         Broadcast(SMask_t, const struct iovec *, int, int tot=0);
+SMask_t         Broadcast(SMask_t, const struct iovec *, int, int tot=0,
+                          SMask_t *qmask=0);
 
 SMask_t         Broadcast(SMask_t smask, XrdCms::CmsRRHdr &Hdr,
                           char *Data,    int Dlen=0);
 
 SMask_t         Broadcast(SMask_t smask, XrdCms::CmsRRHdr &Hdr,
-                          void *Data,    int Dlen);
+                          void *Data,    int Dlen, SMask_t *qmask=0);
 
 // Sends a message to a single node in a round-robbin fashion.
 //
@@ -206,6 +211,22 @@ void            Space(XrdCms::SpaceData &sData, SMask_t smask);
 int             Stats(char *bfr, int bln); // Server
 int             Statt(char *bfr, int bln); // Manager
 
+// Called to add a path to the namespace summary of a node (see Summary())
+//
+void            SumAdd(int sNum, const char *path);
+
+// Called with a piece of the namespace summary sent by a node. Summaries are
+// used to avoid querying nodes that certainly do not have a file; resolve
+// says the summary may also end a lookup (see Screen()). False is returned if
+// the piece was unacceptable.
+//
+bool            Summary(int sNum, unsigned int gen, int lgbits, int hashes,
+                        bool resolve, int offset, const char *data, int dlen);
+
+// Called whenever a node attribute used for node selection changes
+//
+void            Update(XrdCmsNode *nP);
+
                 XrdCmsCluster();
 virtual        ~XrdCmsCluster() {} // This object should never be deleted
 
@@ -217,16 +238,23 @@ int         Drop(int sent, int sinst, XrdCmsDrop *djp=0);
 void        Record(char *path, const char *reason, bool force=false);
 bool        maxBits(SMask_t mVec, int mbits);
 int         Multiple(SMask_t mVec);
+void        Query(XrdCmsSelect &Sel, XrdCms::CmsRRHdr &Hdr, SMask_t qmask);
+SMask_t     Screen(XrdCmsSelect &Sel, SMask_t qmask, SMask_t smask);
 enum        {eExists, eDups, eROfs, eNoRep, eNoSel, eNoEnt}; // Passed to SelFail
 int         SelFail(XrdCmsSelect &Sel, int rc);
 int         SelNode(XrdCmsSelect &Sel, SMask_t  pmask, SMask_t  amask);
 XrdCmsNode *SelbyCost(SMask_t, XrdCmsSelector &selR);
 XrdCmsNode *SelbyLoad(SMask_t, XrdCmsSelector &selR);
 XrdCmsNode *SelbyRef (SMask_t, XrdCmsSelector &selR);
+XrdCmsNode *SelbyTie (SMask_t, XrdCmsSelector &selR, bool Multi);
+XrdCmsNode *SelbyTwo (SMask_t, XrdCmsSelector &selR, const int *vals);
+SMask_t     SelElig(SMask_t mask, XrdCmsSelector &selR, SMask_t full,
+                    bool chkLoad);
 int         SelDFS(XrdCmsSelect &Sel, SMask_t amask,
                    SMask_t &pmask, SMask_t &smask, int isRW);
 void        sendAList(XrdLink *lp);
 void        setAltMan(int snum, XrdLink *lp, int port);
+void        SumDrop(int sNum);
 int         Unreachable(XrdCmsSelect &Sel, bool none);
 int         Unuseable(XrdCmsSelect &Sel);
 
@@ -237,6 +265,22 @@ static const  int AltSize = 254; // We may revert to IP address
 XrdSysMutex   XXMutex;          // Protects cluster summary state variables
 XrdSysMutex   STMutex;          // Protects all node information  variables
 XrdCmsNode   *NodeTab[STMax];   // Current  set of nodes
+XrdCmsSelVec  selVec;           // Node selection attributes by node number
+
+// The namespace summaries are locked in shards of consecutive node numbers so
+// that lookups screening different nodes or summaries arriving from different
+// nodes do not serialize on a single lock. SumCnt and SumRes are updated with
+// atomics as they span the shards.
+//
+static const int SumShardBits = 3;
+static const int SumShardCnt  = 1 << SumShardBits;
+XrdSysMutex  &sumLock(int sNum) {return sumMutex[sNum/(STMax/SumShardCnt)];}
+
+XrdSysMutex   sumMutex[SumShardCnt]; // Protects the namespace summaries
+XrdCmsSummary *SumTab[STMax];   // Current  namespace summary of each node
+XrdCmsSummary *SumPnd[STMax];   // Incoming namespace summary of each node
+int           SumCnt;           // Number of current summaries
+SMask_t       SumRes;           // Nodes whose summary may resolve lookups
 
 int           STHi;             // NodeTab high watermark
 int           doReset;          // Must send reset event to Managers[resetMask]
@@ -245,6 +289,7 @@ long long     SelWtot;          // Total number of r/w selections (successful)
 long long     SelRcnt;          // Curr  number of r/o selections (successful)
 long long     SelRtot;          // Total number of r/o selections (successful)
 long long     SelTcnt;          // Total number of all selections
+unsigned int  selSeed;          // Random number state for selections
 
 // The following is a list of IP:Port tokens that identify supervisor nodes.
 // The information is sent via the try request to redirect nodes; as needed.
@@ -54,6 +54,7 @@
 #include "XrdCms/XrdCmsCluster.hh"
 #include "XrdCms/XrdCmsConfig.hh"
 #include "XrdCms/XrdCmsManager.hh"
+#include "XrdCms/XrdCmsNotify.hh"
 #include "XrdCms/XrdCmsMeter.hh"
 #include "XrdCms/XrdCmsNode.hh"
 #include "XrdCms/XrdCmsPrepare.hh"
@@ -63,6 +64,7 @@
 #include "XrdCms/XrdCmsRRQ.hh"
 #include "XrdCms/XrdCmsSecurity.hh"
 #include "XrdCms/XrdCmsState.hh"
+#include "XrdCms/XrdCmsSummary.hh"
 #include "XrdCms/XrdCmsSupervisor.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 #include "XrdCms/XrdCmsUtils.hh"
@@ -509,6 +511,7 @@ int XrdCmsConfig::ConfigXeq(char *var, XrdOucStream &CFile, XrdSysError *eDest)
    TS_Xeq("namelib",       xnml);    // Server,  non-dynamic
    TS_Xeq("vnid",          xvnid);   // Server,  non-dynamic
    TS_Xeq("nbsendq",       xnbsq);   // Any      non-dynamic
+   TS_Xeq("notify",        xnote);   // Any,     non-dynamic
    TS_Xeq("osslib",        xolib);   // Any,     non-dynamic
    TS_Xeq("perf",          xperf);   // Server,  non-dynamic
    TS_Xeq("pidpath",       xpidf);   // Any,     non-dynamic
@@ -519,6 +522,7 @@ int XrdCmsConfig::ConfigXeq(char *var, XrdOucStream &CFile, XrdSysError *eDest)
    TS_Xeq("role",          xrole);   // Server,  non-dynamic
    TS_Xeq("seclib",        xsecl);   // Server,  non-dynamic
    TS_Xeq("subcluster",    xsubc);   // Manager, non-dynamic
+   TS_Xeq("summary",       xsumm);   // Server,  non-dynamic
    TS_Xeq("superport",     xsupp);   // Super,   non-dynamic
    TS_Set("wait",          doWait);  // Server,  non-dynamic (backward compat)
    TS_unSet("nowait",      doWait);  // Server,  non-dynamic
@@ -595,7 +599,15 @@ void XrdCmsConfig::DoIt()
 
 // Start the manager subsystem.
 //
-   if (isManager || isServer || isPeer) XrdCmsManager::Start(ManList);
+   if (isManager || isServer || isPeer)
+      {XrdCmsManager::Start(ManList);
+       if (NoteDelay && ManList) Notifier.Init(NoteDelay);
+      }
+
+// Start the namespace summary thread if we are a data server that wants one
+//
+   if (SumLgBits && DiskOK)
+      Summarizer.Init(SumLgBits, SumHashes, SumEvery, SumResolve);
 
 // Start state monitoring thread
 //
@@ -677,6 +689,9 @@ void XrdCmsConfig::ConfigDefaults(void)
    P_load   = 0;
    P_mem    = 0;
    P_pag    = 0;
+   P_refc   = 1;
+   P_rspc   = 1;
+   P_smooth = -1;
    AskPerf  = 10;         // Every 10 pings
    AskPing  = 60;         // Every  1 minute
    PingTick = 0;
@@ -695,6 +710,7 @@ void XrdCmsConfig::ConfigDefaults(void)
    myPaths  = (char *)""; // Default is 'r /'
    ConfigFN = 0;
    sched_RR = sched_Pack = sched_Level = 0; sched_Force = 1;
+   sched_P2C = 0;
    isManager= 0;
    isMeta   = 0;
    isPeer   = 0;
@@ -756,6 +772,11 @@ void XrdCmsConfig::ConfigDefaults(void)
    adsMon      = 0;
    adsProt     = 0;
    nbSQ        = 1;
+   SumLgBits   = 0;
+   SumHashes   = 7;
+   SumEvery    = 30*60;
+   SumResolve  = 0;
+   NoteDelay   = 10;
 
 // Compute the time zone we are in
 //
@@ -1067,14 +1088,18 @@ int XrdCmsConfig::setupManager()
 //
    if (isServer && !XrdCmsSupervisor::Init(AdminPath, AdminMode)) return 1;
 
-// Compute the scheduling policy
+// Compute the scheduling policy. Choosing between two random nodes does not
+// need any load figures as it also uses what we see here; it does want the
+// load figures smoothed unless told otherwise.
 //
-   sched_RR = (100 == P_fuzz) || !AskPerf
-              || !(P_cpu || P_io || P_load || P_mem || P_pag);
+   sched_RR = !sched_P2C && ((100 == P_fuzz) || !AskPerf
+              || !(P_cpu || P_io || P_load || P_mem || P_pag));
    if (sched_RR)
       {Say.Say("Config round robin scheduling in effect.");
        sched_Level = 0;
       }
+   if (P_smooth < 0) P_smooth = (sched_P2C ? 50 : 0);
+   if (sched_P2C) Say.Say("Config two choice scheduling in effect.");
 
 // Create statistical monitoring thread
 //
@@ -1627,7 +1652,9 @@ int XrdCmsConfig::xdefs(XrdSysError *eDest, XrdOucStream &CFile)
 
              qmax <n>          - maximum number of requests that may be queued.
                                  One is the minimum. The default qmax is 2.5
-                                 the limit value.
+                                 the limit value. Requests for a path that is
+                                 already queued are answered along with it
+                                 and do not count.
 
              redirect {immed | verify}
                        immed   - do not verify file existence prior to
@@ -1639,6 +1666,14 @@ int XrdCmsConfig::xdefs(XrdSysError *eDest, XrdOucStream &CFile)
 
              retries <n>         Maximum number of select retries.
 
+             share <pct>       - the percentage of the limit that any one
+                                 requesting node may use. The default is 100.
+                                 Queued requests are always served from each
+                                 requesting node in turn.
+
+             threads <n>       - the number of threads issuing queued lookups.
+                                 The default is 1.
+
    Type: Any, non-dynamic.
 
    Output: 0 upon success or !0 upon failure.
@@ -1649,6 +1684,7 @@ int XrdCmsConfig::xdfs(XrdSysError *eDest, XrdOucStream &CFile)
     int Opts = XrdCmsBaseFS::DFSys | (isProxy ? XrdCmsBaseFS::Immed : 0)
              | (!isManager && isServer ? XrdCmsBaseFS::Servr: 0);
     int Hold = 0, limCent = 0, limFix = 0, limV = 0, qMax = 0, rTry = 0;
+    int Share = 100, tNum = 1;
     char *val;
 
 // If we are a meta-manager or a peer, ignore this option
@@ -1703,6 +1739,16 @@ do{     if (!strcmp("mdhold",  val))
                {eDest->Emsg("Config","retries value not specified.");    return 1;}
             if (XrdOuca2x::a2i(*eDest, "retries value", val, &rTry, 1))  return 1;
            }
+   else if (!strcmp("share",   val))
+           {if (!(val = CFile.GetWord()))
+               {eDest->Emsg("Config","share value not specified.");   return 1;}
+            if (XrdOuca2x::a2i(*eDest,"share value",val,&Share,1,100)) return 1;
+           }
+   else if (!strcmp("threads", val))
+           {if (!(val = CFile.GetWord()))
+               {eDest->Emsg("Config","threads value not specified."); return 1;}
+            if (XrdOuca2x::a2i(*eDest,"threads value",val,&tNum,1,64)) return 1;
+           }
    else {eDest->Emsg("Config", "invalid dfs option '",val,"'."); return 1;}
   } while((val = CFile.GetWord()));
 
@@ -1729,7 +1775,7 @@ do{     if (!strcmp("mdhold",  val))
 // All done, simply set the values
 //
    baseFS.SetTries(true, rTry);
-   baseFS.Limit(limV, qMax);
+   baseFS.Limit(limV, qMax, tNum, Share);
    baseFS.Init(Opts, Hold, Hold*10);
    return 0;
 }
@@ -2124,6 +2170,41 @@ int XrdCmsConfig::xnml(XrdSysError *eDest, XrdOucStream &CFile)
 }
   
 /******************************************************************************/
+/*                                 x n o t e                                  */
+/* Function: xnote
+
+   Purpose:  To parse the directive: notify batch <ms>
+
+             <ms>  The maximum number of milliseconds a have or gone
+                   notification may be held so that it can be sent to our
+                   managers along with others as a single notify request. A
+                   value of zero sends each one as it occurs. The default
+                   is 10.
+
+   Notes:    Managers that do not accept notify requests are always sent
+             the individual notifications.
+
+   Type: Any, non-dynamic.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdCmsConfig::xnote(XrdSysError *eDest, XrdOucStream &CFile)
+{
+    char *val;
+    int msdelay;
+
+    if (!(val = CFile.GetWord()) || strcmp("batch", val))
+       {eDest->Emsg("Config", "notify batch not specified"); return 1;}
+    if (!(val = CFile.GetWord()))
+       {eDest->Emsg("Config", "notify batch delay not specified"); return 1;}
+    if (XrdOuca2x::a2i(*eDest, "notify batch delay", val, &msdelay, 0, 1000))
+       return 1;
+
+    NoteDelay = msdelay;
+    return 0;
+}
+  
 /*                                 x o l i b                                  */
 /******************************************************************************/
 
@@ -2434,6 +2515,7 @@ int XrdCmsConfig::xreps(XrdSysError *eDest, XrdOucStream &CFile)
     static struct repsopts {const char *opname; int opval;} rsopts[] =
        {
         {"all",      RepStat_All},
+        {"cch",      RepStat_cch},
         {"frq",      RepStat_frq},
         {"shr",      RepStat_shr}
        };
@@ -2645,6 +2727,8 @@ int XrdCmsConfig::xrole(XrdSysError *eDest, XrdOucStream &CFile)
                                        [io <p>] [runq <p>]
                                        [mem <p>] [pag <p>] [space <p>]
                                        [fuzz <p>] [maxload <p>] [refreset <sec>]
+                                       [select {least | p2c}] [smooth <p>]
+                                       [refcost <n>] [rspcost <n>]
                 [affinity [default] {none | weak | strong | strict}]
 
              <p>      is the percentage to include in the load as a value
@@ -2655,7 +2739,15 @@ int XrdCmsConfig::xrole(XrdSysError *eDest, XrdOucStream &CFile)
                       between reference counter resets. gshr is the percentage
                       share of requests that should be redirected here via the 
                       metamanager (i.e. global share). The gsdflt is the
-                      default to be used by the metamanager.
+                      default to be used by the metamanager. smooth is the
+                      weight the previous load of a server keeps when it
+                      reports a new one (default 50 for p2c, 0 otherwise).
+             least    selects the least loaded server (the default).
+             p2c      selects the less loaded of two servers picked at random.
+                      Load is increased by refcost for each redirection made
+                      to the server since its last load report (default 1)
+                      and by rspcost for each millisecond the server takes to
+                      respond to pings (default 1). Either may be 0 to 100.
 
    Type: Any, dynamic.
 
@@ -2677,10 +2769,14 @@ int XrdCmsConfig::xsched(XrdSysError *eDest, XrdOucStream &CFile)
         {"runq",     100, &P_load}, // Actually load, runq to avoid confusion
         {"mem",      100, &P_mem},
         {"pag",      100, &P_pag},
+        {"refcost",  100, &P_refc},
+        {"rspcost",  100, &P_rspc},
+        {"smooth",   100, &P_smooth},
         {"space",    100, &P_dsk},
         {"maxload",  100, &MaxLoad},
         {"refreset", -1,  &RefReset},
         {"affinity", -2,  0},
+        {"select",   -3,  0},
         {"tryhname",   1, &V_hntry}
        };
     int numopts = sizeof(scopts)/sizeof(struct schedopts);
@@ -2700,6 +2796,14 @@ int XrdCmsConfig::xsched(XrdSysError *eDest, XrdOucStream &CFile)
                       {if (!xschedm(val, eDest, CFile)) return 1;
                        break;
                       }
+                   if (scopts[i].maxv == -3)
+                      {     if (!strcmp(val, "p2c"))   sched_P2C = 1;
+                       else if (!strcmp(val, "least")) sched_P2C = 0;
+                       else {eDest->Emsg("Config","Invalid sched select -",val);
+                             return 1;
+                            }
+                       break;
+                      }
                    if (scopts[i].maxv < 0)
                       {if (XrdOuca2x::a2tm(*eDest,"sched value", val, &ppp, 0)) 
                           return 1;
@@ -2975,6 +3079,79 @@ int XrdCmsConfig::xsubc(XrdSysError *eDest, XrdOucStream &CFile)
    return (XrdCmsUtils::ParseMan(eDest, &SanList, hSpec, hPort) ? 0 : 1);
 }
   
+/******************************************************************************/
+/*                                 x s u m m                                  */
+/******************************************************************************/
+
+/* Function: xsumm
+
+   Purpose:  To parse the directive: summary [size <sz>] [hashes <n>]
+                                             [every <sec>] [resolve]
+
+             <sz>  The size of the namespace summary in bytes (or K, M). It is
+                   rounded up to a power of two between 1K and 8M. The default
+                   is 1M which suits about a million files.
+             <n>   The number of hashes used for each file, 1 to 16. The
+                   default is 7.
+             <sec> The number of seconds between summary rebuilds. The default
+                   is 30m.
+   resolve   Files only appear through xrootd. Managers then answer a lookup
+             that no summary allows right away. Otherwise they still ask the
+             servers, as a file created behind xrootd's back is only in the
+             summary after the next rebuild.
+
+   Notes:    Only data servers build a namespace summary. Their managers use
+             it to avoid asking them about files they do not have.
+
+   Type: Server, non-dynamic.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdCmsConfig::xsumm(XrdSysError *eDest, XrdOucStream &CFile)
+{
+    char *val;
+    long long sumsz = 1024*1024;
+    int lgbits, hashes = SumHashes, every = SumEvery, resolve = 0;
+
+    while((val = CFile.GetWord()))
+      {    if (!strcmp("size", val))
+              {if (!(val = CFile.GetWord()))
+                  {eDest->Emsg("Config", "summary size not specified"); return 1;}
+               if (XrdOuca2x::a2sz(*eDest,"summary size",val,&sumsz,
+                                   1024, 8*1024*1024)) return 1;
+              }
+      else if (!strcmp("hashes", val))
+              {if (!(val = CFile.GetWord()))
+                  {eDest->Emsg("Config", "summary hashes not specified");
+                   return 1;
+                  }
+               if (XrdOuca2x::a2i(*eDest,"summary hashes",val,&hashes,
+                                  1, XrdCmsSummary::maxHashes)) return 1;
+              }
+      else if (!strcmp("every", val))
+              {if (!(val = CFile.GetWord()))
+                  {eDest->Emsg("Config", "summary interval not specified");
+                   return 1;
+                  }
+               if (XrdOuca2x::a2tm(*eDest,"summary interval",val,&every,60))
+                  return 1;
+              }
+      else if (!strcmp("resolve", val)) resolve = 1;
+      else {eDest->Emsg("Config", "invalid summary option -", val); return 1;}
+      }
+
+    lgbits = XrdCmsSummary::minLgBits;
+    while(lgbits < XrdCmsSummary::maxLgBits && (1LL << (lgbits-3)) < sumsz)
+         lgbits++;
+
+    SumLgBits = lgbits;
+    SumHashes = hashes;
+    SumEvery  = every;
+    SumResolve= resolve;
+    return 0;
+}
+
 /******************************************************************************/
 /*                                 x s u p p                                  */
 /******************************************************************************/
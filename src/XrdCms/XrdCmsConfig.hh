@@ -103,6 +103,9 @@ int         P_io;         // % I/O Capacity in load factor
 int         P_load;       // % MSC Capacity in load factor
 int         P_mem;        // % MEM Capacity in load factor
 int         P_pag;        // % PAG Capacity in load factor
+int         P_refc;       //       Load added per selection since last report
+int         P_rspc;       //       Load added per millisecond of response time
+int         P_smooth;     // %     Weight of the old load when a new one arrives
 
 char        DoMWChk;      // When true (default) perform multiple write check
 char        DoHnTry;      // When true (default) use hostnames for try redirs
@@ -118,11 +121,17 @@ int         DiskAsk;      // Seconds between disk space reclaculations
 int         DiskWT;       // Seconds to defer client while waiting for space
 int         DiskSS;       // This is a staging server
 int         DiskOK;       // This configuration has data
+int         SumLgBits;    // log2 of the namespace summary bits (0 -> none)
+int         SumHashes;    // Number of hashes used by the namespace summary
+int         SumEvery;     // Seconds between namespace summary rebuilds
+int         SumResolve;   // 1 -> Files only appear through xrootd
+int         NoteDelay;    // Milliseconds to batch have/gone notifications
 
 char        sched_RR;     // 1 -> Simply do round robin scheduling
 char        sched_Pack;   // 1 -> Pick oldest node (>1 same but wait for resps)
 char        sched_Level;  // 1 -> Use load-based level for "pack" selection
 char        sched_Force;  // 1 -> Client cannot select mode
+char        sched_P2C;    // 1 -> Pick the better of two random nodes
 int         doWait;       // 1 -> Wait for a data end-point
 
 int         adsPort;      // Alternate server port
@@ -187,6 +196,7 @@ XrdNetSecurity    *Police;
 //
 static const int RepStat_frq    = 0x0001; // Fast Response Queue
 static const int RepStat_shr    = 0x0002; // Share
+static const int RepStat_cch    = 0x0004; // Location cache shards
 static const int RepStat_All    = 0xffff; // All
 
 private:
@@ -218,6 +228,7 @@ int  xlclrt(XrdSysError *edest, XrdOucStream &CFile);
 int  xmang(XrdSysError *edest, XrdOucStream &CFile);
 int  xnbsq(XrdSysError *edest, XrdOucStream &CFile);
 int  xnml(XrdSysError *edest, XrdOucStream &CFile);
+int  xnote(XrdSysError *edest, XrdOucStream &CFile);
 int  xolib(XrdSysError *edest, XrdOucStream &CFile);
 int  xperf(XrdSysError *edest, XrdOucStream &CFile);
 int  xpidf(XrdSysError *edest, XrdOucStream &CFile);
@@ -232,6 +243,7 @@ int  xschedm(char *val, XrdSysError *eDest, XrdOucStream &CFile);
 int  xsecl(XrdSysError *edest, XrdOucStream &CFile);
 int  xspace(XrdSysError *edest, XrdOucStream &CFile);
 int  xsubc(XrdSysError *edest, XrdOucStream &CFile);
+int  xsumm(XrdSysError *edest, XrdOucStream &CFile);
 int  xsupp(XrdSysError *edest, XrdOucStream &CFile);
 int  xtrace(XrdSysError *edest, XrdOucStream &CFile);
 int  xvnid(XrdSysError *edest, XrdOucStream &CFile);
@@ -54,6 +54,7 @@
 
 #include "XrdCms/XrdCmsFinder.hh"
 #include "XrdCms/XrdCmsParser.hh"
+#include "XrdCms/XrdCmsRdrCache.hh"
 #include "XrdCms/XrdCmsResp.hh"
 #include "XrdCms/XrdCmsRRData.hh"
 #include "XrdCms/XrdCmsSecurity.hh"
@@ -106,6 +107,7 @@ XrdCmsFinderRMT::XrdCmsFinderRMT(XrdSysLogger *lp, int whoami, int Port)
      myManagers  = 0;
      myManCount  = 0;
      myManList   = 0;
+     rdrCache    = 0;
      myPort      = Port;
      SMode       = 0;
      sendID      = 0;
@@ -128,6 +130,8 @@ XrdCmsFinderRMT::~XrdCmsFinderRMT()
     while((mp = nmp)) {nmp = mp->nextManager(); delete mp;}
 
     while((tp = tpp)) {tpp = tp->next; delete tp;}
+
+    if (rdrCache) delete rdrCache;
 }
 
 /******************************************************************************/
@@ -174,6 +178,17 @@ int XrdCmsFinderRMT::Configure(const char *cfn, char *Args, XrdOucEnv *envP)
    ConWait    = config.ConWait;
    FwdWait    = config.FwdWait;
    PrepWait   = config.PrepWait;
+
+// Create the redirect cache if wanted. The managers must know about it before
+// they log in as they are asked to tell us about changes.
+//
+   if (config.RdrTTL)
+      {rdrCache = new XrdCmsRdrCache(config.RdrTTL, config.RdrMax);
+       XrdCmsClientMan::setCache(rdrCache);
+      }
+
+// Start the managers
+//
    if (isProxy)
            {SMode = config.SModeP;
             StartManagers(config.PanList);
@@ -333,13 +348,21 @@ void XrdCmsFinderRMT::Inform(XrdCmsClientMan *xman,
 int XrdCmsFinderRMT::Locate(XrdOucErrInfo &Resp, const char *path, int flags,
                             XrdOucEnv *Env)
 {
+   EPNAME("Locate")
    static const int xNum   = 12;
 
+   static const int noCache = CmsSelectRequest::kYR_create
+                            | CmsSelectRequest::kYR_trunc
+                            | CmsSelectRequest::kYR_stat
+                            | CmsSelectRequest::kYR_metaop
+                            | CmsSelectRequest::kYR_refresh;
+
    XrdCmsRRData   Data;
-   int            n, iovcnt;
+   int            n, iovcnt, retc;
    char           Work[xNum*12];
    struct iovec   xmsg[xNum];
    char          *triedRC, *affmode;
+   bool           doCache = false;
 
 // Fill out the RR data structure
 //
@@ -423,6 +446,21 @@ int XrdCmsFinderRMT::Locate(XrdOucErrInfo &Resp, const char *path, int flags,
        else if (!strcmp(triedRC, "resel"))
                Data.Opts |= CmsSelectRequest::kYR_tryRSEL;
       }
+
+// Opens of existing files may be redirected where the last one went. A retry
+// means that was wrong, so the redirect is forgotten and the manager asked.
+//
+   if (rdrCache && !(Data.Opts & noCache))
+      {if (Data.Avoid) rdrCache->Del(path);
+          else {Resp.setErrData(savePath ? path : 0);
+                if (!rdrCache->Find(path, Data.Opts, Resp)) doCache = true;
+                   else {TRACE(Redirect, "cache redirects " <<Resp.getErrUser()
+                               <<" to " <<Resp.getErrText() <<':'
+                               <<Resp.getErrInfo() <<' ' <<path);
+                         return SFS_REDIRECT;
+                        }
+               }
+      }
   }
 
 // Pack the arguments
@@ -440,9 +478,12 @@ int XrdCmsFinderRMT::Locate(XrdOucErrInfo &Resp, const char *path, int flags,
    xmsg[0].iov_base      = (char *)&Data.Request;
    xmsg[0].iov_len       = sizeof(Data.Request);
 
-// Send the 2way message
+// Send the 2way message and remember where we were redirected if need be
 //
-   return send2Man(Resp, path, xmsg, iovcnt+1);
+   retc = send2Man(Resp, path, xmsg, iovcnt+1);
+   if (doCache && retc == SFS_REDIRECT)
+      rdrCache->Add(path, Data.Opts, Resp.getErrText(), Resp.getErrInfo());
+   return retc;
 }
   
 /******************************************************************************/
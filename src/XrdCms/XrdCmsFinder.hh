@@ -35,6 +35,7 @@
 #include "XrdSys/XrdSysPthread.hh"
 
 class  XrdCmsClientMan;
+class  XrdCmsRdrCache;
 class  XrdOss;
 class  XrdOucEnv;
 class  XrdOucErrInfo;
@@ -93,6 +94,7 @@ int              StartManagers(XrdOucTList *);
 XrdCmsClientMan *myManTable[MaxMan];
 XrdCmsClientMan *myManagers;
 XrdOucTList     *myManList;
+XrdCmsRdrCache  *rdrCache;
 int              myManCount;
 XrdSysMutex      myData;
 char            *CMSPath;
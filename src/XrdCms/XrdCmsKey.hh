@@ -92,6 +92,7 @@ public:
 SMask_t        hfvec;    // Servers that are staging or have the file
 SMask_t        pfvec;    // Servers that are staging         the file
 SMask_t        qfvec;    // Servers that are not yet queried
+SMask_t        rfvec;    // Servers that were queried but have not responded
 unsigned int   TOD_B;    // Server currency clock
 int            lifeline; // TOD when nil entry should expire
 union {
@@ -120,7 +121,8 @@ XrdCmsKeyLoc&  operator=(const XrdCmsKeyLoc &rhs)
   
 // The XrdCmsKeyItem object marries the XrdCmsKey and XrdCmsKeyLoc objects in
 // the key cache. It is only used by logical manipulator, XrdCmsCache, which
-// always front-ends the physical manipulator, XrdCmsNash.
+// always front-ends the physical manipulator, XrdCmsNash. Items are handed out
+// by an XrdCmsKeyPool and always return to the pool they came from.
 //
 class XrdCmsKeyItem
 {
@@ -130,34 +132,56 @@ public:
        XrdCmsKey      Key;
        XrdCmsKeyItem *Next;
 
-static XrdCmsKeyItem *Alloc(unsigned int theTock);
+       XrdCmsKeyItem() {}  // Warning see the constructor!
+      ~XrdCmsKeyItem() {}  // These are usually never deleted
+
+static const unsigned int TickRate =   64;
+static const unsigned int TickMask =   63;
+static const          int minAlloc = 4096;
+static const          int minFree  = 1024;
+};
 
-       void           Recycle();
+/******************************************************************************/
+/*                   C l a s s   X r d C m s K e y P o o l                    */
+/******************************************************************************/
 
-       void           Reload();
+// The XrdCmsKeyPool object holds the free items and the aging (tock) lists of
+// one key cache. It is not serialized; the cache serializes access to it.
+//
+class XrdCmsKeyPool
+{
+public:
 
-static int            Replenish();
+XrdCmsKeyItem *Alloc(unsigned int theTock);
 
-static void           Stats(int &isAlloc, int &isFree, int &wasEmpty);
+void           Recycle(XrdCmsKeyItem *theItem);
 
-static XrdCmsKeyItem *Unload(unsigned int   theTock);
+void           Reload(XrdCmsKeyItem *theItem);
 
-static XrdCmsKeyItem *Unload(XrdCmsKeyItem *theItem);
+int            Replenish();
 
-       XrdCmsKeyItem() {}  // Warning see the constructor!
-      ~XrdCmsKeyItem() {}  // These are usually never deleted
+void           Stats(int &isAlloc, int &isFree, int &wasEmpty);
 
-static const unsigned int TickRate =   64;
-static const unsigned int TickMask =   63;
-static const          int minAlloc = 4096;
-static const          int minFree  = 1024;
+XrdCmsKeyItem *Unload(unsigned int   theTock);
 
-private:
+XrdCmsKeyItem *Unload(XrdCmsKeyItem *theItem);
 
-static XrdCmsKeyItem *TockTable[TickRate];
-static XrdCmsKeyItem *Free;
-static int            numFree;
-static int            numHave;
-static int            numNull;
+// The quantum is the number of items allocated at a time and the minimum is
+// the number of free items below which the cache asks for more.
+//
+               XrdCmsKeyPool(int quantum=XrdCmsKeyItem::minAlloc,
+                             int minimum=XrdCmsKeyItem::minFree)
+                            : Free(0), numFree(0), numHave(0), numNull(0),
+                              minAlloc(quantum), minFree(minimum)
+                            {memset(TockTable, 0, sizeof(TockTable));}
+              ~XrdCmsKeyPool() {} // Never gets deleted
+
+XrdCmsKeyItem *TockTable[XrdCmsKeyItem::TickRate];
+XrdCmsKeyItem *Free;
+int            numFree;
+int            numHave;
+int            numNull;
+int            minAlloc;
+int            minFree;
 };
 #endif
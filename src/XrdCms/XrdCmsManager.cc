@@ -40,6 +40,7 @@
 #include "XrdCms/XrdCmsManager.hh"
 #include "XrdCms/XrdCmsManTree.hh"
 #include "XrdCms/XrdCmsNode.hh"
+#include "XrdCms/XrdCmsNotify.hh"
 #include "XrdCms/XrdCmsProtocol.hh"
 #include "XrdCms/XrdCmsRouting.hh"
 #include "XrdCms/XrdCmsUtils.hh"
@@ -307,6 +308,44 @@ void XrdCmsManager::Inform(CmsRRHdr &Hdr, const char *Arg, int Alen)
     Inform(Router.getName(Hdr.rrCode), ioV, (Arg ? 2 : 1), Alen+sizeof(Hdr));
 }
 
+/******************************************************************************/
+/*                                N o t i f y                                 */
+/******************************************************************************/
+  
+void XrdCmsManager::Notify(const char *Data, int Dlen)
+{
+   EPNAME("Notify");
+   CmsRRHdr Hdr = {0, kYR_notify, kYR_raw,
+                   htons(static_cast<unsigned short>(Dlen))};
+   struct iovec ioV[2] = {{(char *)&Hdr, sizeof(Hdr)},
+                          {(char *)Data, (size_t)Dlen}};
+   XrdCmsNode *nP;
+   int i;
+
+// Obtain a lock on the table
+//
+   MTMutex.Lock();
+
+// Run through the table sending the batch in whatever form each manager takes
+//
+   for (i = 0; i <= MTHi; i++)
+       {if ((nP=MastTab[i]) && !nP->isOffline)
+           {nP->Lock(true);
+            MTMutex.UnLock();
+            if (nP->canBatch())
+               {DEBUG(nP->Name() <<" notify");
+                nP->Send(ioV, 2, sizeof(Hdr)+Dlen);
+               } else {
+                DEBUG(nP->Name() <<" notify unbatched");
+                XrdCmsNotifier::Unbatch(nP, Data, Dlen);
+               }
+            nP->UnLock();
+            MTMutex.Lock();
+           }
+       }
+   MTMutex.UnLock();
+}
+
 /******************************************************************************/
 /*                                R e m o v e                                 */
 /******************************************************************************/
@@ -576,6 +615,35 @@ bool XrdCmsManager::Start(const XrdOucTList *mL)
    return xnum == mtot;
 }
 
+/******************************************************************************/
+/*                               S u m m a r y                                */
+/******************************************************************************/
+  
+void XrdCmsManager::Summary(struct iovec *vP, int vN, int vT)
+{
+   EPNAME("Summary");
+   XrdCmsNode *nP;
+   int i;
+
+// Obtain a lock on the table
+//
+   MTMutex.Lock();
+
+// Run through the table looking for managers that take summaries
+//
+   for (i = 0; i <= MTHi; i++)
+       {if ((nP=MastTab[i]) && !nP->isOffline && nP->canSummary())
+           {nP->Lock(true);
+            MTMutex.UnLock();
+            DEBUG(nP->Name() <<" summary");
+            nP->Send(vP, vN, vT);
+            nP->UnLock();
+            MTMutex.Lock();
+           }
+       }
+   MTMutex.UnLock();
+}
+
 /******************************************************************************/
 /*                                V e r i f y                                 */
 /******************************************************************************/
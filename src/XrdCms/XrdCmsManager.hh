@@ -73,6 +73,16 @@ static void Inform(const char *What, struct iovec *vP, int vN, int vT=0);
 static void Inform(XrdCms::CmsReqCode rCode, int rMod, const char *Arg=0, int Alen=0);
 static void Inform(XrdCms::CmsRRHdr &Hdr, const char *Arg=0, int Alen=0);
 
+// Notify() sends a batch of have and gone requests as a notify request or, to
+// managers that do not accept one, as the individual requests.
+//
+static void Notify(const char *Data, int Dlen);
+
+// Summary() sends a piece of the namespace summary to the managers that accept
+// one. Older managers would reject the unknown request.
+//
+static void Summary(struct iovec *vP, int vN, int vT);
+
 static bool Present() {return MTHi >= 0;};
 
 void        Remove(XrdCmsNode *nP, const char *reason=0);
@@ -39,13 +39,15 @@ XrdCmsKeyItem *Add(XrdCmsKey &Key);
 
 XrdCmsKeyItem *Find(XrdCmsKey &Key);
 
+int            Num() {return nashnum;}
+
 int            Recycle(XrdCmsKeyItem *rip);
 
-// When allocateing a new nash, specify the required starting size. Make
-// sure that the previous number is the correct Fibonocci antecedent. The
-// series is simply n[j] = n[j-1] + n[j-2].
+// When allocateing a new nash, specify the pool its items come from and the
+// required starting size. Make sure that the previous number is the correct
+// Fibonocci antecedent. The series is simply n[j] = n[j-1] + n[j-2].
 //
-    XrdCmsNash(int psize = 17711, int size = 28657);
+    XrdCmsNash(XrdCmsKeyPool &pool, int psize = 17711, int size = 28657);
    ~XrdCmsNash() {} // Never gets deleted
 
 private:
@@ -54,6 +56,7 @@ static const int LoadMax = 80;
 
 void               Expand();
 
+XrdCmsKeyPool   &keyPool;
 XrdCmsKeyItem  **nashtable;
 int              prevtablesize;
 int              nashtablesize;
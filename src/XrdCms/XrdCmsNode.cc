@@ -49,9 +49,11 @@
 #include "XrdCms/XrdCmsManager.hh"
 #include "XrdCms/XrdCmsManList.hh"
 #include "XrdCms/XrdCmsMeter.hh"
+#include "XrdCms/XrdCmsNotify.hh"
 #include "XrdCms/XrdCmsPList.hh"
 #include "XrdCms/XrdCmsPrepare.hh"
 #include "XrdCms/XrdCmsRRData.hh"
+#include "XrdCms/XrdCmsRTable.hh"
 #include "XrdCms/XrdCmsNode.hh"
 #include "XrdCms/XrdCmsSelect.hh"
 #include "XrdCms/XrdCmsState.hh"
@@ -82,6 +84,15 @@ namespace
 {
 XrdNetIF::ifType ifVec[4] = {XrdNetIF::PublicV4, XrdNetIF::Public46,
                              XrdNetIF::PublicV6, XrdNetIF::Public64};
+
+// Milliseconds on a clock that never goes backwards (used for response times)
+//
+long long msNow()
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return static_cast<long long>(ts.tv_sec)*1000 + ts.tv_nsec/1000000;
+}
 };
   
 /******************************************************************************/
@@ -124,6 +135,10 @@ XrdCmsNode::XrdCmsNode(XrdLink *lnkp, const char *theIF, const char *nid,
     RefTotW  =  0;
     RefR     =  0;
     RefTotR  =  0;
+    RefSince =  0;
+    hasLoad  =  0;
+    isBatch  =  0;
+    isSumry  =  0;
     Share    =  0;
     Shrem    =  0;
     Shrin    =  0;
@@ -307,6 +322,7 @@ void XrdCmsNode::Disc(const char *reason, int needLock)
 //
    if (needLock) nodeMutex.Lock();
    isOffline = 1;         // STMutex is already held if needed
+   Cluster.Update(this);
 
 // If we are still connected, initiate a teardown. This may be done async as
 // we are asking for a defered close which will be followed by a full close.
@@ -337,6 +353,7 @@ const char *XrdCmsNode::do_Avail(XrdCmsRRData &Arg)
 //
    DiskFree = Arg.dskFree;
    DiskUtil = static_cast<int>(Arg.dskUtil);
+   Cluster.Update(this);
 
 // Do some debugging
 //
@@ -398,6 +415,7 @@ const char *XrdCmsNode::do_Disc(XrdCmsRRData &Arg)
 // Close the link and return an error
 //
    isOffline = 1;  // STMutex not needed here
+   Cluster.Update(this);
    Link->Close(1);
    return ".";   // Signal disconnect
 }
@@ -419,6 +437,19 @@ const char *XrdCmsNode::do_Gone(XrdCmsRRData &Arg)
 //
    TRACER(Files,Arg.Path);
 
+// A miss is the answer to a state query that asked for one. It tells us the
+// node does not have the file, which we already assumed, so it only counts
+// as a response to the query and is never propagated.
+//
+   if (Arg.Request.modifier & CmsGoneRequest::kYR_miss)
+      {if (Config.asManager())
+          {XrdCmsSelect Sel(0, Arg.Path, Arg.PathLen-1);
+           Sel.Path.Hash = Arg.Request.streamid;
+           Cache.NakFile(Sel, NodeMask);
+          }
+       return 0;
+      }
+
 // Update path information and delete this from the prep queue if we are a
 // staging node. We can also be called via the admin end-point interface
 // In this case, we have no cache and simply forward up the request.
@@ -426,6 +457,7 @@ const char *XrdCmsNode::do_Gone(XrdCmsRRData &Arg)
    if (Config.asManager())
       {XrdCmsSelect Sel(XrdCmsSelect::Advisory, Arg.Path, Arg.PathLen-1);
        newgone = Cache.DelFile(Sel, baseFS.isDFS() ? allNodes : NodeMask);
+       if (newgone) RTable.Inform("gone", Arg.Request, Arg.Buff, Arg.Dlen);
       } else {
        newgone = 1;
        if (Config.DiskSS) PrepQ.Gone(Arg.Path);
@@ -437,7 +469,7 @@ const char *XrdCmsNode::do_Gone(XrdCmsRRData &Arg)
 
 // Back-propogate the gone to all of our managers
 //
-   XrdCmsManager::Inform(Arg.Request, Arg.Buff, Arg.Dlen);
+   Notifier.Add(kYR_gone, Arg.Request.modifier, Arg.Path, Arg.PathLen-1);
 
 // All done
 //
@@ -480,7 +512,10 @@ const char *XrdCmsNode::do_Have(XrdCmsRRData &Arg)
             if (baseFS.isDFS())
                {Sel.Vec.hf = pinfo.rovec; Sel.Vec.wf = pinfo.rwvec;
                 isnew       = Cache.AddFile(Sel, allNodes);
-               } else isnew = Cache.AddFile(Sel, NodeMask);
+               } else {isnew = Cache.AddFile(Sel, NodeMask);
+                       Cluster.SumAdd(NodeID, Arg.Path);
+                      }
+            if (isnew) RTable.Inform("have", Arg.Request, Arg.Buff, Arg.Dlen);
            }
 
 // Return if we have no managers or we already informed the managers
@@ -489,7 +524,7 @@ const char *XrdCmsNode::do_Have(XrdCmsRRData &Arg)
 
 // Back-propogate the have to all of our managers
 //
-   XrdCmsManager::Inform(Arg.Request, Arg.Buff, Arg.Dlen);
+   Notifier.Add(kYR_have, Arg.Request.modifier, Arg.Path, Arg.PathLen-1);
 
 // All done
 //
@@ -505,7 +540,7 @@ const char *XrdCmsNode::do_Have(XrdCmsRRData &Arg)
 const char *XrdCmsNode::do_Load(XrdCmsRRData &Arg)
 {
    EPNAME("do_Load")
-   int temp, pcpu, pnet, pxeq, pmem, ppag, pdsk;
+   int temp, pcpu, pnet, pxeq, pmem, ppag, pdsk, sw = Config.P_smooth;
 
 // Process: load <cpu> <io> <load> <mem> <pag> <util> <rsvd> <dskFree>
 //               0     1    2      3     4     5      6
@@ -516,12 +551,23 @@ const char *XrdCmsNode::do_Load(XrdCmsRRData &Arg)
    ppag = static_cast<int>(Arg.Opaque[CmsLoadRequest::pagLoad]);
    pdsk = static_cast<int>(Arg.Opaque[CmsLoadRequest::dskLoad]);
 
-// Compute actual load value
+// The load answers our usage request, so it also tells how quickly the node
+// responds. It must be folded in here or the next ping would be timed from
+// the usage request.
+//
+   RspTime.Answered(msNow());
+
+// Compute actual load value, smoothed with the previous one if so wanted. As
+// this load reflects whatever we sent the node, we start counting anew.
 //
-   myLoad = Meter.calcLoad(pcpu, pnet, pxeq, pmem, ppag);
+   temp   = Meter.calcLoad(pcpu, pnet, pxeq, pmem, ppag);
+   if (sw && hasLoad) myLoad = (myLoad*sw + temp*(100-sw))/100;
+      else {myLoad = temp; hasLoad = 1;}
    myMass = Meter.calcLoad(myLoad, pdsk);
+   RefSince = 0;
    DiskFree = Arg.dskFree;
    DiskUtil = pdsk;
+   Cluster.Update(this);
 
 // Do some debugging
 //
@@ -877,6 +923,94 @@ const char *XrdCmsNode::do_Mv(XrdCmsRRData &Arg)
    return (rc ? fsFail(Arg.Ident, "mv", Arg.Path, rc) : 0);
 }
 
+/******************************************************************************/
+/*                             d o _ N o t i f y                              */
+/******************************************************************************/
+
+// A notify request is a batch of have and gone requests. Each is handled as
+// do_Have() and do_Gone() would handle it except that the cache is updated a
+// chunk of requests at a time so that each cache shard is locked only once.
+//
+const char *XrdCmsNode::do_Notify(XrdCmsRRData &Arg)
+{
+   EPNAME("do_Notify")
+   static const SMask_t allNodes(~0);
+   static const int maxUpd = 32;
+   XrdCmsNotify Batch(Arg.Buff, Arg.Dlen);
+   XrdCmsCache::Update Upd[maxUpd];
+   XrdCmsSelect Sel[maxUpd];
+   CmsRRHdr     Hdr = {0, 0, 0, 0};
+   const char  *path;
+   char         pArena[16384], *pP;
+   int          Mods[maxUpd], rrCode, rrMod, plen, i, n;
+
+// Process: notify <batch>
+// Respond: n/a
+//
+   do {n = 0; pP = pArena;
+
+   // Collect a chunk of requests. The paths are copied into the arena because
+   // the batch returns each one in the same buffer.
+   //
+       while(n < maxUpd && pArena+sizeof(pArena)-pP > XrdCmsMAX_PATH_LEN
+         &&  Batch.Next(rrCode, rrMod, path, plen))
+            {if ((rrCode != kYR_have && rrCode != kYR_gone)
+             ||  (rrCode == kYR_gone && rrMod & CmsGoneRequest::kYR_miss))
+                continue;
+             strcpy(pP, path);
+             Sel[n].Path.Val  = pP;     Sel[n].Path.Len = plen;
+             Sel[n].Path.Hash = 0;      Sel[n].Path.Ref = 0;
+             Sel[n].Opts      = XrdCmsSelect::Advisory;
+             if (rrCode == kYR_have)
+                {XrdCmsPInfo pinfo;
+                 if (Cache.Paths.Find(pP, pinfo) && (pinfo.rwvec & NodeMask))
+                    Sel[n].Opts |= XrdCmsSelect::Write;
+                 if (rrMod & CmsHaveRequest::Pending)
+                    Sel[n].Opts |= XrdCmsSelect::Pending;
+                 Sel[n].Vec.hf = pinfo.rovec; Sel[n].Vec.wf = pinfo.rwvec;
+                }
+             TRACER(Files, (rrCode == kYR_have ? "have " : "gone ")
+                           <<(rrMod & CmsHaveRequest::Pending
+                             && rrCode == kYR_have ? "P " : "") <<pP);
+             Upd[n].Sel  = &Sel[n];
+             Upd[n].Rc   = 1;
+             Upd[n].Have = (rrCode == kYR_have);
+             Mods[n++]   = rrMod;
+             pP += plen+1;
+            }
+       if (!n) break;
+
+   // Update the cache for the whole chunk. When called via the admin interface
+   // we have no cache and simply forward the requests.
+   //
+       if (Config.asManager())
+          Cache.PutFiles(Upd, n, (baseFS.isDFS() ? allNodes : NodeMask));
+
+   // Finish up each request and propagate whatever is new
+   //
+       for (i = 0; i < n; i++)
+           {pP = Sel[i].Path.Val; plen = Sel[i].Path.Len;
+            rrCode = (Upd[i].Have ? kYR_have : kYR_gone);
+            if (Config.asManager())
+               {if (Upd[i].Have && !baseFS.isDFS()) Cluster.SumAdd(NodeID, pP);
+               } else if (!Upd[i].Have && Config.DiskSS) PrepQ.Gone(pP);
+            if (!Upd[i].Rc) continue;
+            if (Config.asManager())
+               {Hdr.rrCode = rrCode; Hdr.modifier = Mods[i] | kYR_raw;
+                RTable.Inform((Upd[i].Have ? "have" : "gone"), Hdr,
+                              pP, plen+1);
+               }
+            if (XrdCmsManager::Present())
+               Notifier.Add((CmsReqCode)rrCode, Mods[i], pP, plen);
+           }
+      } while(1);
+
+// Complain if the batch was not properly formed
+//
+   if (Batch.Bad()) Say.Emsg("do_Notify", Ident, "sent a malformed request.");
+   return 0;
+}
+
 /******************************************************************************/
 /*                               d o _ P i n g                                */
 /******************************************************************************/
@@ -906,6 +1040,9 @@ const char *XrdCmsNode::do_Pong(XrdCmsRRData &Arg)
 // Process: pong
 // Reponds: n/a
 
+// Fold the time it took to answer into the response time
+//
+   RspTime.Answered(msNow());
    return 0;
 }
   
@@ -1275,13 +1412,14 @@ const char *XrdCmsNode::do_State(XrdCmsRRData &Arg)
    EPNAME("do_State")
    struct iovec xmsg[2];
    int rc, noResp = Arg.Request.modifier & CmsStateRequest::kYR_noresp;
+   int misResp = !noResp && Arg.Request.modifier&CmsStateRequest::kYR_misresp;
 
 // Do some debugging
 //
    TRACER(Files,Arg.Path);
 
 // Process: state <path>
-// Respond: have <path>
+// Respond: have <path> or, if asked and the file is not here, gone <path>
 //
    isKnown = 1;
 
@@ -1293,25 +1431,36 @@ const char *XrdCmsNode::do_State(XrdCmsRRData &Arg)
    else if (baseFS.Limit() && Arg.Request.modifier&CmsStateRequest::kYR_metaman)
            {XrdCmsPInfo pinfo;
             pinfo.rovec = NodeMask;
-            if ((rc = baseFS.Exists(Arg,pinfo)) > 0) Arg.Request.modifier = rc;
+            if ((rc = baseFS.Exists(Arg,pinfo,0,NodeID)) > 0)
+               Arg.Request.modifier = rc;
+               else if (rc < 0 && misResp) Arg.Request.modifier = 0;
                else return 0;
            }
    else     if ((rc = baseFS.Exists(Arg.Path, -(Arg.PathLen-1))) > 0)
                 Arg.Request.modifier = rc;
+   else     if (misResp) Arg.Request.modifier = 0;
    else     return 0;
 
-// Respond appropriately
+// Respond appropriately. A manager that asked for a miss response can stop
+// waiting for us once it knows we don't have the file.
 //
    if (Arg.Request.modifier && !noResp)
       {TRACER(Files,Arg.Path <<" responding have!");
-       xmsg[0].iov_base      = (char *)&Arg.Request;
-       xmsg[0].iov_len       = sizeof(Arg.Request);
-       xmsg[1].iov_base      = Arg.Buff;
-       xmsg[1].iov_len       = Arg.Dlen;
        Arg.Request.rrCode    = kYR_have;
        Arg.Request.modifier |= kYR_raw;
-       Link->Send(xmsg, 2);
       }
+   else if (misResp)
+      {TRACER(Files,Arg.Path <<" responding gone!");
+       Arg.Request.rrCode    = kYR_gone;
+       Arg.Request.modifier  = CmsGoneRequest::kYR_miss | kYR_raw;
+      }
+   else return 0;
+
+   xmsg[0].iov_base      = (char *)&Arg.Request;
+   xmsg[0].iov_len       = sizeof(Arg.Request);
+   xmsg[1].iov_base      = Arg.Buff;
+   xmsg[1].iov_len       = Arg.Dlen;
+   Link->Send(xmsg, 2);
    return 0;
 }
   
@@ -1344,7 +1493,14 @@ void XrdCmsNode::do_StateDFS(XrdCmsBaseFR *rP, int rc)
               {Request.rrCode = kYR_state;
                Cluster.Broadsend(rP->Route, Request, rP->Path, rP->PathLen+1);
               }
-          }
+          } else if (rc < 0 && XrdCmsManager::Present()
+                 &&  (rP->Mod & (CmsStateRequest::kYR_misresp
+                               | CmsStateRequest::kYR_noresp))
+                              == CmsStateRequest::kYR_misresp)
+                    {Request.rrCode   = kYR_gone;
+                     Request.modifier = CmsGoneRequest::kYR_miss | kYR_raw;
+                     Notifier.Inform(Request, rP->Path, rP->PathLen+1);
+                    }
        return;
       }
 
@@ -1364,7 +1520,7 @@ void XrdCmsNode::do_StateDFS(XrdCmsBaseFR *rP, int rc)
    if (XrdCmsManager::Present() && isNew
    && !(rP->Mod & CmsStateRequest::kYR_noresp))
       {Request.rrCode   = kYR_have;
-       XrdCmsManager::Inform(Request, rP->Path, rP->PathLen+1);
+       Notifier.Inform(Request, rP->Path, rP->PathLen+1);
       }
 }
   
@@ -1414,7 +1570,7 @@ int XrdCmsNode::do_StateFWD(XrdCmsRRData &Arg)
                Cluster.Broadsend(pinfo.rovec, Arg.Request, Arg.Buff, Arg.Dlen);
                return 0;
               }
-           if ((retc = baseFS.Exists(Arg, pinfo)) <= 0)
+           if ((retc = baseFS.Exists(Arg, pinfo, 0, NodeID)) <= 0)
               {if (retc < 0) Cache.AddFile(Sel, 0);
                return 0;
               }
@@ -1606,6 +1762,7 @@ const char *XrdCmsNode::do_Status(XrdCmsRRData &Arg)
                         }
                     }
        else         {add2Activ =  0; srvMsg = 0;}
+    if (add2Activ || add2Stage) Cluster.Update(this);
 
 // Get the most important message out (advisory isOffline doen't need STMutex)
 //
@@ -1623,6 +1780,32 @@ const char *XrdCmsNode::do_Status(XrdCmsRRData &Arg)
    return 0;
 }
 
+/******************************************************************************/
+/*                            d o _ S u m m a r y                             */
+/******************************************************************************/
+  
+// Summary requests carry a piece of the namespace summary of a data server.
+// They are only meaningful to managers and are never propagated.
+//
+const char *XrdCmsNode::do_Summary(XrdCmsRRData &Arg)
+{
+   static const int hLen = sizeof(CmsSummaryRequest) - sizeof(CmsRRHdr);
+   CmsSummaryRequest Req;
+
+// Process: <id> summary <gen> <offset> <lgbits> <hashes> <flags> <data>
+//
+   if (!Config.asManager() || Arg.Dlen < hLen) return 0;
+   memcpy((char *)&Req + sizeof(CmsRRHdr), Arg.Buff, hLen);
+
+// Pass the piece to the cluster, an unacceptable piece is simply ignored
+//
+   if (!Cluster.Summary(NodeID, ntohl(Req.Gen), Req.lgBits, Req.Hashes,
+                        (Req.Flags & CmsSummaryRequest::kYR_resolve) != 0,
+                        ntohl(Req.Offset), Arg.Buff+hLen, Arg.Dlen-hLen))
+      Say.Emsg("do_Summary", Ident, "sent an unusable namespace summary.");
+   return 0;
+}
+
 /******************************************************************************/
 /*                              d o _ T r u n c                               */
 /******************************************************************************/
@@ -1711,6 +1894,18 @@ const char *XrdCmsNode::do_Usage(XrdCmsRRData &Arg)
    return 0;
 }
 
+/******************************************************************************/
+/*                                 P r o b e                                  */
+/******************************************************************************/
+
+// Only the first of several unanswered requests is timed so that a node that
+// does not keep up is seen as slow as it actually is.
+//
+void XrdCmsNode::Probe()
+{
+   if (!isOffline) RspTime.Sent(msNow());
+}
+
 /******************************************************************************/
 /*                          R e p o r t _ U s a g e                           */
 /******************************************************************************/
@@ -38,6 +38,7 @@
 #include "Xrd/XrdLink.hh"
 #include "XrdCms/XrdCmsTypes.hh"
 #include "XrdCms/XrdCmsRRQ.hh"
+#include "XrdCms/XrdCmsRspTime.hh"
 #include "XrdNet/XrdNetIF.hh"
 #include "XrdNet/XrdNetAddr.hh"
 #include "XrdSys/XrdSysPthread.hh"
@@ -55,6 +56,7 @@ class XrdOucProg;
 class XrdCmsNode
 {
 friend class XrdCmsCluster;
+friend class XrdCmsSelVec;
 public:
        char  *Ident;        // -> role hostname
        char   hasNet;       //0 Network selection mask
@@ -102,6 +104,7 @@ static int    do_LocFmt(char *buff, XrdCmsSelected *sP,
 const  char  *do_Mkdir(XrdCmsRRData &Arg);
 const  char  *do_Mkpath(XrdCmsRRData &Arg);
 const  char  *do_Mv(XrdCmsRRData &Arg);
+const  char  *do_Notify(XrdCmsRRData &Arg);
 const  char  *do_Ping(XrdCmsRRData &Arg);
 const  char  *do_Pong(XrdCmsRRData &Arg);
 const  char  *do_PrepAdd(XrdCmsRRData &Arg);
@@ -117,6 +120,7 @@ static void   do_StateDFS(XrdCmsBaseFR *rP, int rc);
 const  char  *do_StatFS(XrdCmsRRData &Arg);
 const  char  *do_Stats(XrdCmsRRData &Arg);
 const  char  *do_Status(XrdCmsRRData &Arg);
+const  char  *do_Summary(XrdCmsRRData &Arg);
 const  char  *do_Trunc(XrdCmsRRData &Arg);
 const  char  *do_Try(XrdCmsRRData &Arg);
 const  char  *do_Update(XrdCmsRRData &Arg);
@@ -149,8 +153,14 @@ inline char  *Name()   {return (myName ? myName : (char *)"?");}
 
 inline SMask_t Mask() {return NodeMask;}
 
+       void    Probe(); // Call just before sending a ping or usage request
+
 inline void    g2Ref(XrdSysMutex &gMutex) {lkCount++; gMutex.UnLock();}
 
+inline void    gRef()   {lkCount++;} // Global lock must be held
+
+inline void    gUnRef() {lkCount--;} // Global lock must be held
+
 inline void    Ref2g(XrdSysMutex &gMutex) {gMutex.Lock(); lkCount--;}
 
 inline void    g2nLock(XrdSysMutex &gMutex)
@@ -189,11 +199,19 @@ inline void  UnLock() {isLocked = 0;
 
 static void  Report_Usage(XrdLink *lp);
 
+inline bool  canBatch() {return isBatch != 0;}
+
+inline bool  canSummary() {return isSumry != 0;}
+
 inline int   Send(const char *buff, int blen=0)
                  {return (isOffline ? -1 : Link->Send(buff, blen));}
 inline int   Send(const struct iovec *iov, int iovcnt, int iotot=0)
                  {return (isOffline ? -1 : Link->Send(iov, iovcnt, iotot));}
 
+       void  setBatch(bool batch) {isBatch = batch;}
+
+       void  setSummary(bool sumry) {isSumry = sumry;}
+
        void  setManager(XrdCmsManager *mP) {Manager = mP;}
 
        void  setName(XrdLink *lnkp, const char *theIF, int port);
@@ -265,12 +283,16 @@ int                RefW;         // Number of times used for writing
 int                RefTotW;
 int                RefR;         // Number of times used for redirection
 int                RefTotR;
+int                RefSince;     // Number of times used since the last load
+XrdCmsRspTime      RspTime;      // Smoothed ping and usage response time
 short              RSlot;
 char               isLocked;
 char               Share;        // Share of requests for this node (0 -> n/a)
 char               Shrem;        // Share of requests left
 char               Shrip;        // Share of requests to skip
-char               Rsvd[2];
+char               hasLoad;      // Set once the node has reported its load
+char               isBatch;      // Set when the node accepts notify requests
+char               isSumry;      // Set when the node accepts summary requests
 int                Shrin;        // Share intervals used
 
 // The following fields are used to keep the supervisor's free space value
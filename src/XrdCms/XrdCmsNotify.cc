@@ -0,0 +1,301 @@
+/******************************************************************************/
+/*                                                                            */
+/*                       X r d C m s N o t i f y . c c                        */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                        Author: agent <agent@local>                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <errno.h>
+#include <string.h>
+#include <netinet/in.h>
+#include <sys/uio.h>
+
+#include "XrdCms/XrdCmsManager.hh"
+#include "XrdCms/XrdCmsNode.hh"
+#include "XrdCms/XrdCmsNotify.hh"
+#include "XrdCms/XrdCmsTrace.hh"
+
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysTimer.hh"
+
+using namespace XrdCms;
+
+/******************************************************************************/
+/*                        G l o b a l   O b j e c t s                         */
+/******************************************************************************/
+
+XrdCmsNotifier XrdCms::Notifier;
+
+/******************************************************************************/
+/*            E x t e r n a l   T h r e a d   I n t e r f a c e s             */
+/******************************************************************************/
+  
+void *XrdCmsStartNotifier(void *carg)
+     {XrdCmsNotifier *myNote = (XrdCmsNotifier *)carg;
+      return myNote->Start();
+     }
+
+/******************************************************************************/
+/*            X r d C m s N o t i f y   C l a s s   M e t h o d s             */
+/******************************************************************************/
+/******************************************************************************/
+/*                          C o n s t r u c t o r s                           */
+/******************************************************************************/
+  
+XrdCmsNotify::XrdCmsNotify()
+             : bBuff(new char[CmsNotifyRequest::MaxData]), bLen(0), bPos(0),
+               bNum(0), lastLen(0), isBad(false), isMine(true) {}
+
+XrdCmsNotify::XrdCmsNotify(const char *data, int dlen)
+             : bBuff((char *)data), bLen(dlen), bPos(0), bNum(0), lastLen(0),
+               isBad(false), isMine(false) {}
+
+/******************************************************************************/
+/*                                   A d d                                    */
+/******************************************************************************/
+  
+bool XrdCmsNotify::Add(int rrCode, int rrMod, const char *path, int plen)
+{
+   CmsNotifyEntry Ent;
+   int keep = 0, maxk = (plen < lastLen ? plen : lastLen);
+
+// Only keep the part of the path that differs from the previous one
+//
+   if (plen <= 0 || plen > XrdCmsMAX_PATH_LEN) return false;
+   while(keep < maxk && path[keep] == lastPath[keep]) keep++;
+   if (bLen + int(sizeof(Ent)) + plen - keep > CmsNotifyRequest::MaxData)
+      return false;
+
+// Add the entry
+//
+   Ent.rrCode = static_cast<kXR_char>(rrCode);
+   Ent.Mod    = static_cast<kXR_char>(rrMod);
+   Ent.Keep   = htons(static_cast<unsigned short>(keep));
+   Ent.Slen   = htons(static_cast<unsigned short>(plen - keep));
+   memcpy(bBuff+bLen, &Ent, sizeof(Ent)); bLen += sizeof(Ent);
+   memcpy(bBuff+bLen, path+keep, plen-keep); bLen += plen-keep;
+
+// Remember the path to code the next one against it
+//
+   memcpy(lastPath+keep, path+keep, plen-keep);
+   lastLen = plen;
+   bNum++;
+   return true;
+}
+
+/******************************************************************************/
+/*                                  N e x t                                   */
+/******************************************************************************/
+  
+bool XrdCmsNotify::Next(int &rrCode, int &rrMod, const char *&path, int &plen)
+{
+   CmsNotifyEntry Ent;
+   int keep, slen;
+
+// Check if we are at the end of the batch
+//
+   if (bPos >= bLen || isBad) return false;
+   if (bLen - bPos < int(sizeof(Ent))) {isBad = true; return false;}
+
+// Get the entry and make sure it is sensible
+//
+   memcpy(&Ent, bBuff+bPos, sizeof(Ent)); bPos += sizeof(Ent);
+   keep = ntohs(Ent.Keep); slen = ntohs(Ent.Slen);
+   if (keep > lastLen || keep+slen <= 0 || keep+slen > XrdCmsMAX_PATH_LEN
+   ||  slen > bLen - bPos) {isBad = true; return false;}
+
+// Reconstruct the path
+//
+   memcpy(lastPath+keep, bBuff+bPos, slen); bPos += slen;
+   lastLen = keep+slen; lastPath[lastLen] = '\0';
+   rrCode = Ent.rrCode; rrMod = Ent.Mod;
+   path   = lastPath;   plen  = lastLen;
+   bNum++;
+   return true;
+}
+
+/******************************************************************************/
+/*          X r d C m s N o t i f i e r   C l a s s   M e t h o d s           */
+/******************************************************************************/
+/******************************************************************************/
+/*                                   A d d                                    */
+/******************************************************************************/
+  
+void XrdCmsNotifier::Add(XrdCms::CmsReqCode rrCode, int rrMod,
+                         const char *path, int plen)
+{
+
+// If we are not batching, send the request right away
+//
+   if (!msWait)
+      {XrdCmsManager::Inform(rrCode, rrMod | kYR_raw, path, plen+1);
+       return;
+      }
+
+// Add the request to the batch. If the batch is full send it and start a new
+// one. A path that cannot be batched at all is sent by itself.
+//
+   myMutex.Lock();
+   if (!Batch->Add(rrCode, rrMod, path, plen))
+      {if (Batch->Count()) {Send(); myMutex.Lock();}
+       if (!Batch->Add(rrCode, rrMod, path, plen))
+          {sendMutex.Lock();
+           myMutex.UnLock();
+           XrdCmsManager::Inform(rrCode, rrMod | kYR_raw, path, plen+1);
+           sendMutex.UnLock();
+           return;
+          }
+      }
+
+// Make sure the batch will be sent in time
+//
+   if (isIdle) {isIdle = false; mySem.Post();}
+   myMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                                I n f o r m                                 */
+/******************************************************************************/
+  
+void XrdCmsNotifier::Inform(XrdCms::CmsRRHdr &Hdr, const char *path, int plen)
+{
+
+// If we are not batching, there is nothing to keep in order
+//
+   if (!msWait)
+      {XrdCmsManager::Inform(Hdr, path, plen);
+       return;
+      }
+
+// Flush the batch and send the request before any batch that follows it
+//
+   myMutex.Lock();
+   if (Batch->Count()) Send(true);
+      else {sendMutex.Lock(); myMutex.UnLock();}
+   XrdCmsManager::Inform(Hdr, path, plen);
+   sendMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+  
+bool XrdCmsNotifier::Init(int msDelay)
+{
+   pthread_t tid;
+
+// Start the thread that sends batches
+//
+   if (msDelay <= 0) return true;
+   Batch = new XrdCmsNotify;
+   msWait = msDelay;
+   if (XrdSysThread::Run(&tid, XrdCmsStartNotifier, (void *)this,
+                         0, "Notifier"))
+      {Say.Emsg("Notifier", errno, "start notifier");
+       msWait = 0;
+       return false;
+      }
+   return true;
+}
+
+/******************************************************************************/
+/* Private:                         S e n d                                   */
+/******************************************************************************/
+
+// Send() must be called with myMutex held and returns with it released. When
+// keepOrder is true it also returns with sendMutex held so that the caller can
+// send something before the next batch.
+  
+void XrdCmsNotifier::Send(bool keepOrder)
+{
+   XrdCmsNotify *bP = Batch;
+   const char *path;
+   int rrCode, rrMod, plen;
+
+// Start a new batch. Lock the send mutex before releasing the batch one so
+// batches are sent in the order they were built.
+//
+   Batch = new XrdCmsNotify;
+   sendMutex.Lock();
+   myMutex.UnLock();
+
+// A single request is simply sent as is, otherwise send the batch
+//
+   if (bP->Count() == 1)
+      {XrdCmsNotify oneReq(bP->Data(), bP->Size());
+       if (oneReq.Next(rrCode, rrMod, path, plen))
+          XrdCmsManager::Inform(static_cast<CmsReqCode>(rrCode),
+                                rrMod | kYR_raw, path, plen+1);
+      } else XrdCmsManager::Notify(bP->Data(), bP->Size());
+
+// All done
+//
+   if (!keepOrder) sendMutex.UnLock();
+   delete bP;
+}
+
+/******************************************************************************/
+/*                                 S t a r t                                  */
+/******************************************************************************/
+  
+void *XrdCmsNotifier::Start()
+{
+
+// Each time a batch is started wait out the delay and then send it unless it
+// was already sent because it filled up.
+//
+do{mySem.Wait();
+   XrdSysTimer::Wait(msWait);
+   myMutex.Lock();
+   isIdle = true;
+   if (Batch->Count()) Send();
+      else myMutex.UnLock();
+  } while(1);
+
+   return (void *)0;
+}
+
+/******************************************************************************/
+/*                               U n b a t c h                                */
+/******************************************************************************/
+  
+void XrdCmsNotifier::Unbatch(XrdCmsNode *nP, const char *data, int dlen)
+{
+   XrdCmsNotify theBatch(data, dlen);
+   CmsRRHdr     Hdr = {0, 0, 0, 0};
+   struct iovec ioV[2] = {{(char *)&Hdr, sizeof(Hdr)}, {0, 0}};
+   const char  *path;
+   int          rrCode, rrMod, plen;
+
+// Send each request in the batch by itself
+//
+   while(theBatch.Next(rrCode, rrMod, path, plen))
+        {Hdr.rrCode   = static_cast<kXR_char>(rrCode);
+         Hdr.modifier = static_cast<kXR_char>(rrMod | kYR_raw);
+         Hdr.datalen  = htons(static_cast<unsigned short>(plen+1));
+         ioV[1].iov_base = (char *)path; ioV[1].iov_len = plen+1;
+         nP->Send(ioV, 2, sizeof(Hdr)+plen+1);
+        }
+}
@@ -0,0 +1,135 @@
+#ifndef __XRDCMSNOTIFY_HH__
+#define __XRDCMSNOTIFY_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                       X r d C m s N o t i f y . h h                        */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                        Author: agent <agent@local>                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "XProtocol/YProtocol.hh"
+#include "XrdCms/XrdCmsTypes.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdCmsNode;
+
+/******************************************************************************/
+/*                    C l a s s   X r d C m s N o t i f y                     */
+/******************************************************************************/
+
+// The XrdCmsNotify object encodes or decodes the body of a notify request, a
+// batch of have and gone requests with front coded paths (see YProtocol.hh).
+//
+class XrdCmsNotify
+{
+public:
+
+// Add() appends a request to the batch. It returns false if it does not fit.
+//
+bool         Add(int rrCode, int rrMod, const char *path, int plen);
+
+// Next() returns the next request in the batch being decoded. The path is null
+//        terminated and remains valid until the next call. False is returned
+//        at the end of the batch or if the batch is malformed (see Bad()).
+//
+bool         Next(int &rrCode, int &rrMod, const char *&path, int &plen);
+
+inline bool  Bad()   {return isBad;}
+inline int   Count() {return bNum;}
+inline
+const char  *Data()  {return bBuff;}
+inline int   Size()  {return bLen;}
+
+             XrdCmsNotify();                             // To encode
+             XrdCmsNotify(const char *data, int dlen);   // To decode
+            ~XrdCmsNotify() {if (isMine) delete [] bBuff;}
+
+private:
+
+char        *bBuff;
+int          bLen;
+int          bPos;
+int          bNum;
+int          lastLen;
+bool         isBad;
+bool         isMine;
+char         lastPath[XrdCmsMAX_PATH_LEN+1];
+};
+
+/******************************************************************************/
+/*                  C l a s s   X r d C m s N o t i f i e r                   */
+/******************************************************************************/
+
+// The XrdCmsNotifier sends the have and gone requests that a node originates
+// or propagates to its managers. When a batch delay is configured requests are
+// held for at most that long and sent as one notify request to managers that
+// accept it; others are sent the individual requests.
+//
+class XrdCmsNotifier
+{
+public:
+
+// Add() sends a request or adds it to the batch being built.
+//
+void   Add(XrdCms::CmsReqCode rrCode, int rrMod, const char *path, int plen);
+
+// Inform() sends a have or gone request right away, after whatever is being
+//          batched so that our managers see the requests in order.
+//
+void   Inform(XrdCms::CmsRRHdr &Hdr, const char *path, int plen);
+
+// Init() starts batching with the given delay in milliseconds. Until it is
+//        called requests are sent as they are added. It returns true on
+//        success.
+//
+bool   Init(int msDelay);
+
+void  *Start();
+
+// Unbatch() sends each request in a batch to a node that does not accept
+//           notify requests.
+//
+static void Unbatch(XrdCmsNode *nP, const char *data, int dlen);
+
+       XrdCmsNotifier() : mySem(0), Batch(0), msWait(0), isIdle(true) {}
+      ~XrdCmsNotifier() {}   // Never gets deleted
+
+private:
+
+void   Send(bool keepOrder=false);
+
+XrdSysMutex      myMutex;     // Protects Batch and isIdle
+XrdSysMutex      sendMutex;   // Keeps batches in order as they are sent
+XrdSysSemaphore  mySem;
+XrdCmsNotify    *Batch;
+int              msWait;
+bool             isIdle;
+};
+
+namespace XrdCms
+{
+extern    XrdCmsNotifier Notifier;
+}
+#endif
@@ -60,6 +60,7 @@
 #include "XrdCms/XrdCmsRouting.hh"
 #include "XrdCms/XrdCmsRTable.hh"
 #include "XrdCms/XrdCmsState.hh"
+#include "XrdCms/XrdCmsSummary.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 
 #include "XrdOuc/XrdOucCRC.hh"
@@ -390,6 +391,9 @@ void XrdCmsProtocol::Pander(const char *manager, int mport)
                    Say.Emsg("Protocol", "Logged into", sname, Link->Name());
                    if (Data.SID)
                       Manager->Verify(Link, (const char *)Data.SID, sname);
+                   myNode->setBatch((Data.Mode & CmsLoginData::kYR_batch) != 0);
+                   myNode->setSummary((Data.Mode & CmsLoginData::kYR_namesum)!=0);
+                   Summarizer.Resend();
                    Reason = Dispatch(isUp, TimeOut, 2);
                    rc = 0;
                    loginData.fSpace= Meter.FreeSpace(fsUtil);
@@ -468,6 +472,7 @@ int XrdCmsProtocol::Process(XrdLink *lp)
        myNode->UnLock();
        if ((Reason = Dispatch(myWay, tOut, 2))) lp->setEtext(Reason);
        Cluster.SLock(true); myNode->isOffline = 1; Cluster.SLock(false);
+       Cluster.Update(myNode);
       }
 
 // Serialize all activity on the link before we proceed. This makes sure that
@@ -571,9 +576,10 @@ XrdCmsRouting *XrdCmsProtocol::Admit()
        envP = envBuff;
       }
 
-// Establish outgoing mode
+// Establish outgoing mode. We always accept batched have and gone requests
+// as well as namespace summaries.
 //
-   Data.Mode = 0;
+   Data.Mode = CmsLoginData::kYR_batch | CmsLoginData::kYR_namesum;
    if (Trace.What & TRACE_Debug) Data.Mode |= CmsLoginData::kYR_debug;
    if (CmsState.Suspended)      {Data.Mode |= CmsLoginData::kYR_suspend;
                                  wasSuspended = 1;
@@ -588,7 +594,8 @@ XrdCmsRouting *XrdCmsProtocol::Admit()
 //
    if (Data.Mode & CmsLoginData::kYR_director) 
       {Link->setID("redirector", Data.HoldTime);
-       return Admit_Redirector(wasSuspended);
+       return Admit_Redirector(wasSuspended,
+                               (Data.Mode & CmsLoginData::kYR_rdrcache) != 0);
       }
 
 // Disallow subscriptions we are are configured as a solo manager
@@ -722,6 +729,7 @@ XrdCmsRouting *XrdCmsProtocol::Admit()
    Cluster.ResetRef(servset);
    if (Config.asManager()) {Manager->Reset(); myNode->SyncSpace();}
    myNode->isBad &= ~XrdCmsNode::isDisabled;
+   Cluster.Update(myNode);
 
 // At this point we can switch to nonblocking sendq for this node
 //
@@ -750,7 +758,8 @@ XrdCmsRouting *XrdCmsProtocol::Admit()
 /*                      A d m i t _ R e d i r e c t o r                       */
 /******************************************************************************/
   
-XrdCmsRouting *XrdCmsProtocol::Admit_Redirector(int wasSuspended)
+XrdCmsRouting *XrdCmsProtocol::Admit_Redirector(int wasSuspended,
+                                                bool rdrCache)
 {
    EPNAME("Admit_Redirector");
    static CmsStatusRequest newState 
@@ -764,7 +773,7 @@ XrdCmsRouting *XrdCmsProtocol::Admit_Redirector(int wasSuspended)
 // locked to be consistent with the way server/suprvisors nodes are returned.
 //
    myNode = new XrdCmsNode(Link); myNode->Lock(false);
-   if (!(RSlot = RTable.Add(myNode)))
+   if (!(RSlot = RTable.Add(myNode, rdrCache)))
       {myNode->UnLock();
        delete myNode;
        myNode = 0;
@@ -1160,6 +1169,7 @@ bool XrdCmsProtocol::SendPing()
 
 // Send the ping
 //
+   myNode->Probe();
    if (Link->Send((char *)&Ping, sizeof(Ping)) < 0) return false;
    return true;
 }
@@ -54,6 +54,8 @@ using namespace XrdCms;
   
 XrdCmsRRQ             XrdCms::RRQ;
 
+const char            XrdCmsRRQ::nakrMsg[] = "No servers have the file";
+
 XrdSysMutex           XrdCmsRRQSlot::myMutex;
 XrdCmsRRQSlot        *XrdCmsRRQSlot::freeSlot = 0;
 short                 XrdCmsRRQSlot::initSlot = 0;
@@ -169,6 +171,26 @@ int XrdCmsRRQ::Init(int Tint, int Tdly)
    waitResp.Hdr.datalen  = htons(static_cast<unsigned short>(sizeof(waitResp.Val)));
    waitResp.Val          = htonl(Tdelay);
 
+// Fill out the response used when all queried nodes said they do not have
+// the file. Locates get a definitive error and the i/o vector for it.
+//
+   nakrResp.Hdr.streamid = 0;
+   nakrResp.Hdr.rrCode   = kYR_error;
+   nakrResp.Hdr.modifier = 0;
+   nakrResp.Hdr.datalen  = htons(static_cast<unsigned short>
+                                 (sizeof(nakrResp.Val) + sizeof(nakrMsg)));
+   nakrResp.Val          = htonl(kYR_ENOENT);
+   nakr_iov[0].iov_base  = (char *)&nakrResp;
+   nakr_iov[0].iov_len   = sizeof(nakrResp);
+   nakr_iov[1].iov_base  = (char *)nakrMsg;
+   nakr_iov[1].iov_len   = sizeof(nakrMsg);
+
+// Selects are asked to retry after the shortest possible wait as the retry will
+// be resolved from the cache (a zero wait is not a wait to the redirector).
+//
+   missResp = waitResp;
+   missResp.Val          = htonl(1);
+
 // Start the responder thread
 //
    if ((rc = XrdSysThread::Run(&tid, XrdCmsRRQ_StartRespond, (void *)0,
@@ -234,6 +256,37 @@ int XrdCmsRRQ::Ready(int Snum, const void *Key, SMask_t mask1, SMask_t mask2)
    return 1;
 }
 
+/******************************************************************************/
+/*                               R e s o l v e                                */
+/******************************************************************************/
+
+// Called when every queried node has responded. The slot is readied whether
+// or not the minimum number of responders was reached; if no node has the
+// file the responder sends a definitive answer instead of a full delay.
+  
+int XrdCmsRRQ::Resolve(int Snum, const void *Key)
+{
+   XrdCmsRRQSlot *sp;
+
+// Check if it's the right slot and it is still queued.
+//
+   myMutex.Lock();
+   sp = &Slot[Snum];
+   if (sp->Info.Key != Key || !sp->Expire)
+      {myMutex.UnLock();
+       return 1;
+      }
+
+// Move the element from the waiting queue to the ready queue
+//
+   sp->Resolved = 1;
+   sp->Link.Remove();
+   if (readyQ.Singleton()) isReady.Post();
+   readyQ.Prev()->Insert(&sp->Link);
+   myMutex.UnLock();
+   return 1;
+}
+
 /******************************************************************************/
 /*                               R e s p o n d                                */
 /******************************************************************************/
@@ -258,13 +311,14 @@ void *XrdCmsRRQ::Respond()
     //
        if (sp->Info.isLU)
           {if (sp->Cont)
-              {sp->Cont->Arg1 = sp->Arg1;
+              {sp->Cont->Arg1 = sp->Arg1; sp->Cont->Resolved = sp->Resolved;
                sendRedResp(sp->Cont);
               }
            sendLocResp(sp);
           } else {
            if (sp->LkUp)
               {sp->LkUp->Arg1 = sp->Arg1; sp->LkUp->Arg2 = sp->Arg2;
+               sp->LkUp->Resolved = sp->Resolved;
                sendLocResp(sp->LkUp);
               }
            sendRedResp(sp);
@@ -291,10 +345,12 @@ void XrdCmsRRQ::sendLocResp(XrdCmsRRQSlot *lP)
    int bytes;
    bool oksel;
 
-// Send a delay if we timed out
+// Send a delay if we timed out or an error if every node said it does not
+// have the file.
 //
    if (!(lP->Arg1))
-      {sendLwtResp(lP);
+      {if (lP->Resolved) sendNakResp(lP);
+          else sendLwtResp(lP);
        return;
       }
 
@@ -329,6 +385,26 @@ void XrdCmsRRQ::sendLocResp(XrdCmsRRQSlot *lP)
    RTable.UnLock();
 }
 
+/******************************************************************************/
+/*                           s e n d N a k R e s p                            */
+/******************************************************************************/
+  
+void XrdCmsRRQ::sendNakResp(XrdCmsRRQSlot *rP)
+{
+   static const int bytes = sizeof(nakrResp) + sizeof(nakrMsg);
+   XrdCmsNode *nP;
+
+// For each request, find the redirector and tell it the file does not exist
+//
+   RTable.Lock();
+do{if ((nP = RTable.Find(rP->Info.Rnum, rP->Info.Rinst)))
+      {nakrResp.Hdr.streamid = rP->Info.ID; luFast++;
+       nP->Send(nakr_iov, iov_cnt, bytes);
+      }
+  } while((rP = rP->LkUp));
+   RTable.UnLock();
+}
+
 /******************************************************************************/
 /*                           s e n d L w t R e s p                            */
 /******************************************************************************/
@@ -360,6 +436,7 @@ void XrdCmsRRQ::sendRedResp(XrdCmsRRQSlot *rP)
 // EPNAME("sendRedResp");
    static const int ovhd = sizeof(kXR_unt32);
    XrdCmsNode *nP;
+   XrdCms::CmsResponse *wP = (rP->Resolved ? &missResp : &waitResp);
    int doredir, port, hlen = 0;
 
 // Determine where the client should be redirected
@@ -381,8 +458,8 @@ do{if ((nP = RTable.Find(rP->Info.Rnum, rP->Info.Rinst)))
                     nP->Send(redr_iov, iov_cnt, hlen);
 //                  DEBUG("Fast redirect " <<nP->Name() <<" -> " <<hostbuff);
                    }
-              else {waitResp.Hdr.streamid = rP->Info.ID; rdSlow++;
-                    nP->Send((char *)&waitResp, sizeof(waitResp));
+              else {wP->Hdr.streamid = rP->Info.ID; rdSlow++;
+                    nP->Send((char *)wP, sizeof(*wP));
 //                  DEBUG("Redirect delay " <<nP->Name() <<' ' <<Tdelay);
                    }
       } 
@@ -446,6 +523,7 @@ XrdCmsRRQSlot::XrdCmsRRQSlot() : Link(this)
        freeSlot = this;
       } else Cont = 0;
    Arg1 = Arg2 = 0;
+   Resolved = 0;
    Info.Key = 0;
 }
 
@@ -465,6 +543,7 @@ XrdCmsRRQSlot *XrdCmsRRQSlot::Alloc(XrdCmsRRQInfo *theInfo)
        sp->LkUp = 0;
        sp->Arg1 = 0;
        sp->Arg2 = 0;
+       sp->Resolved = 0;
       }
    myMutex.UnLock();
    return sp;
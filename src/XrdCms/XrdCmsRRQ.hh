@@ -94,6 +94,7 @@ static   short                       initSlot;
          SMask_t                     Arg1;
          SMask_t                     Arg2;
 unsigned int                         Expire;
+         char                        Resolved; // All queried nodes responded
          int                         slotNum;
 };
 
@@ -113,6 +114,8 @@ int   Init(int Tint=0, int Tdly=0);
 
 int   Ready(int Snum, const void *Key, SMask_t mask1, SMask_t mask2);
 
+int   Resolve(int Snum, const void *Key);
+
 void *Respond();
 
 struct Info
@@ -154,6 +157,7 @@ private:
 
 void sendLocResp(XrdCmsRRQSlot *lP);
 void sendLwtResp(XrdCmsRRQSlot *rP);
+void sendNakResp(XrdCmsRRQSlot *rP);
 void sendRedResp(XrdCmsRRQSlot *rP);
 static const int numSlots = 1024;
 
@@ -166,9 +170,13 @@ static const int numSlots = 1024;
 static   const int                     iov_cnt = 2;
          struct iovec                  data_iov[iov_cnt];
          struct iovec                  redr_iov[iov_cnt];
+         struct iovec                  nakr_iov[iov_cnt];
+static   const char                    nakrMsg[];
          XrdCms::CmsResponse           dataResp;
          XrdCms::CmsResponse           redrResp;
          XrdCms::CmsResponse           waitResp;
+         XrdCms::CmsResponse           nakrResp;  // Locate: no server has it
+         XrdCms::CmsResponse           missResp;  // Select: retry right away
 union   {char                          hostbuff[288];
          char                          databuff[XrdCms::CmsLocateRequest::RHLen
                                                *STMax];
@@ -43,7 +43,7 @@ XrdCmsRTable XrdCms::RTable;
 /*                                   A d d                                    */
 /******************************************************************************/
   
-short XrdCmsRTable::Add(XrdCmsNode *nP)
+short XrdCmsRTable::Add(XrdCmsNode *nP, bool rdrCache)
 {
    int i;
 
@@ -56,6 +56,7 @@ short XrdCmsRTable::Add(XrdCmsNode *nP)
 //
    if (i >= maxRD) i = 0;
       else {Rtable[i] = nP;
+            if ((Rcache[i] = rdrCache)) Cached++;
             if (i > Hwm) Hwm = i;
            }
 
@@ -82,6 +83,7 @@ void XrdCmsRTable::Del(XrdCmsNode *nP)
 //
    if (i <= Hwm)
       {Rtable[i] = 0;
+       if (Rcache[i]) {Rcache[i] = false; Cached--;}
        if (i == Hwm) {while(--i) if (Rtable[i]) break; Hwm = i;}
       }
 
@@ -108,6 +110,38 @@ XrdCmsNode *XrdCmsRTable::Find(short Num, int Inst)
    return (XrdCmsNode *)0;
 }
 
+/******************************************************************************/
+/*                                I n f o r m                                 */
+/******************************************************************************/
+  
+void XrdCmsRTable::Inform(const char *What, XrdCms::CmsRRHdr &Hdr,
+                          char *data, int dlen)
+{
+   EPNAME("Inform");
+   XrdCms::CmsRRHdr myHdr = Hdr;
+   struct iovec ioV[2] = {{(char *)&myHdr, sizeof(myHdr)}, {data, (size_t)dlen}};
+   int i;
+
+// Most of the time no redirector wants to know
+//
+   if (!Cached) return;
+
+// The request is sent as is except that it is not a response to anything
+//
+   myHdr.streamid  = 0;
+   myHdr.modifier &= XrdCms::kYR_raw;
+
+// Send the request to all redirectors that cache redirects
+//
+   myMutex.Lock();
+   for (i = 1; i <= Hwm; i++)
+       if (Rtable[i] && Rcache[i])
+          {DEBUG(What <<" to " <<Rtable[i]->Ident);
+           Rtable[i]->Send(ioV, 2, sizeof(myHdr)+dlen);
+          }
+   myMutex.UnLock();
+}
+
 /******************************************************************************/
 /*                                  S e n d                                   */
 /******************************************************************************/
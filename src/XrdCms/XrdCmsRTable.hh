@@ -32,6 +32,7 @@
 
 #include <string.h>
 
+#include "XProtocol/YProtocol.hh"
 #include "XrdCms/XrdCmsNode.hh"
 #include "XrdCms/XrdCmsTypes.hh"
 #include "XrdSys/XrdSysPthread.hh"
@@ -40,19 +41,27 @@ class XrdCmsRTable
 {
 public:
 
-short         Add(XrdCmsNode *nP);
+short         Add(XrdCmsNode *nP, bool rdrCache=false);
 
 void          Del(XrdCmsNode *nP);
 
 XrdCmsNode   *Find(short Num, int Inst);
 
+// Inform() sends a have or gone request to the redirectors that cache redirects
+//
+void          Inform(const char *What, XrdCms::CmsRRHdr &Hdr,
+                     char *data, int dlen);
+
 void          Send(const char *What, const char *data, int dlen);
 
 void          Lock() {myMutex.Lock();}
 
 void          UnLock() {myMutex.UnLock();}
 
-              XrdCmsRTable() {memset(Rtable, 0, sizeof(Rtable)); Hwm = -1;}
+              XrdCmsRTable() {memset(Rtable, 0, sizeof(Rtable));
+                              memset(Rcache, 0, sizeof(Rcache));
+                              Hwm = -1; Cached = 0;
+                             }
 
              ~XrdCmsRTable() {}
 
@@ -60,7 +69,9 @@ private:
 
 XrdSysMutex   myMutex;
 XrdCmsNode   *Rtable[maxRD];
+bool          Rcache[maxRD];  // Redirector in this slot caches redirects
 int           Hwm;
+int           Cached;         // Number of redirectors that cache redirects
 };
 
 namespace XrdCms
@@ -0,0 +1,155 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d C m s R d r C a c h e . c c                      */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                        Author: agent <agent@local>                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "XrdCms/XrdCmsRdrCache.hh"
+#include "XrdOuc/XrdOucErrInfo.hh"
+
+/******************************************************************************/
+/*                      L o c a l   S t r u c t u r e s                       */
+/******************************************************************************/
+
+// Each path has a short list of redirects, one per set of select options.
+// Deleting the first one deletes the whole list.
+//
+struct XrdCmsRdrCache::RdrEnt
+{
+RdrEnt *next;
+char   *host;
+time_t  expires;
+int     opts;
+int     port;
+
+        RdrEnt(RdrEnt *np, const char *hp, int op, int pt, time_t et)
+              : next(np), host(strdup(hp)), expires(et), opts(op), port(pt) {}
+       ~RdrEnt() {free(host); if (next) delete next;}
+};
+
+/******************************************************************************/
+/*                       L o c a l   F u n c t i o n s                        */
+/******************************************************************************/
+
+namespace
+{
+// Remove a path whose redirects have all expired (used via Apply)
+//
+int Expired(const char *path, XrdCmsRdrCache::RdrEnt *rP, void *arg)
+{
+   time_t now = *static_cast<time_t *>(arg);
+
+   for (; rP; rP = rP->next) if (rP->expires > now) return 0;
+   return -1;
+}
+}
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdCmsRdrCache::XrdCmsRdrCache(int ttl, int maxpaths)
+              : rdrTTL(ttl), rdrMax(maxpaths)
+{
+}
+
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
+
+XrdCmsRdrCache::~XrdCmsRdrCache()
+{
+}
+
+/******************************************************************************/
+/*                                   A d d                                    */
+/******************************************************************************/
+  
+void XrdCmsRdrCache::Add(const char *path, int opts, const char *host, int port)
+{
+   XrdSysMutexHelper rdrMon(rdrMutex);
+   RdrEnt *hP, *rP;
+   time_t  now = time(0);
+
+// Make room if we have too many paths. Expired ones go first and if that is
+// not enough, everything goes.
+//
+   if (rdrTab.Num() >= rdrMax)
+      {rdrTab.Apply(Expired, (void *)&now);
+       if (rdrTab.Num() >= rdrMax) rdrTab.Purge();
+      }
+
+// Add the path if it is new
+//
+   if (!(hP = rdrTab.Find(path)))
+      {rdrTab.Add(path, new RdrEnt(0, host, opts, port, now+rdrTTL));
+       return;
+      }
+
+// Replace the redirect for these options or add one
+//
+   for (rP = hP; rP; rP = rP->next) if (rP->opts == opts) break;
+   if (!rP) hP->next = new RdrEnt(hP->next, host, opts, port, now+rdrTTL);
+      else {if (strcmp(rP->host, host)) {free(rP->host); rP->host = strdup(host);}
+            rP->port = port; rP->expires = now+rdrTTL;
+           }
+}
+
+/******************************************************************************/
+/*                                   D e l                                    */
+/******************************************************************************/
+  
+void XrdCmsRdrCache::Del(const char *path)
+{
+   XrdSysMutexHelper rdrMon(rdrMutex);
+
+   rdrTab.Del(path);
+}
+
+/******************************************************************************/
+/*                                  F i n d                                   */
+/******************************************************************************/
+  
+bool XrdCmsRdrCache::Find(const char *path, int opts, XrdOucErrInfo &Resp)
+{
+   XrdSysMutexHelper rdrMon(rdrMutex);
+   RdrEnt *rP;
+
+// Find the redirect for these options, it must not have expired
+//
+   if (!(rP = rdrTab.Find(path))) return false;
+   while(rP && rP->opts != opts) rP = rP->next;
+   if (!rP || rP->expires <= time(0)) return false;
+
+// Return it
+//
+   Resp.setErrInfo(rP->port, rP->host);
+   return true;
+}
@@ -0,0 +1,78 @@
+#ifndef __XRDCMSRDRCACHE_HH__
+#define __XRDCMSRDRCACHE_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d C m s R d r C a c h e . h h                      */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                        Author: agent <agent@local>                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <time.h>
+
+#include "XrdOuc/XrdOucHash.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdOucErrInfo;
+
+/******************************************************************************/
+/*                  C l a s s   X r d C m s R d r C a c h e                   */
+/******************************************************************************/
+
+// The XrdCmsRdrCache object remembers, for a short time, where the manager
+// redirected an open of a path with a particular set of select options so that
+// the same open by other clients need not be sent to the manager. The manager
+// tells us when a path is added to or removed from a server and we then forget
+// everything about it. A redirect that is acted on before that news arrives
+// costs the client a retry, which never uses the cache.
+
+class XrdCmsRdrCache
+{
+public:
+
+// Add() remembers that opening path with opts is redirected to host:port.
+//
+void  Add(const char *path, int opts, const char *host, int port);
+
+// Del() forgets everything about path.
+//
+void  Del(const char *path);
+
+// Find() returns true and sets Resp to the redirect if one is remembered.
+//
+bool  Find(const char *path, int opts, XrdOucErrInfo &Resp);
+
+      XrdCmsRdrCache(int ttl, int maxpaths);
+     ~XrdCmsRdrCache();
+
+struct RdrEnt;
+
+private:
+
+XrdSysMutex         rdrMutex;
+XrdOucHash<RdrEnt>  rdrTab;
+int                 rdrTTL;
+int                 rdrMax;
+};
+#endif
@@ -63,11 +63,13 @@ XrdCmsRouter::theRoute initRouter[] =
        {kYR_gone,    "gone",   &XrdCmsNode::do_Gone},
        {kYR_have,    "have",   &XrdCmsNode::do_Have},
        {kYR_load,    "load",   &XrdCmsNode::do_Load},
+       {kYR_notify,  "notify", &XrdCmsNode::do_Notify},
        {kYR_ping,    "ping",   &XrdCmsNode::do_Ping},
        {kYR_pong,    "pong",   &XrdCmsNode::do_Pong},
        {kYR_space,   "space",  &XrdCmsNode::do_Space},
        {kYR_state,   "state",  &XrdCmsNode::do_State},
        {kYR_status,  "status", &XrdCmsNode::do_Status},
+       {kYR_summary, "summary",&XrdCmsNode::do_Summary},
        {kYR_try,     "try",    &XrdCmsNode::do_Try},
        {kYR_update,  "update", &XrdCmsNode::do_Update},
        {kYR_usage,   "usage",  &XrdCmsNode::do_Usage},
@@ -157,8 +159,10 @@ XrdCmsRouting::theRouting initRSProuting[] =
       {kYR_gone,    XrdCmsRouting::isSync},
       {kYR_have,    XrdCmsRouting::AsyncQ0},
       {kYR_load,    XrdCmsRouting::isSync},
+      {kYR_notify,  XrdCmsRouting::isSync},
       {kYR_pong,    XrdCmsRouting::isSync | XrdCmsRouting::noArgs},
       {kYR_status,  XrdCmsRouting::isSync | XrdCmsRouting::noArgs},
+      {kYR_summary, XrdCmsRouting::isSync},
       {0,           0}};
 }
 
@@ -0,0 +1,77 @@
+#ifndef __XRDCMSRSPTIME_HH__
+#define __XRDCMSRSPTIME_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d C m s R s p T i m e . h h                        */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                        Author: agent <agent@local>                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+/******************************************************************************/
+/*                         X r d C m s R s p T i m e                          */
+/******************************************************************************/
+
+// Keeps the smoothed time a node takes to answer a ping or usage request. The
+// caller supplies the time in milliseconds on a monotonic clock.
+//
+class XrdCmsRspTime
+{
+public:
+
+// Answered() is called when the reply to a ping or usage request arrives. The
+//            time it took is folded into the response time. A node that takes
+//            more than a second is simply slow; we don't want one stall to
+//            dominate. The average is kept in sixteenths of a millisecond; in
+//            whole milliseconds the truncation would keep it up to 3ms below
+//            the actual response time.
+//
+inline void Answered(long long now)
+                    {long long rsp, sent = rspSent;
+                     if (sent)
+                        {rspSent = 0;
+                         if ((rsp = now - sent) > 1000) rsp = 1000;
+                         rspTime = (rspTime*3 + static_cast<int>(rsp)*16)/4;
+                        }
+                    }
+
+// Sent() is called just before sending a ping or usage request. Only the first
+//        of several unanswered requests is timed so that a node that does not
+//        keep up is seen as slow as it actually is.
+//
+inline void Sent(long long now) {if (!rspSent) rspSent = now;}
+
+// Time() returns the smoothed response time in ms/16.
+//
+inline int  Time() {return rspTime;}
+
+            XrdCmsRspTime() : rspSent(0), rspTime(0) {}
+           ~XrdCmsRspTime() {}
+
+private:
+
+long long   rspSent;     // When the unanswered request was sent (0 if none)
+int         rspTime;     // Smoothed response time in ms/16
+};
+#endif
@@ -0,0 +1,246 @@
+#ifndef __XRDCMSSMASK_HH__
+#define __XRDCMSSMASK_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d C m s S M a s k . h h                         */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                        Author: agent <agent@local>                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <iomanip>
+#include <ostream>
+
+/******************************************************************************/
+/*                       B i t   P r i m i t i v e s                          */
+/******************************************************************************/
+
+// These work on a single 64-bit word and use the compiler builtins, which map
+// to a single instruction where the target has one.
+//
+inline int XrdCmsBitCount(unsigned long long w)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   return __builtin_popcountll(w);
+#else
+   int n = 0;
+   while(w) {w &= (w - 1); n++;}
+   return n;
+#endif
+}
+
+inline int XrdCmsBitFirst(unsigned long long w) // w must not be zero
+{
+#if defined(__GNUC__) || defined(__clang__)
+   return __builtin_ctzll(w);
+#else
+   int n = 0;
+   while(!(w & 1ULL)) {w >>= 1; n++;}
+   return n;
+#endif
+}
+
+/******************************************************************************/
+/*                     S c a l a r   S e r v e r   M a s k                    */
+/******************************************************************************/
+
+// The following are the mask operations used by the node selection code. They
+// are defined for the default 64-bit mask and for the wide mask below so that
+// the callers need not care which one is compiled in.
+//
+inline int  XrdCmsSMaskCount(unsigned long long m) {return XrdCmsBitCount(m);}
+
+// Return the number of the lowest node in the mask or -1 if it is empty.
+//
+inline int  XrdCmsSMaskFirst(unsigned long long m)
+                            {return (m ? XrdCmsBitFirst(m) : -1);}
+
+// Return the number of the lowest node in the mask above node 'n' or -1.
+//
+inline int  XrdCmsSMaskNext(unsigned long long m, int n)
+{
+   if (n >= 63) return -1;
+   m &= ~0ULL << (n+1);
+   return (m ? XrdCmsBitFirst(m) : -1);
+}
+
+// Word access for code that processes a mask 64 nodes at a time. Word i covers
+// nodes i*64 through i*64+63.
+//
+inline int  XrdCmsSMaskWords(const unsigned long long &) {return 1;}
+
+inline unsigned long long &XrdCmsSMaskWord(unsigned long long &m, int)
+                                          {return m;}
+inline unsigned long long  XrdCmsSMaskWord(const unsigned long long &m, int)
+                                          {return m;}
+
+/******************************************************************************/
+/*                       W i d e   S e r v e r   M a s k                      */
+/******************************************************************************/
+
+// A server mask of Bits bits (a multiple of 64) used when the cell size is
+// configured above 64 nodes. It behaves like the unsigned integer it replaces:
+// it is a trivial type, so left uninitialized unless given a value, and
+// construction from an integer sign extends so that SMask_t(~0) is all nodes.
+// Every operation is a fixed length loop over the words that the compiler can
+// unroll and vectorize.
+//
+template<int Bits>
+class XrdCmsSMask
+{
+public:
+
+enum {Words = Bits/64};
+
+unsigned long long w[Words];
+
+explicit operator bool() const
+                   {unsigned long long v = 0;
+                    for (int i = 0; i < Words; i++) v |= w[i];
+                    return v != 0;
+                   }
+
+XrdCmsSMask  operator~() const
+                   {XrdCmsSMask r;
+                    for (int i = 0; i < Words; i++) r.w[i] = ~w[i];
+                    return r;
+                   }
+
+XrdCmsSMask &operator&=(const XrdCmsSMask &m)
+                   {for (int i = 0; i < Words; i++) w[i] &= m.w[i];
+                    return *this;
+                   }
+
+XrdCmsSMask &operator|=(const XrdCmsSMask &m)
+                   {for (int i = 0; i < Words; i++) w[i] |= m.w[i];
+                    return *this;
+                   }
+
+XrdCmsSMask &operator^=(const XrdCmsSMask &m)
+                   {for (int i = 0; i < Words; i++) w[i] ^= m.w[i];
+                    return *this;
+                   }
+
+XrdCmsSMask &operator<<=(int n)
+                   {int sw = n/64, sb = n%64;
+                    for (int i = Words-1; i >= 0; i--)
+                        {unsigned long long v = 0;
+                         if (i-sw >= 0)
+                            {v = w[i-sw] << sb;
+                             if (sb && i-sw-1 >= 0) v |= w[i-sw-1] >> (64-sb);
+                            }
+                         w[i] = v;
+                        }
+                    return *this;
+                   }
+
+XrdCmsSMask &operator>>=(int n)
+                   {int sw = n/64, sb = n%64;
+                    for (int i = 0; i < Words; i++)
+                        {unsigned long long v = 0;
+                         if (i+sw < Words)
+                            {v = w[i+sw] >> sb;
+                             if (sb && i+sw+1 < Words) v |= w[i+sw+1] << (64-sb);
+                            }
+                         w[i] = v;
+                        }
+                    return *this;
+                   }
+
+XrdCmsSMask  operator<<(int n) const {XrdCmsSMask r(*this); return r <<= n;}
+XrdCmsSMask  operator>>(int n) const {XrdCmsSMask r(*this); return r >>= n;}
+
+friend XrdCmsSMask operator&(XrdCmsSMask a, const XrdCmsSMask &b)
+                            {return a &= b;}
+friend XrdCmsSMask operator|(XrdCmsSMask a, const XrdCmsSMask &b)
+                            {return a |= b;}
+friend XrdCmsSMask operator^(XrdCmsSMask a, const XrdCmsSMask &b)
+                            {return a ^= b;}
+
+friend bool        operator==(const XrdCmsSMask &a, const XrdCmsSMask &b)
+                             {unsigned long long v = 0;
+                              for (int i = 0; i < Words; i++) v |= a.w[i]^b.w[i];
+                              return v == 0;
+                             }
+friend bool        operator!=(const XrdCmsSMask &a, const XrdCmsSMask &b)
+                             {return !(a == b);}
+
+// Masks are displayed in hex, most significant word first, as they would be
+// if they were a single integer.
+//
+friend std::ostream &operator<<(std::ostream &os, const XrdCmsSMask &m)
+                   {int i = Words-1;
+                    while(i > 0 && !m.w[i]) i--;
+                    os <<m.w[i];
+                    if (i)
+                       {char fill = os.fill('0');
+                        while(i--) os <<std::setw(16) <<m.w[i];
+                        os.fill(fill);
+                       }
+                    return os;
+                   }
+
+      XrdCmsSMask() = default;
+
+      XrdCmsSMask(long long v)
+                 {w[0] = static_cast<unsigned long long>(v);
+                  for (int i = 1; i < Words; i++) w[i] = (v < 0 ? ~0ULL : 0);
+                 }
+};
+
+template<int Bits>
+inline int  XrdCmsSMaskCount(const XrdCmsSMask<Bits> &m)
+{
+   int n = 0;
+   for (int i = 0; i < XrdCmsSMask<Bits>::Words; i++) n += XrdCmsBitCount(m.w[i]);
+   return n;
+}
+
+template<int Bits>
+inline int  XrdCmsSMaskNext(const XrdCmsSMask<Bits> &m, int n)
+{
+   int i = (n+1)/64, b = (n+1)%64;
+   unsigned long long v;
+
+   if (n+1 >= Bits) return -1;
+   v = m.w[i] & (~0ULL << b);
+   while(!v) {if (++i >= XrdCmsSMask<Bits>::Words) return -1; v = m.w[i];}
+   return i*64 + XrdCmsBitFirst(v);
+}
+
+template<int Bits>
+inline int  XrdCmsSMaskFirst(const XrdCmsSMask<Bits> &m)
+                            {return XrdCmsSMaskNext(m, -1);}
+
+template<int Bits>
+inline int  XrdCmsSMaskWords(const XrdCmsSMask<Bits> &)
+                            {return XrdCmsSMask<Bits>::Words;}
+
+template<int Bits>
+inline unsigned long long &XrdCmsSMaskWord(XrdCmsSMask<Bits> &m, int i)
+                                          {return m.w[i];}
+template<int Bits>
+inline unsigned long long  XrdCmsSMaskWord(const XrdCmsSMask<Bits> &m, int i)
+                                          {return m.w[i];}
+#endif
@@ -0,0 +1,203 @@
+/******************************************************************************/
+/*                                                                            */
+/*                       X r d C m s S e l V e c . c c                        */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                        Author: agent <agent@local>                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <limits.h>
+#include <string.h>
+
+#include "XrdCms/XrdCmsNode.hh"
+#include "XrdCms/XrdCmsSelVec.hh"
+
+/******************************************************************************/
+/*                       L o c a l   F u n c t i o n s                        */
+/******************************************************************************/
+
+// The following process the 64 nodes of one mask word, 32 at a time. The bit
+// of each node is tested using a table instead of a shift and the node's value
+// is chosen without a branch as otherwise the loops can't be vectorized.
+//
+static const unsigned int Bit32[32] =
+       {1U<< 0, 1U<< 1, 1U<< 2, 1U<< 3, 1U<< 4, 1U<< 5, 1U<< 6, 1U<< 7,
+        1U<< 8, 1U<< 9, 1U<<10, 1U<<11, 1U<<12, 1U<<13, 1U<<14, 1U<<15,
+        1U<<16, 1U<<17, 1U<<18, 1U<<19, 1U<<20, 1U<<21, 1U<<22, 1U<<23,
+        1U<<24, 1U<<25, 1U<<26, 1U<<27, 1U<<28, 1U<<29, 1U<<30, 1U<<31};
+
+static int minWord(unsigned long long w, const int *vals)
+{
+   unsigned int hw[2] = {static_cast<unsigned int>(w),
+                         static_cast<unsigned int>(w >> 32)};
+   int sel, val, vmin = INT_MAX;
+
+   for (int k = 0; k < 2; k++, vals += 32)
+       for (int j = 0; j < 32; j++)
+           {sel  = -static_cast<int>((hw[k] & Bit32[j]) != 0);
+            val  = (vals[j] & sel) | (INT_MAX & ~sel);
+            vmin = (val < vmin ? val : vmin);
+           }
+   return vmin;
+}
+
+static unsigned long long uptoWord(unsigned long long w, const int *vals,
+                                   int lim)
+{
+   unsigned int hw[2] = {0, 0};
+
+   for (int k = 0; k < 2; k++, vals += 32)
+       for (int j = 0; j < 32; j++) hw[k] |= (vals[j] <= lim ? Bit32[j] : 0);
+
+   return w & (hw[0] | (static_cast<unsigned long long>(hw[1]) << 32));
+}
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+  
+XrdCmsSelVec::XrdCmsSelVec() : inTab(0), isBad(0), isOffline(0), isNoStage(0),
+                               isFull(0)
+{
+   for (int i = 0; i < 8; i++) onNet[i] = 0;
+   memset(myCost, 0, sizeof(myCost));
+   memset(myLoad, 0, sizeof(myLoad));
+   memset(myMass, 0, sizeof(myMass));
+}
+
+/******************************************************************************/
+/*                                   M i n                                    */
+/******************************************************************************/
+  
+int XrdCmsSelVec::Min(const SMask_t &mask, const int *vals)
+{
+   unsigned long long w;
+   int val, vmin = INT_MAX, n = XrdCmsSMaskWords(mask);
+
+   for (int i = 0; i < n; i++, vals += 64)
+       if ((w = XrdCmsSMaskWord(mask, i)) && (val = minWord(w, vals)) < vmin)
+          vmin = val;
+   return vmin;
+}
+
+/******************************************************************************/
+/*                                   N e t                                    */
+/******************************************************************************/
+  
+SMask_t XrdCmsSelVec::Net(const SMask_t &mask, int needNet)
+{
+   SMask_t nmask(0);
+
+   needNet &= 0xff;
+   for (int i = 0; needNet; i++, needNet >>= 1)
+       if (needNet & 1) nmask |= onNet[i];
+   return mask & nmask;
+}
+
+/******************************************************************************/
+/*                                   N t h                                    */
+/******************************************************************************/
+  
+int XrdCmsSelVec::Nth(const SMask_t &mask, int k)
+{
+   unsigned long long w;
+   int cnt, n = XrdCmsSMaskWords(mask);
+
+// Skip whole words until we get to the one with the node, then clear the
+// lower bits until it is the lowest one.
+//
+   for (int i = 0; i < n; i++)
+       {w = XrdCmsSMaskWord(mask, i);
+        if (k >= (cnt = XrdCmsBitCount(w))) {k -= cnt; continue;}
+        while(k--) w &= w - 1;
+        return i*64 + XrdCmsBitFirst(w);
+       }
+   return -1;
+}
+
+/******************************************************************************/
+/*                                   S e t                                    */
+/******************************************************************************/
+  
+void XrdCmsSelVec::Set(int n, XrdCmsNode *nP)
+{
+   if (n < 0 || n >= STMax) return;
+
+// Remove the node, if so wanted. It leaves the table first.
+//
+   if (!nP)
+      {setBit(inTab, n, false);
+       for (int i = 0; i < 8; i++) setBit(onNet[i], n, false);
+       setBit(isBad,     n, false);
+       setBit(isOffline, n, false);
+       setBit(isNoStage, n, false);
+       setBit(isFull,    n, false);
+       myCost[n] = myLoad[n] = myMass[n] = 0;
+       return;
+      }
+
+// Copy the node's attributes. It enters the table last.
+//
+   myCost[n] = nP->myCost;
+   myLoad[n] = nP->myLoad;
+   myMass[n] = nP->myMass;
+   for (int i = 0; i < 8; i++) setBit(onNet[i], n, (nP->hasNet & (1<<i)) != 0);
+   setBit(isBad,     n, nP->isBad     != 0);
+   setBit(isOffline, n, nP->isOffline != 0);
+   setBit(isNoStage, n, nP->isNoStage != 0);
+   setBit(isFull,    n, nP->DiskFree < nP->DiskMinF);
+   setBit(inTab,     n, true);
+}
+
+/******************************************************************************/
+/*                                  U p t o                                   */
+/******************************************************************************/
+  
+SMask_t XrdCmsSelVec::Upto(const SMask_t &mask, const int *vals, int lim)
+{
+   SMask_t umask(0);
+   unsigned long long w;
+   int n = XrdCmsSMaskWords(mask);
+
+   for (int i = 0; i < n; i++, vals += 64)
+       if ((w = XrdCmsSMaskWord(mask, i)))
+          XrdCmsSMaskWord(umask, i) = uptoWord(w, vals, lim);
+   return umask;
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                s e t B i t                                 */
+/******************************************************************************/
+  
+void XrdCmsSelVec::setBit(SMask_t &mask, int n, bool on)
+{
+   unsigned long long &w = XrdCmsSMaskWord(mask, n/64);
+   unsigned long long  b = 1ULL << (n%64);
+
+   if (on) {if (!(w & b)) __sync_fetch_and_or (&w,  b);}
+      else {if (  w & b ) __sync_fetch_and_and(&w, ~b);}
+}
@@ -0,0 +1,96 @@
+#ifndef __XRDCMSSELVEC_HH__
+#define __XRDCMSSELVEC_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                       X r d C m s S e l V e c . h h                        */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                        Author: agent <agent@local>                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <limits.h>
+
+#include "XrdCms/XrdCmsTypes.hh"
+
+class XrdCmsNode;
+
+/******************************************************************************/
+/*                    C l a s s   X r d C m s S e l V e c                     */
+/******************************************************************************/
+
+// The XrdCmsSelVec object holds a copy of the node attributes used by node
+// selection laid out by attribute instead of by node. The yes/no attributes
+// are node masks and the values are arrays indexed by node number so that a
+// selection becomes mask arithmetic plus a scan of an array that the compiler
+// can vectorize. The copy is refreshed by Set() whenever one of the attributes
+// changes. The masks are updated a bit at a time using atomic operations so
+// neither updates nor selections need a lock; a selection may see a change a
+// moment late which it could equally well do when looking at the node itself.
+//
+class XrdCmsSelVec
+{
+public:
+
+SMask_t  inTab;          // Node is in the node table
+SMask_t  onNet[8];       // Node can be reached via the interface (hasNet bit)
+SMask_t  isBad;          // Node is unselectable (suspended, disabled, etc)
+SMask_t  isOffline;      // Node is offline
+SMask_t  isNoStage;      // Node may not stage files
+SMask_t  isFull;         // Node has less free space than its minimum
+
+int      myCost[STMax];  // Cost of each node
+int      myLoad[STMax];  // Load of each node
+int      myMass[STMax];  // Load of each node including space utilization
+
+// Min() returns the smallest value in vals[] of the nodes in mask or INT_MAX
+//       if mask is empty.
+//
+static int     Min(const SMask_t &mask, const int *vals);
+
+// Net() returns the nodes in mask reachable via any of the needNet interfaces.
+//
+       SMask_t Net(const SMask_t &mask, int needNet);
+
+// Nth() returns the number of the k'th node (counting from 0) in mask or -1
+//       if mask has fewer nodes.
+//
+static int     Nth(const SMask_t &mask, int k);
+
+// Set() copies the attributes of node number n from nP or, if nP is zero,
+//       removes the node.
+//
+       void    Set(int n, XrdCmsNode *nP);
+
+// Upto() returns the nodes in mask whose value in vals[] is at most lim.
+//
+static SMask_t Upto(const SMask_t &mask, const int *vals, int lim);
+
+               XrdCmsSelVec();
+              ~XrdCmsSelVec() {}
+
+private:
+
+static void    setBit(SMask_t &mask, int n, bool on);
+};
+#endif
@@ -0,0 +1,1063 @@
+/******************************************************************************/
+/*                                                                            */
+/*                          X r d C m s S i m . c c                           */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                        Author: agent <agent@local>                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+// xrdcmssim runs the cmsd manager logic in-process against simulated data
+// servers and a simulated redirector, each talking the real cms protocol over
+// a loopback connection. It replays a synthetic or recorded request trace and
+// reports redirect latency, state query traffic and load distribution so that
+// changes to node selection and the location cache can be measured on a
+// single machine. It is not part of the default build; use "make xrdcmssim".
+//
+#include <errno.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "XProtocol/YProtocol.hh"
+#include "Xrd/XrdInet.hh"
+#include "Xrd/XrdLink.hh"
+#include "Xrd/XrdProtocol.hh"
+#include "Xrd/XrdScheduler.hh"
+#include "XrdCms/XrdCmsConfig.hh"
+#include "XrdCms/XrdCmsLogin.hh"
+#include "XrdCms/XrdCmsParser.hh"
+#include "XrdCms/XrdCmsRRData.hh"
+#include "XrdCms/XrdCmsTypes.hh"
+#include "XrdNet/XrdNetAddr.hh"
+#include "XrdOuc/XrdOucCRC.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdOuc/XrdOucPup.hh"
+#include "XrdOuc/XrdOucTrace.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include "XrdSys/XrdSysTimer.hh"
+
+using namespace XrdCms;
+
+/******************************************************************************/
+/*                    E x t e r n a l   F u n c t i o n s                     */
+/******************************************************************************/
+
+// These are the cms protocol entry points normally called by the xrd driver.
+//
+extern "C"
+{
+extern int          XrdgetProtocolPort(const char *pname, char *parms,
+                                       XrdProtocol_Config *pi);
+
+extern XrdProtocol *XrdgetProtocol(const char *pname, char *parms,
+                                   XrdProtocol_Config *pi);
+}
+
+/******************************************************************************/
+/*                      G l o b a l   V a r i a b l e s                       */
+/******************************************************************************/
+
+namespace XrdCmsSim
+{
+       XrdSysLogger      *Logger;
+
+       XrdSysError        eDest(0, "cmssim");
+
+       XrdOucTrace        simTrace(&eDest);
+
+       XrdProtocol       *Matcher;
+
+static const int          basePort = 30000;  // Data port of simulated node 0
+
+       int                numNodes = 16;
+       int                numClients = 16;
+       int                numFiles = 10000;
+       int                numReqs  = 10000;
+       int                numReps  = 1;
+       int                holdTime = 1000;   // Milliseconds a file stays open
+       int                nodeCap  = 100;    // Opens for 100% load
+       int                maxWait  = -1;     // Cap on honored waits (ms)
+       int                locPct   = 0;
+       int                newPct   = 0;
+       long               theSeed  = 1;
+       double             zipfExp  = 0.0;
+       bool               Verbose  = false;
+
+// Paths that only exist once created; fixed before the run starts
+//
+       std::set<std::string> newFiles;
+
+       XrdSysSemaphore    loginSem(0);
+       XrdSysSemaphore    doneSem(0);
+};
+
+using namespace XrdCmsSim;
+
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+struct SimReq
+      {const char *Path;
+       char        Op;     // o(pen) w(rite) c(reate) s(tat) l(ocate)
+      };
+
+namespace
+{
+std::vector<SimReq> theReqs;
+XrdSysMutex         reqMutex;
+size_t              reqNext = 0;
+
+long long Now()  // Microseconds on the monotonic clock
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec*1000000LL + ts.tv_nsec/1000;
+}
+}
+
+/******************************************************************************/
+/*                               S i m N o d e                                */
+/******************************************************************************/
+
+// A simulated data server. It answers state queries from its view of the
+// namespace, replies to pings and usage requests and reports its load, which
+// is driven by the number of files the simulated clients have open on it.
+//
+class SimNode
+{
+public:
+
+void     Close();
+
+bool     Has(const char *path);
+
+void     Made(const char *path);
+
+void     Open();
+
+void     Stat() {myMutex.Lock(); Redirs++; myMutex.UnLock();}
+
+void    *Run();
+
+XrdLink          *Link;
+int               Num;
+int               Cap;
+long long         Queries;
+long long         Haves;
+long long         Redirs;
+int               Active;
+int               maxActive;
+
+         SimNode(XrdLink *lp, int num, int cap)
+                : Link(lp), Num(num), Cap(cap), Queries(0), Haves(0),
+                  Redirs(0), Active(0), maxActive(0), Reported(-1) {}
+        ~SimNode() {}
+
+private:
+
+void     doState(CmsRRHdr &Hdr, char *path, int dlen);
+void     sendLoad(bool force);
+
+XrdSysMutex           myMutex;
+std::set<std::string> myFiles;
+int                   Reported;
+};
+
+/******************************************************************************/
+/*                        S i m N o d e : : C l o s e                         */
+/******************************************************************************/
+
+void SimNode::Close()
+{
+   myMutex.Lock(); Active--; myMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                          S i m N o d e : : H a s                           */
+/******************************************************************************/
+
+// Pre-existing files are placed on numReps consecutive nodes starting at the
+// node selected by the path's checksum. Created files only exist where made.
+//
+bool SimNode::Has(const char *path)
+{
+   bool isHere;
+
+   if (!newFiles.count(path))
+      {unsigned int h = XrdOucCRC::CRC32((const unsigned char *)path,
+                                         strlen(path));
+       return (Num - static_cast<int>(h % numNodes) + numNodes) % numNodes
+              < numReps;
+      }
+
+   myMutex.Lock(); isHere = myFiles.count(path) != 0; myMutex.UnLock();
+   return isHere;
+}
+
+/******************************************************************************/
+/*                         S i m N o d e : : M a d e                          */
+/******************************************************************************/
+
+// A client created a file here. Record it and tell the manager, as the
+// server's ofs would.
+//
+void SimNode::Made(const char *path)
+{
+   CmsRRHdr     Have = {0, kYR_have, CmsHaveRequest::Online | kYR_raw, 0};
+   struct iovec ioV[2];
+   int          plen = strlen(path)+1;
+
+   myMutex.Lock(); myFiles.insert(path); myMutex.UnLock();
+
+   Have.datalen = htons(static_cast<unsigned short>(plen));
+   ioV[0].iov_base = (char *)&Have;   ioV[0].iov_len = sizeof(Have);
+   ioV[1].iov_base = (char *)path;    ioV[1].iov_len = plen;
+   Link->Send(ioV, 2);
+}
+
+/******************************************************************************/
+/*                         S i m N o d e : : O p e n                          */
+/******************************************************************************/
+
+void SimNode::Open()
+{
+   myMutex.Lock();
+   Redirs++;
+   if (++Active > maxActive) maxActive = Active;
+   myMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                          S i m N o d e : : R u n                           */
+/******************************************************************************/
+
+void *SimNode::Run()
+{
+   CmsLoginData Data;
+   CmsRRHdr     Hdr;
+   char         sid[32], buff[65536];
+   int          dlen, rc;
+
+// Login as a data server exporting the whole namespace read/write
+//
+   memset(&Data, 0, sizeof(Data));
+   snprintf(sid, sizeof(sid), "simnode%d", Num);
+   Data.Version  = kYR_Version;
+   Data.Mode     = CmsLoginData::kYR_server;
+   Data.HoldTime = static_cast<int>(getpid());
+   Data.tSpace   = 1000;
+   Data.fSpace   = 1000000;
+   Data.fsNum    = 1;
+   Data.dPort    = static_cast<kXR_unt16>(basePort + Num);
+   Data.SID      = (kXR_char *)sid;
+   Data.Paths    = (kXR_char *)"w /";
+   rc = XrdCmsLogin::Login(Link, Data, 30000);
+   if (Data.SID)    free(Data.SID);
+   if (Data.envCGI) free(Data.envCGI);
+   if (rc) {eDest.Emsg("Node", sid, "login failed;", strerror(rc));
+            Num = -1; loginSem.Post(); return 0;
+           }
+   loginSem.Post();
+
+// Process requests until the manager goes away. Idle periods are used to
+// push a load report whenever the load changed.
+//
+   while(1)
+        {if ((rc = Link->RecvAll((char *)&Hdr, sizeof(Hdr), 1000)) < 0)
+            {if (rc == -ETIMEDOUT) {sendLoad(false); continue;}
+             break;
+            }
+         if ((dlen = ntohs(Hdr.datalen)))
+            {if (dlen >= (int)sizeof(buff) || Link->RecvAll(buff, dlen) < 0)
+                break;
+            }
+         buff[dlen] = 0;
+
+         switch(Hdr.rrCode)
+               {case kYR_state: doState(Hdr, buff, dlen);
+                                break;
+                case kYR_ping:  {CmsPongRequest Pong = {{0, kYR_pong, 0, 0}};
+                                 Link->Send((char *)&Pong, sizeof(Pong));
+                                }
+                                break;
+                case kYR_usage: sendLoad(true);
+                                break;
+                default:        break;
+               }
+        }
+
+   eDest.Emsg("Node", sid, "lost its connection to the manager.");
+   return 0;
+}
+
+/******************************************************************************/
+/*                      S i m N o d e : : d o S t a t e                       */
+/******************************************************************************/
+
+void SimNode::doState(CmsRRHdr &Hdr, char *path, int dlen)
+{
+   struct iovec ioV[2];
+
+// We only handle raw requests which is all the manager sends today
+//
+   if (!(Hdr.modifier & kYR_raw)) return;
+   Queries++;
+
+// Respond with have if we have it or gone if the manager wants misses
+//
+   if (Has(path))
+      {Haves++;
+       if (Hdr.modifier & CmsStateRequest::kYR_noresp) return;
+       Hdr.rrCode   = kYR_have;
+       Hdr.modifier = CmsHaveRequest::Online | kYR_raw;
+      } else {
+       if (!(Hdr.modifier & CmsStateRequest::kYR_misresp)) return;
+       Hdr.rrCode   = kYR_gone;
+       Hdr.modifier = CmsGoneRequest::kYR_miss | kYR_raw;
+      }
+
+   ioV[0].iov_base = (char *)&Hdr; ioV[0].iov_len = sizeof(Hdr);
+   ioV[1].iov_base = path;         ioV[1].iov_len = dlen;
+   Link->Send(ioV, 2);
+}
+
+/******************************************************************************/
+/*                     S i m N o d e : : s e n d L o a d                      */
+/******************************************************************************/
+
+// The report is formatted exactly as XrdCmsMeter::Report_Usage() does it.
+//
+void SimNode::sendLoad(bool force)
+{
+   CmsLoadRequest myLoad = {{0, kYR_load, 0, 0}};
+   struct iovec   ioV[2];
+   char           loadbuff[CmsLoadRequest::numLoad];
+   char           respbuff[sizeof(loadbuff)+2+sizeof(int)+2], *bp = respbuff;
+   int            blen, load, maxfr = 1000000;
+
+   myMutex.Lock(); load = Active*100/Cap; myMutex.UnLock();
+   if (load > 100) load = 100;
+   if (!force && load == Reported) return;
+   Reported = load;
+
+   memset(loadbuff, 0, sizeof(loadbuff));
+   loadbuff[CmsLoadRequest::cpuLoad] = static_cast<char>(load);
+   loadbuff[CmsLoadRequest::xeqLoad] = static_cast<char>(load);
+   blen  = XrdOucPup::Pack(&bp, loadbuff, sizeof(loadbuff));
+   blen += XrdOucPup::Pack(&bp, maxfr);
+   myLoad.Hdr.datalen = htons(static_cast<unsigned short>(blen));
+
+   ioV[0].iov_base = (char *)&myLoad; ioV[0].iov_len = sizeof(myLoad);
+   ioV[1].iov_base = respbuff;        ioV[1].iov_len = blen;
+   Link->Send(ioV, 2);
+}
+
+/******************************************************************************/
+/*                   R e d i r e c t o r   S i m u l a t i o n                */
+/******************************************************************************/
+
+namespace
+{
+// Each client thread owns one slot; its stream id is the slot number plus one
+// so that it never collides with the unsolicited status messages.
+//
+struct SimSlot
+      {XrdSysSemaphore        Done;
+       int                    rrCode;
+       int                    Val;
+       int                    Waited;
+       int                    Waits;
+       int                    Failed;
+       int                    Located;
+       int                    Redirected;
+       int                    Unknown;
+       std::vector<int>       Latency;   // Microseconds
+
+       SimSlot() : Done(0), rrCode(0), Val(0), Waited(0), Waits(0),
+                   Failed(0), Located(0), Redirected(0), Unknown(0) {}
+      };
+
+XrdLink               *rdrLink;
+SimSlot               *Slots;
+SimNode              **Nodes;
+
+XrdSysCondVar          closeCV(0);
+std::deque<std::pair<long long, SimNode *> > closeQ;
+
+/******************************************************************************/
+/*                                C l o s e r                                 */
+/******************************************************************************/
+
+// Files are closed in the order they were opened since they all stay open for
+// the same amount of time.
+//
+void *Closer(void *)
+{
+   long long wTime;
+
+   closeCV.Lock();
+   while(1)
+        {while(closeQ.empty()) closeCV.Wait();
+         if ((wTime = closeQ.front().first - Now()) > 0)
+            {closeCV.WaitMS(static_cast<int>(wTime/1000)+1); continue;}
+         closeQ.front().second->Close();
+         closeQ.pop_front();
+        }
+   return 0;
+}
+
+/******************************************************************************/
+/*                             R d r R e a d e r                              */
+/******************************************************************************/
+
+// Deliver responses from the manager to the client thread waiting on them.
+// A waitresp only says that the real response comes later so it is ignored.
+//
+void *RdrReader(void *)
+{
+   CmsRRHdr Hdr;
+   char     buff[65536];
+   int      dlen, sid;
+
+   while(rdrLink->RecvAll((char *)&Hdr, sizeof(Hdr)) >= 0)
+        {if ((dlen = ntohs(Hdr.datalen)))
+            {if (dlen >= (int)sizeof(buff) || rdrLink->RecvAll(buff,dlen) < 0)
+                break;
+            }
+         sid = static_cast<int>(Hdr.streamid) - 1;
+         if (sid < 0 || sid >= numClients) continue;
+         switch(Hdr.rrCode)
+               {case kYR_redirect: case kYR_wait:
+                case kYR_error:    case kYR_data:
+                     break;
+                default: continue;
+               }
+         Slots[sid].rrCode = Hdr.rrCode;
+         if (dlen >= (int)sizeof(kXR_unt32))
+            {kXR_unt32 val;
+             memcpy(&val, buff, sizeof(val));
+             Slots[sid].Val = static_cast<int>(ntohl(val));
+            } else Slots[sid].Val = 0;
+         Slots[sid].Done.Post();
+        }
+
+   eDest.Emsg("Redirector", "lost its connection to the manager.");
+   return 0;
+}
+
+/******************************************************************************/
+/*                               R d r S e n d                                */
+/******************************************************************************/
+
+// Format the request the way XrdCmsFinderRMT does for the xrootd redirector.
+//
+void RdrSend(SimReq &Req, int sid)
+{
+   static const int xNum = 12;
+   XrdCmsRRData Data;
+   struct iovec xmsg[xNum];
+   char         Work[xNum*12];
+   int          iovcnt;
+
+   memset(&Data, 0, sizeof(Data));
+   Data.Ident = (char *)"";
+   Data.Path  = (char *)Req.Path;
+   switch(Req.Op)
+         {case 'l': Data.Request.rrCode = kYR_locate;
+                    Data.Opts = CmsLocateRequest::kYR_retipv46;
+                    break;
+          case 'w': Data.Request.rrCode = kYR_select;
+                    Data.Opts = CmsSelectRequest::kYR_write;
+                    break;
+          case 'c': Data.Request.rrCode = kYR_select;
+                    Data.Opts = CmsSelectRequest::kYR_create
+                              | CmsSelectRequest::kYR_write;
+                    break;
+          case 's': Data.Request.rrCode = kYR_select;
+                    Data.Opts = CmsSelectRequest::kYR_stat
+                              | CmsSelectRequest::kYR_read;
+                    break;
+          default:  Data.Request.rrCode = kYR_select;
+                    Data.Opts = CmsSelectRequest::kYR_read
+                              | CmsSelectRequest::kYR_retipv46;
+                    break;
+         }
+
+   if (!(iovcnt = XrdCmsParser::Pack(Data.Request.rrCode, &xmsg[1],
+                                     &xmsg[xNum], (char *)&Data, Work)))
+      {eDest.Emsg("Redirector", "unable to pack request for", Req.Path);
+       return;
+      }
+   Data.Request.streamid = static_cast<kXR_unt32>(sid);
+   xmsg[0].iov_base = (char *)&Data.Request;
+   xmsg[0].iov_len  = sizeof(Data.Request);
+   rdrLink->Send(xmsg, iovcnt+1);
+}
+
+/******************************************************************************/
+/*                                C l i e n t                                 */
+/******************************************************************************/
+
+// Each client issues the next request in the trace, honoring waits, until the
+// trace is exhausted.
+//
+void *Client(void *carg)
+{
+   int        slot = static_cast<int>(reinterpret_cast<long>(carg));
+   SimSlot   &Me   = Slots[slot];
+   SimReq     Req;
+   long long  tBeg;
+   int        n, wms, waits;
+
+   while(1)
+        {reqMutex.Lock();
+         if (reqNext >= theReqs.size()) {reqMutex.UnLock(); break;}
+         Req = theReqs[reqNext++];
+         reqMutex.UnLock();
+
+         tBeg = Now(); waits = 0;
+         while(1)
+              {RdrSend(Req, slot+1);
+               Me.Done.Wait();
+               if (Me.rrCode != kYR_wait) break;
+               waits++;
+               wms = Me.Val*1000;
+               if (maxWait >= 0 && wms > maxWait) wms = maxWait;
+               if (wms > 0) XrdSysTimer::Wait(wms);
+              }
+         if (waits) {Me.Waited++; Me.Waits += waits;}
+
+         switch(Me.rrCode)
+               {case kYR_redirect:
+                     n = Me.Val - basePort;
+                     if (n < 0 || n >= numNodes) {Me.Unknown++; break;}
+                     Me.Redirected++;
+                     Me.Latency.push_back(static_cast<int>(Now()-tBeg));
+                     if (Req.Op == 's') {Nodes[n]->Stat(); break;}
+                     Nodes[n]->Open();
+                     if (Req.Op == 'c') Nodes[n]->Made(Req.Path);
+                     closeCV.Lock();
+                     closeQ.push_back(std::make_pair(Now()+holdTime*1000LL,
+                                                     Nodes[n]));
+                     if (closeQ.size() == 1) closeCV.Signal();
+                     closeCV.UnLock();
+                     break;
+                case kYR_data:
+                     Me.Located++;
+                     Me.Latency.push_back(static_cast<int>(Now()-tBeg));
+                     break;
+                default:
+                     Me.Failed++;
+                     break;
+               }
+        }
+
+   doneSem.Post();
+   return 0;
+}
+}
+
+/******************************************************************************/
+/*                         L o c a l   H e l p e r s                          */
+/******************************************************************************/
+
+namespace
+{
+/******************************************************************************/
+/*                              M a k e P a i r                               */
+/******************************************************************************/
+
+// Create a connected loopback pair and wrap each end in a link object. The
+// first link is the manager's end.
+//
+bool MakePair(int lsFD, XrdLink *&mLink, XrdLink *&sLink)
+{
+   struct sockaddr_in sa;
+   socklen_t sl = sizeof(sa);
+   XrdNetAddr mAddr, sAddr;
+   int cFD, aFD, on = 1;
+
+   if (getsockname(lsFD, (struct sockaddr *)&sa, &sl)
+   ||  (cFD = socket(AF_INET, SOCK_STREAM, 0)) < 0) return false;
+   if (connect(cFD, (struct sockaddr *)&sa, sl)
+   ||  (aFD = accept(lsFD, 0, 0)) < 0) {close(cFD); return false;}
+
+   setsockopt(cFD, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+   setsockopt(aFD, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+   mAddr.Set(aFD); sAddr.Set(cFD);
+
+   if (!(mLink = XrdLink::Alloc(mAddr)) || !(sLink = XrdLink::Alloc(sAddr)))
+      return false;
+   return true;
+}
+
+/******************************************************************************/
+/*                               M a k e R e q s                              */
+/******************************************************************************/
+
+// Generate a synthetic trace. Existing files are picked uniformly or following
+// a Zipf distribution; new files are unique to their create request.
+//
+void MakeReqs()
+{
+   std::vector<double> cdf;
+   std::vector<char *> fName(numFiles);
+   char buff[64];
+   SimReq Req;
+   int k;
+
+   srand48(theSeed);
+   for (k = 0; k < numFiles; k++)
+       {snprintf(buff, sizeof(buff), "/sim/f%d", k); fName[k] = strdup(buff);}
+
+   if (zipfExp > 0.0)
+      {double sum = 0.0;
+       cdf.resize(numFiles);
+       for (k = 0; k < numFiles; k++)
+           {sum += 1.0/pow(k+1, zipfExp); cdf[k] = sum;}
+       for (k = 0; k < numFiles; k++) cdf[k] /= sum;
+      }
+
+   for (int i = 0; i < numReqs; i++)
+       {if (drand48()*100.0 < newPct)
+           {snprintf(buff, sizeof(buff), "/sim/new/f%d", i);
+            Req.Path = strdup(buff); Req.Op = 'c';
+            newFiles.insert(Req.Path);
+           } else {
+            if (cdf.empty()) k = static_cast<int>(drand48()*numFiles);
+               else k = std::lower_bound(cdf.begin(), cdf.end(), drand48())
+                      - cdf.begin();
+            if (k >= numFiles) k = numFiles-1;
+            Req.Path = fName[k];
+            Req.Op   = (drand48()*100.0 < locPct ? 'l' : 'o');
+           }
+        theReqs.push_back(Req);
+       }
+}
+
+/******************************************************************************/
+/*                               R e a d R e q s                              */
+/******************************************************************************/
+
+// A trace file has one "<op> <path>" per line where op is one of open, read,
+// write, create, stat or locate. Blank lines and '#' comments are ignored.
+//
+bool ReadReqs(const char *fn)
+{
+   static const struct {const char *name; char op;} opTab[] =
+               {{"open", 'o'}, {"read", 'o'}, {"write", 'w'},
+                {"create", 'c'}, {"stat", 's'}, {"locate", 'l'}};
+   static const int opNum = sizeof(opTab)/sizeof(opTab[0]);
+   FILE  *fP;
+   SimReq Req;
+   char   line[4096], opname[16], path[4096];
+   int    i, lnum = 0;
+
+   if (!(fP = fopen(fn, "r")))
+      {fprintf(stderr, "xrdcmssim: Unable to open %s; %s\n",fn,strerror(errno));
+       return false;
+      }
+
+   while(fgets(line, sizeof(line), fP))
+        {lnum++;
+         if (sscanf(line, "%15s %4095s", opname, path) < 1
+         ||  *opname == '#') continue;
+         for (i = 0; i < opNum; i++) if (!strcmp(opname,opTab[i].name)) break;
+         if (i >= opNum || *path != '/')
+            {fprintf(stderr, "xrdcmssim: Invalid request at %s:%d\n",fn,lnum);
+             fclose(fP);
+             return false;
+            }
+         Req.Path = strdup(path); Req.Op = opTab[i].op;
+         if (Req.Op == 'c') newFiles.insert(Req.Path);
+         theReqs.push_back(Req);
+        }
+
+   fclose(fP);
+   if (theReqs.empty())
+      {fprintf(stderr, "xrdcmssim: No requests found in %s\n", fn);
+       return false;
+      }
+   return true;
+}
+
+/******************************************************************************/
+/*                                R e p o r t                                 */
+/******************************************************************************/
+
+void Report(double elapsed)
+{
+   std::vector<int> lat;
+   long long qTot = 0, hTot = 0, tot = 0;
+   int redir = 0, located = 0, waited = 0, waits = 0, failed = 0, unknown = 0;
+   long long rMin = -1, rMax = 0;
+   int i;
+   double avg = 0.0, var = 0.0, lsum = 0.0;
+
+   for (i = 0; i < numClients; i++)
+       {redir  += Slots[i].Redirected; located += Slots[i].Located;
+        waited += Slots[i].Waited;     waits   += Slots[i].Waits;
+        failed += Slots[i].Failed;     unknown += Slots[i].Unknown;
+        lat.insert(lat.end(), Slots[i].Latency.begin(), Slots[i].Latency.end());
+       }
+   std::sort(lat.begin(), lat.end());
+   for (i = 0; i < (int)lat.size(); i++) lsum += lat[i];
+
+   for (i = 0; i < numNodes; i++)
+       {qTot += Nodes[i]->Queries; hTot += Nodes[i]->Haves;
+        tot  += Nodes[i]->Redirs;
+        if (rMin < 0 || Nodes[i]->Redirs < rMin) rMin = Nodes[i]->Redirs;
+        if (Nodes[i]->Redirs > rMax) rMax = Nodes[i]->Redirs;
+       }
+   avg = static_cast<double>(tot)/numNodes;
+   for (i = 0; i < numNodes; i++)
+       var += (Nodes[i]->Redirs - avg)*(Nodes[i]->Redirs - avg);
+   var /= numNodes;
+
+   printf("requests %d nodes %d clients %d elapsed %.3fs rate %.1f/s\n",
+          static_cast<int>(theReqs.size()), numNodes, numClients, elapsed,
+          theReqs.size()/(elapsed > 0.0 ? elapsed : 1.0));
+
+#define PCT(p) (lat.empty() ? 0.0 : lat[(lat.size()-1)*p/100]/1000.0)
+   printf("latency ms avg %.3f p50 %.3f p90 %.3f p99 %.3f max %.3f\n",
+          (lat.empty() ? 0.0 : lsum/lat.size()/1000.0),
+          PCT(50), PCT(90), PCT(99), PCT(100));
+#undef PCT
+
+   printf("redirected %d located %d waited %d (%d waits) failed %d",
+          redir, located, waited, waits, failed);
+   if (unknown) printf(" unknown %d", unknown);
+   printf("\n");
+
+   printf("state queries %lld (%.2f/request) haves %lld\n", qTot,
+          static_cast<double>(qTot)/theReqs.size(), hTot);
+
+   printf("redirects/node min %lld max %lld avg %.1f sd %.1f cv %.3f\n",
+          rMin, rMax, avg, sqrt(var), (avg > 0.0 ? sqrt(var)/avg : 0.0));
+
+   if (Verbose)
+      {printf("%6s %10s %10s %10s %10s\n",
+              "node", "redirects", "queries", "haves", "maxopen");
+       for (i = 0; i < numNodes; i++)
+           printf("%6d %10lld %10lld %10lld %10d\n", i, Nodes[i]->Redirs,
+                  Nodes[i]->Queries, Nodes[i]->Haves, Nodes[i]->maxActive);
+      }
+}
+
+/******************************************************************************/
+/*                                 S e r v e                                  */
+/******************************************************************************/
+
+// Run the manager's end of a link just as the xrd poller would.
+//
+void *Serve(void *carg)
+{
+   XrdLink     *lP = static_cast<XrdLink *>(carg);
+   XrdProtocol *pP;
+
+   if (!(pP = Matcher->Match(lP)))
+      eDest.Emsg("Serve", lP->ID, "did not send a cms login.");
+      else {pP->Process(lP); pP->Recycle(lP, 0, 0);}
+   return 0;
+}
+
+void *NodeRun(void *carg) {return static_cast<SimNode *>(carg)->Run();}
+
+/******************************************************************************/
+/*                                 U s a g e                                  */
+/******************************************************************************/
+
+void Usage(int rc)
+{
+   fprintf(stderr, "Usage: xrdcmssim [-c cfn] [-d] [-f files] [-h holdms] "
+                   "[-k cap] [-l logfn] [-L locpct]\n"
+                   "                 [-C newpct] [-n reqs] [-N nodes] "
+                   "[-p clients] [-r reps] [-s seed]\n"
+                   "                 [-t trace] [-v] [-w waitms] [-z zipf]\n");
+   exit(rc);
+}
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+
+int main(int argc, char *argv[])
+{
+   extern char *optarg;
+   extern int   opterr, optopt;
+   XrdProtocol_Config pi;
+   struct rlimit rlim;
+   pthread_t tid;
+   const char *cfgFN = 0, *logFN = 0, *traceFN = 0;
+   char *pArgv[] = {(char *)"cmsd", 0}, workDir[] = "/tmp/xrdcmssim.XXXXXX";
+   char  buff[4096];
+   bool  Debug = false;
+   long long tBeg;
+   int   c, lsFD, n;
+   FILE *fP;
+
+// Process the options
+//
+   opterr = 0;
+   if (argc > 1 && '-' == *argv[1])
+      while ((c = getopt(argc,argv,"c:C:df:h:k:l:L:n:N:p:r:s:t:vw:z:"))
+             && ((unsigned char)c != 0xff))
+     { switch(c)
+       {
+       case 'c': cfgFN      = optarg;                       break;
+       case 'C': newPct     = atoi(optarg);                 break;
+       case 'd': Debug      = true;                         break;
+       case 'f': numFiles   = atoi(optarg);                 break;
+       case 'h': holdTime   = atoi(optarg);                 break;
+       case 'k': nodeCap    = atoi(optarg);                 break;
+       case 'l': logFN      = optarg;                       break;
+       case 'L': locPct     = atoi(optarg);                 break;
+       case 'n': numReqs    = atoi(optarg);                 break;
+       case 'N': numNodes   = atoi(optarg);                 break;
+       case 'p': numClients = atoi(optarg);                 break;
+       case 'r': numReps    = atoi(optarg);                 break;
+       case 's': theSeed    = atol(optarg);                 break;
+       case 't': traceFN    = optarg;                       break;
+       case 'v': Verbose    = true;                         break;
+       case 'w': maxWait    = atoi(optarg);                 break;
+       case 'z': zipfExp    = atof(optarg);                 break;
+       default:  fprintf(stderr, "xrdcmssim: Invalid option '-%c'\n", optopt);
+                 Usage(1);
+       }
+     }
+
+// Verify the options
+//
+   if (numNodes < 1 || numNodes > STMax)
+      {fprintf(stderr, "xrdcmssim: Node count must be 1 to %d\n", STMax);
+       Usage(1);
+      }
+   if (numClients < 1 || numFiles < 1 || numReqs < 1 || nodeCap < 1
+   ||  holdTime < 0 || numReps < 1 || numReps > numNodes || zipfExp < 0.0)
+      {fprintf(stderr, "xrdcmssim: Invalid option value\n"); Usage(1);}
+
+// The cmsd refuses to run as root and so must we
+//
+   if (geteuid() == 0)
+      {fprintf(stderr, "xrdcmssim: Security reasons prohibit running as "
+                       "superuser.\n");
+       exit(2);
+      }
+
+// Generate or read the trace before anything else
+//
+   if (traceFN) {if (!ReadReqs(traceFN)) exit(1);}
+      else MakeReqs();
+
+// Each simulated node uses two file descriptors
+//
+   signal(SIGPIPE, SIG_IGN);
+   if (!getrlimit(RLIMIT_NOFILE, &rlim))
+      {rlim.rlim_cur = rlim.rlim_max;
+       setrlimit(RLIMIT_NOFILE, &rlim);
+      }
+
+// Create the work directory and the manager's configuration file. Any user
+// supplied configuration is appended so that it overrides our defaults.
+//
+   if (!mkdtemp(workDir))
+      {fprintf(stderr, "xrdcmssim: Unable to create work directory; %s\n",
+               strerror(errno));
+       exit(2);
+      }
+   snprintf(buff, sizeof(buff), "%s/cmsd.cf", workDir);
+   if (!(fP = fopen(buff, "w")))
+      {fprintf(stderr, "xrdcmssim: Unable to create %s; %s\n",
+               buff, strerror(errno));
+       exit(2);
+      }
+   fprintf(fP, "all.role manager\nall.export /\nall.adminpath %s\n"
+               "all.pidpath %s\ncms.delay startup 1\ncms.nbsendq off\n"
+               "cms.ping 1 log 0 usage 1\n", workDir, workDir);
+   if (cfgFN)
+      {FILE *cP = fopen(cfgFN, "r");
+       if (!cP)
+          {fprintf(stderr, "xrdcmssim: Unable to open %s; %s\n",
+                   cfgFN, strerror(errno));
+           exit(2);
+          }
+       while((n = fread(buff, 1, sizeof(buff), cP)) > 0) fwrite(buff,1,n,fP);
+       fclose(cP);
+      }
+   fclose(fP);
+
+// Route all of the cmsd's messages to the log file
+//
+   Logger = new XrdSysLogger(dup(STDERR_FILENO), 0);
+   if (!logFN) {snprintf(buff, sizeof(buff), "%s/cmsd.log", workDir);
+                logFN = strdup(buff);
+               }
+   if (Logger->Bind(logFN, 0) < 0)
+      {fprintf(stderr, "xrdcmssim: Unable to log to %s\n", logFN); exit(2);}
+   eDest.logger(Logger);
+   fprintf(stderr, "xrdcmssim: Logging to %s\n", logFN);
+
+// Set up the xrd services the cmsd expects
+//
+   XrdScheduler *schedP = new XrdScheduler(&eDest, &simTrace, 8, 4096, 60);
+   XrdInet      *netP   = new XrdInet(&eDest, &simTrace);
+   schedP->Start();
+   if (netP->Bind(0, "tcp"))
+      {fprintf(stderr, "xrdcmssim: Unable to bind the manager port\n");
+       exit(2);
+      }
+   XrdLink::Init(&eDest, &simTrace, schedP);
+   XrdLink::Init(netP);
+   XrdLink::Setup(static_cast<int>(rlim.rlim_cur), 0);
+
+// Configure the cmsd, exporting the environment the xrd driver would have
+//
+   XrdOucEnv::Export("XRDINSTANCE", "cmsd anon@localhost");
+   XrdOucEnv::Export("XRDHOST", "localhost");
+   XrdOucEnv::Export("XRDNAME", "anon");
+   XrdOucEnv::Export("XRDPROG", "cmsd");
+   snprintf(buff, sizeof(buff), "%s/cmsd.cf", workDir);
+   pi.eDest    = &eDest;   pi.NetTCP   = netP;      pi.BPool    = 0;
+   pi.Sched    = schedP;   pi.Stats    = 0;         pi.theEnv   = 0;
+   pi.Trace    = &simTrace;
+   pi.ConfigFN = strdup(buff);
+   pi.Format   = 0;        pi.Port     = netP->Port(); pi.WSize = 0;
+   pi.AdmPath  = workDir;  pi.AdmMode  = 0700;
+   pi.myInst   = "anon";   pi.myName   = "localhost";  pi.myProg = "cmsd";
+   pi.urAddr   = 0;
+   pi.ConnMax  = static_cast<int>(rlim.rlim_cur);
+   pi.readWait = 1000;     pi.idleWait = 0;
+   pi.argc     = 1;        pi.argv     = pArgv;     pi.DebugON  = Debug;
+   pi.WANPort  = 0;        pi.WANWSize = 0;         pi.hailWait = 30000;
+
+   if (XrdgetProtocolPort("cmsd", 0, &pi) <= 0
+   ||  !(Matcher = XrdgetProtocol("cmsd", 0, &pi)))
+      {fprintf(stderr, "xrdcmssim: cmsd configuration failed; see %s\n",logFN);
+       exit(2);
+      }
+
+// Create the listener used to make the loopback connections
+//
+   struct sockaddr_in sa;
+   memset(&sa, 0, sizeof(sa));
+   sa.sin_family      = AF_INET;
+   sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   if ((lsFD = socket(AF_INET, SOCK_STREAM, 0)) < 0
+   ||  bind(lsFD, (struct sockaddr *)&sa, sizeof(sa)) || listen(lsFD, 64))
+      {fprintf(stderr, "xrdcmssim: Unable to listen; %s\n", strerror(errno));
+       exit(2);
+      }
+
+// Start the simulated data servers and wait for them to log in
+//
+   XrdLink *mLink, *sLink;
+   Nodes = new SimNode *[numNodes];
+   for (int i = 0; i < numNodes; i++)
+       {if (!MakePair(lsFD, mLink, sLink))
+           {fprintf(stderr, "xrdcmssim: Unable to connect node %d; %s\n",
+                    i, strerror(errno));
+            exit(2);
+           }
+        Nodes[i] = new SimNode(sLink, i, nodeCap);
+        if (XrdSysThread::Run(&tid, Serve, mLink, 0, "cms link")
+        ||  XrdSysThread::Run(&tid, NodeRun, Nodes[i], 0, "sim node"))
+           {fprintf(stderr, "xrdcmssim: Unable to start node %d\n", i);
+            exit(2);
+           }
+       }
+   for (int i = 0; i < numNodes; i++) loginSem.Wait();
+   for (int i = 0; i < numNodes; i++)
+       if (Nodes[i]->Num < 0)
+          {fprintf(stderr, "xrdcmssim: Node %d failed to log in; see %s\n",
+                   i, logFN);
+           exit(3);
+          }
+
+// Now log in the redirector
+//
+   CmsLoginData Data;
+   if (!MakePair(lsFD, mLink, rdrLink)
+   ||  XrdSysThread::Run(&tid, Serve, mLink, 0, "cms link"))
+      {fprintf(stderr, "xrdcmssim: Unable to connect the redirector\n");
+       exit(2);
+      }
+   memset(&Data, 0, sizeof(Data));
+   Data.Version  = kYR_Version;
+   Data.Mode     = CmsLoginData::kYR_director;
+   Data.HoldTime = static_cast<int>(getpid());
+   n = XrdCmsLogin::Login(rdrLink, Data, 30000);
+   if (Data.SID)    free(Data.SID);
+   if (Data.envCGI) free(Data.envCGI);
+   if (n)
+      {fprintf(stderr, "xrdcmssim: Redirector failed to log in; see %s\n",
+               logFN);
+       exit(3);
+      }
+   Slots = new SimSlot[numClients];
+   XrdSysThread::Run(&tid, RdrReader, 0, 0, "sim reader");
+   XrdSysThread::Run(&tid, Closer,    0, 0, "sim closer");
+
+// Wait for the manager to enable service and the first load reports to arrive
+//
+   XrdSysTimer::Snooze(Config.SRVDelay + 2);
+
+// Replay the trace
+//
+   tBeg = Now();
+   for (long i = 0; i < numClients; i++)
+       if (XrdSysThread::Run(&tid, Client, reinterpret_cast<void *>(i),
+                             0, "sim client"))
+          {fprintf(stderr, "xrdcmssim: Unable to start client %ld\n", i);
+           exit(2);
+          }
+   for (int i = 0; i < numClients; i++) doneSem.Wait();
+
+// Report and exit without tearing down the cmsd
+//
+   Report((Now() - tBeg)/1000000.0);
+   fflush(stdout);
+   _exit(0);
+}
@@ -0,0 +1,300 @@
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d C m s S u m m a r i z e r . c c                    */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                        Author: agent <agent@local>                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <netinet/in.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "XProtocol/YProtocol.hh"
+
+#include "XrdCms/XrdCmsConfig.hh"
+#include "XrdCms/XrdCmsManager.hh"
+#include "XrdCms/XrdCmsPList.hh"
+#include "XrdCms/XrdCmsSummary.hh"
+#include "XrdCms/XrdCmsTrace.hh"
+#include "XrdCms/XrdCmsTypes.hh"
+
+#include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysPlatform.hh"
+
+using namespace XrdCms;
+
+/******************************************************************************/
+/*                        G l o b a l   O b j e c t s                         */
+/******************************************************************************/
+
+XrdCmsSummarizer XrdCms::Summarizer;
+
+/******************************************************************************/
+/*            E x t e r n a l   T h r e a d   I n t e r f a c e s             */
+/******************************************************************************/
+  
+void *XrdCmsStartSummarizer(void *carg)
+     {XrdCmsSummarizer *mySumm = (XrdCmsSummarizer *)carg;
+      return mySumm->Start();
+     }
+
+/******************************************************************************/
+/*                                 A d d e d                                  */
+/******************************************************************************/
+  
+void XrdCmsSummarizer::Added(const char *path)
+{
+   if (!sumEvery) return;
+
+   sumMutex.Lock();
+   if (curSum) curSum->Add(path);
+   if (newSum) newSum->Add(path);
+   sumMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+  
+bool XrdCmsSummarizer::Init(int lgbits, int hashes, int every, bool resolve)
+{
+   pthread_t tid;
+
+// Record the parameters
+//
+   sumLgBits = lgbits;
+   sumHashes = hashes;
+   sumEvery  = every;
+   sumResolve= resolve;
+
+// Start the summary thread
+//
+   if (XrdSysThread::Run(&tid, XrdCmsStartSummarizer, (void *)this,
+                            0, "Namespace summary"))
+      {Say.Emsg("Summary", errno, "start namespace summary thread");
+       return false;
+      }
+   return true;
+}
+
+/******************************************************************************/
+/*                                R e s e n d                                 */
+/******************************************************************************/
+  
+void XrdCmsSummarizer::Resend()
+{
+   if (!sumEvery) return;
+
+   myCond.Lock();
+   doSend = true;
+   myCond.Signal();
+   myCond.UnLock();
+}
+
+/******************************************************************************/
+/*                                 S t a r t                                  */
+/******************************************************************************/
+  
+void *XrdCmsSummarizer::Start()
+{
+   XrdCmsSummary *sP, *oldSum;
+   time_t tNext;
+   int    tWait;
+   bool   isOK;
+
+// Build the summary, send it, and wait until it is time to rebuild it. We
+// resend the summary whenever asked to do so in the meantime.
+//
+   do {sP = new XrdCmsSummary(sumLgBits, sumHashes, ++myGen);
+       sumMutex.Lock(); newSum = sP; sumMutex.UnLock();
+       isOK = Build(sP);
+       sumMutex.Lock();
+       newSum = 0;
+       if (isOK) {oldSum = curSum; curSum = sP;}
+          else    oldSum = sP;
+       sumMutex.UnLock();
+       delete oldSum;
+       if (curSum) Send(curSum);
+
+       tNext = time(0) + sumEvery;
+       myCond.Lock();
+       while((tWait = tNext - time(0)) > 0)
+            {if (!doSend) myCond.Wait(tWait);
+             if (doSend)
+                {doSend = false;
+                 myCond.UnLock();
+                 if (curSum) Send(curSum);
+                 myCond.Lock();
+                }
+            }
+       doSend = false;
+       myCond.UnLock();
+      } while(1);
+
+// Keep the compiler happy
+//
+   return (void *)0;
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                 B u i l d                                  */
+/******************************************************************************/
+  
+bool XrdCmsSummarizer::Build(XrdCmsSummary *sP)
+{
+   XrdCmsPList *pP = Config.PathList.First();
+   char  path[XrdCmsMAX_PATH_LEN+1];
+   int   plen;
+   time_t tBeg = time(0);
+   bool  isOK = true;
+
+// Scan each exported path. If nothing was exported, everything was.
+//
+   do {if (!pP) *path = '\0';
+          else if (strlcpy(path, pP->Path(), sizeof(path)) >= sizeof(path))
+                  continue;
+       plen = strlen(path);
+       while(plen && path[plen-1] == '/') path[--plen] = '\0';
+       if (plen) sP->Add(path);
+       if (!(isOK = Scan(sP, path, plen, 0))) break;
+      } while(pP && (pP = pP->Next()));
+
+// Document what happened
+//
+   if (isOK)
+      {char buff[80];
+       snprintf(buff, sizeof(buff), "%d built in %d seconds.", sP->Gen(),
+                static_cast<int>(time(0) - tBeg));
+       Say.Emsg("Summary", "Namespace summary", buff);
+      } else Say.Emsg("Summary", "Namespace summary not built; "
+                                 "managers will keep querying this server.");
+   return isOK;
+}
+
+/******************************************************************************/
+/*                                  S c a n                                   */
+/******************************************************************************/
+
+// Add every entry in the directory to the summary and descend into
+// subdirectories. Directories are included as servers also say they have them.
+// Any error makes the summary incomplete and it must then not be used.
+  
+bool XrdCmsSummarizer::Scan(XrdCmsSummary *sP, char *path, int plen, int depth)
+{
+   static const int maxDepth = 255;
+   XrdOucEnv  myEnv;
+   XrdOssDF  *dP;
+   struct stat Stat;
+   char  ename[XrdCmsMAX_PATH_LEN];
+   int   rc, elen;
+   bool  isOK = true;
+
+// Avoid symlink loops
+//
+   if (depth > maxDepth)
+      {Say.Emsg("Summary", "Directory tree too deep at", path);
+       return false;
+      }
+
+// Open the directory. A missing export is simply empty.
+//
+   dP = Config.ossFS->newDir("cms");
+   if ((rc = dP->Opendir((plen ? path : "/"), myEnv)))
+      {delete dP;
+       if (rc == -ENOENT && !depth) return true;
+       Say.Emsg("Summary", rc, "open directory", (plen ? path : "/"));
+       return false;
+      }
+
+// Process each entry
+//
+   path[plen] = '/';
+   while(!(rc = dP->Readdir(ename, sizeof(ename))) && *ename)
+        {if (*ename == '.' && (!ename[1] || (ename[1] == '.' && !ename[2])))
+            continue;
+         elen = strlen(ename);
+         if (plen + 1 + elen > XrdCmsMAX_PATH_LEN) continue;
+         strcpy(path+plen+1, ename);
+         sP->Add(path);
+         if (!Config.ossFS->Stat(path, &Stat, XRDOSS_resonly)
+         &&  S_ISDIR(Stat.st_mode)
+         &&  !(isOK = Scan(sP, path, plen+1+elen, depth+1))) break;
+        }
+   path[plen] = '\0';
+
+// Check how we ended
+//
+   if (rc)
+      {Say.Emsg("Summary", rc, "read directory", (plen ? path : "/"));
+       isOK = false;
+      }
+   dP->Close();
+   delete dP;
+   return isOK;
+}
+
+/******************************************************************************/
+/*                                  S e n d                                   */
+/******************************************************************************/
+  
+void XrdCmsSummarizer::Send(XrdCmsSummary *sP)
+{
+   static const int hLen = sizeof(CmsSummaryRequest) - sizeof(CmsRRHdr);
+   CmsSummaryRequest Req;
+   struct iovec ioV[2];
+   const char *data = sP->Data();
+   int dlen, offs, size = sP->Size();
+
+// Send the summary in pieces small enough for any manager to accept. Only
+// managers that accept summaries get them (see XrdCmsManager::Summary).
+//
+   memset(&Req, 0, sizeof(Req));
+   Req.Hdr.rrCode   = kYR_summary;
+   Req.Hdr.modifier = kYR_raw;
+   Req.Gen          = htonl(sP->Gen());
+   Req.lgBits       = static_cast<kXR_char>(sP->lgBits());
+   Req.Hashes       = static_cast<kXR_char>(sP->Hashes());
+   Req.Flags        = (sumResolve ? CmsSummaryRequest::kYR_resolve : 0);
+
+   for (offs = 0; offs < size; offs += dlen)
+       {if ((dlen = size - offs) > CmsSummaryRequest::MaxData)
+           dlen = CmsSummaryRequest::MaxData;
+        Req.Hdr.datalen = htons(static_cast<unsigned short>(hLen + dlen));
+        Req.Offset      = htonl(offs);
+        ioV[0].iov_base = (char *)&Req;         ioV[0].iov_len = sizeof(Req);
+        ioV[1].iov_base = (char *)(data+offs);  ioV[1].iov_len = dlen;
+        XrdCmsManager::Summary(ioV, 2, sizeof(Req)+dlen);
+       }
+}
@@ -0,0 +1,142 @@
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d C m s S u m m a r y . c c                       */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                        Author: agent <agent@local>                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <string.h>
+
+#include "XrdCms/XrdCmsSummary.hh"
+
+/******************************************************************************/
+/*           X r d C m s S u m m a r y   C l a s s   M e t h o d s            */
+/******************************************************************************/
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+  
+XrdCmsSummary::XrdCmsSummary(int lgbits, int hashes, unsigned int gen)
+{
+   if (lgbits < minLgBits) lgbits = minLgBits;
+      else if (lgbits > maxLgBits) lgbits = maxLgBits;
+   if (hashes < 1) hashes = 1;
+      else if (hashes > maxHashes) hashes = maxHashes;
+
+   mapLgBits = lgbits;
+   numHash   = hashes;
+   myGen     = gen;
+   mapSize   = 1 << (lgbits-3);
+   mapFill   = 0;
+   bitMask   = (1U << lgbits) - 1;
+   bitMap    = new unsigned char[mapSize];
+   memset(bitMap, 0, mapSize);
+}
+
+/******************************************************************************/
+/*                                   A d d                                    */
+/******************************************************************************/
+  
+void XrdCmsSummary::Add(const char *path)
+{
+   unsigned int h1, h2, bit;
+
+// Set the bits for the path. The bytes are or'd atomically as other threads
+// may be setting bits in the same byte.
+//
+   Hash(path, h1, h2);
+   for (int i = 0; i < numHash; i++)
+       {bit = (h1 + i*h2) & bitMask;
+        __sync_fetch_and_or(&bitMap[bit >> 3],
+                            static_cast<unsigned char>(1 << (bit & 7)));
+       }
+}
+
+/******************************************************************************/
+/*                                   H a s                                    */
+/******************************************************************************/
+  
+bool XrdCmsSummary::Has(const char *path)
+{
+   unsigned int h1, h2;
+
+   Hash(path, h1, h2);
+   return Has(h1, h2);
+}
+
+bool XrdCmsSummary::Has(unsigned int h1, unsigned int h2)
+{
+   unsigned int bit;
+
+   for (int i = 0; i < numHash; i++)
+       {bit = (h1 + i*h2) & bitMask;
+        if (!(bitMap[bit >> 3] & (1 << (bit & 7)))) return false;
+       }
+   return true;
+}
+
+/******************************************************************************/
+/*                                   S e t                                    */
+/******************************************************************************/
+  
+bool XrdCmsSummary::Set(int offset, const char *data, int dlen)
+{
+
+// Pieces must arrive in order and fit. They are merged so that paths added
+// while the summary is being received are not lost.
+//
+   if (offset != mapFill || dlen < 0 || dlen > mapSize - mapFill) return false;
+
+   for (int i = 0; i < dlen; i++) bitMap[offset+i] |= data[i];
+   mapFill += dlen;
+   return true;
+}
+
+/******************************************************************************/
+/*                                  H a s h                                   */
+/******************************************************************************/
+
+// The server and the manager must agree on the hash of a path however it was
+// spelled, so repeated slashes are treated as one and a trailing slash is
+// ignored. Two hash values are derived from a 64-bit FNV-1a hash and combined
+// to produce the bit positions (Kirsch-Mitzenmacher double hashing).
+  
+void XrdCmsSummary::Hash(const char *path, unsigned int &h1, unsigned int &h2)
+{
+   unsigned long long hv = 0xcbf29ce484222325ULL;
+   const char *pP = path;
+
+   while(*pP)
+        {if (*pP == '/')
+            {while(*(pP+1) == '/') pP++;
+             if (!*(pP+1) && pP != path) break;
+            }
+         hv ^= static_cast<unsigned char>(*pP++);
+         hv *= 0x100000001b3ULL;
+        }
+
+   h1 = static_cast<unsigned int>(hv);
+   h2 = static_cast<unsigned int>(hv >> 32) | 1;
+}
@@ -0,0 +1,156 @@
+#ifndef __XRDCMSSUMMARY_HH__
+#define __XRDCMSSUMMARY_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d C m s S u m m a r y . h h                       */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                        Author: agent <agent@local>                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                   C l a s s   X r d C m s S u m m a r y                    */
+/******************************************************************************/
+  
+// The XrdCmsSummary object is a Bloom filter of the paths a server has. A
+// server builds one from its namespace and sends it to its managers which use
+// it to avoid asking the server about files it certainly does not have. Paths
+// are only ever added; removed files linger until the summary is rebuilt which
+// only costs an unneeded query.
+//
+class XrdCmsSummary
+{
+public:
+
+// Add() records a path. It may be called concurrently with Add() and Has().
+//
+void           Add(const char *path);
+
+// Has() returns false if the path is certainly not in the summary and true
+//       if it may be.
+//
+bool           Has(const char *path);
+
+// The second form takes the hash of the path (see Hash()) which does not
+// depend on the summary, so many summaries can be checked hashing only once.
+//
+bool           Has(unsigned int h1, unsigned int h2);
+
+// Hash() returns the hash of a path as used by Add() and Has().
+//
+static void    Hash(const char *path, unsigned int &h1, unsigned int &h2);
+
+// Set() copies a piece of a summary sent by a server. It returns false if the
+//       piece does not fit and true if it does. Done() is true once the
+//       summary has been completely received.
+//
+bool           Set(int offset, const char *data, int dlen);
+
+inline bool    Done() {return mapFill == mapSize;}
+
+inline const
+char          *Data()   {return (const char *)bitMap;}
+inline int     Size()   {return mapSize;}
+inline int     lgBits() {return mapLgBits;}
+inline int     Hashes() {return numHash;}
+inline unsigned int Gen() {return myGen;}
+
+static const int minLgBits = 13;   // 1KB summary
+static const int maxLgBits = 26;   // 8MB summary
+static const int maxHashes = 16;
+
+               XrdCmsSummary(int lgbits, int hashes, unsigned int gen=0);
+              ~XrdCmsSummary() {delete [] bitMap;}
+
+private:
+
+unsigned char *bitMap;
+unsigned int   bitMask;
+unsigned int   myGen;
+int            mapSize;
+int            mapFill;
+int            mapLgBits;
+int            numHash;
+};
+
+/******************************************************************************/
+/*                C l a s s   X r d C m s S u m m a r i z e r                 */
+/******************************************************************************/
+
+// The XrdCmsSummarizer runs on a data server. It periodically rebuilds the
+// summary of the exported namespace via the oss plugin and sends it to all of
+// our managers. Files added in the meantime are folded into the summary as the
+// local xrootd reports them (our managers learn of them via the have message).
+//
+class XrdCmsSummarizer
+{
+public:
+
+// Added() records a new file in the summary being built and the one sent.
+//         It and Resend() do nothing unless Init() was called.
+//
+void   Added(const char *path);
+
+// Init() starts the summary thread. It returns true on success. When resolve
+//        is true our managers may take the summary's word that we do not
+//        have a file.
+//
+bool   Init(int lgbits, int hashes, int every, bool resolve=false);
+
+// Resend() asks for the current summary to be sent again (e.g. upon login).
+//
+void   Resend();
+
+void  *Start();
+
+       XrdCmsSummarizer() : myCond(0), curSum(0), newSum(0), myGen(0),
+                            doSend(false), sumResolve(false), sumLgBits(0),
+                            sumHashes(0), sumEvery(0) {}
+      ~XrdCmsSummarizer() {}   // Never gets deleted
+
+private:
+
+bool   Build(XrdCmsSummary *sP);
+bool   Scan(XrdCmsSummary *sP, char *path, int plen, int depth);
+void   Send(XrdCmsSummary *sP);
+
+XrdSysMutex    sumMutex;    // Protects curSum and newSum
+XrdSysCondVar  myCond;      // Protects doSend
+XrdCmsSummary *curSum;      // The summary last built
+XrdCmsSummary *newSum;      // The summary being built
+unsigned int   myGen;
+bool           doSend;
+bool           sumResolve;
+int            sumLgBits;
+int            sumHashes;
+int            sumEvery;
+};
+
+namespace XrdCms
+{
+extern    XrdCmsSummarizer Summarizer;
+}
+#endif
@@ -30,13 +30,28 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
   
+#include "XrdCms/XrdCmsSMask.hh"
+
+// The following defines our cell size (maximum subscribers). It may be raised
+// at build time to 128, 256, 512, or 1024 using -DXRDCMS_STMAX=<n>, in which
+// case the server mask becomes a multi-word bit vector instead of an integer.
+//
+#ifndef XRDCMS_STMAX
+#define XRDCMS_STMAX 64
+#endif
+
+#if XRDCMS_STMAX == 64
 typedef unsigned long long SMask_t;
+#elif XRDCMS_STMAX == 128 || XRDCMS_STMAX == 256 || XRDCMS_STMAX == 512 \
+   || XRDCMS_STMAX == 1024
+typedef XrdCmsSMask<XRDCMS_STMAX> SMask_t;
+#else
+#error XRDCMS_STMAX must be 64, 128, 256, 512, or 1024
+#endif
 
-#define FULLMASK 0xFFFFFFFFFFFFFFFFULL
+#define FULLMASK (~SMask_t(0))
 
-// The following defines our cell size (maximum subscribers)
-//
-#define STMax 64
+#define STMax XRDCMS_STMAX
 
 // The following defines the maximum number of redirectors. It is one greater
 // than the actual maximum as the zeroth is never used.
@@ -23,12 +23,7 @@ target_link_libraries(
 #-------------------------------------------------------------------------------
 # cmsd
 #-------------------------------------------------------------------------------
-add_executable(
-  cmsd
-  Xrd/XrdConfig.cc                Xrd/XrdConfig.hh
-  Xrd/XrdProtLoad.cc              Xrd/XrdProtLoad.hh
-  Xrd/XrdStats.cc                 Xrd/XrdStats.hh
-  Xrd/XrdMain.cc
+set( XRD_CMSD_SOURCES
   XrdCms/XrdCmsAdmin.cc           XrdCms/XrdCmsAdmin.hh
   XrdCms/XrdCmsBaseFS.cc          XrdCms/XrdCmsBaseFS.hh
   XrdCms/XrdCmsCache.cc           XrdCms/XrdCmsCache.hh
@@ -43,6 +38,7 @@ add_executable(
   XrdCms/XrdCmsMeter.cc           XrdCms/XrdCmsMeter.hh
   XrdCms/XrdCmsNash.cc            XrdCms/XrdCmsNash.hh
   XrdCms/XrdCmsNode.cc            XrdCms/XrdCmsNode.hh
+  XrdCms/XrdCmsNotify.cc          XrdCms/XrdCmsNotify.hh
   XrdCms/XrdCmsPList.cc           XrdCms/XrdCmsPList.hh
   XrdCms/XrdCmsPrepare.cc         XrdCms/XrdCmsPrepare.hh
   XrdCms/XrdCmsPrepArgs.cc        XrdCms/XrdCmsPrepArgs.hh
@@ -50,9 +46,21 @@ add_executable(
   XrdCms/XrdCmsRouting.cc         XrdCms/XrdCmsRouting.hh
   XrdCms/XrdCmsRRQ.cc             XrdCms/XrdCmsRRQ.hh
                                   XrdCms/XrdCmsSelect.hh
+  XrdCms/XrdCmsSelVec.cc          XrdCms/XrdCmsSelVec.hh
   XrdCms/XrdCmsState.cc           XrdCms/XrdCmsState.hh
+  XrdCms/XrdCmsSummary.cc         XrdCms/XrdCmsSummary.hh
+  XrdCms/XrdCmsSummarizer.cc
   XrdCms/XrdCmsSupervisor.cc      XrdCms/XrdCmsSupervisor.hh
                                   XrdCms/XrdCmsTrace.hh )
+
+add_executable(
+  cmsd
+  Xrd/XrdConfig.cc                Xrd/XrdConfig.hh
+  Xrd/XrdProtLoad.cc              Xrd/XrdProtLoad.hh
+  Xrd/XrdStats.cc                 Xrd/XrdStats.hh
+  Xrd/XrdMain.cc
+  ${XRD_CMSD_SOURCES} )
+
 target_link_libraries(
   cmsd
   XrdServer
@@ -61,6 +69,23 @@ target_link_libraries(
   ${EXTRA_LIBS}
   ${SOCKET_LIBRARY} )
 
+#-------------------------------------------------------------------------------
+# xrdcmssim (cluster manager simulator, not installed, built on request only
+# with 'make xrdcmssim' as it compiles the cmsd sources once more)
+#-------------------------------------------------------------------------------
+add_executable(
+  xrdcmssim EXCLUDE_FROM_ALL
+  XrdCms/XrdCmsSim.cc
+  ${XRD_CMSD_SOURCES} )
+
+target_link_libraries(
+  xrdcmssim
+  XrdServer
+  XrdUtils
+  pthread
+  ${EXTRA_LIBS}
+  ${SOCKET_LIBRARY} )
+
 #-------------------------------------------------------------------------------
 # Install
 #-------------------------------------------------------------------------------
@@ -19,8 +19,10 @@ add_library(
   XrdFileCache/XrdFileCache.cc              XrdFileCache/XrdFileCache.hh
   XrdFileCache/XrdFileCacheConfiguration.cc
   XrdFileCache/XrdFileCachePurge.cc
+  XrdFileCache/XrdFileCachePrestage.cc
   XrdFileCache/XrdFileCacheFile.cc          XrdFileCache/XrdFileCacheFile.hh
   XrdFileCache/XrdFileCacheVRead.cc
+  XrdFileCache/XrdFileCacheDedup.cc         XrdFileCache/XrdFileCacheDedup.hh
   XrdFileCache/XrdFileCacheStats.hh
   XrdFileCache/XrdFileCacheInfo.cc          XrdFileCache/XrdFileCacheInfo.hh
   XrdFileCache/XrdFileCacheIO.cc            XrdFileCache/XrdFileCacheIO.hh
@@ -35,6 +35,7 @@
 #include "XrdFileCacheInfo.hh"
 #include "XrdFileCacheIOEntireFile.hh"
 #include "XrdFileCacheIOFileBlock.hh"
+#include "XrdFileCacheDedup.hh"
 
 using namespace XrdFileCache;
 
@@ -56,6 +57,20 @@ void *ProcessWriteTaskThread(void* c)
    return NULL;
 }
 
+void *ProcessUploadTaskThread(void* c)
+{
+   Cache *cache = static_cast<Cache*>(c);
+   cache->ProcessUploadTasks();
+   return NULL;
+}
+
+void *ProcessStageThread(void* c)
+{
+   Cache *cache = static_cast<Cache*>(c);
+   cache->ProcessStageRequests();
+   return NULL;
+}
+
 void *PrefetchThread(void* ptr)
 {
    Cache* cache = static_cast<Cache*>(ptr);
@@ -86,6 +101,18 @@ XrdOucCache2 *XrdOucGetCache2(XrdSysLogger *logger,
    pthread_t tid2;
    XrdSysThread::Run(&tid2, PrefetchThread, (void*)(&factory), 0, "XrdFileCache Prefetch ");
 
+   if (factory.RefConfiguration().m_write_mode == Configuration::kWriteBack)
+   {
+      pthread_t tid3;
+      XrdSysThread::Run(&tid3, ProcessUploadTaskThread, (void*)(&factory), 0, "XrdFileCache Uploads ");
+   }
+
+   for (int i = 0; i < factory.RefConfiguration().m_stage_threads; ++i)
+   {
+      pthread_t tid4;
+      XrdSysThread::Run(&tid4, ProcessStageThread, (void*)(&factory), 0, "XrdFileCache Prestage ");
+   }
+
    pthread_t tid;
    XrdSysThread::Run(&tid, CacheDirCleanupThread, NULL, 0, "XrdFileCache CacheDirCleanup");
    
@@ -146,9 +173,12 @@ Cache::Cache() : XrdOucCache(),
    m_log(0, "XrdFileCache_"),
    m_trace(0),
    m_traceID("Manager"),
+   m_dedup(0),
    m_prefetch_condVar(0),
    m_RAMblocks_used(0),
-   m_isClient(false)
+   m_isClient(false),
+   m_stage_condVar(0),
+   m_stage_bw_next(0)
 {
    m_trace = new XrdSysTrace("XrdFileCache");
    // default log level is Warning
@@ -159,14 +189,42 @@ Cache::Cache() : XrdOucCache(),
 
 XrdOucCacheIO2 *Cache::Attach(XrdOucCacheIO2 *io, int Options)
 {
+   // Files opened for update are cached only when they are created through
+   // the proxy and write caching is enabled, otherwise writes go to origin.
+   const bool writable = (Options & XrdOucCache::optRW) != 0;
+   if (writable)
+   {
+      if (m_configuration.m_write_mode == Configuration::kWriteOff || m_configuration.m_hdfsmode ||
+          (Options & XrdOucCache::optNEW) != XrdOucCache::optNEW)
+      {
+         TRACE(Info, "Cache::Attach() writable file passed to origin " << io->Path());
+         return io;
+      }
+   }
+
    if (Cache::GetInstance().Decide(io))
    {
+      if (writable && ! PrepareNewFile(io->Path()))
+      {
+         TRACE(Info, "Cache::Attach() new file is in use, passed to origin " << io->Path());
+         return io;
+      }
+
       TRACE(Info, "Cache::Attach() " << io->Path());
       IO* cio;
       if (Cache::GetInstance().RefConfiguration().m_hdfsmode)
          cio = new IOFileBlock(io, m_stats, *this);
       else
-         cio = new IOEntireFile(io, m_stats, *this);
+      {
+         IOEntireFile *eio = new IOEntireFile(io, m_stats, *this, writable);
+         if ( ! eio->HasFile())
+         {
+            TRACE(Info, "Cache::Attach() file not available in cache, passed to origin " << io->Path());
+            eio->Detach();
+            return io;
+         }
+         cio = eio;
+      }
 
       TRACE_PC(Debug, const char* loc = io->Location(),
                "Cache::Attach() " << io->Path() << " location: " <<
@@ -247,6 +305,53 @@ Cache::ProcessWriteTasks()
    }
 }
 
+//______________________________________________________________________________
+bool Cache::PrepareNewFile(const char *url)
+{
+   // Remove stale data and info files of a file that is being recreated.
+
+   XrdCl::URL xx(url);
+   std::string path = xx.GetPath();
+
+   if (HaveActiveFileWithLocalPath(path)) return false;
+
+   std::string ifn = path + Info::m_infoExtension;
+   m_output_fs->Unlink(ifn.c_str());
+   m_output_fs->Unlink(path.c_str());
+   if (m_dedup) m_dedup->ReleaseFile(path);
+   return true;
+}
+
+//______________________________________________________________________________
+void
+Cache::AddUploadTask(File* f)
+{
+   TRACE(Dump, "Cache::AddUploadTask() " << f->lPath());
+   m_uploadQ.condVar.Lock();
+   m_uploadQ.queue.push_back(f);
+   m_uploadQ.condVar.Signal();
+   m_uploadQ.condVar.UnLock();
+}
+
+//______________________________________________________________________________
+void
+Cache::ProcessUploadTasks()
+{
+   while (true)
+   {
+      m_uploadQ.condVar.Lock();
+      while (m_uploadQ.queue.empty())
+      {
+         m_uploadQ.condVar.Wait();
+      }
+      File* file = m_uploadQ.queue.front();
+      m_uploadQ.queue.pop_front();
+      m_uploadQ.condVar.UnLock();
+
+      file->Upload();
+   }
+}
+
 //______________________________________________________________________________
 
 bool
@@ -271,7 +376,8 @@ Cache::RAMBlockReleased()
 
 //______________________________________________________________________________
 
-File* Cache::GetFile(const std::string& path, IO* iIO, long long off, long long filesize)
+File* Cache::GetFile(const std::string& path, IO* iIO, long long off, long long filesize,
+                     bool writable, bool exclusive)
 {
    // Called from virtual IO::Attach
    
@@ -283,6 +389,14 @@ File* Cache::GetFile(const std::string& path, IO* iIO, long long off, long long
 
    if (it != m_active.end())
    {
+      // A file written through the cache is owned by its writer, the
+      // upload goes through the writer's input and must not be taken over.
+      if (writable || exclusive || it->second->IsWritable())
+      {
+         TRACE(Info, "Cache::GetFile file is active, not shared " << path);
+         return 0;
+      }
+
       IO* prevIO = it->second->SetIO(iIO);
       if (prevIO)
       {
@@ -309,6 +423,8 @@ File* Cache::GetFile(const std::string& path, IO* iIO, long long off, long long
       }
 
       File* file = new File(iIO, path, off, filesize);
+      if (writable)  file->EnableWrite();
+      if (exclusive) file->StopPrefetch();
       inc_ref_cnt(file, false);
       m_active[file->GetLocalPath()] = file;
       return file;
@@ -491,6 +607,9 @@ Cache::GetNextFileToPrefetch()
 int
 Cache::Prepare(const char *url, int oflags, mode_t mode)
 {
+   // Writes need the file open at origin.
+   if (oflags & (O_WRONLY | O_RDWR | O_CREAT | O_TRUNC)) return 0;
+
    std::string curl(url);
    XrdCl::URL xx(curl);
    std::string spath = xx.GetPath();
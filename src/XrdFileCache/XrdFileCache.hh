@@ -39,6 +39,7 @@ class Log;
 namespace XrdFileCache {
 class File;
 class IO;
+class DedupStore;
 }
 
 
@@ -49,6 +50,9 @@ namespace XrdFileCache
 //----------------------------------------------------------------------------
 struct Configuration
 {
+   //! Handling of files that are created or truncated through the proxy.
+   enum WriteMode_e { kWriteOff, kWriteThrough, kWriteBack };
+
    Configuration() :
       m_hdfsmode(false),
       m_data_space("public"),
@@ -61,7 +65,16 @@ struct Configuration
       m_NRamBuffers(-1),
       m_prefetch_max_blocks(10),
       m_hdfsbsize(128*1024*1024),
-      m_flushCnt(100)
+      m_flushCnt(100),
+      m_vread_merge(false),
+      m_vread_admit(0.5),
+      m_write_mode(kWriteOff),
+      m_write_retries(3),
+      m_write_timeout(300),
+      m_dedup(false),
+      m_dedup_store("/.pfc-dedup-store"),
+      m_stage_threads(0),
+      m_stage_bw(0)
    {}
 
    bool m_hdfsmode;                     //!< flag for enabling block-level operation
@@ -81,6 +94,19 @@ struct Configuration
 
    long long m_hdfsbsize;               //!< used with m_hdfsmode, default 128MB
    long long m_flushCnt;                //!< nuber of unsynced blcoks on disk before flush is called
+
+   bool      m_vread_merge;             //!< coalesce disk reads and pass sparse misses to origin in ReadV
+   double    m_vread_admit;             //!< min fraction of a missing block a readv must cover to cache it
+
+   WriteMode_e m_write_mode;            //!< write-through / write-back caching of new files
+   int         m_write_retries;         //!< number of upload attempts in write-back mode
+   int         m_write_timeout;         //!< max seconds sync waits for the upload in write-back mode
+
+   bool        m_dedup;                 //!< share identical blocks between data files
+   std::string m_dedup_store;           //!< path of the dedup block store
+
+   int         m_stage_threads;         //!< number of pre-stage threads, 0 disables pre-staging
+   long long   m_stage_bw;              //!< pre-stage bandwidth limit in bytes per second, 0 for none
 };
 
 struct TmpConfiguration
@@ -129,6 +155,15 @@ public:
    // virtual function of XrdOucCache2::Stat()
    virtual int  Stat(const char *url, struct stat &sbuff);
 
+   //---------------------------------------------------------------------
+   // virtual function of XrdOucCache2::Stage(). Queues a file or, with
+   // pfc.off and pfc.len cgi, a byte range for pre-staging.
+   virtual int  Stage(const char *url, int prty);
+
+   //---------------------------------------------------------------------
+   // virtual function of XrdOucCache2::StageStatus()
+   virtual int  StageStatus(const char *url, char *buff, int blen);
+
    //--------------------------------------------------------------------
    //! \brief Makes decision if the original XrdOucCacheIO should be cached.
    //!
@@ -199,14 +234,47 @@ public:
 
    XrdOss* GetOss() const { return m_output_fs; }
 
+   //---------------------------------------------------------------------
+   //! Block dedup store, null if deduplication is not enabled.
+   //---------------------------------------------------------------------
+   DedupStore* GetDedupStore() const { return m_dedup; }
+
    bool HaveActiveFileWithLocalPath(std::string);
+
+   //---------------------------------------------------------------------
+   //! Remove cached copy of a file that is being created through the cache.
+   //! Returns false if the file is currently active.
+   //---------------------------------------------------------------------
+   bool PrepareNewFile(const char *url);
    
-   File* GetFile(const std::string&, IO*, long long off = 0, long long filesize = 0);
+   //---------------------------------------------------------------------
+   //! Get the File for a path, taking it over from its current IO if it is
+   //! active. Returns 0 if the file is active and either side is writable or
+   //! exclusive is set. A File created with exclusive set does not prefetch
+   //! until another IO takes it over.
+   //---------------------------------------------------------------------
+   File* GetFile(const std::string&, IO*, long long off = 0, long long filesize = 0,
+                 bool writable = false, bool exclusive = false);
 
    void ReleaseFile(File*);
 
    void ScheduleFileSync(File* f) { schedule_file_sync(f, false); }
 
+   //---------------------------------------------------------------------
+   //! Queue file with dirty extents for upload to origin (write-back).
+   //---------------------------------------------------------------------
+   void AddUploadTask(File* f);
+
+   //---------------------------------------------------------------------
+   //! Separate task which uploads write-back data to origin.
+   //---------------------------------------------------------------------
+   void ProcessUploadTasks();
+
+   //---------------------------------------------------------------------
+   //! Separate task which downloads pre-stage requests.
+   //---------------------------------------------------------------------
+   void ProcessStageRequests();
+
    void FileSyncDone(File*);
    
    XrdSysTrace* GetTrace() { return m_trace; }
@@ -217,6 +285,19 @@ private:
    bool xdlib(XrdOucStream &);
    bool xtrace(XrdOucStream &);
 
+   struct StageRequest
+   {
+      std::string m_url;              //!< origin url without staging cgi
+      std::string m_lpath;            //!< local path
+      long long   m_off;              //!< start of range
+      long long   m_len;              //!< length of range, <= 0 to end of file
+   };
+
+   int  StageFile(const StageRequest &req);
+   void StagePace(long long bytes);
+   void StageDetach(IO *cio);
+   void StageReap();
+
    static Cache     *m_factory;         //!< this object
    static 
    XrdScheduler     *schedP;
@@ -227,6 +308,7 @@ private:
 
    XrdOucCacheStats  m_stats;           //!<
    XrdOss           *m_output_fs;       //!< disk cache file system
+   DedupStore       *m_dedup;           //!< block dedup store
 
    std::vector<XrdFileCache::Decision*> m_decisionpoints;       //!< decision plugins
 
@@ -250,6 +332,36 @@ private:
 
    WriteQ m_writeQ;
 
+   struct UploadQ
+   {
+      UploadQ() : condVar(0) {}
+      XrdSysCondVar     condVar;      //!< upload list condVar
+      std::list<File*>  queue;        //!< files with dirty extents
+   };
+
+   UploadQ m_uploadQ;
+
+   struct StageState
+   {
+      enum State_e { kQueued, kActive, kDone, kFailed };
+
+      StageState() : m_state(kQueued), m_bytes(0), m_size(-1), m_errno(0), m_time(0) {}
+      State_e   m_state;
+      long long m_bytes;              //!< bytes of the range present in cache
+      long long m_size;               //!< size of the range, -1 until known
+      int       m_errno;              //!< error of a failed request
+      time_t    m_time;               //!< time of last state change
+   };
+
+   static const int s_stage_nprty = 4;
+
+   XrdSysCondVar                      m_stage_condVar;           //!< lock for pre-stage queues and states
+   std::list<StageRequest>            m_stageQ[s_stage_nprty];   //!< pre-stage queues, by priority
+   std::map<std::string, StageState>  m_stage_state;             //!< pre-stage state by local path
+   std::list<IO*>                     m_stage_detach;            //!< pre-stage IOs waiting for their File to go idle
+   XrdSysMutex                        m_stage_bw_mutex;
+   double                             m_stage_bw_next;           //!< time next pre-stage read may start
+
    // active map
    typedef std::map<std::string, File*> ActiveMap_t;
    typedef ActiveMap_t::iterator        ActiveMap_i;
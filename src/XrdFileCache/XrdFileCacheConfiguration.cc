@@ -1,5 +1,6 @@
 #include "XrdFileCache.hh"
 #include "XrdFileCacheTrace.hh"
+#include "XrdFileCacheDedup.hh"
 
 #include "XrdOss/XrdOss.hh"
 #include "XrdOss/XrdOssCache.hh"
@@ -292,6 +293,31 @@ bool Cache::Config(XrdSysLogger *logger, const char *config_filename, const char
          loff += snprintf(&buff[loff], strlen(buff2), "%s", buff2);
       }
 
+      if (m_configuration.m_vread_merge)
+      {
+         loff += snprintf(buff + loff, sizeof(buff) - loff, "\n       pfc.readv merge admit %.2f",
+                          m_configuration.m_vread_admit);
+      }
+
+      if (m_configuration.m_write_mode != Configuration::kWriteOff)
+      {
+         loff += snprintf(buff + loff, sizeof(buff) - loff, "\n       pfc.writemode %s retries %d timeout %d",
+                          m_configuration.m_write_mode == Configuration::kWriteBack ? "back" : "through",
+                          m_configuration.m_write_retries, m_configuration.m_write_timeout);
+      }
+
+      if (m_configuration.m_stage_threads > 0)
+      {
+         loff += snprintf(buff + loff, sizeof(buff) - loff, "\n       pfc.prestage threads %d bw %lld",
+                          m_configuration.m_stage_threads, m_configuration.m_stage_bw);
+      }
+
+      if (m_configuration.m_dedup)
+      {
+         loff += snprintf(buff + loff, sizeof(buff) - loff, "\n       pfc.dedup on store %s",
+                          m_configuration.m_dedup_store.c_str());
+      }
+
       char unameBuff[256];
       if (m_configuration.m_username.empty())
       {
@@ -307,6 +333,17 @@ bool Cache::Config(XrdSysLogger *logger, const char *config_filename, const char
       m_log.Say( buff);
    }
 
+   if (retval && m_configuration.m_dedup)
+   {
+      m_dedup = new DedupStore(m_trace);
+      if ( ! m_dedup->Init(m_output_fs, m_configuration.m_username, m_configuration.m_data_space,
+                           m_configuration.m_dedup_store, m_configuration.m_bufferSize))
+      {
+         m_log.Emsg("Config", "Warning: block deduplication is not available, continuing without it.");
+         delete m_dedup; m_dedup = 0;
+      }
+   }
+
    m_log.Say("------ File Caching Proxy interface initialization ", retval ? "completed" : "failed");
 
    if (ofsCfg) delete ofsCfg;
@@ -440,6 +477,135 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
    {
       tmpc.m_flushRaw = config.GetWord();
    }
+   else if ( part == "writemode" )
+   {
+      const char* params = config.GetWord();
+      if      (params && ! strcmp(params, "off"))     m_configuration.m_write_mode = Configuration::kWriteOff;
+      else if (params && ! strcmp(params, "through")) m_configuration.m_write_mode = Configuration::kWriteThrough;
+      else if (params && ! strcmp(params, "back"))    m_configuration.m_write_mode = Configuration::kWriteBack;
+      else
+      {
+         m_log.Emsg("Config", "Error: writemode requires one of off, through or back.");
+         return false;
+      }
+
+      while ((params = config.GetWord()))
+      {
+         if ( ! strcmp(params, "retries"))
+         {
+            if (XrdOuca2x::a2i(m_log, "Error getting number of upload retries", config.GetWord(), &m_configuration.m_write_retries, 1, 100))
+            {
+               return false;
+            }
+         }
+         else if ( ! strcmp(params, "timeout"))
+         {
+            if (XrdOuca2x::a2tm(m_log, "Error getting upload timeout", config.GetWord(), &m_configuration.m_write_timeout, 1))
+            {
+               return false;
+            }
+         }
+         else
+         {
+            m_log.Emsg("Config", "Error: unknown writemode parameter", params);
+            return false;
+         }
+      }
+   }
+   else if ( part == "prestage" )
+   {
+      // pfc.prestage threads <n> [bw <rate>]
+      const char* params;
+      while ((params = config.GetWord()))
+      {
+         if ( ! strcmp(params, "threads"))
+         {
+            if (XrdOuca2x::a2i(m_log, "Error getting number of prestage threads", config.GetWord(),
+                               &m_configuration.m_stage_threads, 0, 64))
+            {
+               return false;
+            }
+         }
+         else if ( ! strcmp(params, "bw"))
+         {
+            if (XrdOuca2x::a2sz(m_log, "Error getting prestage bandwidth", config.GetWord(),
+                                &m_configuration.m_stage_bw, 0))
+            {
+               return false;
+            }
+         }
+         else
+         {
+            m_log.Emsg("Config", "Error: unknown prestage parameter", params);
+            return false;
+         }
+      }
+   }
+   else if ( part == "dedup" )
+   {
+      const char* params = config.GetWord();
+      if      (params && ! strcmp(params, "on"))  m_configuration.m_dedup = true;
+      else if (params && ! strcmp(params, "off")) m_configuration.m_dedup = false;
+      else
+      {
+         m_log.Emsg("Config", "Error: dedup requires on or off argument.");
+         return false;
+      }
+
+      params = config.GetWord();
+      if (params)
+      {
+         const char* path = config.GetWord();
+         if (strcmp(params, "store") || ! path || *path != '/')
+         {
+            m_log.Emsg("Config", "Error: dedup store requires an absolute path.");
+            return false;
+         }
+         m_configuration.m_dedup_store = path;
+      }
+   }
+   else if ( part == "readv" )
+   {
+      const char* params = config.GetWord();
+      if ( ! params)
+      {
+         m_log.Emsg("Config", "Error: readv requires merge or nomerge argument.");
+         return false;
+      }
+      if ( ! strcmp(params, "merge"))
+      {
+         m_configuration.m_vread_merge = true;
+      }
+      else if ( ! strcmp(params, "nomerge"))
+      {
+         m_configuration.m_vread_merge = false;
+      }
+      else
+      {
+         m_log.Emsg("Config", "Error: unknown readv mode", params);
+         return false;
+      }
+
+      params = config.GetWord();
+      if (params)
+      {
+         if (strcmp(params, "admit"))
+         {
+            m_log.Emsg("Config", "Error: unknown readv parameter", params);
+            return false;
+         }
+         params = config.GetWord();
+         char* eP = 0;
+         errno = 0;
+         double admit = params ? strtod(params, &eP) : -1;
+         if ( ! params || errno || eP == params || admit < 0 || admit > 1)
+         {
+            m_log.Emsg("Config", "Error: readv admit requires a fraction between 0 and 1.");
+            return false;
+         }
+         m_configuration.m_vread_admit = admit;
+      }
+   }
    else
    {
       m_log.Emsg("Cache::ConfigParameters() unmatched pfc parameter", part.c_str());
@@ -0,0 +1,335 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: agent <agent@local>
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+
+#include "XrdCks/XrdCksCalcmd5.hh"
+#include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdSys/XrdSysTrace.hh"
+
+#include "XrdFileCacheDedup.hh"
+#include "XrdFileCacheTrace.hh"
+
+#if defined(FICLONERANGE) && defined(FIDEDUPERANGE) && defined(FALLOC_FL_PUNCH_HOLE)
+#define XRDPFC_HAVE_DEDUP
+#endif
+
+using namespace XrdFileCache;
+
+//______________________________________________________________________________
+DedupStore::DedupStore(XrdSysTrace *trace) :
+   m_trace(trace),
+   m_traceID("Dedup"),
+   m_store(0),
+   m_fd(-1),
+   m_blockSize(0),
+   m_enabled(false),
+   m_nSlots(0)
+{}
+
+//______________________________________________________________________________
+DedupStore::~DedupStore()
+{
+   if (m_store)
+   {
+      m_store->Close();
+      delete m_store;
+   }
+}
+
+//______________________________________________________________________________
+bool DedupStore::Init(XrdOss *oss, const std::string &user, const std::string &space,
+                      const std::string &path, long long blockSize)
+{
+#ifdef XRDPFC_HAVE_DEDUP
+   XrdOucEnv myEnv;
+   myEnv.Put("oss.cgroup", space.c_str());
+
+   // Store entries are not persistent, start with an empty store. Blocks
+   // of data files that share extents with the old store are not affected.
+   oss->Unlink(path.c_str());
+   if (oss->Create(user.c_str(), path.c_str(), 0600, myEnv, XRDOSS_mkpath) != XrdOssOK)
+   {
+      TRACE(Error, "DedupStore::Init() Create failed for store file " << path << ", err=" << strerror(errno));
+      return false;
+   }
+
+   m_store = oss->newFile(user.c_str());
+   if (m_store->Open(path.c_str(), O_RDWR, 0600, myEnv) != XrdOssOK || m_store->getFD() < 0)
+   {
+      TRACE(Error, "DedupStore::Init() Open failed for store file " << path << ", err=" << strerror(errno));
+      delete m_store; m_store = 0;
+      return false;
+   }
+
+   m_fd        = m_store->getFD();
+   m_blockSize = blockSize;
+   m_enabled   = true;
+   TRACE(Info, "DedupStore::Init() store file " << path);
+   return true;
+#else
+   TRACE(Error, "DedupStore::Init() block sharing is not supported on this platform");
+   return false;
+#endif
+}
+
+//______________________________________________________________________________
+void DedupStore::Disable(const char *what, int err)
+{
+   TRACE(Warning, "DedupStore " << what << " failed, err=" << strerror(err) << "; deduplication disabled");
+   XrdSysMutexHelper _lck(m_mutex);
+   m_enabled = false;
+}
+
+//______________________________________________________________________________
+bool DedupStore::CloneToStore(int fd, long long offset, long long slot)
+{
+#ifdef XRDPFC_HAVE_DEDUP
+   long long dst = slot * m_blockSize;
+
+   struct file_clone_range fcr;
+   fcr.src_fd      = fd;
+   fcr.src_offset  = offset;
+   fcr.src_length  = m_blockSize;
+   fcr.dest_offset = dst;
+   if (ioctl(m_fd, FICLONERANGE, &fcr) != 0)
+   {
+      // Filesystem without reflink support or data on another device.
+      Disable("cloning block to store", errno);
+      return false;
+   }
+   return true;
+#else
+   return false;
+#endif
+}
+
+//______________________________________________________________________________
+bool DedupStore::ShareFromStore(int fd, long long offset, long long slot)
+{
+#ifdef XRDPFC_HAVE_DEDUP
+   char buf[sizeof(struct file_dedupe_range) + sizeof(struct file_dedupe_range_info)];
+   memset(buf, 0, sizeof(buf));
+
+   struct file_dedupe_range      *fdr  = (struct file_dedupe_range*) buf;
+   struct file_dedupe_range_info *info = &fdr->info[0];
+
+   fdr->src_offset   = slot * m_blockSize;
+   fdr->src_length   = m_blockSize;
+   fdr->dest_count   = 1;
+   info->dest_fd     = fd;
+   info->dest_offset = offset;
+
+   if (ioctl(m_fd, FIDEDUPERANGE, fdr) != 0)
+   {
+      Disable("sharing block from store", errno);
+      return false;
+   }
+
+   if (info->status == FILE_DEDUPE_RANGE_DIFFERS)
+   {
+      TRACE(Warning, "DedupStore::ShareFromStore() digest collision for store block " << slot);
+      return false;
+   }
+   if (info->status < 0)
+   {
+      TRACE(Warning, "DedupStore::ShareFromStore() block " << slot << " not shared, err=" << strerror(-info->status));
+      return false;
+   }
+   return (long long) info->bytes_deduped == m_blockSize;
+#else
+   return false;
+#endif
+}
+
+//______________________________________________________________________________
+void DedupStore::FreeSlots(std::vector<long long> &slots)
+{
+   // Called without m_mutex. A slot becomes reusable only after its hole
+   // has been punched.
+   if (slots.empty()) return;
+
+#ifdef XRDPFC_HAVE_DEDUP
+   for (std::vector<long long>::iterator si = slots.begin(); si != slots.end(); ++si)
+   {
+      if (fallocate(m_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, *si * m_blockSize, m_blockSize) != 0)
+      {
+         TRACE(Warning, "DedupStore::FreeSlots() punching hole failed, err=" << strerror(errno));
+      }
+   }
+#endif
+
+   XrdSysMutexHelper _lck(m_mutex);
+   m_freeSlots.insert(m_freeSlots.end(), slots.begin(), slots.end());
+}
+
+//______________________________________________________________________________
+void DedupStore::Unref(EntryMap_i it, std::vector<long long> &freed)
+{
+   // Called with m_mutex locked.
+   if (--it->second.m_refcnt <= 0)
+   {
+      freed.push_back(it->second.m_slot);
+      m_entries.erase(it);
+   }
+}
+
+//______________________________________________________________________________
+void DedupStore::AddBlock(const std::string &lpath, int fd, long long offset, const char *buff, long long size)
+{
+   if (size != m_blockSize || fd < 0) return;
+
+   {
+      XrdSysMutexHelper _lck(m_mutex);
+      if ( ! m_enabled) return;
+   }
+
+   XrdCksCalcmd5 md5;
+   std::string   key(md5.Calc(buff, size), 16);
+
+   std::vector<long long> freed;
+   EntryMap_i it;
+   long long  slot;
+   bool       is_new;
+
+   // Reserve a store slot for a new digest or pin the entry of a known one.
+   {
+      XrdSysMutexHelper _lck(m_mutex);
+
+      if ( ! m_enabled) return;
+
+      it = m_entries.find(key);
+      if (it == m_entries.end())
+      {
+         if (m_freeSlots.empty())
+         {
+            // Grow the store here so that the size only ever increases.
+            if (ftruncate(m_fd, (m_nSlots + 1) * m_blockSize) != 0)
+            {
+               TRACE(Warning, "DedupStore extending store failed, err=" << strerror(errno) << "; deduplication disabled");
+               m_enabled = false;
+               return;
+            }
+            slot = m_nSlots++;
+         }
+         else
+         {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+         }
+         it     = m_entries.insert(std::make_pair(key, Entry(slot))).first;
+         is_new = true;
+      }
+      else
+      {
+         // The first copy of this block is still being cloned, keep ours.
+         if ( ! it->second.m_ready) return;
+         ++it->second.m_refcnt;
+         slot   = it->second.m_slot;
+         is_new = false;
+      }
+   }
+
+   bool ok = is_new ? CloneToStore(fd, offset, slot) : ShareFromStore(fd, offset, slot);
+
+   {
+      XrdSysMutexHelper _lck(m_mutex);
+
+      if ( ! ok)
+      {
+         if (is_new)
+         {
+            // Nobody else can reference an entry that is not ready.
+            m_entries.erase(it);
+            m_freeSlots.push_back(slot);
+         }
+         else
+         {
+            Unref(it, freed);
+         }
+      }
+      else
+      {
+         if (is_new)
+         {
+            it->second.m_ready = true;
+            TRACE(Dump, "DedupStore::AddBlock() new block " << slot << " from " << lpath << " off " << offset);
+         }
+         else
+         {
+            TRACE(Dump, "DedupStore::AddBlock() shared block " << slot << " refcnt " << it->second.m_refcnt
+                  << " with " << lpath << " off " << offset);
+         }
+         m_files[lpath].push_back(key);
+      }
+   }
+
+   FreeSlots(freed);
+}
+
+//______________________________________________________________________________
+void DedupStore::ReleaseFile(const std::string &lpath)
+{
+   std::vector<long long> freed;
+   {
+      XrdSysMutexHelper _lck(m_mutex);
+
+      FileMap_i fi = m_files.find(lpath);
+      if (fi == m_files.end()) return;
+
+      for (std::vector<std::string>::iterator ki = fi->second.begin(); ki != fi->second.end(); ++ki)
+      {
+         EntryMap_i it = m_entries.find(*ki);
+         if (it == m_entries.end()) continue;
+
+         Unref(it, freed);
+      }
+
+      TRACE(Debug, "DedupStore::ReleaseFile() released " << fi->second.size() << " blocks of " << lpath);
+      m_files.erase(fi);
+   }
+
+   FreeSlots(freed);
+}
+
+//______________________________________________________________________________
+void DedupStore::GetStats(long long &logical, long long &physical)
+{
+   XrdSysMutexHelper _lck(m_mutex);
+
+   long long nref = 0, nent = 0;
+   for (EntryMap_i it = m_entries.begin(); it != m_entries.end(); ++it)
+   {
+      if ( ! it->second.m_ready) continue;
+      nref += it->second.m_refcnt;
+      ++nent;
+   }
+
+   logical  = nref * m_blockSize;
+   physical = nent * m_blockSize;
+}
@@ -0,0 +1,133 @@
+#ifndef __XRDFILECACHE_DEDUP_HH__
+#define __XRDFILECACHE_DEDUP_HH__
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: agent <agent@local>
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdOss;
+class XrdOssDF;
+class XrdSysTrace;
+
+namespace XrdFileCache
+{
+//----------------------------------------------------------------------------
+//! \brief Content-addressed store of cached blocks.
+//!
+//! Full blocks are identified by the md5 digest computed when the block is
+//! first written to disk. The first copy of a block is cloned into a common
+//! store file; identical blocks of other data files are then made to share
+//! the store extents with FIDEDUPERANGE, which also compares the content, so
+//! the data files stay readable as before. Each store entry is reference
+//! counted by the data file blocks sharing it and is released when the last
+//! of them is purged. The index is kept in memory and the store is
+//! recreated on startup, blocks already shared on disk stay shared.
+//!
+//! The mutex only protects the index. The clone, dedupe and hole punching
+//! calls are made without it; the kernel serializes them per inode, so
+//! writes of different files are not serialized by the store. An entry is
+//! pinned by a reference while its store block is being shared and a new
+//! entry is not used by other files until its block has been cloned.
+//----------------------------------------------------------------------------
+class DedupStore
+{
+public:
+   //------------------------------------------------------------------------
+   //! Constructor.
+   //------------------------------------------------------------------------
+   DedupStore(XrdSysTrace *trace);
+
+   //------------------------------------------------------------------------
+   //! Destructor.
+   //------------------------------------------------------------------------
+   ~DedupStore();
+
+   //------------------------------------------------------------------------
+   //! Create the store file.
+   //!
+   //! @return false if the store can not be used on this platform
+   //------------------------------------------------------------------------
+   bool Init(XrdOss *oss, const std::string &user, const std::string &space,
+             const std::string &path, long long blockSize);
+
+   //------------------------------------------------------------------------
+   //! Register a block that has just been written to a data file.
+   //!
+   //! @param lpath    local path of the data file
+   //! @param fd       file descriptor of the data file, opened read-write
+   //! @param offset   offset of the block in the data file
+   //! @param buff     block content
+   //! @param size     block size, only full blocks are deduplicated
+   //------------------------------------------------------------------------
+   void AddBlock(const std::string &lpath, int fd, long long offset, const char *buff, long long size);
+
+   //------------------------------------------------------------------------
+   //! Drop references of a data file that has been removed from the cache.
+   //------------------------------------------------------------------------
+   void ReleaseFile(const std::string &lpath);
+
+   //------------------------------------------------------------------------
+   //! Get bytes referenced by data files and bytes held by the store.
+   //! Their ratio is the deduplication ratio.
+   //------------------------------------------------------------------------
+   void GetStats(long long &logical, long long &physical);
+
+   XrdSysTrace* GetTrace() const { return m_trace; }
+
+private:
+   struct Entry
+   {
+      long long m_slot;       //!< block index in the store file
+      int       m_refcnt;     //!< number of data file blocks sharing the entry
+      bool      m_ready;      //!< block has been cloned into the store
+
+      Entry(long long slot) : m_slot(slot), m_refcnt(1), m_ready(false) {}
+   };
+
+   typedef std::map<std::string, Entry>                     EntryMap_t;
+   typedef EntryMap_t::iterator                             EntryMap_i;
+   typedef std::map<std::string, std::vector<std::string> > FileMap_t;
+   typedef FileMap_t::iterator                              FileMap_i;
+
+   bool CloneToStore(int fd, long long offset, long long slot);
+   bool ShareFromStore(int fd, long long offset, long long slot);
+   void FreeSlots(std::vector<long long> &slots);
+   void Unref(EntryMap_i it, std::vector<long long> &freed);
+   void Disable(const char *what, int err);
+
+   XrdSysTrace           *m_trace;
+   const char            *m_traceID;
+
+   XrdSysMutex            m_mutex;
+   XrdOssDF              *m_store;         //!< store file
+   int                    m_fd;            //!< file descriptor of the store file
+   long long              m_blockSize;
+   bool                   m_enabled;
+
+   EntryMap_t             m_entries;       //!< digest -> store entry
+   FileMap_t              m_files;         //!< data file -> digests of shared blocks
+   std::vector<long long> m_freeSlots;     //!< released store blocks
+   long long              m_nSlots;        //!< number of blocks in the store file
+};
+}
+
+#endif
@@ -33,6 +33,7 @@
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdSfs/XrdSfsInterface.hh"
 #include "XrdFileCache.hh"
+#include "XrdFileCacheDedup.hh"
 
 
 using namespace XrdFileCache;
@@ -52,6 +53,10 @@ const char *File::m_traceID = "File";
 
 File::File(IO *io, const std::string& path, long long iOffset, long long iFileSize) :
    m_ref_cnt(0),
+   m_async_req_cnt(0),
+   m_is_writable(false),
+   m_upload_queued(false),
+   m_upload_errno(0),
    m_is_open(false),
    m_io(io),
    m_output(0),
@@ -147,7 +152,8 @@ bool File::ioActive()
          }
       }
 
-      blockMapEmpty = m_block_map.empty();
+      blockMapEmpty = m_block_map.empty() && m_async_req_cnt == 0 &&
+                      m_dirty.empty() && ! m_upload_queued;
    }
 
    return !blockMapEmpty;
@@ -155,6 +161,18 @@ bool File::ioActive()
 
 //------------------------------------------------------------------------------
 
+void File::StopPrefetch()
+{
+   XrdSysCondVarHelper _lck(m_downloadCond);
+   if (m_prefetchState == kOn || m_prefetchState == kHold)
+   {
+      m_prefetchState = kStopped;
+      cache()->DeRegisterPrefetchFile(this);
+   }
+}
+
+//------------------------------------------------------------------------------
+
 void File::RequestSyncOfDetachStats()
 {
    XrdSysCondVarHelper _lck(m_downloadCond);
@@ -288,7 +306,7 @@ bool File::Open()
    m_cfi.WriteIOStatAttach();
    m_downloadCond.Lock();
    m_is_open = true;
-   m_prefetchState = (m_cfi.IsComplete()) ? kComplete : kOn;
+   m_prefetchState = (m_cfi.IsComplete() || m_fileSize == 0) ? kComplete : kOn;
    m_downloadCond.UnLock();
 
    if (m_prefetchState == kOn) cache()->RegisterPrefetchFile(this);
@@ -693,6 +711,536 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
 
 //------------------------------------------------------------------------------
 
+void File::Read(XrdOucCacheIOCB &iocb, char* iUserBuff, long long iUserOff, int iUserSize)
+{
+   if ( ! isOpen())
+   {
+      m_io->GetInput()->Read(iocb, iUserBuff, iUserOff, iUserSize);
+      return;
+   }
+
+   XrdOucIOVec2 chunk(iUserBuff, iUserOff, iUserSize);
+   ReadAsync(iocb, &chunk, 1);
+}
+
+//------------------------------------------------------------------------------
+
+void File::ReadV(XrdOucCacheIOCB &iocb, const XrdOucIOVec *readV, int n)
+{
+   if ( ! isOpen())
+   {
+      m_io->GetInput()->ReadV(iocb, readV, n);
+      return;
+   }
+
+   if ( ! VReadValidate(readV, n))
+   {
+      iocb.Done(-EINVAL);
+      return;
+   }
+
+   ReadAsync(iocb, readV, n);
+}
+
+//------------------------------------------------------------------------------
+
+void File::ReadAsync(XrdOucCacheIOCB &iocb, const XrdOucIOVec *readV, int n)
+{
+   // Blocks in RAM or on disk are copied on the calling thread. Chunks of
+   // blocks still being downloaded are registered on the block and copied
+   // from ProcessBlockResponse(), so the caller never waits for the origin.
+   // The readV vector is not referenced after this function returns.
+
+   const long long BS = m_cfi.GetBufferSize();
+
+   ReadRequest *rreq = new ReadRequest(iocb);
+
+   typedef std::vector<std::pair<Block*, ChunkRequest> > vReadyChunk_t;
+
+   BlockList_t              blks_to_request;
+   vReadyChunk_t            chunks_ready;
+   std::vector<XrdOucIOVec> chunks_on_disk;
+   std::vector<XrdOucIOVec> chunks_direct;
+
+   m_downloadCond.Lock();
+
+   ++m_async_req_cnt;
+
+   for (int iov_idx = 0; iov_idx < n; ++iov_idx)
+   {
+      if (readV[iov_idx].size <= 0) continue;
+
+      const int idx_first =  readV[iov_idx].offset / BS;
+      const int idx_last  = (readV[iov_idx].offset + readV[iov_idx].size - 1) / BS;
+
+      for (int block_idx = idx_first; block_idx <= idx_last; ++block_idx)
+      {
+         long long off;     // offset in user buffer
+         long long blk_off; // offset in block
+         long long size;    // size to copy
+
+         overlap(block_idx, BS, readV[iov_idx].offset, readV[iov_idx].size, off, blk_off, size);
+         char *buff = readV[iov_idx].data + off;
+
+         BlockMap_i bi = m_block_map.find(block_idx);
+
+         // In RAM or incoming?
+         if (bi != m_block_map.end())
+         {
+            Block *b = bi->second;
+            inc_ref_count(b);
+            if (b->is_finished())
+            {
+               chunks_ready.push_back(std::make_pair(b, ChunkRequest(rreq, buff, blk_off, size)));
+            }
+            else
+            {
+               b->m_chunk_reqs.push_back(ChunkRequest(rreq, buff, blk_off, size));
+               ++rreq->m_to_wait;
+            }
+         }
+         // On disk?
+         else if (m_cfi.TestBit(offsetIdx(block_idx)))
+         {
+            chunks_on_disk.push_back(XrdOucIOVec2(buff, block_idx*BS + blk_off - m_offset, size));
+            if (m_cfi.TestPrefetchBit(offsetIdx(block_idx)))
+               m_prefetchHitCnt++;
+         }
+         // Is there room for one more RAM Block?
+         else if (cache()->RequestRAMBlock())
+         {
+            Block *b = PrepareBlockRequest(block_idx, false);
+            inc_ref_count(b);
+            b->m_chunk_reqs.push_back(ChunkRequest(rreq, buff, blk_off, size));
+            ++rreq->m_to_wait;
+            blks_to_request.push_back(b);
+         }
+         // Nope ... read this directly without caching.
+         else
+         {
+            XrdOucIOVec2 chunk(buff, block_idx*BS + blk_off, size);
+            if ( ! chunks_direct.empty() &&
+                 chunks_direct.back().offset + chunks_direct.back().size == chunk.offset &&
+                 chunks_direct.back().data   + chunks_direct.back().size == chunk.data)
+               chunks_direct.back().size += size;
+            else
+               chunks_direct.push_back(chunk);
+         }
+      }
+   }
+
+   if ( ! chunks_direct.empty())
+      ++rreq->m_to_wait;
+
+   m_downloadCond.UnLock();
+
+   TRACEF(Dump, "File::ReadAsync() " << n << " chunks, ready = " << chunks_ready.size() << " disk = " << chunks_on_disk.size()
+          << " requested = " << blks_to_request.size() << " direct = " << chunks_direct.size());
+
+   ProcessBlockRequests(blks_to_request);
+
+   // Misses that could not get a RAM block go to origin in one request.
+   if ( ! chunks_direct.empty())
+   {
+      AsyncDirectResponseHandler *handler = new AsyncDirectResponseHandler(this, rreq);
+      if (chunks_direct.size() == 1)
+         m_io->GetInput()->Read(*handler, chunks_direct[0].data, chunks_direct[0].offset, chunks_direct[0].size);
+      else
+         m_io->GetInput()->ReadV(*handler, &chunks_direct[0], chunks_direct.size());
+   }
+
+   long long bytes_read = 0;
+
+   if ( ! chunks_on_disk.empty())
+   {
+      ssize_t rs = m_output->ReadV(&chunks_on_disk[0], chunks_on_disk.size());
+      if (rs < 0)
+      {
+         TRACEF(Error, "File::ReadAsync() failed read from disk, err = " << strerror(-rs));
+         bytes_read = rs;
+      }
+      else
+      {
+         bytes_read += rs;
+         m_stats.m_BytesDisk += rs;
+      }
+   }
+
+   if ( ! chunks_ready.empty())
+   {
+      long long bytes_ram = 0;
+      int       err       = 0;
+      for (vReadyChunk_t::iterator i = chunks_ready.begin(); i != chunks_ready.end(); ++i)
+      {
+         if (i->first->is_ok())
+         {
+            memcpy(i->second.m_buf, &(i->first->m_buff[i->second.m_off]), i->second.m_size);
+            bytes_ram += i->second.m_size;
+         }
+         else
+         {
+            err = i->first->m_errno;
+         }
+      }
+
+      XrdSysCondVarHelper _lck(m_downloadCond);
+      for (vReadyChunk_t::iterator i = chunks_ready.begin(); i != chunks_ready.end(); ++i)
+      {
+         if (i->first->m_prefetch) m_prefetchHitCnt++;
+         dec_ref_count(i->first);
+      }
+      m_stats.m_BytesRam += bytes_ram;
+
+      if (err)
+         bytes_read = err;
+      else if (bytes_read >= 0)
+         bytes_read += bytes_ram;
+   }
+
+   if (rreq->Done(bytes_read))
+      FinalizeReadRequest(rreq);
+}
+
+//------------------------------------------------------------------------------
+
+void File::ProcessChunkRequests(Block* b, vChunkRequest_t& creqs)
+{
+   // Called without lock, the block is kept alive by references held by creqs.
+
+   const bool ok  = b->is_ok();
+   const int  err = b->m_errno;
+
+   long long bytes_ram = 0;
+   if (ok)
+   {
+      for (vChunkRequest_t::iterator i = creqs.begin(); i != creqs.end(); ++i)
+      {
+         memcpy(i->m_buf, &(b->m_buff[i->m_off]), i->m_size);
+         bytes_ram += i->m_size;
+      }
+   }
+
+   {
+      XrdSysCondVarHelper _lck(m_downloadCond);
+      m_stats.m_BytesRam += bytes_ram;
+      for (vChunkRequest_t::iterator i = creqs.begin(); i != creqs.end(); ++i)
+      {
+         dec_ref_count(b);
+      }
+   }
+
+   for (vChunkRequest_t::iterator i = creqs.begin(); i != creqs.end(); ++i)
+   {
+      if (i->m_read_req->Done(ok ? i->m_size : err))
+         FinalizeReadRequest(i->m_read_req);
+   }
+}
+
+//------------------------------------------------------------------------------
+
+void File::ProcessDirectResponse(ReadRequest* rreq, int res)
+{
+   if (res >= 0)
+   {
+      XrdSysCondVarHelper _lck(m_downloadCond);
+      m_stats.m_BytesMissed += res;
+   }
+
+   if (rreq->Done(res))
+      FinalizeReadRequest(rreq);
+}
+
+//------------------------------------------------------------------------------
+
+void File::FinalizeReadRequest(ReadRequest* rreq)
+{
+   const int res = rreq->Result();
+
+   TRACEF(Dump, "File::FinalizeReadRequest() " << (void*) rreq << " result = " << res);
+
+   {
+      XrdSysCondVarHelper _lck(m_downloadCond);
+      if (m_prefetchReadCnt)
+         m_prefetchScore = float(m_prefetchHitCnt)/m_prefetchReadCnt;
+      --m_async_req_cnt;
+   }
+
+   rreq->m_iocb.Done(res);
+   delete rreq;
+}
+
+//==============================================================================
+// Write support
+//==============================================================================
+
+void File::EnableWrite()
+{
+   bool deregister = false;
+   {
+      XrdSysCondVarHelper _lck(m_downloadCond);
+      m_is_writable = true;
+      if (m_prefetchState == kOn || m_prefetchState == kHold)
+      {
+         deregister = true;
+      }
+      // All data of a new file is produced locally, there is nothing to prefetch.
+      m_prefetchState = kComplete;
+   }
+   if (deregister) cache()->DeRegisterPrefetchFile(this);
+
+   TRACEF(Debug, "File::EnableWrite() mode = " << Cache::GetInstance().RefConfiguration().m_write_mode);
+}
+
+//------------------------------------------------------------------------------
+
+int File::Write(const char* buff, long long off, int size)
+{
+   if ( ! isOpen())
+   {
+      return m_io->GetInput()->Write((char*) buff, off, size);
+   }
+   if ( ! m_is_writable)
+   {
+      errno = ENOTSUP;
+      return -1;
+   }
+
+   if (Cache::GetInstance().RefConfiguration().m_write_mode == Configuration::kWriteThrough)
+   {
+      int rc = m_io->GetInput()->Write((char*) buff, off, size);
+      if (rc < 0) return rc;
+
+      if (WriteToDisk(buff, off, size) < 0)
+      {
+         // Origin has the data, stop serving this file from the cache.
+         TRACEF(Error, "File::Write() local write failed, passing further requests to origin");
+         XrdSysCondVarHelper _lck(m_downloadCond);
+         m_is_open = false;
+      }
+      return rc;
+   }
+
+   // Write-back: acknowledge once the data is in the local file.
+   {
+      XrdSysCondVarHelper _lck(m_downloadCond);
+      if (m_upload_errno)
+      {
+         errno = -m_upload_errno;
+         return -1;
+      }
+   }
+
+   if (WriteToDisk(buff, off, size) < 0)
+   {
+      return -1;
+   }
+
+   bool queue;
+   {
+      XrdSysCondVarHelper _lck(m_downloadCond);
+      // The upload may have failed while we were writing locally.
+      if (m_upload_errno)
+      {
+         errno = -m_upload_errno;
+         return -1;
+      }
+      if ( ! m_dirty.empty() && m_dirty.back().first + m_dirty.back().second == off)
+         m_dirty.back().second += size;
+      else
+         m_dirty.push_back(Extent_t(off, size));
+      queue = ! m_upload_queued;
+      m_upload_queued = true;
+   }
+   if (queue) cache()->AddUploadTask(this);
+
+   return size;
+}
+
+//------------------------------------------------------------------------------
+
+int File::WriteToDisk(const char* buff, long long off, int size)
+{
+   int done = 0;
+   while (done < size)
+   {
+      ssize_t rc = m_output->Write(buff + done, off + done - m_offset, size - done);
+      if (rc < 0)
+      {
+         if (rc == -EINTR) continue;
+         errno = -rc;
+         TRACEF(Error, "File::WriteToDisk() off = " << off + done << " size = " << size - done << " err = " << strerror(errno));
+         return -1;
+      }
+      done += rc;
+   }
+
+   const long long BS = m_cfi.GetBufferSize();
+
+   bool schedule_sync = false;
+   {
+      XrdSysCondVarHelper _lck(m_downloadCond);
+
+      // The file was created through the cache so every block up to the end
+      // of the file, including holes skipped by this write, is local.
+      int first_blk = std::min(off/BS, (m_fileSize - 1)/BS);
+      if (first_blk < 0) first_blk = 0;
+
+      if (off + size > m_fileSize)
+      {
+         m_fileSize = off + size;
+         m_cfi.GrowFileSize(m_fileSize);
+      }
+      const int last_blk = (off + size - 1)/BS;
+
+      for (int i = first_blk; i <= last_blk; ++i)
+      {
+         m_cfi.SetBitWritten(i);
+         if (m_in_sync)
+            m_writes_during_sync.push_back(i);
+         else
+            m_cfi.SetBitSynced(i);
+      }
+      m_cfi.UpdateDownloadCompleteStatus();
+
+      if ( ! m_in_sync && ++m_non_flushed_cnt >= Cache::GetInstance().RefConfiguration().m_flushCnt)
+      {
+         schedule_sync     = true;
+         m_in_sync         = true;
+         m_non_flushed_cnt = 0;
+      }
+   }
+
+   if (schedule_sync)
+   {
+      cache()->ScheduleFileSync(this);
+   }
+
+   return size;
+}
+
+//------------------------------------------------------------------------------
+
+int File::Flush()
+{
+   if ( ! m_is_writable || ! isOpen()) return 0;
+
+   if (Cache::GetInstance().RefConfiguration().m_write_mode != Configuration::kWriteThrough)
+   {
+      // Wait until everything written so far is uploaded so that upload
+      // errors are reported here.
+      const time_t deadline = time(0) + Cache::GetInstance().RefConfiguration().m_write_timeout;
+      XrdSysCondVarHelper _lck(m_downloadCond);
+      while ( ! m_dirty.empty() || m_upload_queued)
+      {
+         const time_t now = time(0);
+         if (now >= deadline)
+         {
+            TRACEF(Warning, "File::Flush() upload not finished in time, " << m_dirty.size() << " extents pending");
+            errno = ETIMEDOUT;
+            return -1;
+         }
+         m_downloadCond.Wait(deadline - now);
+      }
+      if (m_upload_errno)
+      {
+         errno = -m_upload_errno;
+         return -1;
+      }
+   }
+
+   int rc = m_io->GetInput()->Sync();
+   if (rc < 0) return rc;
+
+   rc = m_output->Fsync();
+   if (rc < 0)
+   {
+      errno = -rc;
+      return -1;
+   }
+   return 0;
+}
+
+//------------------------------------------------------------------------------
+
+void File::Upload()
+{
+   // Called from the upload thread. The file can not be detached while
+   // m_upload_queued is set; once it is cleared the File must not be touched.
+
+   const long long BS      = m_cfi.GetBufferSize();
+   const int       retries = Cache::GetInstance().RefConfiguration().m_write_retries;
+
+   std::vector<char> buff;
+
+   while (true)
+   {
+      Extent_t ext;
+      {
+         XrdSysCondVarHelper _lck(m_downloadCond);
+         if (m_dirty.empty())
+         {
+            m_upload_queued = false;
+            m_downloadCond.Broadcast();
+            return;
+         }
+         ext = m_dirty.front();
+         m_dirty.pop_front();
+      }
+
+      while (ext.second > 0)
+      {
+         const int size = std::min(ext.second, BS);
+         buff.resize(size);
+
+         ssize_t rc = m_output->Read(&buff[0], ext.first - m_offset, size);
+         if (rc != size)
+         {
+            TRACEF(Error, "File::Upload() local read failed off = " << ext.first << " size = " << size << " ret = " << rc);
+            UploadFailed((rc < 0) ? rc : -EIO);
+            return;
+         }
+
+         int attempt = 1;
+         while (m_io->GetInput()->Write(&buff[0], ext.first, size) < 0)
+         {
+            int err = errno ? errno : EIO;
+            if (attempt >= retries)
+            {
+               TRACEF(Error, "File::Upload() giving up off = " << ext.first << " size = " << size
+                      << " after " << attempt << " attempts, err = " << strerror(err));
+               UploadFailed(-err);
+               return;
+            }
+            TRACEF(Warning, "File::Upload() attempt " << attempt << " failed off = " << ext.first
+                   << " err = " << strerror(err) << ", retrying");
+            XrdSysTimer::Snooze(attempt);
+            ++attempt;
+         }
+
+         ext.first  += size;
+         ext.second -= size;
+      }
+      TRACEF(Dump, "File::Upload() uploaded extent ending at " << ext.first);
+   }
+}
+
+//------------------------------------------------------------------------------
+
+void File::UploadFailed(int err)
+{
+   // Stop the upload for good. Sending later extents would leave a hole at
+   // the origin followed by data, so they are dropped and any further write
+   // or sync fails with this error. The File must not be touched afterwards.
+
+   XrdSysCondVarHelper _lck(m_downloadCond);
+   m_upload_errno  = err;
+   m_dirty.clear();
+   m_upload_queued = false;
+   m_downloadCond.Broadcast();
+}
+
+//------------------------------------------------------------------------------
+
 void File::WriteBlockToDisk(Block* b)
 {
    int retval = 0;
@@ -722,6 +1270,13 @@ void File::WriteBlockToDisk(Block* b)
       }
    }
 
+   // share identical blocks with other data files
+   DedupStore *dedup = cache()->GetDedupStore();
+   if (dedup)
+   {
+      dedup->AddBlock(m_filename, m_output->getFD(), offset, &b->m_buff[0], size);
+   }
+
    // set bit fetched
    TRACEF(Dump, "File::WriteToDisk() success set bit for block " <<  b->m_offset << " size " <<  size);
    int pfIdx =  (b->m_offset - m_offset)/m_cfi.GetBufferSize();
@@ -838,6 +1393,8 @@ void File::free_block(Block* b)
 
 void File::ProcessBlockResponse(Block* b, int res)
 {
+   vChunkRequest_t creqs;
+
    m_downloadCond.Lock();
 
    TRACEF(Dump, "File::ProcessBlockResponse " << (void*)b << "  " << b->m_offset/BufferSize());
@@ -857,9 +1414,14 @@ void File::ProcessBlockResponse(Block* b, int res)
       inc_ref_count(b);
    }
 
+   creqs.swap(b->m_chunk_reqs);
+
    m_downloadCond.Broadcast();
 
    m_downloadCond.UnLock();
+
+   if ( ! creqs.empty())
+      ProcessChunkRequests(b, creqs);
 }
 
 long long File::BufferSize()
@@ -958,6 +1520,15 @@ void BlockResponseHandler::Done(int res)
 
 //------------------------------------------------------------------------------
 
+void AsyncDirectResponseHandler::Done(int res)
+{
+   m_file->ProcessDirectResponse(m_read_req, res);
+
+   delete this;
+}
+
+//------------------------------------------------------------------------------
+
 void DirectResponseHandler::Done(int res)
 {
    XrdSysCondVarHelper _lck(m_cond);
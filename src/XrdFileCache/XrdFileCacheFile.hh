@@ -55,6 +55,56 @@ namespace XrdFileCache
 {
 
 class File;
+class ReadRequest;
+
+// ================================================================
+
+//! Part of an asynchronous read request that waits for a block.
+struct ChunkRequest
+{
+   ReadRequest *m_read_req;
+   char        *m_buf;                                  // user buffer
+   long long    m_off;                                  // offset in block
+   long long    m_size;                                 // size to copy
+
+   ChunkRequest(ReadRequest *rreq, char *buf, long long off, long long size) :
+      m_read_req(rreq), m_buf(buf), m_off(off), m_size(size)
+   {}
+};
+
+typedef std::vector<ChunkRequest> vChunkRequest_t;
+
+// ================================================================
+
+//! State of an asynchronous Read / ReadV, completed by the last part to arrive.
+class ReadRequest
+{
+public:
+   XrdOucCacheIOCB &m_iocb;
+   XrdSysMutex      m_mutex;
+   int              m_to_wait;                          // pending parts, including the issuer
+   long long        m_bytes_read;
+   int              m_errno;                            // stores negative errno
+
+   ReadRequest(XrdOucCacheIOCB &iocb) :
+      m_iocb(iocb), m_to_wait(1), m_bytes_read(0), m_errno(0)
+   {}
+
+   //! Account result of one part, returns true if this was the last one.
+   bool Done(long long res)
+   {
+      XrdSysMutexHelper _lck(m_mutex);
+      if (res < 0)
+         m_errno = res;
+      else
+         m_bytes_read += res;
+      return --m_to_wait == 0;
+   }
+
+   int Result() const { return m_errno ? m_errno : (int) m_bytes_read; }
+};
+
+// ================================================================
 
 class Block
 {
@@ -66,6 +116,7 @@ public:
    int                 m_refcnt;
    int                 m_errno;                         // stores negative errno
    bool                m_downloaded;
+   vChunkRequest_t     m_chunk_reqs;                    // async requests waiting for this block
 
    Block(File *f, long long off, int size, bool m_prefetch) :
       m_offset(off), m_file(f), m_prefetch(m_prefetch), m_refcnt(0),
@@ -122,6 +173,19 @@ public:
 
 // ================================================================
 
+class AsyncDirectResponseHandler : public XrdOucCacheIOCB
+{
+public:
+   File        *m_file;
+   ReadRequest *m_read_req;
+
+   AsyncDirectResponseHandler(File *f, ReadRequest *rreq) : m_file(f), m_read_req(rreq) {}
+
+   virtual void Done(int result);
+};
+
+// ================================================================
+
 class File
 {
 public:
@@ -144,6 +208,46 @@ public:
 
    int Read(char* buff, long long offset, int size);
 
+   //! Asynchronous read. Cache hits are served on the calling thread, misses
+   //! complete the request from the thread delivering the last block.
+   void Read(XrdOucCacheIOCB &iocb, char* buff, long long offset, int size);
+
+   //! Asynchronous vector read, see asynchronous Read().
+   void ReadV(XrdOucCacheIOCB &iocb, const XrdOucIOVec *readV, int n);
+
+   //----------------------------------------------------------------------
+   //! \brief Accept writes for a file created through the cache.
+   //! Must be called before any data is written.
+   //----------------------------------------------------------------------
+   void EnableWrite();
+
+   //! Check if the file was created through the cache, called under Cache's m_active lock.
+   bool IsWritable() { XrdSysCondVarHelper _lck(m_downloadCond); return m_is_writable; }
+
+   //----------------------------------------------------------------------
+   //! \brief Write data according to the configured write mode.
+   //! Write-through sends data to origin and then stores it locally,
+   //! write-back stores data locally and queues it for upload.
+   //----------------------------------------------------------------------
+   int Write(const char* buff, long long offset, int size);
+
+   //----------------------------------------------------------------------
+   //! \brief Make written data durable, called on client sync.
+   //! In write-back mode waits for the upload of the data written so far,
+   //! at most pfc.writemode timeout seconds, and returns the upload error, if any.
+   //----------------------------------------------------------------------
+   int Flush();
+
+   //----------------------------------------------------------------------
+   //! \brief Upload dirty extents to origin, called from the upload thread.
+   //----------------------------------------------------------------------
+   void Upload();
+
+   //----------------------------------------------------------------------
+   //! \brief Stop prefetching, data is requested explicitly (pre-staging).
+   //----------------------------------------------------------------------
+   void StopPrefetch();
+
    //----------------------------------------------------------------------
    //! \brief Data and cinfo files are open.
    //----------------------------------------------------------------------
@@ -178,6 +282,7 @@ public:
    Stats& GetStats() { return m_stats; }
 
    void ProcessBlockResponse(Block* b, int res);
+   void ProcessDirectResponse(ReadRequest* rreq, int res);
    void WriteBlockToDisk(Block* b);
 
    void Prefetch();
@@ -205,6 +310,17 @@ private:
    enum PrefetchState_e { kOff=-1, kOn, kHold, kStopped, kComplete };
 
    int            m_ref_cnt;            //!< number of references from IO or sync
+
+   int            m_async_req_cnt;      //!< number of asynchronous reads in flight
+
+   // write support
+   typedef std::pair<long long, long long> Extent_t;   //!< offset, size
+   typedef std::list<Extent_t>             ExtentList_t;
+
+   bool           m_is_writable;        //!< file was created through the cache
+   ExtentList_t   m_dirty;              //!< extents not yet uploaded in write-back mode
+   bool           m_upload_queued;      //!< file is in upload queue or being uploaded
+   int            m_upload_errno;       //!< error that stopped the upload, stores negative errno
    
    bool           m_is_open;            //!< open state
 
@@ -266,6 +382,14 @@ private:
    int    ReadBlocksFromDisk(IntList_t& blocks,
                              char* req_buf, long long req_off, long long req_size);
 
+   int    WriteToDisk(const char* buff, long long off, int size);
+   void   UploadFailed(int err);
+
+   // Async read
+   void   ReadAsync(XrdOucCacheIOCB &iocb, const XrdOucIOVec *readV, int n);
+   void   ProcessChunkRequests(Block* b, vChunkRequest_t& creqs);
+   void   FinalizeReadRequest(ReadRequest* rreq);
+
    // VRead
    bool VReadValidate     (const XrdOucIOVec *readV, int n);
    bool VReadPreProcess   (const XrdOucIOVec *readV, int n,
@@ -274,6 +398,9 @@ private:
                            std::vector<XrdOucIOVec>& chunkVec);
    int  VReadFromDisk     (const XrdOucIOVec *readV, int n,
                            ReadVBlockListDisk& blks_on_disk);
+   int  VReadMergedFromDisk(const XrdOucIOVec *readV, int n,
+                           ReadVBlockListDisk& blks_on_disk);
+   void VReadMergeDirect  (std::vector<XrdOucIOVec>& chunkVec);
    int  VReadProcessBlocks(const XrdOucIOVec *readV, int n,
                            std::vector<ReadVChunkListRAM>& blks_to_process,
                            std::vector<ReadVChunkListRAM>& blks_rocessed);
@@ -32,14 +32,15 @@
 using namespace XrdFileCache;
 
 //______________________________________________________________________________
-IOEntireFile::IOEntireFile(XrdOucCacheIO2 *io, XrdOucCacheStats &stats, Cache & cache) :
+IOEntireFile::IOEntireFile(XrdOucCacheIO2 *io, XrdOucCacheStats &stats, Cache & cache, bool writable,
+                           bool exclusive) :
    IO(io, stats, cache),
    m_file(0),
    m_localStat(0)
 {
    XrdCl::URL url(GetInput()->Path());
    std::string fname = url.GetPath();
-   m_file = Cache::GetInstance().GetFile(fname, this);
+   m_file = Cache::GetInstance().GetFile(fname, this, 0, 0, writable, exclusive);
 }
 
 //______________________________________________________________________________
@@ -67,12 +68,16 @@ int IOEntireFile::Fstat(struct stat &sbuff)
    }
 
    memcpy(&sbuff, m_localStat, sizeof(struct stat));
+   // size changes if the file is written through the cache
+   sbuff.st_size = FSize();
    return 0;
 }
 
 //______________________________________________________________________________
 long long IOEntireFile::FSize()
 {
+   if ( ! m_file) return GetInput()->FSize();
+
    return m_file->GetFileSize();
 }
 
@@ -182,6 +187,9 @@ int IOEntireFile::Read(char *buff, long long off, int size)
       size = FSize() - off;
 
 
+   // the file was taken over by another IO
+   if ( ! m_file) return GetInput()->Read(buff, off, size);
+
    ssize_t bytes_read = 0;
    ssize_t retval = 0;
 
@@ -203,6 +211,28 @@ int IOEntireFile::Read(char *buff, long long off, int size)
    return (retval < 0) ? retval : bytes_read;
 }
 
+//______________________________________________________________________________
+void IOEntireFile::Read(XrdOucCacheIOCB &iocb, char *buff, long long off, int size)
+{
+   TRACEIO(Dump, "IOEntireFile::Read() async "<< this << " off: " << off << " size: " << size );
+
+   // protect from reads over the file size
+   if (off >= FSize())
+   {
+      iocb.Done(0);
+      return;
+   }
+   if (off < 0)
+   {
+      iocb.Done(-EINVAL);
+      return;
+   }
+   if (off + size > FSize())
+      size = FSize() - off;
+
+   m_file->Read(iocb, buff, off, size);
+}
+
 
 /*
  * Perform a readv from the cache
@@ -213,3 +243,33 @@ int IOEntireFile::ReadV (const XrdOucIOVec *readV, int n)
    return m_file->ReadV(readV, n);
 }
 
+//______________________________________________________________________________
+void IOEntireFile::ReadV(XrdOucCacheIOCB &iocb, const XrdOucIOVec *readV, int n)
+{
+   TRACEIO(Dump, "IO::ReadV() async, get " <<  n << " requests" );
+   m_file->ReadV(iocb, readV, n);
+}
+
+//______________________________________________________________________________
+int IOEntireFile::Write(char *buff, long long off, int size)
+{
+   TRACEIO(Dump, "IOEntireFile::Write() "<< this << " off: " << off << " size: " << size );
+
+   if (off < 0)
+   {
+      errno = EINVAL;
+      return -1;
+   }
+
+   if ( ! m_file) return GetInput()->Write(buff, off, size);
+
+   return m_file->Write(buff, off, size);
+}
+
+//______________________________________________________________________________
+int IOEntireFile::Sync()
+{
+   if ( ! m_file) return GetInput()->Sync();
+
+   return m_file->Flush();
+}
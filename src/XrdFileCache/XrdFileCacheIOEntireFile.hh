@@ -43,7 +43,8 @@ public:
    //------------------------------------------------------------------------
    //! Constructor
    //------------------------------------------------------------------------
-   IOEntireFile(XrdOucCacheIO2 *io, XrdOucCacheStats &stats, Cache &cache);
+   IOEntireFile(XrdOucCacheIO2 *io, XrdOucCacheStats &stats, Cache &cache, bool writable = false,
+                bool exclusive = false);
 
    //------------------------------------------------------------------------
    //! Destructor
@@ -63,6 +64,12 @@ public:
 
    virtual int Read(char *Buffer, long long Offset, int Length);
 
+   //---------------------------------------------------------------------
+   //! Pass asynchronous Read request to the corresponding File object.
+   //! The calling thread is not blocked while missing blocks are fetched.
+   //---------------------------------------------------------------------
+   virtual void Read(XrdOucCacheIOCB &iocb, char *Buffer, long long Offset, int Length);
+
    //---------------------------------------------------------------------
    //! Pass ReadV request to the corresponding File object.
    //!
@@ -75,6 +82,26 @@ public:
 
    virtual int ReadV(const XrdOucIOVec *readV, int n);
 
+   //---------------------------------------------------------------------
+   //! Pass asynchronous ReadV request to the corresponding File object.
+   //---------------------------------------------------------------------
+   virtual void ReadV(XrdOucCacheIOCB &iocb, const XrdOucIOVec *readV, int n);
+
+   //---------------------------------------------------------------------
+   //! Pass Write request to the corresponding File object. Only files
+   //! created through the cache with write caching enabled are writable.
+   //---------------------------------------------------------------------
+   using XrdOucCacheIO2::Write;
+
+   virtual int Write(char *Buffer, long long Offset, int Length);
+
+   using XrdOucCacheIO2::Sync;
+
+   virtual int Sync();
+
+   //! Check if the file was made available by the cache.
+   bool HasFile() const { return m_file != 0; }
+
    //---------------------------------------------------------------------
    //! Detach itself from Cache. Note: this will delete the object.
    //!
@@ -35,9 +35,47 @@
 
 using namespace XrdFileCache;
 
+namespace
+{
+//! Collects results of reads from several file-blocks into one callback.
+class MultiBlockReadCB : public XrdOucCacheIOCB
+{
+public:
+   MultiBlockReadCB(XrdOucCacheIOCB &iocb, int n) :
+      m_iocb(iocb), m_to_wait(n), m_bytes_read(0), m_errno(0)
+   {}
+
+   virtual void Done(int res)
+   {
+      bool last;
+      {
+         XrdSysMutexHelper lock(&m_mutex);
+         if (res < 0)
+            m_errno = res;
+         else
+            m_bytes_read += res;
+         last = --m_to_wait == 0;
+      }
+      if (last)
+      {
+         m_iocb.Done(m_errno ? m_errno : m_bytes_read);
+         delete this;
+      }
+   }
+
+private:
+   XrdOucCacheIOCB &m_iocb;
+   XrdSysMutex      m_mutex;
+   int              m_to_wait;
+   int              m_bytes_read;
+   int              m_errno;
+};
+}
+
 //______________________________________________________________________________
-IOFileBlock::IOFileBlock(XrdOucCacheIO2 *io, XrdOucCacheStats &statsGlobal, Cache & cache) :
-  IO(io, statsGlobal, cache), m_localStat(0), m_info(cache.GetTrace(), false), m_infoFile(0)
+IOFileBlock::IOFileBlock(XrdOucCacheIO2 *io, XrdOucCacheStats &statsGlobal, Cache & cache, bool exclusive) :
+  IO(io, statsGlobal, cache), m_localStat(0), m_info(cache.GetTrace(), false), m_infoFile(0),
+  m_exclusive(exclusive)
 {
    m_blocksize = Cache::GetInstance().RefConfiguration().m_hdfsbsize;
    GetBlockSizeFromPath();
@@ -141,7 +179,7 @@ File* IOFileBlock::newBlockFile(long long off, int blocksize)
 
    TRACEIO(Debug, "FileBlock::FileBlock(), create XrdFileCacheFile ");
 
-   File* file = Cache::GetInstance().GetFile(fname, this, off, blocksize);
+   File* file = Cache::GetInstance().GetFile(fname, this, off, blocksize, false, m_exclusive);
    return file;
 }
 
@@ -269,6 +307,31 @@ bool IOFileBlock::ioActive()
    return active;
 }
 
+//______________________________________________________________________________
+File* IOFileBlock::getBlockFile(int blockIdx, long long fileSize)
+{
+   XrdSysMutexHelper lock(&m_mutex);
+
+   std::map<int, File*>::iterator it = m_blocks.find(blockIdx);
+   if (it != m_blocks.end())
+   {
+      return it->second;
+   }
+
+   size_t pbs = m_blocksize;
+   // check if this is last block
+   int lastIOFileBlock = (fileSize-1)/m_blocksize;
+   if (blockIdx == lastIOFileBlock )
+   {
+      pbs = fileSize - blockIdx*m_blocksize;
+      // TRACEIO(Dump, "IOFileBlock::Read() last block, change output file size to " << pbs);
+   }
+
+   File* fb = newBlockFile(blockIdx*m_blocksize, pbs);
+   m_blocks.insert(std::pair<int,File*>(blockIdx, (File*) fb));
+   return fb;
+}
+
 //______________________________________________________________________________
 int IOFileBlock::Read(char *buff, long long off, int size)
 {
@@ -295,28 +358,7 @@ int IOFileBlock::Read(char *buff, long long off, int size)
    for (int blockIdx = idx_first; blockIdx <= idx_last; ++blockIdx )
    {
       // locate block
-      File* fb;
-      m_mutex.Lock();
-      std::map<int, File*>::iterator it = m_blocks.find(blockIdx);
-      if (it != m_blocks.end())
-      {
-         fb = it->second;
-      }
-      else
-      {
-         size_t pbs = m_blocksize;
-         // check if this is last block
-         int lastIOFileBlock = (fileSize-1)/m_blocksize;
-         if (blockIdx == lastIOFileBlock )
-         {
-            pbs = fileSize - blockIdx*m_blocksize;
-            // TRACEIO(Dump, "IOFileBlock::Read() last block, change output file size to " << pbs);
-         }
-
-         fb = newBlockFile(blockIdx*m_blocksize, pbs);
-         m_blocks.insert(std::pair<int,File*>(blockIdx, (File*) fb));
-      }
-      m_mutex.UnLock();
+      File* fb = getBlockFile(blockIdx, fileSize);
 
       // edit size if read request is reaching more than a block
       int readBlockSize = size;
@@ -340,7 +382,8 @@ int IOFileBlock::Read(char *buff, long long off, int size)
 
       TRACEIO(Dump, "IOFileBlock::Read() block[ " << blockIdx << "] read-block-size[" << readBlockSize << "], offset[" << readBlockSize << "] off = " << off );
 
-      int retvalBlock = fb->Read(buff, off, readBlockSize);
+      // block file in use by another IO
+      int retvalBlock = fb ? fb->Read(buff, off, readBlockSize) : GetInput()->Read(buff, off, readBlockSize);
 
       TRACEIO(Dump, "IOFileBlock::Read()  Block read returned " << retvalBlock);
       if (retvalBlock == readBlockSize)
@@ -363,3 +406,50 @@ int IOFileBlock::Read(char *buff, long long off, int size)
 
    return bytes_read;
 }
+
+//______________________________________________________________________________
+void IOFileBlock::Read(XrdOucCacheIOCB &iocb, char *buff, long long off, int size)
+{
+   // protect from reads over the file size
+
+   long long fileSize = FSize();
+
+   if (off >= fileSize)
+   {
+      iocb.Done(0);
+      return;
+   }
+   if (off < 0)
+   {
+      iocb.Done(-EINVAL);
+      return;
+   }
+   if (off + size > fileSize)
+      size = fileSize - off;
+
+   int idx_first = off/m_blocksize;
+   int idx_last  = (off + size - 1) / m_blocksize;
+   TRACEIO(Dump, "IOFileBlock::Read() async "<< off << "@" << size << " block range ["<< idx_first << ", " << idx_last << "]");
+
+   if (idx_first == idx_last)
+   {
+      getBlockFile(idx_first, fileSize)->Read(iocb, buff, off, size);
+      return;
+   }
+
+   MultiBlockReadCB *mcb = new MultiBlockReadCB(iocb, idx_last - idx_first + 1);
+
+   for (int blockIdx = idx_first; blockIdx <= idx_last; ++blockIdx)
+   {
+      File* fb = getBlockFile(blockIdx, fileSize);
+
+      long long blockEnd      = (blockIdx + 1) * m_blocksize;
+      int       readBlockSize = (off + size > blockEnd) ? blockEnd - off : size;
+
+      fb->Read(*mcb, buff, off, readBlockSize);
+
+      buff += readBlockSize;
+      off  += readBlockSize;
+      size -= readBlockSize;
+   }
+}
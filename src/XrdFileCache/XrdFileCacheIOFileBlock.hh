@@ -41,7 +41,7 @@ public:
    //------------------------------------------------------------------------
    //! Constructor.
    //------------------------------------------------------------------------
-   IOFileBlock(XrdOucCacheIO2 *io, XrdOucCacheStats &stats, Cache &cache);
+   IOFileBlock(XrdOucCacheIO2 *io, XrdOucCacheStats &stats, Cache &cache, bool exclusive = false);
 
    //------------------------------------------------------------------------
    //! Destructor.
@@ -62,6 +62,11 @@ public:
 
    virtual int Read(char *Buffer, long long Offset, int Length);
 
+   //---------------------------------------------------------------------
+   //! Pass asynchronous Read request to the corresponding File objects.
+   //---------------------------------------------------------------------
+   virtual void Read(XrdOucCacheIOCB &iocb, char *Buffer, long long Offset, int Length);
+
    //! \brief Virtual method of XrdOucCacheIO.
    //! Called to check if destruction needs to be done in a separate task.
    virtual bool ioActive();
@@ -79,10 +84,12 @@ private:
    struct stat               *m_localStat;
    Info                       m_info;
    XrdOssDF*                  m_infoFile;
+   bool                       m_exclusive;       //!< do not take over active block files
 
    void  GetBlockSizeFromPath();
    int   initLocalStat();
    File* newBlockFile(long long off, int blocksize);
+   File* getBlockFile(int blockIdx, long long fileSize);
    void  CloseInfoFile();
 };
 }
@@ -140,6 +140,36 @@ void Info::SetFileSize(long long fs)
 
 //------------------------------------------------------------------------------
 
+void Info::GrowFileSize(long long fs)
+{
+   // Used when data is written through the cache, existing bits are kept.
+
+   if (fs <= m_store.m_fileSize) return;
+
+   m_store.m_fileSize = fs;
+
+   const int oldBytes = GetSizeInBytes();
+   const int newBits  = (fs - 1)/m_store.m_bufferSize + 1;
+   if (newBits <= m_sizeInBits) return;
+
+   m_sizeInBits = newBits;
+   const int newBytes = GetSizeInBytes();
+   if (newBytes == oldBytes) return;
+
+   m_buff_written        = (unsigned char*) realloc(m_buff_written,        newBytes);
+   m_store.m_buff_synced = (unsigned char*) realloc(m_store.m_buff_synced, newBytes);
+   memset(m_buff_written        + oldBytes, 0, newBytes - oldBytes);
+   memset(m_store.m_buff_synced + oldBytes, 0, newBytes - oldBytes);
+
+   if (m_buff_prefetch)
+   {
+      m_buff_prefetch = (unsigned char*) realloc(m_buff_prefetch, newBytes);
+      memset(m_buff_prefetch + oldBytes, 0, newBytes - oldBytes);
+   }
+}
+
+//------------------------------------------------------------------------------
+
 void Info::ResizeBits(int s)
 {
    // drop buffer in case of failed/partial reads
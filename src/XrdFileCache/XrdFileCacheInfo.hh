@@ -107,6 +107,13 @@ public:
    
    void SetFileSize(long long);
 
+   //---------------------------------------------------------------------
+   //! \brief Increase file size keeping state of existing blocks
+   //!
+   //! @param fs new file size, ignored if not larger than current
+   //---------------------------------------------------------------------
+   void GrowFileSize(long long fs);
+
    //---------------------------------------------------------------------
    //! \brief Reserve buffer for fileSize/bufferSize bytes
    //!
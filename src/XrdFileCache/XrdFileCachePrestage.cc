@@ -0,0 +1,473 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: agent <agent@local>
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <vector>
+
+#include "XProtocol/XProtocol.hh"
+#include "XrdCl/XrdClFile.hh"
+#include "XrdCl/XrdClURL.hh"
+#include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdSys/XrdSysTimer.hh"
+#include "XrdSys/XrdSysTrace.hh"
+
+#include "XrdFileCache.hh"
+#include "XrdFileCacheTrace.hh"
+#include "XrdFileCacheInfo.hh"
+#include "XrdFileCacheIOEntireFile.hh"
+#include "XrdFileCacheIOFileBlock.hh"
+
+using namespace XrdFileCache;
+
+namespace
+{
+const time_t s_stage_keep = 24 * 3600; // how long finished requests are remembered
+const int    s_stage_reap = 5;         // seconds between detach attempts of busy stage IOs
+
+int StatusToErrno(const XrdCl::XRootDStatus &st)
+{
+   if (st.IsOK()) return 0;
+   if (st.code == XrdCl::errErrorResponse) return XProtocol::toErrno(st.errNo);
+   return EIO;
+}
+
+//----------------------------------------------------------------------------
+//! Origin file opened by the cache itself to serve a pre-stage request.
+//----------------------------------------------------------------------------
+class StageIO : public XrdOucCacheIO2
+{
+public:
+   StageIO(const std::string &url) : m_url(url), m_size(0) {}
+
+   ~StageIO()
+   {
+      XrdCl::XRootDStatus st = m_file.Close();
+      (void) st;
+   }
+
+   int Open()
+   {
+      XrdCl::XRootDStatus st = m_file.Open(m_url, XrdCl::OpenFlags::Read);
+      if ( ! st.IsOK()) return StatusToErrno(st);
+
+      XrdCl::StatInfo *si = 0;
+      st = m_file.Stat(false, si);
+      if ( ! st.IsOK()) return StatusToErrno(st);
+      m_size = si->GetSize();
+      delete si;
+      return 0;
+   }
+
+   virtual long long   FSize() { return m_size; }
+
+   virtual const char *Path()  { return m_url.c_str(); }
+
+   using XrdOucCacheIO2::Read;
+
+   virtual int Read(char *buff, long long off, int size)
+   {
+      uint32_t bytes_read = 0;
+      XrdCl::XRootDStatus st = m_file.Read(off, size, buff, bytes_read);
+      if ( ! st.IsOK()) return -StatusToErrno(st);
+      return bytes_read;
+   }
+
+   virtual void Read(XrdOucCacheIOCB &iocb, char *buff, long long off, int size)
+   {
+      ReadHandler *h = new ReadHandler(iocb);
+      XrdCl::XRootDStatus st = m_file.Read(off, size, buff, h);
+      if ( ! st.IsOK())
+      {
+         delete h;
+         iocb.Done(-StatusToErrno(st));
+      }
+   }
+
+   using XrdOucCacheIO2::Sync;
+
+   virtual int Sync() { return 0; }
+
+   virtual int Trunc(long long) { return -ENOTSUP; }
+
+   using XrdOucCacheIO2::Write;
+
+   virtual int Write(char*, long long, int) { return -ENOTSUP; }
+
+private:
+   class ReadHandler : public XrdCl::ResponseHandler
+   {
+   public:
+      ReadHandler(XrdOucCacheIOCB &iocb) : m_iocb(iocb) {}
+
+      virtual void HandleResponse(XrdCl::XRootDStatus *status, XrdCl::AnyObject *response)
+      {
+         int res;
+         if (status->IsOK())
+         {
+            XrdCl::ChunkInfo *chunk = 0;
+            response->Get(chunk);
+            res = chunk ? (int) chunk->length : 0;
+         }
+         else
+         {
+            res = -StatusToErrno(*status);
+         }
+         delete status;
+         delete response;
+         m_iocb.Done(res);
+         delete this;
+      }
+
+   private:
+      XrdOucCacheIOCB &m_iocb;
+   };
+
+   XrdCl::File m_file;
+   std::string m_url;
+   long long   m_size;
+};
+
+//----------------------------------------------------------------------------
+bool ReadInfoFile(const std::string &lpath, Info &info)
+{
+   Cache     &cache = Cache::GetInstance();
+   std::string  ifn = lpath + Info::m_infoExtension;
+   XrdOucEnv    myEnv;
+
+   XrdOssDF *fp = cache.GetOss()->newFile(cache.RefConfiguration().m_username.c_str());
+   bool ok = fp->Open(ifn.c_str(), O_RDONLY, 0600, myEnv) == XrdOssOK && info.Read(fp, ifn);
+   fp->Close();
+   delete fp;
+   return ok;
+}
+
+bool GetParam(XrdCl::URL::ParamsMap &params, const char *key, long long &val)
+{
+   XrdCl::URL::ParamsMap::iterator it = params.find(key);
+   if (it == params.end()) return true;
+
+   char *eP;
+   errno = 0;
+   val = strtoll(it->second.c_str(), &eP, 10);
+   params.erase(it);
+   return ! errno && *eP == 0 && val >= 0;
+}
+}
+
+//______________________________________________________________________________
+int Cache::Stage(const char *curl, int prty)
+{
+   if (m_configuration.m_stage_threads <= 0) return -ENOTSUP;
+
+   XrdCl::URL url(curl);
+   if ( ! url.IsValid()) return -EINVAL;
+
+   StageRequest req;
+   req.m_off = 0;
+   req.m_len = 0;
+
+   // Staging options are removed from the url that is opened at origin.
+   XrdCl::URL::ParamsMap params = url.GetParams();
+   if ( ! GetParam(params, "pfc.off", req.m_off) || ! GetParam(params, "pfc.len", req.m_len))
+   {
+      TRACE(Error, "Cache::Stage() invalid range for " << url.GetPath());
+      return -EINVAL;
+   }
+   url.SetParams(params);
+
+   req.m_url   = url.GetURL();
+   req.m_lpath = url.GetPath();
+
+   prty = std::max(0, std::min(prty, s_stage_nprty - 1));
+
+   XrdSysCondVarHelper _lck(m_stage_condVar);
+
+   time_t now = time(0);
+   std::map<std::string, StageState>::iterator it = m_stage_state.begin();
+   while (it != m_stage_state.end())
+   {
+      if ((it->second.m_state == StageState::kDone || it->second.m_state == StageState::kFailed) &&
+          it->second.m_time + s_stage_keep < now)
+         m_stage_state.erase(it++);
+      else
+         ++it;
+   }
+
+   StageState &st = m_stage_state[req.m_lpath];
+   if (st.m_time && (st.m_state == StageState::kQueued || st.m_state == StageState::kActive))
+   {
+      TRACE(Debug, "Cache::Stage() already scheduled " << req.m_lpath);
+      return 0;
+   }
+
+   st = StageState();
+   st.m_time = now;
+   m_stageQ[prty].push_back(req);
+   m_stage_condVar.Signal();
+
+   TRACE(Info, "Cache::Stage() queued " << req.m_lpath << " off " << req.m_off << " len " << req.m_len
+         << " prty " << prty);
+   return 0;
+}
+
+//______________________________________________________________________________
+int Cache::StageStatus(const char *curl, char *buff, int blen)
+{
+   XrdCl::URL  url(curl);
+   std::string lpath = url.GetPath();
+
+   {
+      XrdSysCondVarHelper _lck(m_stage_condVar);
+      std::map<std::string, StageState>::iterator it = m_stage_state.find(lpath);
+      if (it != m_stage_state.end())
+      {
+         const StageState &st = it->second;
+         switch (st.m_state)
+         {
+            case StageState::kQueued:
+               return snprintf(buff, blen, "queued 0 %lld", st.m_size);
+            case StageState::kActive:
+               return snprintf(buff, blen, "staging %lld %lld", st.m_bytes, st.m_size);
+            case StageState::kFailed:
+               return snprintf(buff, blen, "failed %lld %lld %s", st.m_bytes, st.m_size, strerror(st.m_errno));
+            default:
+               break;
+         }
+      }
+   }
+
+   // Finished or never requested through prepare, report what is on disk.
+   Info info(m_trace);
+   if ( ! ReadInfoFile(lpath, info))
+      return snprintf(buff, blen, "absent 0 -1");
+
+   return snprintf(buff, blen, "%s %lld %lld", info.IsComplete() ? "cached" : "partial",
+                   info.GetNDownloadedBytes(), info.GetFileSize());
+}
+
+//______________________________________________________________________________
+void Cache::ProcessStageRequests()
+{
+   while (true)
+   {
+      StageReap();
+
+      m_stage_condVar.Lock();
+      int p = -1;
+      while (true)
+      {
+         for (p = s_stage_nprty - 1; p >= 0; --p)
+         {
+            if ( ! m_stageQ[p].empty()) break;
+         }
+         if (p >= 0) break;
+         if (m_stage_detach.empty())
+         {
+            m_stage_condVar.Wait();
+         }
+         else
+         {
+            m_stage_condVar.Wait(s_stage_reap);
+            m_stage_condVar.UnLock();
+            StageReap();
+            m_stage_condVar.Lock();
+         }
+      }
+      StageRequest req = m_stageQ[p].front();
+      m_stageQ[p].pop_front();
+
+      StageState &st = m_stage_state[req.m_lpath];
+      st.m_state = StageState::kActive;
+      st.m_time  = time(0);
+      m_stage_condVar.UnLock();
+
+      int rc = StageFile(req);
+
+      m_stage_condVar.Lock();
+      StageState &fst = m_stage_state[req.m_lpath];
+      fst.m_state = rc ? StageState::kFailed : StageState::kDone;
+      fst.m_errno = rc;
+      fst.m_time  = time(0);
+      m_stage_condVar.UnLock();
+   }
+}
+
+//______________________________________________________________________________
+void Cache::StagePace(long long bytes)
+{
+   // Reserve a time slot on a timeline shared by all pre-stage threads so that
+   // the total pre-stage rate stays below the configured bandwidth.
+
+   if (m_configuration.m_stage_bw <= 0) return;
+
+   struct timeval tv;
+   gettimeofday(&tv, 0);
+   double now = tv.tv_sec + tv.tv_usec * 1e-6;
+
+   m_stage_bw_mutex.Lock();
+   double start = std::max(now, m_stage_bw_next);
+   m_stage_bw_next = start + (double) bytes / m_configuration.m_stage_bw;
+   m_stage_bw_mutex.UnLock();
+
+   if (start > now) XrdSysTimer::Wait((int) ((start - now) * 1000));
+}
+
+//______________________________________________________________________________
+void Cache::StageDetach(IO *cio)
+{
+   // Same handshake as XrdPosixFile: detach only once the IO has no active
+   // I/O, otherwise park it and let the stage threads retry later.
+
+   if ( ! cio->ioActive())
+   {
+      delete cio->Detach();
+      return;
+   }
+
+   XrdSysCondVarHelper _lck(m_stage_condVar);
+   m_stage_detach.push_back(cio);
+}
+
+//______________________________________________________________________________
+void Cache::StageReap()
+{
+   std::list<IO*> busy;
+   {
+      XrdSysCondVarHelper _lck(m_stage_condVar);
+      busy.swap(m_stage_detach);
+   }
+
+   for (std::list<IO*>::iterator i = busy.begin(); i != busy.end(); )
+   {
+      if ((*i)->ioActive())
+      {
+         ++i;
+      }
+      else
+      {
+         delete (*i)->Detach();
+         i = busy.erase(i);
+      }
+   }
+
+   if ( ! busy.empty())
+   {
+      XrdSysCondVarHelper _lck(m_stage_condVar);
+      m_stage_detach.splice(m_stage_detach.end(), busy);
+   }
+}
+
+//______________________________________________________________________________
+int Cache::StageFile(const StageRequest &req)
+{
+   TRACE(Debug, "Cache::StageFile() begin " << req.m_lpath);
+
+   StageIO *sio = new StageIO(req.m_url);
+   int rc = sio->Open();
+   if (rc)
+   {
+      TRACE(Warning, "Cache::StageFile() can not open " << req.m_lpath << " at origin, err=" << strerror(rc));
+      delete sio;
+      return rc;
+   }
+
+   if ( ! Decide(sio))
+   {
+      TRACE(Info, "Cache::StageFile() decision decline " << req.m_lpath);
+      delete sio;
+      return EPERM;
+   }
+
+   long long fsize = sio->FSize();
+   long long beg   = std::min(req.m_off, fsize);
+   long long end   = req.m_len > 0 ? std::min(beg + req.m_len, fsize) : fsize;
+
+   // Blocks that are already on disk are not read again.
+   Info      cinfo(m_trace);
+   bool      haveInfo = ! m_configuration.m_hdfsmode && ReadInfoFile(req.m_lpath, cinfo) &&
+                        cinfo.GetFileSize() == fsize;
+   long long bs       = haveInfo ? cinfo.GetBufferSize() : m_configuration.m_bufferSize;
+
+   // Files in use are left to their clients: the stage IO never takes over an
+   // active File, a client opening the file later takes it over from us.
+   IOEntireFile *eio = 0;
+   IO           *cio;
+   if (m_configuration.m_hdfsmode)
+   {
+      cio = new IOFileBlock(sio, m_stats, *this, true);
+   }
+   else
+   {
+      cio = eio = new IOEntireFile(sio, m_stats, *this, false, true);
+      if ( ! eio->HasFile())
+      {
+         TRACE(Info, "Cache::StageFile() file is in use, not staged " << req.m_lpath);
+         delete eio->Detach();
+         return EBUSY;
+      }
+   }
+
+   {
+      XrdSysCondVarHelper _lck(m_stage_condVar);
+      m_stage_state[req.m_lpath].m_size = end - beg;
+   }
+
+   std::vector<char> buf(bs);
+   long long bytes = 0;
+   for (long long off = (beg / bs) * bs; off < end; off += bs)
+   {
+      if (eio && ! eio->HasFile())
+      {
+         TRACE(Info, "Cache::StageFile() file opened by a client, leaving the rest to it " << req.m_lpath);
+         break;
+      }
+
+      int       size = (int) std::min(bs, fsize - off);
+      long long used = std::min(off + size, end) - std::max(off, beg);
+
+      if ( ! (haveInfo && cinfo.TestBit(off / bs)))
+      {
+         StagePace(size);
+         int res = cio->Read(&buf[0], off, size);
+         if (res < 0)
+         {
+            // cache layer reports -1 with errno, origin -errno
+            rc = (res == -1) ? (errno ? errno : EIO) : -res;
+            TRACE(Warning, "Cache::StageFile() read failed for " << req.m_lpath << " off " << off
+                  << ", err=" << strerror(rc));
+            break;
+         }
+      }
+
+      bytes += used;
+      XrdSysCondVarHelper _lck(m_stage_condVar);
+      m_stage_state[req.m_lpath].m_bytes = bytes;
+   }
+
+   StageDetach(cio);
+
+   TRACE(Info, "Cache::StageFile() " << (rc ? "failed " : "done ") << req.m_lpath << " bytes " << bytes);
+   return rc;
+}
@@ -1,5 +1,6 @@
 #include "XrdFileCache.hh"
 #include "XrdFileCacheTrace.hh"
+#include "XrdFileCacheDedup.hh"
 
 using namespace XrdFileCache;
 
@@ -160,6 +161,13 @@ void Cache::CacheDirCleanup()
       {
          long long ausage = sP.Total - sP.Free;
          TRACE(Info, "Cache::CacheDirCleanup() used disk space " << ausage << " bytes.");
+         if (m_dedup)
+         {
+            long long logical, physical;
+            m_dedup->GetStats(logical, physical);
+            TRACE(Info, "Cache::CacheDirCleanup() dedup referenced " << logical << " bytes, stored " << physical
+                  << " bytes, ratio " << (physical > 0 ? (double) logical / physical : 1.0));
+         }
          if (ausage > m_configuration.m_diskUsageHWM)
          {
             bytesToRemove = ausage - m_configuration.m_diskUsageLWM;
@@ -203,6 +211,7 @@ void Cache::CacheDirCleanup()
                   bytesToRemove -= it->second.nByte;
 
                   oss->Unlink(dataPath.c_str());
+                  if (m_dedup) m_dedup->ReleaseFile(dataPath);
                   TRACE(Info, "Cache::CacheDirCleanup() removed file: %s " << dataPath << " size " << it->second.nByte);
                }
 
@@ -11,6 +11,11 @@
 #include "XrdCl/XrdClFile.hh"
 #include "XrdCl/XrdClXRootDResponses.hh"
 
+#include <algorithm>
+#include <map>
+#include <limits.h>
+#include <sys/uio.h>
+
 namespace XrdFileCache
 {
 // a list of IOVec chuncks that match a given block index
@@ -73,6 +78,20 @@ struct ReadVBlockListDisk
 };
 }
 
+namespace
+{
+bool vec_offset_less(const XrdOucIOVec &a, const XrdOucIOVec &b)
+{
+   return a.offset < b.offset;
+}
+
+#ifndef IOV_MAX
+const int VREAD_IOV_MAX = 1024;
+#else
+const int VREAD_IOV_MAX = IOV_MAX;
+#endif
+}
+
 using namespace XrdFileCache;
 
 //------------------------------------------------------------------------------
@@ -108,12 +127,17 @@ int File::ReadV(const XrdOucIOVec *readV, int n)
       errno = ENOMEM;
    }
 
+   const bool merge = Cache::GetInstance().RefConfiguration().m_vread_merge;
+   int bytesDisk = 0, bytesRam = 0, bytesRemote = 0;
+
    // issue a client read
 
    if (bytesRead >= 0)
    {
       if ( ! chunkVec.empty())
       {
+         if (merge) VReadMergeDirect(chunkVec);
+
          direct_handler = new DirectResponseHandler(1);
          m_io->GetInput()->ReadV(*direct_handler, &chunkVec[0], chunkVec.size());
       }
@@ -122,11 +146,12 @@ int File::ReadV(const XrdOucIOVec *readV, int n)
    // disk read
    if (bytesRead >= 0)
    {
-      int dr = VReadFromDisk(readV, n, blocks_on_disk);
+      int dr = merge ? VReadMergedFromDisk(readV, n, blocks_on_disk)
+                     : VReadFromDisk(readV, n, blocks_on_disk);
       if (dr < 0)
          bytesRead = dr;
       else
-         bytesRead += dr;
+         bytesRead += bytesDisk = dr;
    }
 
    // read from cached blocks
@@ -136,7 +161,7 @@ int File::ReadV(const XrdOucIOVec *readV, int n)
       if (br < 0)
          bytesRead = br;
       else
-         bytesRead += br;
+         bytesRead += bytesRam = br;
    }
 
    // check direct requests have arrived, get bytes read from read handle
@@ -153,9 +178,10 @@ int File::ReadV(const XrdOucIOVec *readV, int n)
       {
          for (std::vector<XrdOucIOVec>::iterator i = chunkVec.begin(); i != chunkVec.end(); ++i)
          {
-            bytesRead += i->size;
-            m_stats.m_BytesMissed += i->size;
+            bytesRemote += i->size;
          }
+         bytesRead             += bytesRemote;
+         m_stats.m_BytesMissed += bytesRemote;
       }
       else
       {
@@ -183,7 +209,8 @@ int File::ReadV(const XrdOucIOVec *readV, int n)
    for (std::vector<ReadVChunkListRAM>::iterator i = blks_processed.begin(); i != blks_processed.end(); ++i)
       delete i->arr;
 
-   TRACEF(Dump, "VRead exit, total = " << bytesRead);
+   TRACEF(Dump, "ReadV " << n << " chunks, total = " << bytesRead << " ram = " << bytesRam
+          << " disk = " << bytesDisk << " remote = " << bytesRemote << " in " << chunkVec.size() << " direct chunks");
    return bytesRead;
 }
 
@@ -211,8 +238,34 @@ bool File::VReadPreProcess(const XrdOucIOVec *readV, int n,
 {
    BlockList_t blks_to_request;
 
+   const long long BS     = m_cfi.GetBufferSize();
+   const bool      merge  = Cache::GetInstance().RefConfiguration().m_vread_merge;
+   const double    admit  = Cache::GetInstance().RefConfiguration().m_vread_admit;
+
+   // number of requested bytes that fall into each missing block
+   std::map<int, long long> coverage;
+
    m_downloadCond.Lock();
 
+   if (merge)
+   {
+      for (int iov_idx = 0; iov_idx < n; iov_idx++)
+      {
+         const int blck_idx_first =  readV[iov_idx].offset / BS;
+         const int blck_idx_last  = (readV[iov_idx].offset + readV[iov_idx].size - 1) / BS;
+
+         for (int block_idx = blck_idx_first; block_idx <= blck_idx_last; ++block_idx)
+         {
+            if (m_block_map.find(block_idx) != m_block_map.end() || m_cfi.TestBit(offsetIdx(block_idx)))
+               continue;
+
+            long long off, blk_off, size;
+            overlap(block_idx, BS, readV[iov_idx].offset, readV[iov_idx].size, off, blk_off, size);
+            coverage[block_idx] += size;
+         }
+      }
+   }
+
    for (int iov_idx = 0; iov_idx < n; iov_idx++)
    {
       const int blck_idx_first =  readV[iov_idx].offset / m_cfi.GetBufferSize();
@@ -238,7 +291,10 @@ bool File::VReadPreProcess(const XrdOucIOVec *readV, int n,
          }
          else
          {
-            if (Cache::GetInstance().RequestRAMBlock())
+            // Sparse misses are passed directly to origin, the block is left for prefetch.
+            const bool admitted = ! merge || coverage[block_idx] >= admit * BS;
+
+            if (admitted && Cache::GetInstance().RequestRAMBlock())
             {
                Block *b = PrepareBlockRequest(block_idx, false);
                // TODO this can not fail (other than out of memory which we don't handle).
@@ -254,9 +310,8 @@ bool File::VReadPreProcess(const XrdOucIOVec *readV, int n,
                long long off;      // offset in user buffer
                long long blk_off;      // offset in block
                long long size;      // size to copy
-               const long long BS = m_cfi.GetBufferSize();
                overlap(block_idx, BS, readV[iov_idx].offset, readV[iov_idx].size, off, blk_off, size);
-               chunkVec.push_back(XrdOucIOVec2(readV[iov_idx].data+off, BS*block_idx + blk_off,size));
+               chunkVec.push_back(XrdOucIOVec2(readV[iov_idx].data+off, BS*block_idx + blk_off, size, iov_idx));
 
                TRACEF(Dump, "VReadPreProcess direct read " << block_idx);
             }
@@ -312,6 +367,135 @@ int File::VReadFromDisk(const XrdOucIOVec *readV, int n, ReadVBlockListDisk& blo
 
 //------------------------------------------------------------------------------
 
+int File::VReadMergedFromDisk(const XrdOucIOVec *readV, int n, ReadVBlockListDisk& blocks_on_disk)
+{
+   // Collect all pieces of user chunks that reside on disk and read them with
+   // as few system calls as possible: pieces contiguous in the data file are
+   // read with a single preadv().
+
+   const long long BS = m_cfi.GetBufferSize();
+
+   std::vector<XrdOucIOVec> pieces;
+   for (std::vector<ReadVChunkListDisk>::iterator bit = blocks_on_disk.bv.begin(); bit != blocks_on_disk.bv.end(); ++bit)
+   {
+      for (std::vector<int>::iterator chunkIt = bit->arr.begin(); chunkIt != bit->arr.end(); ++chunkIt)
+      {
+         long long off;     // offset in user buffer
+         long long blk_off; // offset in block
+         long long size;    // size to copy
+
+         overlap(bit->block_idx, BS, readV[*chunkIt].offset, readV[*chunkIt].size, off, blk_off, size);
+         pieces.push_back(XrdOucIOVec2(readV[*chunkIt].data + off, bit->block_idx*BS + blk_off - m_offset, size));
+      }
+   }
+
+   if (pieces.empty()) return 0;
+
+   std::sort(pieces.begin(), pieces.end(), vec_offset_less);
+
+   // Join pieces that are contiguous both on disk and in user memory.
+   std::vector<XrdOucIOVec>::iterator last = pieces.begin();
+   for (std::vector<XrdOucIOVec>::iterator i = pieces.begin() + 1; i != pieces.end(); ++i)
+   {
+      if (last->offset + last->size == i->offset && last->data + last->size == i->data)
+         last->size += i->size;
+      else
+         *(++last) = *i;
+   }
+   pieces.erase(++last, pieces.end());
+
+   int bytes_read = 0;
+   int fd         = m_output->getFD();
+
+   if (fd < 0)
+   {
+      ssize_t rs = m_output->ReadV(&pieces[0], pieces.size());
+      if (rs < 0)
+      {
+         errno = -rs;
+         TRACEF(Error, "VReadMergedFromDisk FAILED ReadV of " << pieces.size() << " pieces, err = " << strerror(errno));
+         return -1;
+      }
+      bytes_read = rs;
+   }
+   else
+   {
+      struct iovec iov[VREAD_IOV_MAX];
+      int nsys = 0;
+      size_t i = 0;
+      while (i < pieces.size())
+      {
+         const long long beg = pieces[i].offset;
+         long long       end = beg;
+         int             cnt = 0;
+         while (i < pieces.size() && pieces[i].offset == end && cnt < VREAD_IOV_MAX)
+         {
+            iov[cnt].iov_base = pieces[i].data;
+            iov[cnt].iov_len  = pieces[i].size;
+            end += pieces[i].size;
+            ++cnt; ++i;
+         }
+
+         // A short read continues where it stopped; only an error or an
+         // unexpected end of file fails the whole readv.
+         long long pos = beg;
+         int       idx = 0;
+         while (pos < end)
+         {
+            ssize_t rs;
+            do { rs = preadv(fd, iov + idx, cnt - idx, pos); } while (rs < 0 && errno == EINTR);
+            ++nsys;
+
+            if (rs <= 0)
+            {
+               if (rs == 0) errno = ESPIPE;
+               TRACEF(Error, "VReadMergedFromDisk FAILED preadv off = " << pos << " size = " << end - pos
+                      << " ret = " << rs << " err = " << strerror(errno));
+               return -1;
+            }
+            pos += rs;
+            bytes_read += rs;
+
+            while (rs > 0 && (size_t) rs >= iov[idx].iov_len)
+            {
+               rs -= iov[idx].iov_len;
+               ++idx;
+            }
+            if (rs > 0)
+            {
+               iov[idx].iov_base = (char*) iov[idx].iov_base + rs;
+               iov[idx].iov_len -= rs;
+            }
+         }
+      }
+      TRACEF(Dump, "VReadMergedFromDisk " << pieces.size() << " pieces in " << nsys << " preadv calls");
+   }
+
+   m_stats.m_BytesDisk += bytes_read;
+   return bytes_read;
+}
+
+//------------------------------------------------------------------------------
+
+void File::VReadMergeDirect(std::vector<XrdOucIOVec>& chunkVec)
+{
+   // Pieces of the same user chunk that were split on block boundaries are
+   // joined again so that origin receives them as a single readv element.
+   // The info field holds the index of the user chunk.
+
+   std::vector<XrdOucIOVec>::iterator last = chunkVec.begin();
+   for (std::vector<XrdOucIOVec>::iterator i = chunkVec.begin() + 1; i != chunkVec.end(); ++i)
+   {
+      if (last->info == i->info && last->offset + last->size == i->offset && last->data + last->size == i->data)
+         last->size += i->size;
+      else
+         *(++last) = *i;
+   }
+   chunkVec.erase(++last, chunkVec.end());
+}
+
+//------------------------------------------------------------------------------
+
 int File::VReadProcessBlocks(const XrdOucIOVec *readV, int n,
                              std::vector<ReadVChunkListRAM>& blocks_to_process,
                              std::vector<ReadVChunkListRAM>& blocks_processed)
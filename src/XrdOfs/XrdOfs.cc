@@ -1534,6 +1534,7 @@ int XrdOfs::fsctl(const int               cmd,
                         SFS_FSCTL_STATFS - return file system info (physical)
                         SFS_FSCTL_STATLS - return file system info (logical)
                         SFS_FSCTL_STATXA - return file extended attributes
+                        SFS_FSCTL_STATPR - return file pre-stage status
             arg       - Command dependent argument:
                       - Locate: The path whose location is wanted
             buf       - The stat structure to hold the results
@@ -1665,6 +1666,23 @@ int XrdOfs::fsctl(const int               cmd,
        return SFS_DATA;
       }
 
+// Process the STATPR request, only an oss that caches files can answer it
+//
+   if (opcode == SFS_FSCTL_STATPR)
+      {char pbuff[1024], *resp = 0;
+       const char *opq, *Path = Split(args, &opq, pbuff, sizeof(pbuff));
+       AUTHORIZE(client,0,AOP_Stat,"prepare status",Path,einfo);
+       if ((retc = XrdOfsOss->FSctl(XRDOSS_FSctlQPrep, strlen(args), args,
+                                    &resp)) < 0)
+          return XrdOfsFS->Emsg(epname, einfo, retc, "query prepare", args);
+       bP = einfo.getMsgBuff(blen);
+       if (retc >= blen) retc = blen - 1;
+       if (resp) {strncpy(bP, resp, retc); free(resp);}
+       bP[retc] = '\0';
+       einfo.setErrCode(retc+1);
+       return SFS_DATA;
+      }
+
 // Process the STATCC request (this should always succeed)
 //
    if (opcode == SFS_FSCTL_STATCC)
@@ -1807,6 +1825,30 @@ int XrdOfs::prepare(      XrdSfsPrep       &pargs,      // In
    if (XrdOfsFS->Finder
    && (retc = XrdOfsFS->Finder->Prepare(out_error, pargs, &prep_Env)))
       return fsError(out_error, retc);
+
+// Stage requests that are not forwarded to a cluster are passed to the oss.
+// A caching proxy uses them to pre-stage files; other oss plugins do not
+// support this and the request is ignored, as before.
+//
+   if ((pargs.opts & Prep_STAGE)
+   &&  (!XrdOfsFS->Finder || !XrdOfsFS->Finder->isRemote()))
+      {XrdOucTList *op = pargs.oinfo;
+       char pbuff[MAXPATHLEN+16];
+       int plen;
+       tp = pargs.paths;
+       while(tp)
+            {const char *opq = (op && op->text && *op->text ? op->text : 0);
+             plen = snprintf(pbuff, sizeof(pbuff), "%d %s%s%s",
+                             pargs.opts & Prep_PMASK, tp->text,
+                             (opq ? "?" : ""), (opq ? opq : ""));
+             if (plen >= (int)sizeof(pbuff))
+                return XrdOfsFS->Emsg(epname,out_error,ENAMETOOLONG,"prepare",tp->text);
+             retc = XrdOfsOss->FSctl(XRDOSS_FSctlPrep, plen, pbuff);
+             if (retc == -ENOTSUP) break;
+             if (retc) return XrdOfsFS->Emsg(epname,out_error,retc,"prepare",tp->text);
+             tp = tp->next; if (op) op = op->next;
+            }
+      }
    return 0;
 }
   
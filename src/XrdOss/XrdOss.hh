@@ -151,6 +151,11 @@ int     fd;      // The associated file descriptor.
 #define XRDOSS_updtatm 0x0002
 #define XRDOSS_preop   0x0004
 
+// Commands that can be passed to FSctl()
+//
+#define XRDOSS_FSctlPrep  1 // args: "<prty> <path>[?cgi]"  pre-stage a file
+#define XRDOSS_FSctlQPrep 2 // args: "<path>[?cgi]" *resp: malloc'd status text
+
 // Class passed to StatVS()
 //
 class XrdOssVSInfo
@@ -281,6 +281,37 @@ int            Prepare(const char *url, int oflags, mode_t mode)
 virtual int  Stat(const char *url, struct stat &sbuff)
                  {(void)url; (void)sbuff; return 1;}
 
+//------------------------------------------------------------------------------
+//! Pre-stage a file into the cache ahead of its use (e.g. in response to a
+//! prepare request). The request is normally queued and processed in the
+//! background.
+//!
+//! @param url    pointer to the url of the file to be staged. The cgi may hold
+//!               implementation specific staging options (e.g. a byte range).
+//! @param prty   staging priority, 0 (lowest) to 3 (highest).
+//!
+//! @return <0 - Staging failed, value is -errno. -ENOTSUP means the cache
+//!              does not support pre-staging.
+//!         =0 - Staging request accepted.
+//------------------------------------------------------------------------------
+
+virtual int  Stage(const char *url, int prty)
+                  {(void)url; (void)prty; return -ENOTSUP;}
+
+//------------------------------------------------------------------------------
+//! Report the pre-stage status of a file.
+//!
+//! @param url    pointer to the url of the file whose status is wanted.
+//! @param buff   pointer to the buffer to receive the null terminated status.
+//! @param blen   length of the buffer.
+//!
+//! @return <0 - Query failed, value is -errno.
+//!         >=0- Length of the status text placed in buff.
+//------------------------------------------------------------------------------
+
+virtual int  StageStatus(const char *url, char *buff, int blen)
+                        {(void)url; (void)buff; (void)blen; return -ENOTSUP;}
+
                XrdOucCache2() {}
 virtual       ~XrdOucCache2() {}
 };
@@ -111,6 +111,7 @@ XrdPosixFile::XrdPosixFile(bool &aOK, const char *path, XrdPosixCallBack *cbP,
 // Set cache update option
 //
    if (Opts & isUpdt) cOpt |= XrdOucCache::optRW;
+   if (Opts & isNew)  cOpt |= XrdOucCache::optNEW;
 }
   
 /******************************************************************************/
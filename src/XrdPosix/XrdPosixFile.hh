@@ -82,6 +82,9 @@ static void*         DelayedDestroy(void*);
 
 static void          DelayedDestroy(XrdPosixFile *fp);
 
+       bool          cacheWrites() {return XCio != (XrdOucCacheIO2 *)this
+                                           && (cOpt & XrdOucCache::optNEW);}
+
        bool          Close(XrdCl::XRootDStatus &Status);
 
        bool          Finalize(XrdCl::XRootDStatus *Status);
@@ -174,6 +177,7 @@ static int           ddNum;
 static const int realFD = 1;
 static const int isStrm = 2;
 static const int isUpdt = 4;
+static const int isNew  = 8;
 
            XrdPosixFile(bool &aOK, const char *path, XrdPosixCallBack *cbP=0,
                         int   Opts=0);
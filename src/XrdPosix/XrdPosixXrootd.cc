@@ -254,6 +254,7 @@ int XrdPosixXrootd::Close(int fildes)
    XrdCl::XRootDStatus Status;
    XrdPosixFile *fP;
    bool ret;
+   int wbErr = 0;
 
 // Map the file number to the file object. In the prcess we relese the file
 // number so no one can reference this file again.
@@ -261,6 +262,11 @@ int XrdPosixXrootd::Close(int fildes)
    if (!(fP = XrdPosixObject::ReleaseFile(fildes)))
       {errno = EBADF; return -1;}
 
+// A file written through the cache may still be uploaded to origin. Wait for
+// the upload so that a write-back failure is reported by the close.
+//
+   if (fP->cacheWrites() && fP->XCio->Sync() < 0) wbErr = (errno ? errno : EIO);
+
 // Close the file if there is no active I/O (possible caching). Delete the
 // object if the close was successful (it might not be).
 //
@@ -276,6 +282,7 @@ int XrdPosixXrootd::Close(int fildes)
 
 // Return final result
 //
+   if (wbErr) {errno = wbErr; return -1;}
    return (ret ? 0 : XrdPosixMap::Result(Status));
 }
 
@@ -559,9 +566,12 @@ int XrdPosixXrootd::Open(const char *path, int oflags, mode_t mode,
                                    : XrdCl::OpenFlags::Delete);
        XOflags |= XrdCl::OpenFlags::MakePath;
        XOmode   = XrdPosixMap::Mode2Access(mode);
+       if (Opts & XrdPosixFile::isUpdt) Opts |= XrdPosixFile::isNew;
       }
       else if (oflags & O_TRUNC && Opts & XrdPosixFile::isUpdt)
-              XOflags |= XrdCl::OpenFlags::Delete;
+              {XOflags |= XrdCl::OpenFlags::Delete;
+               Opts    |= XrdPosixFile::isNew;
+              }
 
 // Allocate the new file object
 //
@@ -1065,6 +1075,40 @@ void XrdPosixXrootd::Seekdir(DIR *dirp, long loc)
    dP->UnLock();
 }
 
+/******************************************************************************/
+/*                                 S t a g e                                  */
+/******************************************************************************/
+
+int XrdPosixXrootd::Stage(const char *path, int prty)
+{
+   int rc;
+
+// Only a cache can stage files
+//
+   if (!XrdPosixGlobals::myCache2) {errno = ENOTSUP; return -1;}
+
+   if ((rc = XrdPosixGlobals::myCache2->Stage(path, prty)) < 0)
+      {errno = -rc; return -1;}
+   return 0;
+}
+
+/******************************************************************************/
+/*                           S t a g e S t a t u s                            */
+/******************************************************************************/
+
+int XrdPosixXrootd::StageStatus(const char *path, char *buff, int blen)
+{
+   int rc;
+
+// Only a cache knows about staged files
+//
+   if (!XrdPosixGlobals::myCache2) {errno = ENOTSUP; return -1;}
+
+   if ((rc = XrdPosixGlobals::myCache2->StageStatus(path, buff, blen)) < 0)
+      {errno = -rc; return -1;}
+   return (rc < blen ? rc : blen - 1);
+}
+
 /******************************************************************************/
 /*                                  S t a t                                   */
 /******************************************************************************/
@@ -277,6 +277,30 @@ static int     Rmdir(const char *path);
 
 static void    Seekdir(DIR *dirp, long loc);
 
+//-----------------------------------------------------------------------------
+//! Stage() asks the cache, if one is configured, to pre-stage a file.
+//!
+//! @param  path  Url of the file, the cgi may hold cache specific options.
+//! @param  prty  Staging priority, 0 (lowest) to 3 (highest).
+//!
+//! @return 0 upon success, -1 with errno set otherwise. ENOTSUP is returned
+//!         when there is no cache or the cache does not support staging.
+//-----------------------------------------------------------------------------
+
+static int     Stage(const char *path, int prty);
+
+//-----------------------------------------------------------------------------
+//! StageStatus() returns the cache's pre-stage status of a file as text.
+//!
+//! @param  path  Url of the file.
+//! @param  buff  Buffer for the null terminated status text.
+//! @param  blen  Length of the buffer.
+//!
+//! @return Length of the status text upon success, -1 with errno set otherwise.
+//-----------------------------------------------------------------------------
+
+static int     StageStatus(const char *path, char *buff, int blen);
+
 //-----------------------------------------------------------------------------
 //! Stat() conforms to POSIX.1-2001 stat()
 //-----------------------------------------------------------------------------
@@ -37,6 +37,8 @@
 #include <signal.h>
 #include <strings.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/file.h>
 #include <sys/param.h>
 #include <sys/stat.h>
@@ -228,6 +230,56 @@ void        XrdPssSys::EnvInfo(XrdOucEnv *envP)
        XrdPosixConfig::EnvInfo(*envP);
       }
 }
+
+/******************************************************************************/
+/*                                 F S c t l                                  */
+/******************************************************************************/
+/*
+  Function: Pass file system control requests to the cache.
+
+  Input:    cmd         - XRDOSS_FSctlPrep to pre-stage a file or
+                          XRDOSS_FSctlQPrep to query its pre-stage status.
+            alen        - Length of the argument.
+            args        - "<prty> <path>[?cgi]" or "<path>[?cgi]", respectively.
+            resp        - Where the status text is placed for XRDOSS_FSctlQPrep.
+
+  Output:   Returns XrdOssOK upon success and -errno upon failure. The status
+            query returns the length of the malloc'd text placed in *resp.
+*/
+
+int XrdPssSys::FSctl(int cmd, int alen, const char *args, char **resp)
+{
+   const char *Cgi = 0;
+   char *eP, path[MAXPATHLEN+1], pbuff[PBsz], rbuff[1024];
+   int CgiLen = 0, prty = 0, retc;
+
+// Validate the command and get the priority, if any
+//
+   if (cmd != XRDOSS_FSctlPrep && cmd != XRDOSS_FSctlQPrep) return -ENOTSUP;
+   if (!args || alen <= 0) return -EINVAL;
+   if (cmd == XRDOSS_FSctlPrep)
+      {prty = strtol(args, &eP, 10);
+       if (eP == args || *eP != ' ') return -EINVAL;
+       alen -= (eP + 1) - args; args = eP + 1;
+      }
+
+// Split off the cgi and convert path to URL
+//
+   if (alen <= 0 || alen > MAXPATHLEN) return -ENAMETOOLONG;
+   strncpy(path, args, alen); path[alen] = 0;
+   if ((eP = index(path, '?'))) {*eP++ = 0; Cgi = eP; CgiLen = strlen(eP);}
+   if (!P2URL(retc,pbuff,PBsz,path,0,Cgi,CgiLen,0,xLfn2Pfn)) return retc;
+
+// Pass the request to the cache
+//
+   if (cmd == XRDOSS_FSctlPrep)
+      return (XrdPosixXrootd::Stage(pbuff, prty) ? -errno : XrdOssOK);
+
+   if ((retc = XrdPosixXrootd::StageStatus(pbuff, rbuff, sizeof(rbuff))) < 0)
+      return -errno;
+   if (resp) *resp = strdup(rbuff);
+   return retc;
+}
   
 /******************************************************************************/
 /*                               L f n 2 P f n                                */
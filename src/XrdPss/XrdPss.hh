@@ -126,6 +126,7 @@ int       Chmod(const char *, mode_t mode, XrdOucEnv *eP=0);
 virtual
 int       Create(const char *, const char *, mode_t, XrdOucEnv &, int opts=0);
 void      EnvInfo(XrdOucEnv *envP);
+int       FSctl(int cmd, int alen, const char *args, char **resp=0);
 int       Init(XrdSysLogger *, const char *);
 int       Lfn2Pfn(const char *Path, char *buff, int blen);
 const
@@ -143,10 +143,12 @@ add_library(
   XrdCms/XrdCmsClientMan.cc       XrdCms/XrdCmsClientMan.hh
   XrdCms/XrdCmsClientMsg.cc       XrdCms/XrdCmsClientMsg.hh
   XrdCms/XrdCmsFinder.cc          XrdCms/XrdCmsFinder.hh
+  XrdCms/XrdCmsRdrCache.cc        XrdCms/XrdCmsRdrCache.hh
   XrdCms/XrdCmsClient.cc          XrdCms/XrdCmsClient.hh
   XrdCms/XrdCmsResp.cc            XrdCms/XrdCmsResp.hh
   XrdCms/XrdCmsReq.cc             XrdCms/XrdCmsReq.hh
   XrdCms/XrdCmsRTable.cc          XrdCms/XrdCmsRTable.hh
+                                  XrdCms/XrdCmsSMask.hh
                                   XrdCms/XrdCmsTypes.hh
   XrdCms/XrdCmsUtils.cc           XrdCms/XrdCmsUtils.hh
                                   XrdCms/XrdCmsVnId.hh
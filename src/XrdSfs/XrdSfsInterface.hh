@@ -90,6 +90,7 @@
 #define SFS_FSCTL_STATLS  3 // Return LS data
 #define SFS_FSCTL_STATXA  4 // Return XA data
 #define SFS_FSCTL_STATCC  5 // Return Cluster Config status
+#define SFS_FSCTL_STATPR  6 // Return pre-stage status
 #define SFS_FSCTL_PLUGIN  8 // Return Implementation Dependent Data
 #define SFS_FSCTL_PLUGIO 16 // Return Implementation Dependent Data
 
@@ -321,6 +322,7 @@ virtual void           EnvInfo(XrdOucEnv *envP)
 //!                  SFS_FSCTL_STATFS  Return physical filesystem information
 //!                  SFS_FSCTL_STATLS  Return logical  filesystem information
 //!                  SFS_FSCTL_STATXA  Return extended attributes
+//!                  SFS_FSCTL_STATPR  Return pre-stage status
 //! @param  args   - Arguments specific to cmd.
 //!                  SFS_FSCTL_LOCATE  args points to the path to be located
 //!                                    ""   path is the first exported path
@@ -330,6 +332,7 @@ virtual void           EnvInfo(XrdOucEnv *envP)
 //!                  SFS_FSCTL_STATFS  Path in the filesystem in question.
 //!                  SFS_FSCTL_STATLS  Path in the filesystem in question.
 //!                  SFS_FSCTL_STATXA  Path of the file whose xattr is wanted.
+//!                  SFS_FSCTL_STATPR  Path of the file whose status is wanted.
 //! @param  eInfo  - The object where error info or results are to be returned.
 //! @param  client - Client's identify (see common description).
 //!
@@ -161,6 +161,7 @@ enum RD_func {RD_chmod = 0, RD_chksum,  RD_dirlist, RD_locate, RD_mkdir,
        int   do_Qconf();
        int   do_Qfh();
        int   do_Qopaque(short);
+       int   do_Qprep();
        int   do_Qspace();
        int   do_Query();
        int   do_Qxattr();
@@ -1457,7 +1457,8 @@ int XrdXrootdProtocol::do_Prepare()
 //
    fsprep.paths   = 0;
    fsprep.oinfo   = 0;
-   fsprep.opts   |= Prep_PRTY0 | (opts & kXR_fresh ? Prep_FRESH : 0);
+   fsprep.opts   |= (Request.prepare.prty & Prep_PMASK)
+                 |  (opts & kXR_fresh ? Prep_FRESH : 0);
    fsprep.notify  = 0;
 
 // Check if this is a cancel request
@@ -1810,6 +1811,34 @@ int XrdXrootdProtocol::do_Qopaque(short qopt)
    return fsError(rc, 0, myError, 0, 0);
 }
 
+/******************************************************************************/
+/*                              d o _ Q p r e p                               */
+/******************************************************************************/
+
+int XrdXrootdProtocol::do_Qprep()
+{
+   static XrdXrootdCallBack statCB("stat", XROOTD_MON_QUERY);
+   static const int fsctl_cmd = SFS_FSCTL_STATPR;
+   int rc;
+   char *opaque;
+   XrdOucErrInfo myError(Link->ID,&statCB,ReqID.getID(),Monitor.Did,clientPV);
+
+// Check for static routing
+//
+   STATIC_REDIRECT(RD_prepare);
+
+// Prescreen the path
+//
+   if (rpCheck(argp->buff, &opaque)) return rpEmsg("Querying", argp->buff);
+   if (!Squash(argp->buff))          return vpEmsg("Querying", argp->buff);
+
+// Preform the actual function
+//
+   rc = osFS->fsctl(fsctl_cmd, argp->buff, myError, CRED);
+   TRACEP(FS, "rc=" <<rc <<" qprep " <<argp->buff);
+   return fsError(rc, XROOTD_MON_QUERY, myError, argp->buff, opaque);
+}
+
 /******************************************************************************/
 /*                             d o _ Q s p a c e                              */
 /******************************************************************************/
@@ -1867,6 +1896,7 @@ int XrdXrootdProtocol::do_Query()
           case kXR_Qopaque:
           case kXR_Qopaquf: return do_Qopaque(qopt);
           case kXR_Qopaqug: return do_Qfh();
+          case kXR_QPrep:   return do_Qprep();
           default:          break;
          }
 
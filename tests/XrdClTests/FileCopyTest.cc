@@ -52,15 +52,17 @@ class FileCopyTest: public CppUnit::TestCase
       CPPUNIT_TEST( UploadTest );
       CPPUNIT_TEST( MultiStreamDownloadTest );
       CPPUNIT_TEST( MultiStreamUploadTest );
+      CPPUNIT_TEST( AdaptiveStreamDownloadTest );
       CPPUNIT_TEST( ThirdPartyCopyTest );
       CPPUNIT_TEST( NormalCopyTest );
     CPPUNIT_TEST_SUITE_END();
-    void DownloadTestFunc();
+    void DownloadTestFunc( const std::string &userName = "" );
     void UploadTestFunc();
     void DownloadTest();
     void UploadTest();
     void MultiStreamDownloadTest();
     void MultiStreamUploadTest();
+    void AdaptiveStreamDownloadTest();
     void CopyTestFunc( bool thirdParty = true );
     void ThirdPartyCopyTest();
     void NormalCopyTest();
@@ -71,7 +73,7 @@ CPPUNIT_TEST_SUITE_REGISTRATION( FileCopyTest );
 //------------------------------------------------------------------------------
 // Download test
 //------------------------------------------------------------------------------
-void FileCopyTest::DownloadTestFunc()
+void FileCopyTest::DownloadTestFunc( const std::string &userName )
 {
   using namespace XrdCl;
 
@@ -86,6 +88,9 @@ void FileCopyTest::DownloadTestFunc()
   CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
   CPPUNIT_ASSERT( testEnv->GetString( "RemoteFile",    remoteFile ) );
 
+  if( !userName.empty() )
+    address.insert( address.find( "://" ) + 3, userName + "@" );
+
   URL url( address );
   CPPUNIT_ASSERT( url.IsValid() );
 
@@ -275,6 +280,61 @@ void FileCopyTest::MultiStreamDownloadTest()
   DownloadTestFunc();
 }
 
+void FileCopyTest::AdaptiveStreamDownloadTest()
+{
+  using namespace XrdCl;
+  Env *env = DefaultEnv::GetEnv();
+
+  int subStreams    = DefaultSubStreamsPerChannel;
+  int maxSubStreams = DefaultMaxSubStreamsPerChannel;
+  int threshold     = DefaultSubStreamThreshold;
+  env->GetInt( "SubStreamsPerChannel",    subStreams );
+  env->GetInt( "MaxSubStreamsPerChannel", maxSubStreams );
+  env->GetInt( "SubStreamThreshold",      threshold );
+
+  env->PutInt( "SubStreamsPerChannel",    1 );
+  env->PutInt( "MaxSubStreamsPerChannel", 4 );
+  env->PutInt( "SubStreamThreshold",      1048576 );
+
+  //----------------------------------------------------------------------------
+  // The settings only apply to new channels, a user name of its own keeps
+  // the download away from the channels opened by the other tests
+  //----------------------------------------------------------------------------
+  DownloadTestFunc( "adaptive" );
+
+  //----------------------------------------------------------------------------
+  // The 4MB reads are above the threshold, so substreams have been added
+  // to the channel of the data server
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+  std::string address;
+  std::string remoteFile;
+  std::string dataServer;
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "RemoteFile",    remoteFile ) );
+  address.insert( address.find( "://" ) + 3, "adaptive@" );
+
+  File f;
+  CPPUNIT_ASSERT_XRDST( f.Open( address + "/" + remoteFile, OpenFlags::Read ) );
+  CPPUNIT_ASSERT( f.GetProperty( "DataServer", dataServer ) );
+  CPPUNIT_ASSERT_XRDST( f.Close() );
+
+  AnyObject  result;
+  int       *connected = 0;
+  Status     st = DefaultEnv::GetPostMaster()->QueryTransport(
+                    URL( dataServer ), XRootDQuery::SubStreams, result );
+  result.Get( connected );
+  int numConnected = connected ? *connected : 0;
+  delete connected;
+
+  env->PutInt( "SubStreamsPerChannel",    subStreams );
+  env->PutInt( "MaxSubStreamsPerChannel", maxSubStreams );
+  env->PutInt( "SubStreamThreshold",      threshold );
+
+  CPPUNIT_ASSERT_XRDST( st );
+  CPPUNIT_ASSERT( numConnected > 1 && numConnected <= 4 );
+}
+
 namespace
 {
   //----------------------------------------------------------------------------
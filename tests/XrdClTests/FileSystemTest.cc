@@ -21,9 +21,12 @@
 #include <XrdCl/XrdClFile.hh>
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdCl/XrdClPlugInManager.hh"
+#include "XrdCl/XrdClMetadataCache.hh"
 #include "CppUnitXrdHelpers.hh"
 
 #include <pthread.h>
+#include <cstdlib>
+#include <unistd.h>
 
 #include "TestEnv.hh"
 #include "IdentityPlugIn.hh"
@@ -45,6 +48,8 @@ class FileSystemTest: public CppUnit::TestCase
       CPPUNIT_TEST( ChmodTest );
       CPPUNIT_TEST( PingTest );
       CPPUNIT_TEST( StatTest );
+      CPPUNIT_TEST( MetadataCacheTest );
+      CPPUNIT_TEST( SharedMetadataCacheTest );
       CPPUNIT_TEST( StatVFSTest );
       CPPUNIT_TEST( ProtocolTest );
       CPPUNIT_TEST( DeepLocateTest );
@@ -61,6 +66,8 @@ class FileSystemTest: public CppUnit::TestCase
     void ChmodTest();
     void PingTest();
     void StatTest();
+    void MetadataCacheTest();
+    void SharedMetadataCacheTest();
     void StatVFSTest();
     void ProtocolTest();
     void DeepLocateTest();
@@ -331,6 +338,152 @@ void FileSystemTest::StatTest()
   delete response;
 }
 
+//------------------------------------------------------------------------------
+// Metadata cache test
+//------------------------------------------------------------------------------
+void FileSystemTest::MetadataCacheTest()
+{
+  using namespace XrdCl;
+
+  MetadataCache cache( 60, 60, 60, 60, 2, std::string() );
+  XRootDStatus *status   = 0;
+  AnyObject    *response = 0;
+  HostList     *hostList = 0;
+  uint64_t      epoch    = 0;
+
+  std::string fileKey = MetadataCache::MakeKey( kXR_stat, "srv:1094",
+                                                "/data/file", 0 );
+  std::string dirKey  = MetadataCache::MakeKey( kXR_stat, "srv:1094",
+                                                "/data/", 0 );
+  std::string missKey = MetadataCache::MakeKey( kXR_stat, "srv:1094",
+                                                "/data/missing", 0 );
+
+  //----------------------------------------------------------------------------
+  // Store a stat response and get a copy back
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT( !cache.Lookup( fileKey, status, response, hostList, epoch ) );
+
+  StatInfo *info = new StatInfo();
+  CPPUNIT_ASSERT( info->ParseServerResponse( "17 1024 16 1500000000" ) );
+  AnyObject obj;
+  obj.Set( info );
+  XRootDStatus ok;
+  cache.Insert( fileKey, epoch, &ok, &obj, 0 );
+
+  CPPUNIT_ASSERT( cache.Lookup( fileKey, status, response, hostList, epoch ) );
+  CPPUNIT_ASSERT( status->IsOK() );
+  StatInfo *cached = 0;
+  response->Get( cached );
+  CPPUNIT_ASSERT( cached && cached != info );
+  CPPUNIT_ASSERT( cached->GetSize() == 1024 );
+  CPPUNIT_ASSERT( cached->GetModTime() == 1500000000 );
+  delete status; delete response; delete hostList;
+
+  //----------------------------------------------------------------------------
+  // Not found responses are cached, other errors are not
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT( !cache.Lookup( missKey, status, response, hostList, epoch ) );
+  XRootDStatus notFound( stError, errErrorResponse, kXR_NotFound, "no file" );
+  cache.Insert( missKey, epoch, &notFound, 0, 0 );
+  CPPUNIT_ASSERT( cache.Lookup( missKey, status, response, hostList, epoch ) );
+  CPPUNIT_ASSERT( !status->IsOK() && status->errNo == kXR_NotFound );
+  CPPUNIT_ASSERT( !response );
+  delete status; delete hostList;
+
+  XRootDStatus ioError( stError, errErrorResponse, kXR_IOError, "oops" );
+  CPPUNIT_ASSERT( !cache.Lookup( dirKey, status, response, hostList, epoch ) );
+  cache.Insert( dirKey, epoch, &ioError, 0, 0 );
+  CPPUNIT_ASSERT( !cache.Lookup( dirKey, status, response, hostList, epoch ) );
+
+  //----------------------------------------------------------------------------
+  // A change of the parent directory drops the entries below it and
+  // responses looked up before the change are not stored
+  //----------------------------------------------------------------------------
+  cache.Invalidate( "/data" );
+  CPPUNIT_ASSERT( !cache.Lookup( fileKey, status, response, hostList, epoch ) );
+  CPPUNIT_ASSERT( !cache.Lookup( missKey, status, response, hostList, epoch ) );
+  cache.Invalidate( "/data/missing?some=cgi" );
+  cache.Insert( missKey, epoch, &notFound, 0, 0 );
+  CPPUNIT_ASSERT( !cache.Lookup( missKey, status, response, hostList, epoch ) );
+
+  //----------------------------------------------------------------------------
+  // Only two entries fit in this cache
+  //----------------------------------------------------------------------------
+  cache.Insert( missKey, epoch, &notFound, 0, 0 );
+  cache.Insert( fileKey, epoch, &ok, &obj, 0 );
+  cache.Insert( dirKey,  epoch, &ok, &obj, 0 );
+  CPPUNIT_ASSERT( !cache.Lookup( missKey, status, response, hostList, epoch ) );
+
+  MetadataCache::Stats stats;
+  cache.GetStats( stats );
+  CPPUNIT_ASSERT( stats.hits == 2 && stats.negativeHits == 1 );
+  CPPUNIT_ASSERT( stats.evictions == 1 && stats.invalidations == 2 );
+}
+
+//------------------------------------------------------------------------------
+// Metadata cache shared between processes
+//------------------------------------------------------------------------------
+void FileSystemTest::SharedMetadataCacheTest()
+{
+  using namespace XrdCl;
+
+  char shmPath[] = "/tmp/xrdcl-metadata-XXXXXX";
+  int fd = mkstemp( shmPath );
+  CPPUNIT_ASSERT( fd >= 0 );
+  close( fd );
+
+  //----------------------------------------------------------------------------
+  // Two caches mapping the same file stand for two processes
+  //----------------------------------------------------------------------------
+  MetadataCache cache1( 60, 60, 60, 60, 100, shmPath );
+  MetadataCache cache2( 60, 60, 60, 60, 100, shmPath );
+  XRootDStatus *status   = 0;
+  AnyObject    *response = 0;
+  HostList     *hostList = 0;
+  uint64_t      epoch1   = 0;
+  uint64_t      epoch2   = 0;
+
+  std::string fileKey   = MetadataCache::MakeKey( kXR_stat, "srv:1094",
+                                                  "/data/dir/file", 0 );
+  std::string locateKey = MetadataCache::MakeKey( kXR_locate, "srv:1094",
+                                                  "/other", 0 );
+
+  StatInfo *info = new StatInfo();
+  CPPUNIT_ASSERT( info->ParseServerResponse( "17 1024 16 1500000000" ) );
+  AnyObject statObj;
+  statObj.Set( info );
+  AnyObject locateObj;
+  locateObj.Set( new LocationInfo() );
+  XRootDStatus ok;
+
+  CPPUNIT_ASSERT( !cache1.Lookup( fileKey, status, response, hostList, epoch1 ) );
+  cache1.Insert( fileKey, epoch1, &ok, &statObj, 0 );
+  CPPUNIT_ASSERT( cache2.Lookup( fileKey, status, response, hostList, epoch2 ) );
+  delete status; delete response; delete hostList;
+
+  //----------------------------------------------------------------------------
+  // A change made by one drops what the other cached privately
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT( !cache2.Lookup( locateKey, status, response, hostList, epoch2 ) );
+  cache2.Insert( locateKey, epoch2, &ok, &locateObj, 0 );
+  cache1.Invalidate( "/unrelated" );
+  CPPUNIT_ASSERT( !cache2.Lookup( locateKey, status, response, hostList, epoch2 ) );
+  CPPUNIT_ASSERT( cache1.Lookup( fileKey, status, response, hostList, epoch1 ) );
+  delete status; delete response; delete hostList;
+
+  //----------------------------------------------------------------------------
+  // Removing a directory drops the shared responses below it, responses
+  // looked up before a change made by the other are not stored
+  //----------------------------------------------------------------------------
+  cache2.Invalidate( "/data/dir", true );
+  CPPUNIT_ASSERT( !cache1.Lookup( fileKey, status, response, hostList, epoch1 ) );
+  cache2.Invalidate( "/unrelated" );
+  cache1.Insert( fileKey, epoch1, &ok, &statObj, 0 );
+  CPPUNIT_ASSERT( !cache2.Lookup( fileKey, status, response, hostList, epoch2 ) );
+
+  unlink( shmPath );
+}
+
 //------------------------------------------------------------------------------
 // Stat VFS test
 //------------------------------------------------------------------------------
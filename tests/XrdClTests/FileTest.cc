@@ -34,8 +34,10 @@
 #include "XrdCl/XrdClCopyProcess.hh"
 #include "XrdCl/XrdClZipArchiveReader.hh"
 #include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClReadCache.hh"
 
 #include <random>
+#include <cstring>
 
 using namespace XrdClTests;
 
@@ -51,7 +53,10 @@ class FileTest: public CppUnit::TestCase
       CPPUNIT_TEST( WriteTest );
       CPPUNIT_TEST( WriteVTest );
       CPPUNIT_TEST( VectorReadTest );
+      CPPUNIT_TEST( VectorReadBufferedTest );
       CPPUNIT_TEST( VectorWriteTest );
+      CPPUNIT_TEST( ReadCacheTest );
+      CPPUNIT_TEST( ReadBatchTest );
       CPPUNIT_TEST( VirtualRedirectorTest );
       CPPUNIT_TEST( PlugInTest );
     CPPUNIT_TEST_SUITE_END();
@@ -60,7 +65,10 @@ class FileTest: public CppUnit::TestCase
     void WriteTest();
     void WriteVTest();
     void VectorReadTest();
+    void VectorReadBufferedTest();
     void VectorWriteTest();
+    void ReadCacheTest();
+    void ReadBatchTest();
     void VirtualRedirectorTest();
     void PlugInTest();
 };
@@ -410,6 +418,29 @@ void FileTest::WriteVTest()
   CPPUNIT_ASSERT( f2.Close().IsOK() );
   CPPUNIT_ASSERT( crc1 == crc2 );
 
+  //----------------------------------------------------------------------------
+  // Write the first buffer again in more pieces than a single writev takes
+  //----------------------------------------------------------------------------
+  const int smallcnt = 4096;
+  std::vector<iovec> smalliov( smallcnt );
+  for( int i = 0; i < smallcnt; ++i )
+  {
+    smalliov[i].iov_base = buffer1 + i * 1024;
+    smalliov[i].iov_len  = 1024;
+  }
+
+  File f3, f4;
+  CPPUNIT_ASSERT( f3.Open( fileUrl, OpenFlags::Delete | OpenFlags::Update,
+                           Access::UR | Access::UW ).IsOK() );
+  CPPUNIT_ASSERT( f3.WriteV( 0, &smalliov[0], smallcnt ).IsOK() );
+  CPPUNIT_ASSERT( f3.Close().IsOK() );
+
+  CPPUNIT_ASSERT( f4.Open( fileUrl, OpenFlags::Read ).IsOK() );
+  CPPUNIT_ASSERT( f4.Read( 0, 4*MB, buffer3, bytesRead1 ).IsOK() );
+  CPPUNIT_ASSERT( bytesRead1 == 4*MB );
+  CPPUNIT_ASSERT( f4.Close().IsOK() );
+  CPPUNIT_ASSERT( memcmp( buffer1, buffer3, 4*MB ) == 0 );
+
   FileSystem fs( url );
   CPPUNIT_ASSERT( fs.Rm( filePath ).IsOK() );
   delete [] buffer1;
@@ -487,6 +518,250 @@ void FileTest::VectorReadTest()
   delete [] buffer2;
 }
 
+//------------------------------------------------------------------------------
+// Vector read test with the response parsed from the receive buffer
+//------------------------------------------------------------------------------
+void FileTest::VectorReadBufferedTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath", dataPath ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  std::string filePath = dataPath + "/a048e67f-4397-4bb8-85eb-8d7e40d90763.dat";
+  std::string fileUrl = address + "/";
+  fileUrl += filePath;
+
+  //----------------------------------------------------------------------------
+  // Many small chunks, the whole response fits in the default receive
+  // buffer so that all the chunks but the first are read from the data
+  // buffered together with the response header
+  //----------------------------------------------------------------------------
+  const uint32_t MB        = 1024*1024;
+  const uint32_t nChunks   = 100;
+  const uint32_t chunkSize = 500;
+  char *buffer1 = new char[nChunks*chunkSize];
+  char *buffer2 = new char[chunkSize];
+  File f;
+
+  ChunkList chunkList;
+  for( uint32_t i = 0; i < nChunks; ++i )
+    chunkList.push_back( ChunkInfo( i*MB + 7*i, chunkSize ) );
+
+  CPPUNIT_ASSERT_XRDST( f.Open( fileUrl, OpenFlags::Read ) );
+  VectorReadInfo *info = 0;
+  CPPUNIT_ASSERT_XRDST( f.VectorRead( chunkList, buffer1, info ) );
+  CPPUNIT_ASSERT( info->GetSize() == nChunks*chunkSize );
+  CPPUNIT_ASSERT( info->GetChunks().size() == nChunks );
+  delete info;
+
+  //----------------------------------------------------------------------------
+  // Compare every chunk with the same data read on its own
+  //----------------------------------------------------------------------------
+  for( uint32_t i = 0; i < nChunks; ++i )
+  {
+    uint32_t bytesRead = 0;
+    CPPUNIT_ASSERT_XRDST( f.Read( chunkList[i].offset, chunkSize, buffer2,
+                                  bytesRead ) );
+    CPPUNIT_ASSERT( bytesRead == chunkSize );
+    CPPUNIT_ASSERT( memcmp( buffer1 + i*chunkSize, buffer2, chunkSize ) == 0 );
+  }
+
+  CPPUNIT_ASSERT_XRDST( f.Close() );
+
+  delete [] buffer1;
+  delete [] buffer2;
+}
+
+//------------------------------------------------------------------------------
+// Read cache test
+//------------------------------------------------------------------------------
+void FileTest::ReadCacheTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath", dataPath ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  std::string filePath = dataPath + "/a048e67f-4397-4bb8-85eb-8d7e40d90763.dat";
+  std::string fileUrl = address + "/";
+  fileUrl += filePath;
+
+  const uint32_t MB = 1024*1024;
+  char *buffer1 = new char[40*MB];
+  char *buffer2 = new char[40*256000];
+  char *buffer3 = new char[20*MB];
+  char *buffer4 = new char[20*MB];
+  File f1, f2;
+
+  //----------------------------------------------------------------------------
+  // Vector reads through the cache, the second one is served from the
+  // blocks fetched by the first one
+  //----------------------------------------------------------------------------
+  Env *env = DefaultEnv::GetEnv();
+  env->PutString( "ReadCacheSize", "67108864" );
+  ReadCache *cache = DefaultEnv::GetReadCache();
+  CPPUNIT_ASSERT( cache );
+  CPPUNIT_ASSERT_XRDST( f1.Open( fileUrl, OpenFlags::Read ) );
+  env->PutString( "ReadCacheSize", "0" );
+
+  ChunkList chunkList1;
+  ChunkList chunkList2;
+  for( int i = 0; i < 40; ++i )
+  {
+    chunkList1.push_back( ChunkInfo( (i+1)*10*MB, 1*MB ) );
+    chunkList2.push_back( ChunkInfo( (i+1)*10*MB, 256000 ) );
+  }
+
+  VectorReadInfo *info = 0;
+  CPPUNIT_ASSERT_XRDST( f1.VectorRead( chunkList1, buffer1, info ) );
+  CPPUNIT_ASSERT( info->GetSize() == 40*MB );
+  delete info;
+  CPPUNIT_ASSERT( Utils::ComputeCRC32( buffer1, 40*MB ) == 3695956670UL );
+
+  info = 0;
+  CPPUNIT_ASSERT_XRDST( f1.VectorRead( chunkList2, buffer2, info ) );
+  CPPUNIT_ASSERT( info->GetSize() == 40*256000 );
+  delete info;
+  CPPUNIT_ASSERT( Utils::ComputeCRC32( buffer2, 40*256000 ) == 3492603530UL );
+
+  //----------------------------------------------------------------------------
+  // Small sequential reads through the cache compared to the data read
+  // directly
+  //----------------------------------------------------------------------------
+  uint32_t bytesRead = 0;
+  for( uint32_t offset = 0; offset < 20*MB; offset += 65536 )
+  {
+    CPPUNIT_ASSERT_XRDST( f1.Read( 10*MB + offset, 65536, buffer3 + offset,
+                                   bytesRead ) );
+    CPPUNIT_ASSERT( bytesRead == 65536 );
+  }
+
+  CPPUNIT_ASSERT_XRDST( f2.Open( fileUrl, OpenFlags::Read ) );
+  CPPUNIT_ASSERT_XRDST( f2.Read( 10*MB, 20*MB, buffer4, bytesRead ) );
+  CPPUNIT_ASSERT( bytesRead == 20*MB );
+  CPPUNIT_ASSERT( memcmp( buffer3, buffer4, 20*MB ) == 0 );
+
+  CPPUNIT_ASSERT_XRDST( f1.Close() );
+  CPPUNIT_ASSERT_XRDST( f2.Close() );
+
+  ReadCache::Stats stats;
+  cache->GetStats( stats );
+  CPPUNIT_ASSERT( stats.hits > 0 );
+  CPPUNIT_ASSERT( stats.readAheadHits > 0 );
+
+  //----------------------------------------------------------------------------
+  // A re-opened file reads through a cache of its own again and finds the
+  // blocks fetched before, unless disabled in the meantime
+  //----------------------------------------------------------------------------
+  env->PutString( "ReadCacheSize", "67108864" );
+  CPPUNIT_ASSERT_XRDST( f1.Open( fileUrl, OpenFlags::Read ) );
+  env->PutString( "ReadCacheSize", "0" );
+  CPPUNIT_ASSERT_XRDST( f1.Read( 29*MB, 1*MB, buffer4, bytesRead ) );
+  CPPUNIT_ASSERT( bytesRead == 1*MB );
+  CPPUNIT_ASSERT( memcmp( buffer3 + 19*MB, buffer4, 1*MB ) == 0 );
+  CPPUNIT_ASSERT_XRDST( f1.Close() );
+
+  ReadCache::Stats stats2;
+  cache->GetStats( stats2 );
+  CPPUNIT_ASSERT( stats2.hits > stats.hits );
+  CPPUNIT_ASSERT( stats2.misses == stats.misses );
+
+  delete [] buffer1;
+  delete [] buffer2;
+  delete [] buffer3;
+  delete [] buffer4;
+}
+
+//------------------------------------------------------------------------------
+// Read batching test
+//------------------------------------------------------------------------------
+void FileTest::ReadBatchTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath", dataPath ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  std::string filePath = dataPath + "/a048e67f-4397-4bb8-85eb-8d7e40d90763.dat";
+  std::string fileUrl = address + "/";
+  fileUrl += filePath;
+
+  //----------------------------------------------------------------------------
+  // Issue a bunch of reads at once, all but the first one get batched,
+  // and compare with the data read in one go
+  //----------------------------------------------------------------------------
+  const uint32_t MB       = 1024*1024;
+  const uint32_t numReads = 100;
+  const uint32_t readSize = 100000;
+  char *buffer1 = new char[numReads*readSize];
+  char *buffer2 = new char[numReads*readSize];
+
+  Env *env = DefaultEnv::GetEnv();
+  env->PutInt( "ReadBatchSize", 16 );
+  File f;
+  env->PutInt( "ReadBatchSize", 0 );
+  CPPUNIT_ASSERT_XRDST( f.Open( fileUrl, OpenFlags::Read ) );
+
+  SyncResponseHandler handlers[numReads];
+  for( uint32_t i = 0; i < numReads; ++i )
+    CPPUNIT_ASSERT_XRDST( f.Read( 10*MB + i*readSize, readSize,
+                                  buffer1 + i*readSize, &handlers[i] ) );
+
+  for( uint32_t i = 0; i < numReads; ++i )
+  {
+    ChunkInfo *chunk = 0;
+    CPPUNIT_ASSERT_XRDST( MessageUtils::WaitForResponse( &handlers[i], chunk ) );
+    CPPUNIT_ASSERT( chunk->offset == 10*MB + i*readSize );
+    CPPUNIT_ASSERT( chunk->length == readSize );
+    CPPUNIT_ASSERT( chunk->buffer == buffer1 + i*readSize );
+    delete chunk;
+  }
+
+  uint32_t bytesRead = 0;
+  CPPUNIT_ASSERT_XRDST( f.Read( 10*MB, numReads*readSize, buffer2,
+                                bytesRead ) );
+  CPPUNIT_ASSERT( bytesRead == numReads*readSize );
+  CPPUNIT_ASSERT( memcmp( buffer1, buffer2, numReads*readSize ) == 0 );
+  CPPUNIT_ASSERT_XRDST( f.Close() );
+
+  delete [] buffer1;
+  delete [] buffer2;
+}
+
 void gen_random_str(char *s, const int len)
 {
     static const char alphanum[] =
@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "CppUnitXrdHelpers.hh"
+#include "XrdCl/XrdClMemoryPool.hh"
+#include "XrdCl/XrdClMessage.hh"
+#include "XrdCl/XrdClURL.hh"
+#include "XrdCl/XrdClXRootDMsgHandler.hh"
+#include "XProtocol/XProtocol.hh"
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class MemoryPoolTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( MemoryPoolTest );
+      CPPUNIT_TEST( RecycleTest );
+    CPPUNIT_TEST_SUITE_END();
+    void RecycleTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( MemoryPoolTest );
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Go through the allocations of a stat request and its response
+  //----------------------------------------------------------------------------
+  void SimulateRequest( const XrdCl::URL &url, const std::string &path )
+  {
+    using namespace XrdCl;
+    Message *msg = new Message( sizeof( ClientStatRequest ) + path.length() );
+    ClientStatRequest *req = (ClientStatRequest*)msg->GetBuffer();
+    req->requestid = kXR_stat;
+    req->dlen      = path.length();
+    memcpy( msg->GetBuffer( sizeof( ClientStatRequest ) ), path.c_str(),
+            path.length() );
+
+    XRootDMsgHandler *handler = new XRootDMsgHandler( msg, 0, &url, 0, 0 );
+
+    Message *resp = new Message();
+    resp->Allocate( 8 );
+    resp->AdvanceCursor( 8 );
+    resp->ReAllocate( 8 + 40 );
+
+    delete resp;
+    delete handler;
+  }
+
+  //----------------------------------------------------------------------------
+  // Run the simulated requests
+  //----------------------------------------------------------------------------
+  void RunRequests( uint32_t n )
+  {
+    XrdCl::URL  url( "root://localhost//data/file.dat" );
+    std::string path = url.GetPath();
+    for( uint32_t i = 0; i < n; ++i )
+      SimulateRequest( url, path );
+  }
+}
+
+//------------------------------------------------------------------------------
+// Blocks are recycled through the thread cache
+//------------------------------------------------------------------------------
+void MemoryPoolTest::RecycleTest()
+{
+  using namespace XrdCl;
+  bool enabled = MemoryPool::IsEnabled();
+  const uint32_t n = 1000;
+
+  //----------------------------------------------------------------------------
+  // Nothing is counted when pooling is disabled
+  //----------------------------------------------------------------------------
+  MemoryPool::SetEnabled( false );
+  MemoryPool::Stats before, after;
+  MemoryPool::GetStats( before );
+  RunRequests( n );
+  MemoryPool::GetStats( after );
+  CPPUNIT_ASSERT( after.allocations == before.allocations );
+  CPPUNIT_ASSERT( after.frees == before.frees );
+
+  //----------------------------------------------------------------------------
+  // Once the thread cache is warm every block comes from it and goes back
+  // to it, nothing is obtained from or returned to the system
+  //----------------------------------------------------------------------------
+  MemoryPool::SetEnabled( true );
+  RunRequests( 10 );
+  MemoryPool::GetStats( before );
+  RunRequests( n );
+  MemoryPool::GetStats( after );
+
+  uint64_t allocs = after.allocations - before.allocations;
+  CPPUNIT_ASSERT( allocs >= n );
+  CPPUNIT_ASSERT( after.frees - before.frees == allocs );
+  CPPUNIT_ASSERT( after.threadHits - before.threadHits == allocs );
+  CPPUNIT_ASSERT( after.threadRecycled - before.threadRecycled == allocs );
+  CPPUNIT_ASSERT( after.sysAllocs == before.sysAllocs );
+  CPPUNIT_ASSERT( after.sysFrees == before.sysFrees );
+
+  MemoryPool::SetEnabled( enabled );
+}
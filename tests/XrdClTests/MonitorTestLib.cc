@@ -188,6 +188,23 @@ class MonitorTest: public XrdCl::Monitor
                       i->oTime, i->tTime );
           break;
         }
+
+        //----------------------------------------------------------------------
+        // Got a substream event
+        //----------------------------------------------------------------------
+        case EvSubStream:
+        {
+          SubStreamInfo *i = (SubStreamInfo*)evData;
+          const char *action = "stats";
+          if( i->action == SubStreamInfo::Opened ) action = "opened";
+          else if( i->action == SubStreamInfo::Closed ) action = "closed";
+          log->Debug( 2, "Substream %d of %s %s: received: %ld, sent: %ld, "
+                      "receive rate: %ld B/s, send rate: %ld B/s, pending: "
+                      "%ld, active substreams: %d", i->subStream,
+                      i->server.c_str(), action, i->rBytes, i->sBytes,
+                      i->rRate, i->sRate, i->pending, i->active );
+          break;
+        }
       }
     }
 
@@ -394,6 +394,7 @@ void UtilsTest::SIDManagerTest()
   CPPUNIT_ASSERT_XRDST( manager.AllocateSID( sid5 ) );
 
   CPPUNIT_ASSERT( (sid1[0] != sid2[0]) || (sid1[1] != sid2[1]) );
+  CPPUNIT_ASSERT( (sid2[0] != sid3[0]) || (sid2[1] != sid3[1]) );
   CPPUNIT_ASSERT( manager.NumberOfTimedOutSIDs() == 0 );
   manager.TimeOutSID( sid4 );
   manager.TimeOutSID( sid5 );
@@ -406,6 +407,31 @@ void UtilsTest::SIDManagerTest()
   CPPUNIT_ASSERT( manager.IsTimedOut( sid5 ) == false );
   manager.ReleaseAllTimedOut();
   CPPUNIT_ASSERT( manager.NumberOfTimedOutSIDs() == 0 );
+  CPPUNIT_ASSERT( manager.GetNumberOfAllocatedSIDs() == 2 );
+
+  //----------------------------------------------------------------------------
+  // Exhaust the SID space, released SIDs are handed out again
+  //----------------------------------------------------------------------------
+  SIDManager manager1;
+  uint8_t    sid[2];
+  uint32_t   allocated = 0;
+  while( manager1.AllocateSID( sid ).IsOK() )
+  {
+    uint16_t s = 0;
+    memcpy( &s, sid, 2 );
+    CPPUNIT_ASSERT( s != 0 && s != 0xffff );
+    ++allocated;
+  }
+  CPPUNIT_ASSERT( allocated == 0xfffe );
+  CPPUNIT_ASSERT( manager1.GetNumberOfAllocatedSIDs() == 0xfffe );
+
+  uint16_t s = 1000;
+  memcpy( sid, &s, 2 );
+  manager1.TimeOutSID( sid );
+  CPPUNIT_ASSERT( !manager1.AllocateSID( sid1 ).IsOK() );
+  manager1.ReleaseTimedOut( sid );
+  CPPUNIT_ASSERT_XRDST( manager1.AllocateSID( sid1 ) );
+  CPPUNIT_ASSERT( memcmp( sid, sid1, 2 ) == 0 );
 }
 
 //------------------------------------------------------------------------------
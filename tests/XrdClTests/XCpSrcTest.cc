@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "CppUnitXrdHelpers.hh"
+#include "XrdCl/XrdClXCpSrc.hh"
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class XCpSrcTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( XCpSrcTest );
+      CPPUNIT_TEST( StealTest );
+      CPPUNIT_TEST( HedgeTest );
+    CPPUNIT_TEST_SUITE_END();
+    void StealTest();
+    void HedgeTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( XCpSrcTest );
+
+//------------------------------------------------------------------------------
+// A faster source takes over its share of the block of a slower one
+//------------------------------------------------------------------------------
+void XCpSrcTest::StealTest()
+{
+  using XrdCl::XCpSrc;
+  const uint32_t chunk = 1024;
+
+  //----------------------------------------------------------------------------
+  // Nothing is stolen before we know our own transfer rate
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT( XCpSrc::StealFraction( 0, 100 ) == 0 );
+  CPPUNIT_ASSERT( XCpSrc::StealFraction( 300, 100 ) == 0.75 );
+  CPPUNIT_ASSERT( XCpSrc::StealFraction( 100, 300 ) == 0.25 );
+  CPPUNIT_ASSERT( XCpSrc::StealFraction( 100, 0 ) == 1 );
+
+  //----------------------------------------------------------------------------
+  // Take our share of the block, or all of it if at most one chunk would
+  // be left to the source
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT( XCpSrc::StealSize( 0.75, 16*chunk, chunk ) == 12*chunk );
+  CPPUNIT_ASSERT( XCpSrc::StealSize( 0.25, 16*chunk, chunk ) == 4*chunk );
+  CPPUNIT_ASSERT( XCpSrc::StealSize( 0.75, 4*chunk, chunk ) == 4*chunk );
+  CPPUNIT_ASSERT( XCpSrc::StealSize( 0.5, 2*chunk, chunk ) == 2*chunk );
+  CPPUNIT_ASSERT( XCpSrc::StealSize( 0.1, chunk/2, chunk ) == chunk/2 );
+}
+
+//------------------------------------------------------------------------------
+// The in-flight chunks are only read again by a faster source
+//------------------------------------------------------------------------------
+void XCpSrcTest::HedgeTest()
+{
+  using XrdCl::XCpSrc;
+  CPPUNIT_ASSERT( XCpSrc::ShouldHedge( XCpSrc::StealFraction( 300, 100 ) ) );
+  CPPUNIT_ASSERT( XCpSrc::ShouldHedge( XCpSrc::StealFraction( 101, 100 ) ) );
+  CPPUNIT_ASSERT( !XCpSrc::ShouldHedge( XCpSrc::StealFraction( 100, 100 ) ) );
+  CPPUNIT_ASSERT( !XCpSrc::ShouldHedge( XCpSrc::StealFraction( 100, 300 ) ) );
+  CPPUNIT_ASSERT( !XCpSrc::ShouldHedge( XCpSrc::StealFraction( 0, 100 ) ) );
+}
@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "XrdCms/XrdCmsRspTime.hh"
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class RspTimeTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( RspTimeTest );
+      CPPUNIT_TEST( PingTest );
+      CPPUNIT_TEST( UsageTest );
+    CPPUNIT_TEST_SUITE_END();
+    void PingTest();
+    void UsageTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( RspTimeTest );
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Is the smoothed response time (ms/16) within a millisecond of rtt?
+  //----------------------------------------------------------------------------
+  bool Near( XrdCmsRspTime &rsp, int rtt )
+  {
+    int diff = rsp.Time() - rtt*16;
+    return diff > -16 && diff < 16;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Pings answered in a constant time converge to that time
+//------------------------------------------------------------------------------
+void RspTimeTest::PingTest()
+{
+  XrdCmsRspTime rsp;
+  long long     now = 1000000;
+
+  CPPUNIT_ASSERT( rsp.Time() == 0 );
+  for( int i = 0; i < 32; ++i, now += 1000 )
+  {
+    rsp.Sent( now );
+    rsp.Answered( now + 5 );
+  }
+  CPPUNIT_ASSERT( Near( rsp, 5 ) );
+
+  //----------------------------------------------------------------------------
+  // A reply without a request, or a second one, changes nothing
+  //----------------------------------------------------------------------------
+  int before = rsp.Time();
+  rsp.Answered( now + 500 );
+  CPPUNIT_ASSERT( rsp.Time() == before );
+
+  //----------------------------------------------------------------------------
+  // A stall counts as a second at most
+  //----------------------------------------------------------------------------
+  rsp.Sent( now );
+  rsp.Answered( now + 60000 );
+  CPPUNIT_ASSERT( rsp.Time() == (before*3 + 1000*16)/4 );
+}
+
+//------------------------------------------------------------------------------
+// Usage requests answered by a load report interleaved with pings, as the
+// manager sends them, keep the response time at the round trip time
+//------------------------------------------------------------------------------
+void RspTimeTest::UsageTest()
+{
+  XrdCmsRspTime rsp;
+  long long     now = 1000000;
+
+  for( int i = 0; i < 32; ++i, now += 1000 )
+  {
+    rsp.Sent( now );             // usage request
+    rsp.Answered( now + 3 );     // load
+    rsp.Sent( now + 500 );       // ping
+    rsp.Answered( now + 503 );   // pong
+  }
+  CPPUNIT_ASSERT( Near( rsp, 3 ) );
+
+  //----------------------------------------------------------------------------
+  // Should the load not be taken as the answer, the ping is timed from the
+  // usage request and the node looks a lot slower than it is
+  //----------------------------------------------------------------------------
+  rsp.Sent( now );
+  rsp.Sent( now + 500 );
+  rsp.Answered( now + 503 );
+  CPPUNIT_ASSERT( !Near( rsp, 3 ) );
+}
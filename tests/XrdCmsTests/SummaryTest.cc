@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "XrdCms/XrdCmsSummary.hh"
+
+#include <cstdio>
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class SummaryTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( SummaryTest );
+      CPPUNIT_TEST( MembershipTest );
+      CPPUNIT_TEST( TransferTest );
+    CPPUNIT_TEST_SUITE_END();
+    void MembershipTest();
+    void TransferTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( SummaryTest );
+
+//------------------------------------------------------------------------------
+// Membership test
+//------------------------------------------------------------------------------
+void SummaryTest::MembershipTest()
+{
+  XrdCmsSummary summary( 16, 7 );
+  char          path[64];
+
+  CPPUNIT_ASSERT( summary.Size() == 8192 );
+  CPPUNIT_ASSERT( !summary.Has( "/data/file" ) );
+
+  //----------------------------------------------------------------------------
+  // Added paths are always found, however they are spelled
+  //----------------------------------------------------------------------------
+  summary.Add( "/data/file" );
+  summary.Add( "/data/dir/" );
+  CPPUNIT_ASSERT( summary.Has( "/data/file" ) );
+  CPPUNIT_ASSERT( summary.Has( "//data///file" ) );
+  CPPUNIT_ASSERT( summary.Has( "/data/dir" ) );
+  CPPUNIT_ASSERT( summary.Has( "/data/dir//" ) );
+  CPPUNIT_ASSERT( !summary.Has( "/data/fil" ) );
+  CPPUNIT_ASSERT( !summary.Has( "/data" ) );
+
+  unsigned int h1, h2;
+  XrdCmsSummary::Hash( "/data//file", h1, h2 );
+  CPPUNIT_ASSERT( summary.Has( h1, h2 ) );
+
+  //----------------------------------------------------------------------------
+  // With 64K bits for 1000 paths few others seem to be there
+  //----------------------------------------------------------------------------
+  for( int i = 0; i < 1000; ++i )
+  {
+    snprintf( path, sizeof( path ), "/store/file%d", i );
+    summary.Add( path );
+  }
+
+  int falsePositives = 0;
+  for( int i = 0; i < 1000; ++i )
+  {
+    snprintf( path, sizeof( path ), "/store/file%d", i );
+    CPPUNIT_ASSERT( summary.Has( path ) );
+    snprintf( path, sizeof( path ), "/store/other%d", i );
+    if( summary.Has( path ) ) ++falsePositives;
+  }
+  CPPUNIT_ASSERT( falsePositives < 10 );
+}
+
+//------------------------------------------------------------------------------
+// Transfer test
+//------------------------------------------------------------------------------
+void SummaryTest::TransferTest()
+{
+  XrdCmsSummary sent( 14, 5, 3 );
+  sent.Add( "/data/a" );
+  sent.Add( "/data/b" );
+  CPPUNIT_ASSERT( sent.Size() == 2048 );
+
+  //----------------------------------------------------------------------------
+  // The summary is received in pieces, paths added meanwhile are kept
+  //----------------------------------------------------------------------------
+  XrdCmsSummary received( sent.lgBits(), sent.Hashes(), sent.Gen() );
+  received.Add( "/data/c" );
+  CPPUNIT_ASSERT( received.Gen() == 3 && received.Hashes() == 5 );
+
+  const char *data = sent.Data();
+  CPPUNIT_ASSERT( !received.Set( 1000, data + 1000, 1000 ) );
+  CPPUNIT_ASSERT( received.Set( 0, data, 1000 ) );
+  CPPUNIT_ASSERT( !received.Done() );
+  CPPUNIT_ASSERT( !received.Set( 1000, data + 1000, 2000 ) );
+  CPPUNIT_ASSERT( received.Set( 1000, data + 1000, 1048 ) );
+  CPPUNIT_ASSERT( received.Done() );
+  CPPUNIT_ASSERT( !received.Set( 2048, data, 1 ) );
+
+  CPPUNIT_ASSERT( received.Has( "/data/a" ) );
+  CPPUNIT_ASSERT( received.Has( "/data/b" ) );
+  CPPUNIT_ASSERT( received.Has( "/data/c" ) );
+  CPPUNIT_ASSERT( !received.Has( "/data/d" ) );
+
+  //----------------------------------------------------------------------------
+  // Out of range parameters are clamped
+  //----------------------------------------------------------------------------
+  XrdCmsSummary clamped( 40, 99 );
+  CPPUNIT_ASSERT( clamped.lgBits() == XrdCmsSummary::maxLgBits );
+  CPPUNIT_ASSERT( clamped.Hashes() == XrdCmsSummary::maxHashes );
+}